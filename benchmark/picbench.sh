@@ -0,0 +1,167 @@
+#!/bin/sh
+# Benchmark driver for the skeleton PIC codes
+# sweeps grid size, particles per cell, tile size, thread count and
+# MPI node count over the serial, OpenMP, SSE and MPI C drivers and
+# prints a consolidated table of particle times in nsec/particle/step
+# and solver and total time in seconds
+#
+# usage: picbench.sh [name="value list"] ...
+# for example:
+#    picbench.sh variants="serial2 openmp2 sse2" indx="8 9" nvp="1 2 4"
+#
+# variants = codes to run, from:
+#    serial2 serial3 openmp1 openmpb1 openmp2 openmp3 sse2 ompsse2 mpi2
+#    mpi3 mpomp2
+# indx = exponent which determines grid points in each direction
+# ppc = number of particles per cell, must be a square in 2D and a cube
+#       in 3D
+# tile = number of grids in each direction in sorting tiles, OpenMP
+#        codes only
+# nvp = number of threads, OpenMP codes only
+# nproc = number of MPI nodes, MPI codes only
+# tend = time at end of simulation, in units of plasma frequency
+# mpirun = command used to start MPI codes
+# make = command used to build codes, for example
+#        make="make CC=gcc MPCC='gcc -fopenmp'"
+# out = name of file which receives the table, in addition to stdout
+# log = name of file which receives the output of every run
+# any other name=value pair is passed on to every run
+
+variants="serial2 openmp2 sse2 ompsse2 mpi2"
+indx="9"
+ppc1="36"
+ppc2="36"
+ppc3="27"
+ppc=""
+tile=""
+nvp="0"
+nproc="2"
+tend="2.0"
+mpirun="mpirun -np"
+make="make"
+out=""
+log="picbench.log"
+extra=""
+
+for arg in "$@"; do
+   case "$arg" in
+      variants=*|indx=*|ppc=*|tile=*|nvp=*|nproc=*|tend=*|mpirun=*| \
+      make=*|out=*|log=*)
+         eval "${arg%%=*}=\"\${arg#*=}\"" ;;
+      *=*)
+         extra="$extra $arg" ;;
+      *)
+         echo "picbench: expected name=value: $arg"; exit 1 ;;
+   esac
+done
+
+# root = top directory of the skeleton codes
+root=$(cd "$(dirname "$0")/.." && pwd)
+: > "$log"
+
+# variant = (directory,program,dimension,kind,extra parameters),
+# kind = (s,o,m) = (serial,OpenMP,MPI)
+setvar() {
+   case "$1" in
+      serial2) dir=serial/pic2; prog=cpic2; ndim=2; kind=s; vopt="" ;;
+      serial3) dir=serial/pic3; prog=cpic3; ndim=3; kind=s; vopt="" ;;
+      openmp1) dir=openmp/mpic1; prog=cmpic1_f; ndim=1; kind=o;
+               vopt="" ;;
+      openmpb1) dir=openmp/mbpic1; prog=cmbpic1_f; ndim=1; kind=o;
+                vopt="" ;;
+      openmp2) dir=openmp/mpic2; prog=cmpic2; ndim=2; kind=o; vopt="" ;;
+      openmp3) dir=openmp/mpic3; prog=cmpic3; ndim=3; kind=o; vopt="" ;;
+      sse2) dir=vectorization/vpic2; prog=cvpic2; ndim=2; kind=s;
+            vopt="kvec=2" ;;
+      ompsse2) dir=openmp_vectorization/vmpic2; prog=cvmpic2; ndim=2;
+               kind=o; vopt="kvec=2" ;;
+      mpi2) dir=mpi/ppic2; prog=cppic2; ndim=2; kind=m; vopt="" ;;
+      mpi3) dir=mpi/ppic3; prog=cppic3_f; ndim=3; kind=m; vopt="" ;;
+      mpomp2) dir=openmp_mpi/mppic2; prog=cmppic2; ndim=2; kind=m;
+              vopt="" ;;
+      *) echo "picbench: unknown variant $1"; exit 1 ;;
+   esac
+}
+
+# nroot = integer root of $1 of order $2, empty if $1 is not a power
+nroot() {
+   awk -v n="$1" -v d="$2" 'BEGIN {
+      k = int(exp(log(n)/d) + 0.5);
+      if (k^d == n) print k }'
+}
+
+table=$(mktemp)
+printf "%-8s %8s %4s %4s %4s %4s %9s %9s %9s %9s %9s %9s\n" variant \
+   grid ppc tile nvp np push deposit sort particle solver total > "$table"
+cat "$table"
+
+for v in $variants; do
+   setvar "$v"
+   if ! sh -c "$make -C \"$root/$dir\" $prog" >> "$log" 2>&1; then
+      echo "picbench: build of $dir/$prog failed, see $log"
+      continue
+   fi
+   if [ "$ndim" = 1 ]; then
+      dppc=$ppc1; pname=number
+   elif [ "$ndim" = 2 ]; then
+      dppc=$ppc2; pname=square
+   else
+      dppc=$ppc3; pname=cube
+   fi
+   for ix in $indx; do
+   for pc in ${ppc:-$dppc}; do
+      k=$(nroot "$pc" "$ndim")
+      if [ -z "$k" ]; then
+         echo "picbench: $v: ppc = $pc is not a $pname, skipped"
+         continue
+      fi
+      np=$((k << ix))
+      if [ "$ndim" = 1 ]; then
+         opts="indx=$ix npx=$np tend=$tend $vopt"
+      else
+         opts="indx=$ix indy=$ix npx=$np npy=$np tend=$tend $vopt"
+      fi
+      [ "$ndim" = 3 ] && opts="$opts indz=$ix npz=$np"
+      tiles="-"; threads="-"; nodes="-"
+      [ "$kind" = o ] && { tiles=${tile:--}; threads=$nvp; }
+      [ "$kind" = m ] && nodes=$nproc
+      for mt in $tiles; do
+      for nt in $threads; do
+      for nn in $nodes; do
+         run="./$prog $opts$extra"
+         [ "$mt" != - ] && run="$run mx=$mt" &&
+            [ "$ndim" != 1 ] && run="$run my=$mt" &&
+            [ "$ndim" = 3 ] && run="$run mz=$mt"
+         [ "$nt" != - ] && run="$run nvp=$nt"
+         [ "$nn" != - ] && run="$mpirun $nn $run"
+         echo "=== $v: $run" >> "$log"
+         res=$(cd "$root/$dir" && sh -c "$run" 2>&1)
+         echo "$res" >> "$log"
+         echo "$res" | awk -v v="$v" -v g="$((1 << ix))" -v pc="$pc" \
+            -v mt="$mt" -v nt="$nt" -v nn="$nn" '
+            /^Push Time \(nsec\)/ { push = $NF }
+            /^Deposit Time \(nsec\)/ { dpost = $NF }
+            /^Sort Time \(nsec\)/ { sort = $NF }
+            /^Total Particle Time \(nsec\)/ { part = $NF }
+            /^total solver time/ { solve = $NF }
+            /^total time/ { total = $NF }
+            END {
+               if (part == "") {
+                  printf("%-8s %8s %4s %4s %4s %4s failed\n",v,g,pc,mt,
+                         nt,nn)
+                  exit
+               }
+               printf("%-8s %8s %4s %4s %4s %4s %9.3f %9.3f %9.3f %9.3f %9.4f %9.4f\n",
+                      v,g,pc,mt,nt,nn,push,dpost,sort,part,solve,total) }' |
+            tee -a "$table"
+      done
+      done
+      done
+   done
+   done
+done
+
+if [ -n "$out" ]; then
+   cp "$table" "$out"
+fi
+rm -f "$table"
@@ -0,0 +1,197 @@
+/*---------------------------------------------------------------------*/
+/* FFT strong scaling benchmark for 2D MPI PIC codes */
+/* compares the data transposes in ptpose2.c with those in pplib2.c */
+/* for a fixed grid, as the number of MPI ranks is varied            */
+#include <stdlib.h>
+#include <stdio.h>
+#include <complex.h>
+#include <math.h>
+#include "ppush2.h"
+#include "pplib2.h"
+#include "cfglib.h"
+#include "ptpose2.h"
+
+/*--------------------------------------------------------------------*/
+static float cmaxdiff(float f[], float g[], int n) {
+/* this function returns the maximum absolute difference between f and
+   g, relative to the maximum absolute value of f, over all processors
+local data                                                            */
+   int j;
+   float fmax = 0.0, dmax = 0.0;
+   double sum[2], work[2];
+   for (j = 0; j < n; j++) {
+      fmax = fabsf(f[j]) > fmax ? fabsf(f[j]) : fmax;
+      dmax = fabsf(f[j]-g[j]) > dmax ? fabsf(f[j]-g[j]) : dmax;
+   }
+   sum[0] = fmax; sum[1] = dmax;
+   cppdmax(sum,work,2);
+   fmax = sum[0]; dmax = sum[1];
+   if (fmax > 0.0)
+      dmax = dmax/fmax;
+   return dmax;
+}
+
+int main(int argc, char *argv[]) {
+/* indmin/indmax = smallest/largest exponent of grid sizes measured, */
+/* the grid is nx = ny = 2**ind                                      */
+   int indmin = 8, indmax = 11;
+/* ntry = number of inverse and forward transforms timed */
+   int ntry = 4;
+   int ind, indx, indy, nx, ny, nxh, nxe, nye, nxeh, nxyh, nxhy;
+   int idproc, nvp, kstrt, kxp, kyp, kypd, kypp, ks;
+   int i, j, k, n, nt, l, ierr;
+   float ttp;
+   double dtime, tf[2][3][2], work[12];
+   float err[2][3];
+   float *f = NULL, *f0 = NULL, *g = NULL, *g0 = NULL;
+   float complex *bs = NULL, *br = NULL;
+   int *mixup = NULL;
+   float complex *sct = NULL;
+
+   cppinit2(&idproc,&nvp,argc,argv);
+   kstrt = idproc + 1;
+/* replace parameters with values from command line, for example: */
+/* mpirun -np 4 cfftbench2 indmin=9 indmax=11 ntry=8              */
+   ierr = ccfgread(argc,argv,kstrt==1);
+   ccfgint("indmin",&indmin); ccfgint("indmax",&indmax);
+   ccfgint("ntry",&ntry);
+   ierr += ccfgend();
+   if ((ierr != 0) || (ntry < 1) || (indmin < 2)) {
+      if (kstrt==1)
+         printf("invalid run time parameters\n");
+      cppexit();
+      exit(1);
+   }
+
+   if (kstrt==1) {
+      printf("%d MPI ranks, times are maximum msec over ranks ",nvp);
+      printf("for one inverse and one forward transform\n");
+      printf("ktpose = (0,1,2) = (message pairs,Alltoallv,Alltoallw)\n");
+      printf("%5s %1s %8s %8s %8s %8s %8s %8s %8s %8s\n","grid","v",
+             "fft0","tpose0","fft1","tpose1","error1","fft2","tpose2",
+             "error2");
+   }
+   for (ind = indmin; ind <= indmax; ind++) {
+      indx = ind; indy = ind;
+      nx = 1L<<indx; ny = 1L<<indy; nxh = nx/2;
+      nxe = nx + 2; nye = ny + 2; nxeh = nxe/2;
+      nxyh = (nx > ny ? nx : ny)/2; nxhy = nxh > ny ? nxh : ny;
+      if ((nvp > nxh) || (nvp > ny)) {
+         if (kstrt==1)
+            printf("%5d too many processors\n",nx);
+         continue;
+      }
+      kxp = (nxh - 1)/nvp + 1;
+      kyp = (ny - 1)/nvp + 1;
+      kypd = kyp;
+      ks = kstrt - 1;
+      kypp = ny - kyp*ks;
+      kypp = 0 > kypp ? 0 : kypp;
+      kypp = kyp < kypp ? kyp : kypp;
+      n = 2*2*nxe*kypd;
+      nt = 2*2*nye*kxp;
+      f = (float *) malloc(n*sizeof(float));
+      f0 = (float *) malloc(n*sizeof(float));
+      g = (float *) malloc(nt*sizeof(float));
+      g0 = (float *) malloc(nt*sizeof(float));
+      bs = (float complex *) malloc(2*kxp*kyp*nvp*sizeof(float complex));
+      br = (float complex *) malloc(2*kxp*kyp*nvp*sizeof(float complex));
+      mixup = (int *) malloc(nxhy*sizeof(int));
+      sct = (float complex *) malloc(nxyh*sizeof(float complex));
+      cwpfft2rinit(mixup,sct,indx,indy,nxhy,nxyh);
+/* random data in two components, zero in guard cells, the same for */
+/* any number of processors                                         */
+      srand(1);
+      for (j = 0; j < n; j++) {
+         f0[j] = 0.0;
+      }
+      for (k = 0; k < ny; k++) {
+         for (j = 0; j < 2*nx; j++) {
+            i = k - kyp*ks;
+            if ((i >= 0) && (i < kypp))
+               f0[j+2*nxe*i] = (float) rand()/(float) RAND_MAX - 0.5;
+            else
+               rand();
+         }
+      }
+/* l = (0,1) = (scalar,vector) transform, n = ktpose */
+      for (l = 0; l < 2; l++) {
+         for (n = 0; n < 3; n++) {
+/* check transform against ktpose = 0 */
+            for (j = 0; j < (l+1)*nxe*kypd; j++) {
+               f[j] = f0[j];
+            }
+            if (l==0) {
+               cwppfft2rt((float complex *)f,(float complex *)g,bs,br,
+                          -1,1,mixup,sct,&ttp,indx,indy,kstrt,nvp,nxeh,
+                          nye,kxp,kyp,kypd,nxhy,nxyh,n);
+            }
+            else {
+               cwppfft2r2t((float complex *)f,(float complex *)g,bs,br,
+                           -1,1,mixup,sct,&ttp,indx,indy,kstrt,nvp,nxeh,
+                           nye,kxp,kyp,kypd,nxhy,nxyh,n);
+            }
+            if (n==0) {
+               for (j = 0; j < (l+1)*2*nye*kxp; j++) {
+                  g0[j] = g[j];
+               }
+            }
+            err[l][n] = cmaxdiff(g0,g,(l+1)*2*nye*kxp);
+/* time transform, data stays transposed between calls */
+/* synchronize processors before timing */
+            work[0] = 0.0;
+            cppdmax(work,&work[1],1);
+            tf[l][n][1] = 0.0;
+            cpwtimera(-1,&ttp,&dtime);
+            tf[l][n][0] = dtime;
+            for (j = 0; j < ntry; j++) {
+               if (l==0) {
+                  cwppfft2rt((float complex *)f,(float complex *)g,bs,br,
+                             1,1,mixup,sct,&ttp,indx,indy,kstrt,nvp,
+                             nxeh,nye,kxp,kyp,kypd,nxhy,nxyh,n);
+                  tf[l][n][1] += ttp;
+                  cwppfft2rt((float complex *)f,(float complex *)g,bs,br,
+                             -1,1,mixup,sct,&ttp,indx,indy,kstrt,nvp,
+                             nxeh,nye,kxp,kyp,kypd,nxhy,nxyh,n);
+               }
+               else {
+                  cwppfft2r2t((float complex *)f,(float complex *)g,bs,
+                              br,1,1,mixup,sct,&ttp,indx,indy,kstrt,nvp,
+                              nxeh,nye,kxp,kyp,kypd,nxhy,nxyh,n);
+                  tf[l][n][1] += ttp;
+                  cwppfft2r2t((float complex *)f,(float complex *)g,bs,
+                              br,-1,1,mixup,sct,&ttp,indx,indy,kstrt,
+                              nvp,nxeh,nye,kxp,kyp,kypd,nxhy,nxyh,n);
+               }
+               tf[l][n][1] += ttp;
+            }
+            dtime = tf[l][n][0];
+            cpwtimera(1,&ttp,&dtime);
+            tf[l][n][0] = 1.0e+3*ttp/(double) ntry;
+            tf[l][n][1] = 1.0e+3*tf[l][n][1]/(double) ntry;
+         }
+      }
+      cppdmax(&tf[0][0][0],work,12);
+      if (kstrt==1) {
+         for (l = 0; l < 2; l++) {
+            printf("%5d %1d %8.3f %8.3f %8.3f %8.3f %8.2e",nx,l,
+                   tf[l][0][0],tf[l][0][1],tf[l][1][0],tf[l][1][1],
+                   err[l][1]);
+            printf(" %8.3f %8.3f %8.2e\n",tf[l][2][0],tf[l][2][1],
+                   err[l][2]);
+         }
+      }
+      free(f);
+      free(f0);
+      free(g);
+      free(g0);
+      free(bs);
+      free(br);
+      free(mixup);
+      free(sct);
+   }
+
+   cpptpfree();
+   cppexit();
+   return 0;
+}
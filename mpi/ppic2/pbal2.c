@@ -0,0 +1,383 @@
+/*--------------------------------------------------------------------*/
+/* Dynamic load balancing library for 2D MPI PIC codes
+   pbal2.c contains procedures which move the boundaries of the 1d
+           partition in y so that each processor has nearly the same
+           work, and move particles and field rows to the new
+           partitions.
+   the boundaries of all partitions are kept in an integer array kf,
+   where partition k holds the grid rows kf[k] <= y < kf[k+1],
+   kf[0] = 0 and kf[nvp] = ny.
+   cpdistr2b calculates initial particle co-ordinates with a uniform
+             background and a drifting beam.
+   cpbpart2l sets partition variables from the boundaries kf.
+   cpprows2l counts the particles in each grid row of a partition.
+   cppgcost2l gathers the cost of each grid row of all partitions.
+   cpbedges2l finds new boundaries with equal cost in each partition.
+   cpphole2l finds the particles which are outside a partition.
+   cppfmove2 moves grid rows of a field from one partition to another.
+   the MPI calls use MPI_COMM_WORLD, the communicator of pplib2.c
+   written for the skeleton PIC codes                                */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <complex.h>
+#include "mpi.h"
+#include "ppush2.h"
+#include "pplib2.h"
+#include "pbal2.h"
+
+/*--------------------------------------------------------------------*/
+void cpdistr2b(float part[], float edges[], int *npp, int nps,
+               float vtx, float vty, float vdx, float vdy, float ampb,
+               float wb, float vby, int npx, int npy, int nx, int ny,
+               int idimp, int npmax, int idps, int *ierr) {
+/* for 2d code, this subroutine calculates initial particle co-ordinates
+   and velocities with a uniform background and a beam, and maxwellian
+   velocity with drift, for distributed data with periodic boundaries.
+   a fraction ampb of the npy rows of particles is placed uniformly in a
+   band of width wb centered at y = ny/4, and the particles of the band
+   drift in y with velocity vby, in addition to vdx, vdy.  the other
+   rows are placed uniformly in y, as in cpdistr2.
+   input: all except part, npp, ierr, output: part, npp, ierr
+   part[n][0] = position x of particle n in partition
+   part[n][1] = position y of particle n in partition
+   part[n][2] = velocity vx of particle n in partition
+   part[n][3] = velocity vy of particle n in partition
+   edges[0] = lower boundary of particle partition
+   edges[1] = upper boundary of particle partition
+   npp = number of particles in partition
+   nps = starting address of particles in partition
+   vtx/vty = thermal velocity of electrons in x/y direction
+   vdx/vdy = drift velocity of all electrons in x/y direction
+   ampb = fraction of particles in beam, 0 to 1
+   wb = width of beam in y, in grid units, 0 < wb <= ny
+   vby = drift velocity of beam electrons in y direction
+   npx/npy = initial number of particles distributed in x/y direction
+   nx/ny = system length in x/y direction
+   idimp = size of phase space = 4
+   npmax = maximum number of particles in each partition
+   idps = number of partition boundaries
+   ierr = (0,1) = (no,yes) error condition exists
+   ranorm = gaussian random number with zero mean and unit variance
+local data                                                            */
+   int j, k, nb, npt, k1, npxyp;
+   float at1, at2, at3, xt, yt, vxt, vyt, yb, any;
+   double dnpx, dnpxy, dt1;
+   int ierr1[1], iwork1[1];
+   double sum3[3], work3[3];
+   *ierr = 0;
+   dnpx = (double) npx;
+   any = (float) ny;
+/* nb = number of rows of particles in beam */
+   nb = ampb*(float) npy;
+   nb = nb < 0 ? 0 : (nb > npy ? npy : nb);
+   at1 = (float) nx/(float) npx;
+   at2 = npy > nb ? any/(float) (npy - nb) : 0.0;
+   at3 = nb > 0 ? wb/(float) nb : 0.0;
+   yb = 0.25*any - 0.5*wb;
+   npt = *npp;
+   for (k = 0; k < npy; k++) {
+/* beam rows */
+      if (k < nb) {
+         yt = yb + at3*(((float) k) + 0.5);
+         if (yt < 0.0)
+            yt += any;
+         else if (yt >= any)
+            yt -= any;
+      }
+/* background rows */
+      else {
+         yt = at2*(((float) (k - nb)) + 0.5);
+      }
+      for (j = 0; j < npx; j++) {
+         xt = at1*(((float) j) + 0.5);
+/* maxwellian velocity distribution */
+         vxt = vtx*ranorm();
+         vyt = vty*ranorm();
+         if ((yt >= edges[0]) && (yt < edges[1])) {
+            if (npt < npmax) {
+               k1 = idimp*npt;
+               part[k1] = xt;
+               part[1+k1] = yt;
+               part[2+k1] = vxt;
+               part[3+k1] = vyt;
+               if (k < nb)
+                  part[3+k1] += vby;
+               npt += 1;
+            }
+            else
+               *ierr += 1;
+         }
+      }
+   }
+   npxyp = 0;
+/* remove mean thermal velocity, and add drift */
+   sum3[0] = 0.0;
+   sum3[1] = 0.0;
+   for (j = nps-1; j < npt; j++) {
+      npxyp += 1;
+      sum3[0] += part[2+idimp*j];
+      sum3[1] += part[3+idimp*j];
+   }
+   sum3[2] = npxyp;
+   cppdsum(sum3,work3,3);
+   dnpxy = sum3[2];
+   ierr1[0] = *ierr;
+   cppimax(ierr1,iwork1,1);
+   *ierr = ierr1[0];
+   dt1 = 1.0/dnpxy;
+   sum3[0] = dt1*sum3[0] - vdx;
+   sum3[1] = dt1*sum3[1] - vdy - vby*(float) nb/(float) npy;
+   for (j = nps-1; j < npt; j++) {
+      part[2+idimp*j] -= sum3[0];
+      part[3+idimp*j] -= sum3[1];
+   }
+/* process errors */
+   dnpxy -= dnpx*(double) npy;
+   if (dnpxy != 0.0)
+      *ierr = dnpxy;
+   *npp = npt;
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cpbpart2l(float edges[], int kf[], int *nyp, int *noff,
+               int *nypmx, int *nypmn, int kstrt, int nvp) {
+/* this subroutine sets the partition variables of processor kstrt-1
+   from the boundaries of all partitions, as cpdicomp2l does for a
+   uniform partition
+   input: kf, kstrt, nvp, output: edges, nyp, noff, nypmx, nypmn
+   edges[0:1] = lower:upper boundary of particle partition
+   kf[k] = lowermost global gridpoint of partition k, kf[nvp] = ny
+   nyp = number of primary (complete) gridpoints in particle partition
+   noff = lowermost global gridpoint in particle partition
+   nypmx = maximum size of particle partition, including guard cells
+   nypmn = minimum value of nyp
+   kstrt = starting data block number (processor id + 1)
+   nvp = number of real or virtual processors
+local data                                                            */
+   int k, ks, nn;
+   ks = kstrt - 1;
+   *noff = kf[ks];
+   *nyp = kf[ks+1] - kf[ks];
+   edges[0] = (float) kf[ks];
+   edges[1] = (float) kf[ks+1];
+   *nypmx = 0;
+   *nypmn = kf[nvp];
+   for (k = 0; k < nvp; k++) {
+      nn = kf[k+1] - kf[k];
+      *nypmx = nn > *nypmx ? nn : *nypmx;
+      *nypmn = nn < *nypmn ? nn : *nypmn;
+   }
+   *nypmx += 1;
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cpprows2l(float part[], float rcost[], int npp, int noff, int nyp,
+               int idimp, int npmax) {
+/* this subroutine counts the number of particles in each grid row of
+   a partition
+   input: all except rcost, output: rcost
+   part[n][1] = position y of particle n in partition
+   rcost[j] = number of particles in grid row j + noff
+   npp = number of particles in partition
+   noff = lowermost global gridpoint in particle partition
+   nyp = number of primary gridpoints in particle partition
+   idimp = size of phase space = 4
+   npmax = maximum number of particles in each partition
+local data                                                            */
+   int j, mm;
+   for (j = 0; j < nyp; j++) {
+      rcost[j] = 0.0;
+   }
+   for (j = 0; j < npp; j++) {
+      mm = part[1+idimp*j];
+      mm -= noff;
+      mm = mm < 0 ? 0 : (mm >= nyp ? nyp - 1 : mm);
+      rcost[mm] += 1.0;
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cppgcost2l(float rcost[], float gcost[], int kf[], int kstrt,
+                int nvp) {
+/* this subroutine gathers the cost of each grid row of all partitions
+   into a global array, in order of y, on all processors
+   input: rcost, kf, kstrt, nvp, output: gcost
+   rcost[j] = cost of grid row j + kf[kstrt-1] in this partition
+   gcost[j] = cost of global grid row j, dimension kf[nvp]
+   kf[k] = lowermost global gridpoint of partition k, kf[nvp] = ny
+   kstrt = starting data block number (processor id + 1)
+   nvp = number of real or virtual processors
+local data                                                            */
+   int k, ks;
+   int *kcnt;
+   ks = kstrt - 1;
+   kcnt = (int *) malloc(nvp*sizeof(int));
+   for (k = 0; k < nvp; k++) {
+      kcnt[k] = kf[k+1] - kf[k];
+   }
+   MPI_Allgatherv(rcost,kcnt[ks],MPI_FLOAT,gcost,kcnt,kf,MPI_FLOAT,
+                  MPI_COMM_WORLD);
+   free(kcnt);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+static double cpbimb(float gcost[], int kf[], int nvp) {
+/* returns the load imbalance of partitions kf, the largest cost of a
+   partition divided by the average cost
+local data                                                            */
+   int j, k;
+   double sum1, sum2, smax;
+   sum2 = 0.0;
+   smax = 0.0;
+   for (k = 0; k < nvp; k++) {
+      sum1 = 0.0;
+      for (j = kf[k]; j < kf[k+1]; j++) {
+         sum1 += gcost[j];
+      }
+      sum2 += sum1;
+      smax = sum1 > smax ? sum1 : smax;
+   }
+   if (sum2 <= 0.0)
+      return 1.0;
+   return (double) nvp*smax/sum2;
+}
+
+/*--------------------------------------------------------------------*/
+void cpbedges2l(float gcost[], int kf[], int kfn[], float *bimb,
+                float *pimb, int ny, int nvp) {
+/* this subroutine finds new boundaries of the partitions so that each
+   has nearly the same cost.  boundary k is placed at the grid row where
+   the cumulative cost is closest to k times the average cost, then the
+   boundaries are adjusted so that each partition has at least one row.
+   also returns the load imbalance, the largest cost of a partition
+   divided by the average cost, for the old and new boundaries
+   input: gcost, kf, ny, nvp, output: kfn, bimb, pimb
+   gcost[j] = cost of global grid row j
+   kf/kfn = old/new lowermost global gridpoint of each partition,
+   dimension nvp+1
+   bimb/pimb = load imbalance of old/new partitions
+   ny = system length in y direction, must be >= nvp
+   nvp = number of real or virtual processors
+local data                                                            */
+   int j, k;
+   double avg, csum, prev, tk;
+   avg = 0.0;
+   for (j = 0; j < ny; j++) {
+      avg += gcost[j];
+   }
+   avg /= (double) nvp;
+/* place boundaries at equal fractions of cumulative cost */
+   kfn[0] = 0;
+   k = 1;
+   csum = 0.0;
+   for (j = 0; j < ny; j++) {
+      prev = csum;
+      csum += gcost[j];
+      while ((k < nvp) && (csum >= avg*(double) k)) {
+         tk = avg*(double) k;
+         kfn[k] = (tk - prev) < (csum - tk) ? j : j + 1;
+         k += 1;
+      }
+   }
+   for (; k < nvp; k++) {
+      kfn[k] = ny;
+   }
+   kfn[nvp] = ny;
+/* each partition must have at least one grid row */
+   for (k = 1; k < nvp; k++) {
+      if (kfn[k] <= kfn[k-1])
+         kfn[k] = kfn[k-1] + 1;
+   }
+   for (k = nvp - 1; k > 0; k--) {
+      if (kfn[k] >= kfn[k+1])
+         kfn[k] = kfn[k+1] - 1;
+   }
+   *bimb = cpbimb(gcost,kf,nvp);
+   *pimb = cpbimb(gcost,kfn,nvp);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cpphole2l(float part[], float edges[], int npp, int ihole[],
+               int idimp, int npmax, int ntmax) {
+/* this subroutine finds the particles which are outside a partition,
+   after its boundaries have changed, in the form needed by cppmove2
+   input: all except ihole, output: ihole
+   part[n][1] = position y of particle n in partition
+   edges[0:1] = lower:upper boundary of particle partition
+   npp = number of particles in partition
+   ihole = location of holes left in particle arrays
+   ihole[0] = ih, number of holes left (error, if negative)
+   idimp = size of phase space = 4
+   npmax = maximum number of particles in each partition
+   ntmax = size of hole array for particles leaving processors
+local data                                                            */
+   int j, ih, nh;
+   float dy;
+   ih = 0;
+   nh = 0;
+   for (j = 0; j < npp; j++) {
+      dy = part[1+idimp*j];
+      if ((dy < edges[0]) || (dy >= edges[1])) {
+         if (ih < ntmax)
+            ihole[ih+1] = j + 1;
+         else
+            nh = 1;
+         ih += 1;
+      }
+   }
+/* set end of file flag */
+   if (nh > 0)
+      ih = -ih;
+   ihole[0] = ih;
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cppfmove2(float f[], float g[], int kfs[], int kfd[], int kstrt,
+               int nvp, int nxv, int nypms, int nypmd) {
+/* this subroutine moves the grid rows of a field from one partition to
+   another, with one MPI_Alltoallv.  each processor sends the part of
+   its rows which the other partition gives to each processor.  rows are
+   contiguous in memory, so no packing is needed.  guard cells are not
+   moved
+   input: f, kfs, kfd, kstrt, nvp, nxv, nypms, nypmd, output: g
+   f[j][i] = field in source partition, row j is global row kfs[ks] + j
+   g[j][i] = field in destination partition, row j is global row
+   kfd[ks] + j, where ks = kstrt - 1
+   kfs/kfd = lowermost global gridpoint of each source/destination
+   partition, dimension nvp+1
+   kstrt = starting data block number (processor id + 1)
+   nvp = number of real or virtual processors
+   nxv = number of floats in a grid row of f and g
+   nypms/nypmd = maximum number of rows in f/g
+local data                                                            */
+   int k, ks, nb, ne;
+   int *scnt, *sdsp, *rcnt, *rdsp;
+   ks = kstrt - 1;
+   scnt = (int *) malloc(4*nvp*sizeof(int));
+   sdsp = &scnt[nvp];
+   rcnt = &scnt[2*nvp];
+   rdsp = &scnt[3*nvp];
+   for (k = 0; k < nvp; k++) {
+/* rows sent to processor k */
+      nb = kfs[ks] > kfd[k] ? kfs[ks] : kfd[k];
+      ne = kfs[ks+1] < kfd[k+1] ? kfs[ks+1] : kfd[k+1];
+      scnt[k] = ne > nb ? nxv*(ne - nb) : 0;
+      sdsp[k] = ne > nb ? nxv*(nb - kfs[ks]) : 0;
+/* rows received from processor k */
+      nb = kfs[k] > kfd[ks] ? kfs[k] : kfd[ks];
+      ne = kfs[k+1] < kfd[ks+1] ? kfs[k+1] : kfd[ks+1];
+      rcnt[k] = ne > nb ? nxv*(ne - nb) : 0;
+      rdsp[k] = ne > nb ? nxv*(nb - kfd[ks]) : 0;
+   }
+   MPI_Alltoallv(f,scnt,sdsp,MPI_FLOAT,g,rcnt,rdsp,MPI_FLOAT,
+                 MPI_COMM_WORLD);
+   free(scnt);
+   return;
+}
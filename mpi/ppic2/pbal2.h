@@ -0,0 +1,24 @@
+/* header file for pbal2.c */
+
+void cpdistr2b(float part[], float edges[], int *npp, int nps,
+               float vtx, float vty, float vdx, float vdy, float ampb,
+               float wb, float vby, int npx, int npy, int nx, int ny,
+               int idimp, int npmax, int idps, int *ierr);
+
+void cpbpart2l(float edges[], int kf[], int *nyp, int *noff,
+               int *nypmx, int *nypmn, int kstrt, int nvp);
+
+void cpprows2l(float part[], float rcost[], int npp, int noff, int nyp,
+               int idimp, int npmax);
+
+void cppgcost2l(float rcost[], float gcost[], int kf[], int kstrt,
+                int nvp);
+
+void cpbedges2l(float gcost[], int kf[], int kfn[], float *bimb,
+                float *pimb, int ny, int nvp);
+
+void cpphole2l(float part[], float edges[], int npp, int ihole[],
+               int idimp, int npmax, int ntmax);
+
+void cppfmove2(float f[], float g[], int kfs[], int kfd[], int kstrt,
+               int nvp, int nxv, int nypms, int nypmd);
@@ -0,0 +1,198 @@
+/*--------------------------------------------------------------------*/
+/* Many to many particle manager for 2D MPI PIC codes
+   pmove2.c contains a procedure which moves particles to the
+            processors which own them in one collective exchange,
+            instead of the passes between nearby processors of cppmove2
+            in pplib2.c, so that particles can cross any number of
+            partitions in one time step.
+   cppamove2 bins the particles leaving the processor by destination
+             with a counting sort and sends them with one MPI_Alltoallv.
+   the MPI calls use MPI_COMM_WORLD, the communicator of pplib2.c
+   written for the skeleton PIC codes                                */
+
+#include <stdlib.h>
+#include "mpi.h"
+#include "pmove2.h"
+
+/*--------------------------------------------------------------------*/
+static int cpdest2(float el[], float yt, int nvp) {
+/* this function returns the processor whose partition contains the
+   position yt, by bisection of the lower boundaries el of all the
+   partitions.  positions beyond the last boundary belong to the last
+   processor
+local data                                                            */
+   int kl, kr, k;
+   kl = 0;
+   kr = nvp;
+   while ((kr - kl) > 1) {
+      k = (kl + kr)/2;
+      if (yt < el[k])
+         kr = k;
+      else
+         kl = k;
+   }
+   return kl;
+}
+
+/*--------------------------------------------------------------------*/
+void cppamove2(float part[], float edges[], int *npp, float sbuf[],
+               int ihole[], int ny, int kstrt, int nvp, int idimp,
+               int npmax, int idps, int nsmax, int info[]) {
+/* this subroutine moves particles into appropriate spatial regions,
+   sending each particle directly to the processor which owns it
+   periodic boundary conditions
+   the departing particles are binned by destination with a counting
+   sort, the holes they leave are filled with particles from the end of
+   the particle array, and the bins are exchanged with one
+   MPI_Alltoallv, which appends the arriving particles to the array
+   output: part, npp, sbuf, info
+   part[n][0] = position x of particle n in partition
+   part[n][1] = position y of particle n in partition
+   part[n][2] = velocity vx of particle n in partition
+   part[n][3] = velocity vy of particle n in partition
+   edges[0:1] = lower:upper boundary of particle partition
+   npp = number of particles in partition
+   sbuf = buffer for particles being sent, in order of destination
+   ihole = location of holes left in particle arrays, in increasing
+   order, ihole[0] = number of holes
+   ny = system length in y direction
+   kstrt = starting data block number
+   nvp = number of real or virtual processors
+   idimp = size of phase space = 4
+   npmax = maximum number of particles in each partition.
+   idps = number of partition boundaries
+   nsmax = size of sbuf, in particles, at least ihole[0]
+   info = status information
+   info[0] = ierr = (0,N) = (no,yes) error condition exists
+   info[1] = maximum number of particles per processor
+   info[2] = minimum number of particles per processor
+   info[3] = maximum number of buffer overflows, always 0
+   info[4] = maximum number of particle passes required, always 1
+   info[5] = number of particles sent by this processor
+   info[6] = maximum number of partitions crossed by a particle
+local data */
+/* iy = partitioned co-ordinate */
+   int iy = 1;
+   int ks, ih, mpp, nps, j, j1, k, kk, i, m, kd;
+   int *scnt, *sdsp, *rcnt, *rdsp;
+   float any, yt;
+   float *el;
+   int ibflg[4], iwork[4];
+   any = (float) ny;
+   ks = kstrt - 1;
+   ih = ihole[0];
+   mpp = *npp;
+   for (j = 0; j < 7; j++) {
+      info[j] = 0;
+   }
+   info[4] = 1;
+   info[5] = ih;
+/* check for send buffer overflow */
+   if (ih > nsmax) {
+      info[0] = ih - nsmax;
+      ih = nsmax;
+   }
+   scnt = (int *) malloc(4*nvp*sizeof(int));
+   sdsp = &scnt[nvp];
+   rcnt = &scnt[2*nvp];
+   rdsp = &scnt[3*nvp];
+   el = (float *) malloc(nvp*sizeof(float));
+/* find lower boundaries of all partitions */
+   MPI_Allgather(edges,1,MPI_FLOAT,el,1,MPI_FLOAT,MPI_COMM_WORLD);
+/* count particles going to each processor, after periodic wrap */
+   for (k = 0; k < nvp; k++) {
+      scnt[k] = 0;
+   }
+   kk = 0;
+   for (j = 0; j < ih; j++) {
+      yt = part[iy+idimp*(ihole[j+1]-1)];
+      if (yt < 0.0)
+         yt += any;
+      else if (yt >= any)
+         yt -= any;
+      kd = cpdest2(el,yt,nvp);
+      scnt[kd] += 1;
+/* kk = partitions crossed, in shorter direction around the system */
+      k = kd > ks ? kd - ks : ks - kd;
+      k = k < (nvp - k) ? k : nvp - k;
+      kk = k > kk ? k : kk;
+   }
+/* starting location of each destination bin */
+   nps = 0;
+   for (k = 0; k < nvp; k++) {
+      sdsp[k] = nps;
+      nps += scnt[k];
+   }
+/* copy departing particles into bins */
+   for (j = 0; j < ih; j++) {
+      j1 = ihole[j+1] - 1;
+      yt = part[iy+idimp*j1];
+      if (yt < 0.0)
+         yt += any;
+      else if (yt >= any)
+         yt -= any;
+      kd = cpdest2(el,yt,nvp);
+      m = idimp*sdsp[kd];
+      for (i = 0; i < idimp; i++) {
+         sbuf[i+m] = part[i+idimp*j1];
+      }
+      sbuf[iy+m] = yt;
+      sdsp[kd] += 1;
+   }
+/* restore starting locations and convert to units of floats */
+   for (k = 0; k < nvp; k++) {
+      sdsp[k] = idimp*(sdsp[k] - scnt[k]);
+   }
+/* exchange number of particles to be sent and received */
+   MPI_Alltoall(scnt,1,MPI_INT,rcnt,1,MPI_INT,MPI_COMM_WORLD);
+   nps = 0;
+   for (k = 0; k < nvp; k++) {
+      rdsp[k] = idimp*nps;
+      nps += rcnt[k];
+      scnt[k] = idimp*scnt[k];
+      rcnt[k] = idimp*rcnt[k];
+   }
+/* check if move would overflow particle array */
+   nps += mpp - ih;
+   ibflg[0] = nps;
+   ibflg[1] = -nps;
+   ibflg[2] = kk;
+   ibflg[3] = info[0];
+   MPI_Allreduce(ibflg,iwork,4,MPI_INT,MPI_MAX,MPI_COMM_WORLD);
+   info[1] = iwork[0];
+   info[2] = -iwork[1];
+   info[6] = iwork[2];
+   if (info[1] > npmax)
+      info[0] = info[1] - npmax;
+   else
+      info[0] = iwork[3];
+/* all processors return if any has an error */
+   if (info[0] != 0) {
+      free(el);
+      free(scnt);
+      return;
+   }
+/* fill holes with particles from the end of the array, skipping */
+/* particles at the end which are themselves leaving              */
+   kk = ih;
+   for (j = 0; j < ih; j++) {
+      while ((kk > j) && (ihole[kk]==mpp)) {
+         mpp -= 1;
+         kk -= 1;
+      }
+      if (kk <= j)
+         break;
+      j1 = ihole[j+1] - 1;
+      mpp -= 1;
+      for (i = 0; i < idimp; i++) {
+         part[i+idimp*j1] = part[i+idimp*mpp];
+      }
+   }
+/* send particles, appending particles received to the array */
+   MPI_Alltoallv(sbuf,scnt,sdsp,MPI_FLOAT,&part[idimp*mpp],rcnt,rdsp,
+                 MPI_FLOAT,MPI_COMM_WORLD);
+   *npp = nps;
+   free(el);
+   free(scnt);
+   return;
+}
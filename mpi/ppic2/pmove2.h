@@ -0,0 +1,5 @@
+/* header file for pmove2.c */
+
+void cppamove2(float part[], float edges[], int *npp, float sbuf[],
+               int ihole[], int ny, int kstrt, int nvp, int idimp,
+               int npmax, int idps, int nsmax, int info[]);
@@ -4,11 +4,13 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <complex.h>
-#include <sys/time.h>
 #include "ppush2.h"
 #include "pplib2.h"
-
-void dtimer(double *time, struct timeval *itime, int icntrl);
+#include "proflib.h"
+#include "cfglib.h"
+#include "pbal2.h"
+#include "ptpose2.h"
+#include "pmove2.h"
 
 int main(int argc, char *argv[]) {
 /* indx/indy = exponent which determines grid points in x/y direction: */
@@ -25,6 +27,13 @@ int main(int argc, char *argv[]) {
 /* vtx/vty = thermal velocity of electrons in x/y direction */
 /* vx0/vy0 = drift velocity of electrons in x/y direction */
    float vtx = 1.0, vty = 1.0, vx0 = 0.0, vy0 = 0.0;
+/* kdistr = (0,1) = initial density is (uniform,uniform plus a beam */
+/* drifting in y)                                                   */
+/* ampb = fraction of particles in the beam */
+/* wb = width of the beam in y, in grid units */
+/* vby = drift velocity of the beam in y */
+   int kdistr = 0;
+   float ampb = 0.5, wb = 32.0, vby = 2.0;
 /* ax/ay = smoothed particle size in x/y direction */
    float ax = .912871, ay = .912871;
 /* idimp = number of particle coordinates = 4 */
@@ -33,6 +42,26 @@ int main(int argc, char *argv[]) {
    int idimp = 4, ipbc = 1, sortime = 50;
 /* idps = number of partition boundaries */
    int idps = 2;
+/* kprof = (0,1,2,3) = print (no profile,profile summary,summary and   */
+/* per step CSV files prof.n.csv,summary and per step JSON files       */
+/* prof.n.json), where n = processor id                                */
+/* kperf = (0,1) = (no,yes) read hardware counters in profile          */
+   int kprof = 0, kperf = 0;
+/* kbal = (0,1,2) = partition in y is (fixed,moved to balance number */
+/* of particles,moved to balance particles weighted by their measured */
+/* time on each processor)                                            */
+/* nbal = number of time steps between load checks */
+/* blim = load imbalance (max/mean) above which partition is moved */
+/* kbtl = (0,1) = (no,yes) write load check timeline to file bal.csv */
+   int kbal = 0, nbal = 10, kbtl = 0;
+   float blim = 1.1;
+/* ktpose = (0,1,2) = data transpose in fft uses (one message pair per */
+/* processor,one MPI_Alltoallv,one MPI_Alltoallw with derived types)   */
+   int ktpose = 0;
+/* kmove = (0,1) = particles leaving a processor are (passed between */
+/* nearby processors,sent directly to their destination with one    */
+/* MPI_Alltoallv)                                                    */
+   int kmove = 0;
 /* wke/we/wt = particle kinetic/electric field/total energy */
    float wke = 0.0, we = 0.0, wt = 0.0;
 /* declare scalars for standard code */
@@ -46,6 +75,17 @@ int main(int argc, char *argv[]) {
    int ntpose = 1;
    int nvp, idproc, kstrt, npmax, kxp, kyp, nypmx, nypmn;
    int nyp, noff, npp, nps, nbmax, ntmax;
+/* kypd = second dimension of field arrays in uniform partition */
+/* nrepart = number of times the partition was moved */
+/* krep = (0,1) = partition (is not,is) moved at this check */
+   int kypd, nrepart = 0, krep, k, nn;
+/* bimb/pimb = load imbalance of old/new partition, from row costs */
+/* wp = measured time per particle, relative to average */
+   float bimb = 1.0, pimb = 1.0, wp, tb;
+/* tcomp0 = particle time at last load check */
+/* pcomp = number of particles pushed since last load check */
+   double tcomp0 = 0.0, pcomp = 0.0, dtbal;
+   double wsum[2], wmax[2], wwork[2];
 
 /* declare arrays for standard code: */
 /* part, part2 = particle arrays */
@@ -79,16 +119,57 @@ int main(int argc, char *argv[]) {
    float *sbufl = NULL, *sbufr = NULL, *rbufl = NULL, *rbufr = NULL;
 /* edges[0:1] = lower:upper y boundaries of particle partition */
    float *edges = NULL;
+/* kfp/kfu = lowermost gridpoint of each particle/uniform partition */
+/* kfn = new lowermost gridpoint of each particle partition          */
+   int *kfp = NULL, *kfu = NULL, *kfn = NULL;
+/* qu/fxyu = charge density/force in uniform partition, for ffts */
+   float *qu = NULL, *fxyu = NULL;
+/* rcost/gcost = cost of each grid row of partition/global grid */
+   float *rcost = NULL, *gcost = NULL;
+/* iholeb = location of particles leaving a moved partition */
+   int *iholeb = NULL;
+   FILE *fbal = NULL;
 /* scr = guard cell buffer received from nearby processors */
    float *scr = NULL;
 
 /* declare and initialize timing data */
    float time;
-   struct timeval itime;
    float tdpost = 0.0, tguard = 0.0, ttp = 0.0, tfield = 0.0;
    float tpush = 0.0, tsort = 0.0, tmov = 0.0;
+   float tfmov = 0.0, tlbal = 0.0;
+/* dmig = number of particles leaving processor, summed over steps */
+/* mpass = maximum number of passes of particle manager            */
+/* mhop = maximum number of partitions crossed by a particle       */
+   double dmig = 0.0;
+   int mpass = 0, mhop = 0;
    float tfft[2] = {0.0,0.0};
-   double dtime;
+/* tprof/tpmax = profile data for each region, summed/maximum over */
+/* processors, tpscr = scratch array, dimension 5*64              */
+   double tprof[320], tpmax[320], tpscr[320];
+   char fprof[32];
+
+/* nvp = number of MPI ranks */
+/* initialize for distributed memory parallel processing */
+   cppinit2(&idproc,&nvp,argc,argv);
+   kstrt = idproc + 1;
+/* replace parameters with values from input decks or command line, */
+/* for example: cppic2 indx=10 npx=1024 npy=1024                    */
+   ierr = ccfgread(argc,argv,kstrt==1);
+   ccfgint("indx",&indx); ccfgint("indy",&indy); ccfgint("npx",&npx);
+   ccfgint("npy",&npy); ccfgflt("tend",&tend); ccfgflt("dt",&dt);
+   ccfgflt("vtx",&vtx); ccfgflt("vty",&vty); ccfgflt("vx0",&vx0);
+   ccfgflt("vy0",&vy0); ccfgint("sortime",&sortime);
+   ccfgint("kprof",&kprof); ccfgint("kperf",&kperf);
+   ccfgint("kdistr",&kdistr); ccfgflt("ampb",&ampb); ccfgflt("wb",&wb);
+   ccfgflt("vby",&vby); ccfgint("kbal",&kbal); ccfgint("nbal",&nbal);
+   ccfgflt("blim",&blim); ccfgint("kbtl",&kbtl);
+   ccfgint("ktpose",&ktpose); ccfgint("kmove",&kmove);
+   ierr += ccfgend();
+   if (ierr != 0) {
+      if (kstrt==1)
+         printf("invalid run time parameters\n");
+      goto L3000;
+   }
 
 /* initialize scalars for standard code */
 /* np = total number of particles in simulation */
@@ -105,10 +186,6 @@ int main(int argc, char *argv[]) {
    qbme = qme;
    affp = (double) nx*(double) ny/np;
 
-/* nvp = number of MPI ranks */
-/* initialize for distributed memory parallel processing */
-   cppinit2(&idproc,&nvp,argc,argv);
-   kstrt = idproc + 1;
 /* check if too many processors */
    if (nvp > ny) {
       if (kstrt==1) {
@@ -132,6 +209,17 @@ int main(int argc, char *argv[]) {
       goto L3000;
    }
 
+/* boundaries of all partitions, initially the same uniform partition */
+   kfp = (int *) malloc(3*(nvp+1)*sizeof(int));
+   kfu = &kfp[nvp+1];
+   kfn = &kfp[2*(nvp+1)];
+   for (k = 0; k <= nvp; k++) {
+      nn = ((ny - 1)/nvp + 1)*k;
+      kfu[k] = nn < ny ? nn : ny;
+      kfp[k] = kfu[k];
+   }
+   kypd = nypmx;
+
 /* initialize additional scalars for MPI code */
 /* kxp = number of complex grids in each field partition in x direction */
    kxp = (nxh - 1)/nvp + 1;
@@ -139,10 +227,17 @@ int main(int argc, char *argv[]) {
    kyp = (ny - 1)/nvp + 1;
 /* npmax = maximum number of electrons in each partition */
    npmax = (np/nvp)*1.25;
+/* with a beam, one processor may hold all of it */
+   if (kdistr==1)
+      npmax = (ampb*np + (1.0 - ampb)*np/nvp)*1.25;
 /* nbmax = size of buffer for passing particles between processors */
    nbmax = 0.1*npmax;
 /* ntmax = size of ihole buffer for particles leaving processor */
    ntmax = 2*nbmax;
+/* particles sent directly may all leave in one step, since part2 */
+/* can hold them                                                  */
+   if (kmove==1)
+      ntmax = npmax;
 
 /* allocate data for standard code */
    part = (float *) malloc(idimp*npmax*sizeof(float));
@@ -156,10 +251,24 @@ int main(int argc, char *argv[]) {
    sct = (float complex *) malloc(nxyh*sizeof(float complex));
    ihole = (int *) malloc((ntmax+1)*sizeof(int));
    npic = (int *) malloc(nypmx*sizeof(int));
+/* ffts use uniform partition, particles a moving one */
+   if (kbal > 0) {
+      qu = (float *) malloc(nxe*kypd*sizeof(float));
+      fxyu = (float *) malloc(ndim*nxe*kypd*sizeof(float));
+      iholeb = (int *) malloc((npmax+1)*sizeof(int));
+   }
+   else {
+      qu = qe;
+      fxyu = fxye;
+   }
+   rcost = (float *) malloc(ny*sizeof(float));
+   gcost = (float *) malloc(ny*sizeof(float));
 
 /* allocate data for MPI code */
-   bs = (float complex *) malloc(ndim*kxp*kyp*sizeof(float complex));
-   br = (float complex *) malloc(ndim*kxp*kyp*sizeof(float complex));
+/* MPI_Alltoallv transpose packs blocks for all processors */
+   j = ktpose==1 ? nvp : 1;
+   bs = (float complex *) malloc(ndim*kxp*kyp*j*sizeof(float complex));
+   br = (float complex *) malloc(ndim*kxp*kyp*j*sizeof(float complex));
    sbufl = (float *) malloc(idimp*nbmax*sizeof(float));
    sbufr = (float *) malloc(idimp*nbmax*sizeof(float));
    rbufl = (float *) malloc(idimp*nbmax*sizeof(float));
@@ -174,8 +283,12 @@ int main(int argc, char *argv[]) {
 /* initialize electrons */
    nps = 1;
    npp = 0;
-   cpdistr2(part,edges,&npp,nps,vtx,vty,vx0,vy0,npx,npy,nx,ny,idimp,
-            npmax,idps,ipbc,&ierr);
+   if (kdistr==1)
+      cpdistr2b(part,edges,&npp,nps,vtx,vty,vx0,vy0,ampb,wb,vby,npx,
+                npy,nx,ny,idimp,npmax,idps,&ierr);
+   else
+      cpdistr2(part,edges,&npp,nps,vtx,vty,vx0,vy0,npx,npy,nx,ny,idimp,
+               npmax,idps,ipbc,&ierr);
 /* check for particle initialization error */
    if (ierr != 0) {
       if (kstrt==1) {
@@ -184,78 +297,117 @@ int main(int argc, char *argv[]) {
       goto L3000;
    }
 
+/* initialize profiler */
+   if (cprofinit(1,kperf,idproc)==1) {
+      if (kstrt==1)
+         printf("hardware counters not available\n");
+   }
+   if (kprof==2) {
+      sprintf(fprof,"prof.%d.csv",idproc);
+      cprofopen(fprof,1);
+   }
+   else if (kprof==3) {
+      sprintf(fprof,"prof.%d.json",idproc);
+      cprofopen(fprof,2);
+   }
+   if ((kbtl==1) && (kstrt==1)) {
+      fbal = fopen("bal.csv","w");
+      if (fbal==NULL)
+         printf("cannot open load balance file bal.csv\n");
+      else
+         fprintf(fbal,"ntime,tstep,timb,nimb,bimb,pimb,krep\n");
+   }
+   cpwtimera(-1,&tb,&dtbal);
+
 /* * * * start main iteration loop * * * */
 
 L500: if (nloop <= ntime)
          goto L2000;
 /*    if (kstrt==1) printf("ntime = %i\n",ntime); */
+      cprofbeg("step");
 
 /* deposit charge with standard procedure: updates qe */
-      dtimer(&dtime,&itime,-1);
+      cprofbeg("deposit");
       for (j = 0; j < nxe*nypmx; j++) {
          qe[j] = 0.0;
       }
       cppgpost2l(part,qe,npp,noff,qme,idimp,npmax,nxe,nypmx);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tdpost += time;
+      tdpost += cprofend();
 
 /* add guard cells with standard procedure: updates qe */
-      dtimer(&dtime,&itime,-1);
+      cprofbeg("guard");
       cppaguard2xl(qe,nyp,nx,nxe,nypmx);
       cppnaguard2l(qe,scr,nyp,nx,kstrt,nvp,nxe,nypmx);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tguard += time;
+      tguard += cprofend();
+
+/* move charge to uniform partition of ffts: updates qu */
+      if (kbal > 0) {
+         cprofbeg("fmove");
+         cppfmove2(qe,qu,kfp,kfu,kstrt,nvp,nxe,nypmx,kypd);
+         tfmov += cprofend();
+      }
 
 /* transform charge to fourier space with standard procedure: updates qt */
-/* modifies qe */
-      dtimer(&dtime,&itime,-1);
+/* modifies qu */
+      cprofbeg("fft");
       isign = -1;
-      cwppfft2r((float complex *)qe,qt,bs,br,isign,ntpose,mixup,sct,&ttp,
-                indx,indy,kstrt,nvp,nxeh,nye,kxp,kyp,nypmx,nxhy,nxyh);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tfft[0] += time;
+      if (ktpose > 0) {
+         cwppfft2rt((float complex *)qu,qt,bs,br,isign,ntpose,mixup,sct,
+                    &ttp,indx,indy,kstrt,nvp,nxeh,nye,kxp,kyp,kypd,nxhy,
+                    nxyh,ktpose);
+      }
+      else {
+         cwppfft2r((float complex *)qu,qt,bs,br,isign,ntpose,mixup,sct,
+                   &ttp,indx,indy,kstrt,nvp,nxeh,nye,kxp,kyp,kypd,nxhy,
+                   nxyh);
+      }
+      tfft[0] += cprofend();
       tfft[1] += ttp;
 
 /* calculate force/charge in fourier space with standard procedure: */
 /* updates fxyt, we */
-      dtimer(&dtime,&itime,-1);
+      cprofbeg("field");
       isign = -1;
       cppois22(qt,fxyt,isign,ffc,ax,ay,affp,&we,nx,ny,kstrt,nye,kxp,nyh);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tfield += time;
+      tfield += cprofend();
 
-/* transform force to real space with standard procedure: updates fxye */
+/* transform force to real space with standard procedure: updates fxyu */
 /* modifies fxyt */
-      dtimer(&dtime,&itime,-1);
+      cprofbeg("fft");
       isign = 1;
-      cwppfft2r2((float complex *)fxye,fxyt,bs,br,isign,ntpose,mixup,sct,
-                 &ttp,indx,indy,kstrt,nvp,nxeh,nye,kxp,kyp,nypmx,nxhy,
-                 nxyh);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tfft[0] += time;
+      if (ktpose > 0) {
+         cwppfft2r2t((float complex *)fxyu,fxyt,bs,br,isign,ntpose,mixup,
+                     sct,&ttp,indx,indy,kstrt,nvp,nxeh,nye,kxp,kyp,kypd,
+                     nxhy,nxyh,ktpose);
+      }
+      else {
+         cwppfft2r2((float complex *)fxyu,fxyt,bs,br,isign,ntpose,mixup,
+                    sct,&ttp,indx,indy,kstrt,nvp,nxeh,nye,kxp,kyp,kypd,
+                    nxhy,nxyh);
+      }
+      tfft[0] += cprofend();
       tfft[1] += ttp;
 
+/* move force to particle partition: updates fxye */
+      if (kbal > 0) {
+         cprofbeg("fmove");
+         cppfmove2(fxyu,fxye,kfu,kfp,kstrt,nvp,nnxe,kypd,nypmx);
+         tfmov += cprofend();
+      }
+
 /* copy guard cells with standard procedure: updates fxye */
-      dtimer(&dtime,&itime,-1);
+      cprofbeg("guard");
       cppncguard2l(fxye,nyp,kstrt,nvp,nnxe,nypmx);
       cppcguard2xl(fxye,nyp,nx,ndim,nxe,nypmx);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tguard += time;
+      tguard += cprofend();
 
 /* push particles: updates part, wke, and ihole */
-      dtimer(&dtime,&itime,-1);
+      cprofbeg("push");
       wke = 0.0;
       cppgpush2l(part,fxye,edges,npp,noff,ihole,qbme,dt,&wke,nx,ny,idimp,
                  npmax,nxe,nypmx,idps,ntmax,ipbc);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tpush += time;
+      tpush += cprofend();
+      pcomp += npp;
 /* check for ihole overflow error */
       if (ihole[0] < 0) {
          ierr = -ihole[0];
@@ -264,12 +416,20 @@ L500: if (nloop <= ntime)
          goto L3000;
       }
 /* move electrons into appropriate spatial regions: updates part, npp */
-      dtimer(&dtime,&itime,-1);
-      cppmove2(part,edges,&npp,sbufr,sbufl,rbufr,rbufl,ihole,ny,kstrt,nvp,
-               idimp,npmax,idps,nbmax,ntmax,info);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tmov += time;
+      cprofbeg("move");
+      dmig += ihole[0];
+      if (kmove==1) {
+/* part2 is used as send buffer */
+         cppamove2(part,edges,&npp,part2,ihole,ny,kstrt,nvp,idimp,npmax,
+                   idps,npmax,info);
+         mhop = info[6] > mhop ? info[6] : mhop;
+      }
+      else {
+         cppmove2(part,edges,&npp,sbufr,sbufl,rbufr,rbufl,ihole,ny,kstrt,
+                  nvp,idimp,npmax,idps,nbmax,ntmax,info);
+      }
+      mpass = info[4] > mpass ? info[4] : mpass;
+      tmov += cprofend();
 /* check for particle manager error */
       if (info[0] != 0) {
          ierr = info[0];
@@ -282,15 +442,98 @@ L500: if (nloop <= ntime)
 /* sort particles for standard code: updates part */
       if (sortime > 0) {
          if (ntime%sortime==0) {
-            dtimer(&dtime,&itime,-1);
+            cprofbeg("sort");
             cppdsortp2yl(part,part2,npic,npp,noff,nyp,idimp,npmax,nypmx);
 /* exchange pointers */
             tpart = part;
             part = part2;
             part2 = tpart;
-            dtimer(&dtime,&itime,1);
-            time = (float) dtime;
-            tsort += time;
+            tsort += cprofend();
+         }
+      }
+
+/* check load balance every nbal steps: updates kfp, edges, nyp, noff, */
+/* nypmx, part, npp, and if partition is moved, qe, fxye, npic        */
+      if ((nbal > 0) && ((ntime+1)%nbal==0) && ((kbal+kbtl) > 0)) {
+         cprofbeg("balance");
+/* measured particle time and particles pushed, and their maximum */
+         wsum[0] = tdpost + tpush + tsort - tcomp0;
+         wsum[1] = pcomp;
+         wmax[0] = wsum[0];
+         wmax[1] = npp;
+         tcomp0 = tdpost + tpush + tsort;
+         pcomp = 0.0;
+         wp = 1.0;
+         if ((wsum[0] > 0.0) && (wsum[1] > 0.0))
+            wp = wsum[0]/wsum[1];
+         cppdsum(wsum,wwork,2);
+         cppdmax(wmax,wwork,2);
+/* row cost = particles, weighted if kbal=2 by their measured time on */
+/* this processor relative to the average, plus a quarter particle   */
+/* for each grid point                                               */
+         if ((wsum[0] > 0.0) && (wsum[1] > 0.0))
+            wp = wp/(wsum[0]/wsum[1]);
+         wp = wp < 0.5 ? 0.5 : (wp > 2.0 ? 2.0 : wp);
+         if (kbal < 2)
+            wp = 1.0;
+         cpprows2l(part,rcost,npp,noff,nyp,idimp,npmax);
+         for (j = 0; j < nyp; j++) {
+            rcost[j] = wp*rcost[j] + 0.25*(float) nx;
+         }
+         cppgcost2l(rcost,gcost,kfp,kstrt,nvp);
+         cpbedges2l(gcost,kfp,kfn,&bimb,&pimb,ny,nvp);
+/* move only if imbalance is above blim and at least half the excess */
+/* work is removed, to avoid moving back and forth                   */
+         krep = 0;
+         if ((kbal > 0) && (bimb > blim)) {
+            if ((pimb - 1.0) < 0.5*(bimb - 1.0))
+               krep = 1;
+         }
+         if (krep==1) {
+            for (k = 0; k <= nvp; k++) {
+               kfp[k] = kfn[k];
+            }
+            nn = nypmx;
+            cpbpart2l(edges,kfp,&nyp,&noff,&nypmx,&nypmn,kstrt,nvp);
+            if (nypmx != nn) {
+               free(qe);
+               free(fxye);
+               free(npic);
+               qe = (float *) malloc(nxe*nypmx*sizeof(float));
+               fxye = (float *) malloc(ndim*nxe*nypmx*sizeof(float));
+               npic = (int *) malloc(nypmx*sizeof(int));
+               if ((qe==NULL) || (fxye==NULL) || (npic==NULL)) {
+                  printf("%d,field allocation error: nypmx=%d\n",kstrt,
+                         nypmx);
+                  cppabort();
+                  goto L3000;
+               }
+            }
+/* move particles which are outside the new partition */
+            cpphole2l(part,edges,npp,iholeb,idimp,npmax,npmax);
+            if (kmove==1) {
+               cppamove2(part,edges,&npp,part2,iholeb,ny,kstrt,nvp,
+                         idimp,npmax,idps,npmax,info);
+            }
+            else {
+               cppmove2(part,edges,&npp,sbufr,sbufl,rbufr,rbufl,iholeb,
+                        ny,kstrt,nvp,idimp,npmax,idps,nbmax,npmax,info);
+            }
+            if (info[0] != 0) {
+               ierr = info[0];
+               if (kstrt==1) {
+                  printf("repartition particle manager error: ierr=%d\n",
+                         ierr);
+               }
+               goto L3000;
+            }
+            nrepart += 1;
+         }
+         tlbal += cprofend();
+         cpwtimera(1,&tb,&dtbal);
+         if (fbal != NULL) {
+            fprintf(fbal,"%d,%e,%f,%f,%f,%f,%d\n",ntime+1,tb/nbal,
+                    nvp*wmax[0]/wsum[0],nvp*wmax[1]/np,bimb,pimb,krep);
          }
       }
 
@@ -308,15 +551,29 @@ L500: if (nloop <= ntime)
             printf("%e %e %e\n",we,wke,wke+we);
          }
       }
+      cprofend();
+      cprofstep(ntime);
       ntime += 1;
       goto L500;
 L2000:
 
 /* * * * end main iteration loop * * * */
  
+   wtot[0] = dmig;
+   cppdsum(wtot,work,1);
+   dmig = wtot[0];
    if (kstrt==1) {
       printf("ntime = %i\n",ntime);
       printf("MPI nodes nvp = %i\n",nvp);
+      if (kbal > 0) {
+         printf("partition moved %d times, last load imbalance = %f\n",
+                nrepart,bimb);
+      }
+      printf("particles leaving processors per step = %e\n",
+             dmig/(double) (ntime > 0 ? ntime : 1));
+      printf("maximum particle manager passes = %d\n",mpass);
+      if (kmove==1)
+         printf("maximum partitions crossed = %d\n",mhop);
       printf("Final Field, Kinetic and Total Energies:\n");
       printf("%e %e %e\n",we,wke,wke+we);
 
@@ -328,10 +585,14 @@ L2000:
       printf("push time = %f\n",tpush);
       printf("particle move time = %f\n",tmov);
       printf("sort time = %f\n",tsort);
-      tfield += tguard + tfft[0];
+      if (kbal > 0) {
+         printf("field move time = %f\n",tfmov);
+         printf("load balance time = %f\n",tlbal);
+      }
+      tfield += tguard + tfft[0] + tfmov;
       printf("total solver time = %f\n",tfield);
       tsort += tmov;
-      time = tdpost + tpush + tsort;
+      time = tdpost + tpush + tsort + tlbal;
       printf("total particle time = %f\n",time);
       wt = time + tfield;
       printf("total time = %f\n",wt);
@@ -344,7 +605,25 @@ L2000:
       printf("Total Particle Time (nsec) = %f\n",time*wt);
    }
 
+/* print profile, summed and maximum over processors */
+   if (kprof > 0) {
+      cprofget(tprof,320);
+      for (j = 0; j < 320; j++) {
+         tpmax[j] = tprof[j];
+      }
+      cppdsum(tprof,tpscr,320);
+      cppdmax(tpmax,tpscr,320);
+      if (kstrt==1) {
+         printf("\n");
+         cprofprint(tprof,tpmax,nvp);
+      }
+   }
+
 L3000:
+   if (fbal != NULL)
+      fclose(fbal);
+   cprofexit();
+   cpptpfree();
    cppexit();
    return 0;
 }
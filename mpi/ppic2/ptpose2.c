@@ -0,0 +1,471 @@
+/*--------------------------------------------------------------------*/
+/* Collective transpose library for 2D MPI PIC codes
+   ptpose2.c contains procedures which transpose the fourier data
+             between the partitions in y and in x with a single
+             collective call, instead of the nvp pairs of messages of
+             cpptpose and cppntpose in pplib2.c.
+   cppatpose performs a transpose of an n component complex vector
+             array, distributed in y, to an n component complex vector
+             array, distributed in x, with one MPI_Alltoallv of packed
+             buffers.
+   cppwtpose performs the same transpose with one MPI_Alltoallw, where
+             derived datatypes describe the blocks in place, so that no
+             packing is needed.
+   cpptposet performs the transpose selected by ktpose.
+   cpptpfree frees the derived datatypes saved by cppwtpose and the
+             counts saved by cppatpose.
+   cwppfft2rt/cwppfft2r2t: wrapper functions for 2d real to complex
+                           scalar/2 component vector ffts, using the
+                           transpose selected by ktpose.
+   the MPI calls use MPI_COMM_WORLD, the communicator of pplib2.c
+   written for the skeleton PIC codes                                */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <complex.h>
+#include "mpi.h"
+#include "ppush2.h"
+#include "pplib2.h"
+#include "ptpose2.h"
+
+/* MAXTP = maximum number of datatype sets saved by cppwtpose */
+#define MAXTP                   8
+
+/* datatype sets saved by cppwtpose, one for each distinct transpose
+   ntp = number of sets saved
+   kkey = arguments of transpose for which set was made
+   mstyp/mrtyp = send/receive datatype for each processor
+   mcnt = send and receive counts, 0 or 1, for each processor
+   mdsp = send and receive displacements in bytes, for each processor */
+static int ntp = 0;
+static int kkey[MAXTP][9];
+static MPI_Datatype *mstyp[MAXTP], *mrtyp[MAXTP];
+static int *mcnt[MAXTP], *mdsp[MAXTP];
+
+/* counts and displacements saved by cppatpose
+   nacnt = number of processors for which acnt was made
+   acnt = send counts, send displacements, receive counts and receive
+   displacements, for each processor                                 */
+static int nacnt = 0;
+static int *acnt = NULL;
+
+/*--------------------------------------------------------------------*/
+void cppatpose(float complex f[], float complex g[], float complex s[],
+               float complex t[], int nx, int ny, int kxp, int kyp,
+               int kstrt, int nvp, int ndim, int nxv, int nyv, int kxpd,
+               int kypd) {
+/* this subroutine performs a transpose of a matrix f, distributed in y,
+   to a matrix g, distributed in x, that is,
+   g[l][j][k+kyp*m][1:ndim] = f[m][k][j+kxp*l][1:ndim], where
+   0 <= j < kxp, 0 <= k < kyp, 0 <= l < nx/kxp, 0 <= m < ny/kyp
+   and where indices l and m can be distributed across processors.
+   the blocks for all processors are packed into s in processor order,
+   exchanged with one MPI_Alltoallv, and unpacked from t, so that the
+   MPI library can schedule all the messages at once
+   f = complex input array
+   g = complex output array
+   s, t = complex scratch arrays, dimension ndim*kxp*kyp*nvp
+   nx/ny = number of points in x/y
+   kxp/kyp = number of data values per block in x/y
+   kstrt = starting data block number
+   nvp = number of real or virtual processors
+   ndim = leading dimension of arrays f and g
+   nxv/nyv = first dimension of f/g
+   kypd/kxpd = second dimension of f/g
+local data                                                            */
+   int i, j, k, n, ks, kxps, kyps, joff, koff, ld, nnxv, nnyv;
+   int *scnt, *sdsp, *rcnt, *rdsp;
+   ks = kstrt - 1;
+   kxps = nx - kxp*ks;
+   kxps = 0 > kxps ? 0 : kxps;
+   kxps = kxp < kxps ? kxp : kxps;
+   kyps = ny - kyp*ks;
+   kyps = 0 > kyps ? 0 : kyps;
+   kyps = kyp < kyps ? kyp : kyps;
+   nnxv = ndim*nxv;
+   nnyv = ndim*nyv;
+/* special case for one processor */
+   if (nvp==1) {
+      for (k = 0; k < kyp; k++) {
+         for (j = 0; j < kxp; j++) {
+            for (i = 0; i < ndim; i++) {
+               g[i+ndim*k+nnyv*j] = f[i+ndim*j+nnxv*k];
+            }
+         }
+      }
+      return;
+   }
+/* counts are made once for each number of processors */
+   if (nacnt != nvp) {
+      free(acnt);
+      acnt = (int *) calloc(4*nvp,sizeof(int));
+      nacnt = nvp;
+   }
+   scnt = acnt;
+   sdsp = &scnt[nvp];
+   rcnt = &scnt[2*nvp];
+   rdsp = &scnt[3*nvp];
+/* extract data to send */
+   n = 0;
+   for (k = 0; k < nvp; k++) {
+      joff = kxp*k;
+      ld = nx - joff;
+      ld = 0 > ld ? 0 : ld;
+      ld = kxp < ld ? kxp : ld;
+      sdsp[k] = n;
+      scnt[k] = ndim*ld*kyps;
+      for (koff = 0; koff < kyps; koff++) {
+         for (j = 0; j < ld; j++) {
+            for (i = 0; i < ndim; i++) {
+               s[n+i+ndim*(j+ld*koff)] = f[i+ndim*(j+joff)+nnxv*koff];
+            }
+         }
+      }
+      n += scnt[k];
+/* size of data received */
+      koff = kyp*k;
+      ld = ny - koff;
+      ld = 0 > ld ? 0 : ld;
+      ld = kyp < ld ? kyp : ld;
+      rcnt[k] = ndim*kxps*ld;
+      rdsp[k] = k > 0 ? rdsp[k-1] + rcnt[k-1] : 0;
+   }
+   MPI_Alltoallv(s,scnt,sdsp,MPI_C_COMPLEX,t,rcnt,rdsp,MPI_C_COMPLEX,
+                 MPI_COMM_WORLD);
+/* insert data received */
+   for (n = 0; n < nvp; n++) {
+      koff = kyp*n;
+      ld = rcnt[n]/(ndim > 0 ? ndim : 1);
+      ld = kxps > 0 ? ld/kxps : 0;
+      for (k = 0; k < ld; k++) {
+         for (j = 0; j < kxps; j++) {
+            for (i = 0; i < ndim; i++) {
+               g[i+ndim*(k+koff)+nnyv*j]
+               = t[rdsp[n]+i+ndim*(j+kxps*k)];
+            }
+         }
+      }
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+static int cwtplan(int nx, int ny, int kxp, int kyp, int kstrt,
+                   int nvp, int ndim, int nxv, int nyv) {
+/* this function returns the number of the datatype set for the
+   transpose with the given arguments, making it if needed.  the send
+   block for processor k is kyps rows of ndim*ld values with stride
+   ndim*nxv, and the receive block is ld columns of kxps values with
+   stride ndim*nyv, each of ndim values, where ld is the size of the
+   block of processor k
+local data                                                            */
+   int j, k, l, ks, kxps, kyps, joff, koff, ld, nsize;
+   int key[9];
+   MPI_Datatype mcol, mcolr;
+   key[0] = nx; key[1] = ny; key[2] = kxp; key[3] = kyp;
+   key[4] = kstrt; key[5] = nvp; key[6] = ndim; key[7] = nxv;
+   key[8] = nyv;
+   for (l = 0; l < ntp; l++) {
+      for (j = 0; j < 9; j++) {
+         if (kkey[l][j] != key[j])
+            break;
+      }
+      if (j==9)
+         return l;
+   }
+/* table is full, start again */
+   if (ntp==MAXTP)
+      cpptpfree();
+   l = ntp;
+   ntp += 1;
+   for (j = 0; j < 9; j++) {
+      kkey[l][j] = key[j];
+   }
+   mstyp[l] = (MPI_Datatype *) malloc(2*nvp*sizeof(MPI_Datatype));
+   mrtyp[l] = &mstyp[l][nvp];
+   mcnt[l] = (int *) malloc(4*nvp*sizeof(int));
+   mdsp[l] = &mcnt[l][2*nvp];
+   nsize = ndim*sizeof(float complex);
+   ks = kstrt - 1;
+   kxps = nx - kxp*ks;
+   kxps = 0 > kxps ? 0 : kxps;
+   kxps = kxp < kxps ? kxp : kxps;
+   kyps = ny - kyp*ks;
+   kyps = 0 > kyps ? 0 : kyps;
+   kyps = kyp < kyps ? kyp : kyps;
+   for (k = 0; k < nvp; k++) {
+/* block sent to processor k */
+      joff = kxp*k;
+      ld = nx - joff;
+      ld = 0 > ld ? 0 : ld;
+      ld = kxp < ld ? kxp : ld;
+      mstyp[l][k] = MPI_C_COMPLEX;
+      mcnt[l][k] = 0;
+      mdsp[l][k] = 0;
+      if ((ld > 0) && (kyps > 0)) {
+         MPI_Type_vector(kyps,ndim*ld,ndim*nxv,MPI_C_COMPLEX,
+                         &mstyp[l][k]);
+         MPI_Type_commit(&mstyp[l][k]);
+         mcnt[l][k] = 1;
+         mdsp[l][k] = nsize*joff;
+      }
+/* block received from processor k, one column of kxps values for */
+/* each of its ld rows                                             */
+      koff = kyp*k;
+      ld = ny - koff;
+      ld = 0 > ld ? 0 : ld;
+      ld = kyp < ld ? kyp : ld;
+      mrtyp[l][k] = MPI_C_COMPLEX;
+      mcnt[l][k+nvp] = 0;
+      mdsp[l][k+nvp] = 0;
+      if ((ld > 0) && (kxps > 0)) {
+         MPI_Type_vector(kxps,ndim,ndim*nyv,MPI_C_COMPLEX,&mcol);
+         MPI_Type_create_resized(mcol,0,nsize,&mcolr);
+         MPI_Type_contiguous(ld,mcolr,&mrtyp[l][k]);
+         MPI_Type_commit(&mrtyp[l][k]);
+         MPI_Type_free(&mcolr);
+         MPI_Type_free(&mcol);
+         mcnt[l][k+nvp] = 1;
+         mdsp[l][k+nvp] = nsize*koff;
+      }
+   }
+   return l;
+}
+
+/*--------------------------------------------------------------------*/
+void cppwtpose(float complex f[], float complex g[], int nx, int ny,
+               int kxp, int kyp, int kstrt, int nvp, int ndim, int nxv,
+               int nyv, int kxpd, int kypd) {
+/* this subroutine performs a transpose of a matrix f, distributed in y,
+   to a matrix g, distributed in x, that is,
+   g[l][j][k+kyp*m][1:ndim] = f[m][k][j+kxp*l][1:ndim], where
+   0 <= j < kxp, 0 <= k < kyp, 0 <= l < nx/kxp, 0 <= m < ny/kyp
+   and where indices l and m can be distributed across processors.
+   the blocks are sent from f and received into g in place with one
+   MPI_Alltoallw, using derived datatypes.  the datatypes are made on
+   the first call for a given set of arguments and saved for later
+   calls, until cpptpfree is called
+   f = complex input array
+   g = complex output array
+   nx/ny = number of points in x/y
+   kxp/kyp = number of data values per block in x/y
+   kstrt = starting data block number
+   nvp = number of real or virtual processors
+   ndim = leading dimension of arrays f and g
+   nxv/nyv = first dimension of f/g
+   kypd/kxpd = second dimension of f/g
+local data                                                            */
+   int i, j, k, l, nnxv, nnyv;
+/* special case for one processor */
+   if (nvp==1) {
+      nnxv = ndim*nxv;
+      nnyv = ndim*nyv;
+      for (k = 0; k < kyp; k++) {
+         for (j = 0; j < kxp; j++) {
+            for (i = 0; i < ndim; i++) {
+               g[i+ndim*k+nnyv*j] = f[i+ndim*j+nnxv*k];
+            }
+         }
+      }
+      return;
+   }
+   l = cwtplan(nx,ny,kxp,kyp,kstrt,nvp,ndim,nxv,nyv);
+   MPI_Alltoallw(f,mcnt[l],mdsp[l],mstyp[l],g,&mcnt[l][nvp],
+                 &mdsp[l][nvp],mrtyp[l],MPI_COMM_WORLD);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cpptposet(float complex f[], float complex g[], float complex s[],
+               float complex t[], int nx, int ny, int kxp, int kyp,
+               int kstrt, int nvp, int ndim, int nxv, int nyv, int kxpd,
+               int kypd, int ktpose) {
+/* this subroutine performs a transpose of a matrix f, distributed in y,
+   to a matrix g, distributed in x, with the method selected by ktpose
+   ktpose = (0,1,2) = (one message at a time with cpptpose or cppntpose,
+   MPI_Alltoallv with cppatpose,MPI_Alltoallw with cppwtpose)
+   s, t = complex scratch arrays, dimension ndim*kxp*kyp if ktpose = 0,
+   ndim*kxp*kyp*nvp if ktpose = 1, not used if ktpose = 2
+   other arguments are as for cppatpose
+local data                                                            */
+   if (ktpose==1) {
+      cppatpose(f,g,s,t,nx,ny,kxp,kyp,kstrt,nvp,ndim,nxv,nyv,kxpd,kypd);
+   }
+   else if (ktpose==2) {
+      cppwtpose(f,g,nx,ny,kxp,kyp,kstrt,nvp,ndim,nxv,nyv,kxpd,kypd);
+   }
+   else if (ndim==1) {
+      cpptpose(f,g,s,t,nx,ny,kxp,kyp,kstrt,nvp,nxv,nyv,kxpd,kypd);
+   }
+   else {
+      cppntpose(f,g,s,t,nx,ny,kxp,kyp,kstrt,nvp,ndim,nxv,nyv,kxpd,kypd);
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cpptpfree() {
+/* this subroutine frees the derived datatypes saved by cppwtpose and
+   the counts saved by cppatpose
+local data                                                            */
+   int k, l, nvp;
+   for (l = 0; l < ntp; l++) {
+      nvp = kkey[l][5];
+      for (k = 0; k < nvp; k++) {
+         if (mcnt[l][k] > 0)
+            MPI_Type_free(&mstyp[l][k]);
+         if (mcnt[l][k+nvp] > 0)
+            MPI_Type_free(&mrtyp[l][k]);
+      }
+      free(mstyp[l]);
+      free(mcnt[l]);
+   }
+   ntp = 0;
+   free(acnt);
+   acnt = NULL;
+   nacnt = 0;
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cwppfft2rt(float complex f[], float complex g[], float complex bs[],
+                float complex br[], int isign, int ntpose, int mixup[],
+                float complex sct[], float *ttp, int indx, int indy,
+                int kstrt, int nvp, int nxvh, int nyv, int kxp, int kyp,
+                int kypd, int nxhyd, int nxyhd, int ktpose) {
+/* wrapper function for 2d real to complex fft, with packed data */
+/* parallelized with MPI, as cwppfft2r, with transpose selected by */
+/* ktpose, as in cpptposet                                         */
+/* local data */
+   int nxh, ny, ks, kxpp, kypp;
+   static int kxpi = 1, kypi = 1;
+   float tf;
+   double dtime;
+/* calculate range of indices */
+   nxh = 1L<<(indx - 1);
+   ny = 1L<<indy;
+   ks = kstrt - 1;
+   kxpp = nxh - kxp*ks;
+   kxpp = 0 > kxpp ? 0 : kxpp;
+   kxpp = kxp < kxpp ? kxp : kxpp;
+   kypp = ny - kyp*ks;
+   kypp = 0 > kypp ? 0 : kypp;
+   kypp = kyp < kypp ? kyp : kypp;
+/* inverse fourier transform */
+   if (isign < 0) {
+/* perform x fft */
+      cppfft2rxx(f,isign,mixup,sct,indx,indy,kstrt,kypi,kypp,nxvh,kypd,
+                 nxhyd,nxyhd);
+/* transpose f array to g */
+      cpwtimera(-1,ttp,&dtime);
+      cpptposet(f,g,bs,br,nxh,ny,kxp,kyp,kstrt,nvp,1,nxvh,nyv,kxp,kypd,
+                ktpose);
+      cpwtimera(1,ttp,&dtime);
+/* perform y fft */
+      cppfft2rxy(g,isign,mixup,sct,indx,indy,kstrt,kxpi,kxpp,nyv,kxp,
+                 nxhyd,nxyhd);
+/* transpose g array to f */
+      if (ntpose==0) {
+         cpwtimera(-1,&tf,&dtime);
+         cpptposet(g,f,br,bs,ny,nxh,kyp,kxp,kstrt,nvp,1,nyv,nxvh,kypd,
+                   kxp,ktpose);
+         cpwtimera(1,&tf,&dtime);
+      }
+   }
+/* forward fourier transform */
+   else if (isign > 0) {
+/* transpose f array to g */
+      if (ntpose==0) {
+         cpwtimera(-1,&tf,&dtime);
+         cpptposet(f,g,bs,br,nxh,ny,kxp,kyp,kstrt,nvp,1,nxvh,nyv,kxp,
+                   kypd,ktpose);
+         cpwtimera(1,&tf,&dtime);
+      }
+/* perform y fft */
+      cppfft2rxy(g,isign,mixup,sct,indx,indy,kstrt,kxpi,kxpp,nyv,kxp,
+                 nxhyd,nxyhd);
+/* transpose g array to f */
+      cpwtimera(-1,ttp,&dtime);
+      cpptposet(g,f,br,bs,ny,nxh,kyp,kxp,kstrt,nvp,1,nyv,nxvh,kypd,kxp,
+                ktpose);
+      cpwtimera(1,ttp,&dtime);
+/* perform x fft */
+      cppfft2rxx(f,isign,mixup,sct,indx,indy,kstrt,kypi,kypp,nxvh,kypd,
+                 nxhyd,nxyhd);
+   }
+   if (ntpose==0)
+      *ttp += tf;
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cwppfft2r2t(float complex f[], float complex g[],
+                 float complex bs[], float complex br[], int isign,
+                 int ntpose, int mixup[], float complex sct[],
+                 float *ttp, int indx, int indy, int kstrt, int nvp,
+                 int nxvh, int nyv, int kxp, int kyp, int kypd,
+                 int nxhyd, int nxyhd, int ktpose) {
+/* wrapper function for 2 2d real to complex ffts, with packed data */
+/* parallelized with MPI, as cwppfft2r2, with transpose selected by */
+/* ktpose, as in cpptposet                                          */
+/* local data */
+   int nxh, ny, ks, kxpp, kypp;
+   static int kxpi = 1, kypi = 1;
+   float tf;
+   double dtime;
+/* calculate range of indices */
+   nxh = 1L<<(indx - 1);
+   ny = 1L<<indy;
+   ks = kstrt - 1;
+   kxpp = nxh - kxp*ks;
+   kxpp = 0 > kxpp ? 0 : kxpp;
+   kxpp = kxp < kxpp ? kxp : kxpp;
+   kypp = ny - kyp*ks;
+   kypp = 0 > kypp ? 0 : kypp;
+   kypp = kyp < kypp ? kyp : kypp;
+/* inverse fourier transform */
+   if (isign < 0) {
+/* perform x fft */
+      cppfft2r2xx(f,isign,mixup,sct,indx,indy,kstrt,kypi,kypp,nxvh,kypd,
+                  nxhyd,nxyhd);
+/* transpose f array to g */
+      cpwtimera(-1,ttp,&dtime);
+      cpptposet(f,g,bs,br,nxh,ny,kxp,kyp,kstrt,nvp,2,nxvh,nyv,kxp,kypd,
+                ktpose);
+      cpwtimera(1,ttp,&dtime);
+/* perform y fft */
+      cppfft2r2xy(g,isign,mixup,sct,indx,indy,kstrt,kxpi,kxpp,nyv,kxp,
+                  nxhyd,nxyhd);
+/* transpose g array to f */
+      if (ntpose==0) {
+         cpwtimera(-1,&tf,&dtime);
+         cpptposet(g,f,br,bs,ny,nxh,kyp,kxp,kstrt,nvp,2,nyv,nxvh,kypd,
+                   kxp,ktpose);
+         cpwtimera(1,&tf,&dtime);
+      }
+   }
+/* forward fourier transform */
+   else if (isign > 0) {
+/* transpose f array to g */
+      if (ntpose==0) {
+         cpwtimera(-1,&tf,&dtime);
+         cpptposet(f,g,bs,br,nxh,ny,kxp,kyp,kstrt,nvp,2,nxvh,nyv,kxp,
+                   kypd,ktpose);
+         cpwtimera(1,&tf,&dtime);
+      }
+/* perform y fft */
+      cppfft2r2xy(g,isign,mixup,sct,indx,indy,kstrt,kxpi,kxpp,nyv,kxp,
+                  nxhyd,nxyhd);
+/* transpose g array to f */
+      cpwtimera(-1,ttp,&dtime);
+      cpptposet(g,f,br,bs,ny,nxh,kyp,kxp,kstrt,nvp,2,nyv,nxvh,kypd,kxp,
+                ktpose);
+      cpwtimera(1,ttp,&dtime);
+/* perform x fft */
+      cppfft2r2xx(f,isign,mixup,sct,indx,indy,kstrt,kypi,kypp,nxvh,kypd,
+                  nxhyd,nxyhd);
+   }
+   if (ntpose==0)
+      *ttp += tf;
+   return;
+}
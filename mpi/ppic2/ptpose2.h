@@ -0,0 +1,30 @@
+/* header file for ptpose2.c */
+
+void cppatpose(float complex f[], float complex g[], float complex s[],
+               float complex t[], int nx, int ny, int kxp, int kyp,
+               int kstrt, int nvp, int ndim, int nxv, int nyv, int kxpd,
+               int kypd);
+
+void cppwtpose(float complex f[], float complex g[], int nx, int ny,
+               int kxp, int kyp, int kstrt, int nvp, int ndim, int nxv,
+               int nyv, int kxpd, int kypd);
+
+void cpptposet(float complex f[], float complex g[], float complex s[],
+               float complex t[], int nx, int ny, int kxp, int kyp,
+               int kstrt, int nvp, int ndim, int nxv, int nyv, int kxpd,
+               int kypd, int ktpose);
+
+void cpptpfree();
+
+void cwppfft2rt(float complex f[], float complex g[], float complex bs[],
+                float complex br[], int isign, int ntpose, int mixup[],
+                float complex sct[], float *ttp, int indx, int indy,
+                int kstrt, int nvp, int nxvh, int nyv, int kxp, int kyp,
+                int kypd, int nxhyd, int nxyhd, int ktpose);
+
+void cwppfft2r2t(float complex f[], float complex g[],
+                 float complex bs[], float complex br[], int isign,
+                 int ntpose, int mixup[], float complex sct[],
+                 float *ttp, int indx, int indy, int kstrt, int nvp,
+                 int nxvh, int nyv, int kxp, int kyp, int kypd,
+                 int nxhyd, int nxyhd, int ktpose);
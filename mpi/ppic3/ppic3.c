@@ -7,6 +7,7 @@
 #include <sys/time.h>
 #include "ppush3.h"
 #include "pplib3.h"
+#include "cfglib.h"
 
 void dtimer(double *time, struct timeval *itime, int icntrl);
 
@@ -97,6 +98,26 @@ int main(int argc, char *argv[]) {
    float tfft[2] = {0.0,0.0};
    double dtime;
 
+/* nvp = number of MPI ranks */
+/* initialize for distributed memory parallel processing */
+   cppinit2(&idproc,&nvp,argc,argv);
+   kstrt = idproc + 1;
+/* replace parameters with values from input decks or command line, */
+/* for example: cppic3 indx=6 npx=192 npy=192 npz=192               */
+   ierr = ccfgread(argc,argv,kstrt==1);
+   ccfgint("indx",&indx); ccfgint("indy",&indy); ccfgint("indz",&indz);
+   ccfgint("npx",&npx); ccfgint("npy",&npy); ccfgint("npz",&npz);
+   ccfgflt("tend",&tend); ccfgflt("dt",&dt); ccfgflt("vtx",&vtx);
+   ccfgflt("vty",&vty); ccfgflt("vtz",&vtz); ccfgflt("vx0",&vx0);
+   ccfgflt("vy0",&vy0); ccfgflt("vz0",&vz0);
+   ccfgint("sortime",&sortime);
+   ierr += ccfgend();
+   if (ierr != 0) {
+      if (kstrt==1)
+         printf("invalid run time parameters\n");
+      goto L3000;
+   }
+
 /* initialize scalars for standard code */
 /* np = total number of particles in simulation */
    np = ((double) npx)*((double) npy)*((double) npz);
@@ -113,10 +134,6 @@ int main(int argc, char *argv[]) {
    qbme = qme;
    affp = ((double) nx)*((double) ny)*((double) nz)/np;
 
-/* nvp = number of MPI ranks */
-/* initialize for distributed memory parallel processing */
-   cppinit2(&idproc,&nvp,argc,argv);
-   kstrt = idproc + 1;
 /* obtain 2D partition (nvpy,nvpz) from nvp: */
 /* nvpy/nvpz = number of processors in y/z */
    cfcomp32(nvp,nx,ny,nz,&nvpy,&nvpz,&ierr);
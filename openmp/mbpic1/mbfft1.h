@@ -0,0 +1,33 @@
+/* header file for mbfft1.c */
+
+void cfft1rmx(float complex f[], float complex t[], int isign,
+              int mixup[], float complex sct[], int indx, int nxd,
+              int nxhd, int nblok);
+
+void cfft1rm2x(float complex f[], float complex t[], int isign,
+               int mixup[], float complex sct[], int indx, int nxd,
+               int nxhd, int nblok);
+
+void cfft1rm3x(float complex f[], float complex t[], int isign,
+               int mixup[], float complex sct[], int indx, int nxd,
+               int nxhd, int nblok);
+
+void cmpois1(float complex q[], float complex fx[], int isign,
+             float complex ffc[], float ax, float affp, float *we,
+             int nx);
+
+void cmibpois13(float complex cu[], float complex byz[],
+                float complex ffc[], float ci, float *wm, int nx,
+                int nxvh, int nxhd);
+
+void cmmaxwel1(float complex eyz[], float complex byz[],
+               float complex cu[], float complex ffc[], float ci,
+               float dt, float *wf, float *wm, int nx, int nxvh,
+               int nxhd);
+
+void cmemfield1(float complex fxyz[], float complex fx[],
+                float complex eyz[], float complex ffc[], int nx,
+                int nxvh, int nxhd);
+
+void cmbmfield1(float complex fyz[], float complex eyz[],
+                float complex ffc[], int nx, int nxvh, int nxhd);
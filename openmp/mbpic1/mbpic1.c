@@ -7,6 +7,8 @@
 #include <sys/time.h>
 #include "mbpush1.h"
 #include "omplib.h"
+#include "cfglib.h"
+#include "mbfft1.h"
 
 void dtimer(double *time, struct timeval *itime, int icntrl);
 
@@ -39,6 +41,9 @@ int main(int argc, char *argv[]) {
    int mx = 32;
 /* xtras = fraction of extra particles needed for particle management */
    float xtras = 0.2;
+/* kfft = (0,1) = use (standard,parallel) ffts and field solvers */
+/* nbfft = number of short ffts transformed together when kfft=1 */
+   int kfft = 0, nbfft = 16;
 /* declare scalars for standard code */
    int j;
    int np, nx, nxh, nxe, nxeh;
@@ -91,6 +96,25 @@ int main(int argc, char *argv[]) {
    nvp = 0;
 /* printf("enter number of nodes:\n"); */
 /* scanf("%i",&nvp);                   */
+/* replace parameters with values from input decks or command line, */
+/* for example: cmbpic1_f indx=20 npx=1048576 kfft=1                 */
+   irc = ccfgread(argc,argv,1);
+   ccfgint("indx",&indx); ccfgint("npx",&npx); ccfgflt("tend",&tend);
+   ccfgflt("dt",&dt); ccfgflt("vtx",&vtx); ccfgflt("vty",&vty);
+   ccfgflt("vtz",&vtz); ccfgflt("vx0",&vx0); ccfgflt("vy0",&vy0);
+   ccfgflt("vz0",&vz0); ccfgflt("ci",&ci);
+   ccfgint("relativity",&relativity); ccfgint("mx",&mx);
+   ccfgflt("xtras",&xtras); ccfgint("nvp",&nvp); ccfgint("kfft",&kfft);
+   ccfgint("nbfft",&nbfft);
+   irc += ccfgend();
+   if (irc != 0) {
+      printf("invalid run time parameters\n");
+      exit(1);
+   }
+   if (nbfft < 1) {
+      printf("invalid fft block size, nbfft=%d\n",nbfft);
+      exit(1);
+   }
 /* initialize for shared memory parallel processing */
    cinit_omp(nvp);
 
@@ -247,8 +271,14 @@ L500: if (nloop <= ntime)
 /* updates qe, fxe */
       dtimer(&dtime,&itime,-1);
       isign = -1;
-      cfft1rxx((float complex *)qe,(float complex *)fxe,isign,mixup,sct,
-               indx,nxe,nxh);
+      if (kfft==1) {
+         cfft1rmx((float complex *)qe,(float complex *)fxe,isign,mixup,
+                  sct,indx,nxe,nxh,nbfft);
+      }
+      else {
+         cfft1rxx((float complex *)qe,(float complex *)fxe,isign,mixup,
+                  sct,indx,nxe,nxh);
+      }
       dtimer(&dtime,&itime,1);
       time = (float) dtime;
       tfft += time;
@@ -257,8 +287,14 @@ L500: if (nloop <= ntime)
 /*updates cue, byze */
       dtimer(&dtime,&itime,-1);
       isign = -1;
-      cfft1r2x((float complex *)cue,(float complex *)byze,isign,mixup,
-               sct,indx,nxe,nxh);
+      if (kfft==1) {
+         cfft1rm2x((float complex *)cue,(float complex *)byze,isign,
+                   mixup,sct,indx,nxe,nxh,nbfft);
+      }
+      else {
+         cfft1r2x((float complex *)cue,(float complex *)byze,isign,
+                  mixup,sct,indx,nxe,nxh);
+      }
       dtimer(&dtime,&itime,1);
       time = (float) dtime;
       tfft += time;
@@ -267,10 +303,19 @@ L500: if (nloop <= ntime)
 /* procedure: updates eyz, byz                                     */
       dtimer(&dtime,&itime,-1);
       if (ntime==0) {
-         cibpois13((float complex *)cue,byz,ffc,ci,&wm,nx,nxeh,nxh);
+         if (kfft==1) {
+            cmibpois13((float complex *)cue,byz,ffc,ci,&wm,nx,nxeh,nxh);
+         }
+         else {
+            cibpois13((float complex *)cue,byz,ffc,ci,&wm,nx,nxeh,nxh);
+         }
          wf = 0.0;
          dth = 0.5*dt;
       }
+      else if (kfft==1) {
+         cmmaxwel1(eyz,byz,(float complex *)cue,ffc,ci,dt,&wf,&wm,nx,
+                   nxeh,nxh);
+      }
       else {
          cmaxwel1(eyz,byz,(float complex *)cue,ffc,ci,dt,&wf,&wm,nx,
                   nxeh,nxh);
@@ -283,8 +328,14 @@ L500: if (nloop <= ntime)
 /* updates fxe, we */
       dtimer(&dtime,&itime,-1);
       isign = -1;
-      cpois1((float complex *)qe,(float complex *)fxe,isign,ffc,ax,affp,
-             &we,nx);
+      if (kfft==1) {
+         cmpois1((float complex *)qe,(float complex *)fxe,isign,ffc,ax,
+                 affp,&we,nx);
+      }
+      else {
+         cpois1((float complex *)qe,(float complex *)fxe,isign,ffc,ax,
+                affp,&we,nx);
+      }
       dtimer(&dtime,&itime,1);
       time = (float) dtime;
       tfield += time;
@@ -293,11 +344,22 @@ L500: if (nloop <= ntime)
 /* procedure: updates fxyze */
       dtimer(&dtime,&itime,-1);
       isign = 1;
-      cemfield1((float complex *)fxyze,(float complex *)fxe,eyz,ffc,nx,
-                nxeh,nxh);
+      if (kfft==1) {
+         cmemfield1((float complex *)fxyze,(float complex *)fxe,eyz,ffc,
+                    nx,nxeh,nxh);
+      }
+      else {
+         cemfield1((float complex *)fxyze,(float complex *)fxe,eyz,ffc,
+                   nx,nxeh,nxh);
+      }
 /* copy magnetic field with standard procedure: updates byze */
       isign = -1;
-      cbmfield1((float complex *)byze,byz,ffc,nx,nxeh,nxh);
+      if (kfft==1) {
+         cmbmfield1((float complex *)byze,byz,ffc,nx,nxeh,nxh);
+      }
+      else {
+         cbmfield1((float complex *)byze,byz,ffc,nx,nxeh,nxh);
+      }
       dtimer(&dtime,&itime,1);
       time = (float) dtime;
       tfield += time;
@@ -306,8 +368,14 @@ L500: if (nloop <= ntime)
 /* updates fxyze, gxyze */
       dtimer(&dtime,&itime,-1);
       isign = 1;
-      cfft1r3x((float complex *)fxyze,(float complex *)gxyze,isign,
-                mixup,sct,indx,nxe,nxh);
+      if (kfft==1) {
+         cfft1rm3x((float complex *)fxyze,(float complex *)gxyze,isign,
+                   mixup,sct,indx,nxe,nxh,nbfft);
+      }
+      else {
+         cfft1r3x((float complex *)fxyze,(float complex *)gxyze,isign,
+                  mixup,sct,indx,nxe,nxh);
+      }
       dtimer(&dtime,&itime,1);
       time = (float) dtime;
       tfft += time;
@@ -316,8 +384,14 @@ L500: if (nloop <= ntime)
 /* updates byze, cue */
       dtimer(&dtime,&itime,-1);
       isign = 1;
-      cfft1r2x((float complex *)byze,(float complex *)cue,isign,mixup,
-               sct,indx,nxe,nxh);
+      if (kfft==1) {
+         cfft1rm2x((float complex *)byze,(float complex *)cue,isign,
+                   mixup,sct,indx,nxe,nxh,nbfft);
+      }
+      else {
+         cfft1r2x((float complex *)byze,(float complex *)cue,isign,
+                  mixup,sct,indx,nxe,nxh);
+      }
       dtimer(&dtime,&itime,1);
       time = (float) dtime;
       tfft += time;
@@ -41,6 +41,9 @@ int main(int argc, char *argv[]) {
    int mx = 16, my = 16;
 /* xtras = fraction of extra particles needed for particle management */
    float xtras = 0.2;
+/* kdepo = (0,1) = deposit current tile edges with (atomic updates, */
+/* colored tile schedule), used only if relativity = 0              */
+   int kdepo = 0;
 /* declare scalars for standard code */
    int j;
    int np, nx, ny, nxh, nyh, nxe, nye, nxeh, nxyh, nxhy;
@@ -184,6 +187,11 @@ L500: if (nloop <= ntime)
          cgrjppostf2l(ppart,cue,kpic,ncl,ihole,qme,dth,ci,nppmx0,
                       idimp,nx,ny,mx,my,nxe,nye,mx1,mxy1,ntmax,&irc);
       }
+/* updates ppart, cue */
+      else if (kdepo==1) {
+         cgjppost2lc(ppart,cue,kpic,qme,dth,nppmx0,idimp,nx,ny,mx,my,
+                     nxe,nye,mx1,mxy1,ipbc);
+      }
       else {
 /* updates ppart, cue */
 /*       cgjppost2l(ppart,cue,kpic,qme,dth,nppmx0,idimp,nx,ny,mx,my,  */
@@ -210,9 +218,15 @@ L500: if (nloop <= ntime)
 /* updates ppart, ppbuff, kpic, ncl, ihole, and irc */
 /*    cpporder2l(ppart,ppbuff,kpic,ncl,ihole,idimp,nppmx0,nx,ny,mx,my, */
 /*               mx1,my1,npbmx,ntmax,&irc);                            */
+      if ((relativity==0) && (kdepo==1)) {
+         cpporder2l(ppart,ppbuff,kpic,ncl,ihole,idimp,nppmx0,nx,ny,mx,
+                    my,mx1,my1,npbmx,ntmax,&irc);
+      }
 /* updates ppart, ppbuff, kpic, ncl, and irc */
-      cpporderf2l(ppart,ppbuff,kpic,ncl,ihole,idimp,nppmx0,mx1,my1,
-                  npbmx,ntmax,&irc);
+      else {
+         cpporderf2l(ppart,ppbuff,kpic,ncl,ihole,idimp,nppmx0,mx1,my1,
+                     npbmx,ntmax,&irc);
+      }
       dtimer(&dtime,&itime,1);
       time = (float) dtime;
       tsort += time;
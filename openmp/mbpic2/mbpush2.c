@@ -1810,6 +1810,182 @@ vy,vz,scu)
 #undef MYV
 }
 
+/*--------------------------------------------------------------------*/
+void cgjppost2lc(float ppart[], float cu[], int kpic[], float qm,
+                 float dt, int nppmx, int idimp, int nx, int ny, int mx,
+                 int my, int nxv, int nyv, int mx1, int mxy1, int ipbc) {
+/* for 2-1/2d code, this subroutine calculates particle current density
+   using first-order linear interpolation
+   in addition, particle positions are advanced a half time-step
+   OpenMP version using guard cells, without atomic updates
+   data deposited in tiles
+   particles stored segmented array
+   41 flops/particle, 17 loads, 14 stores
+   input: all, output: ppart, cu
+   current density is approximated by values at the nearest grid points
+   cu(i,n,m)=qci*(1.-dx)*(1.-dy)
+   cu(i,n+1,m)=qci*dx*(1.-dy)
+   cu(i,n,m+1)=qci*(1.-dx)*dy
+   cu(i,n+1,m+1)=qci*dx*dy
+   where n,m = leftmost grid points and dx = x-n, dy = y-m
+   and qci = qm*vi, where i = x,y,z
+   tiles are processed in 4 passes, one for each color of a 2x2
+   checkerboard, (even,odd) tile in x by (even,odd) tile in y.  tiles
+   of the same color share no grid points, so each tile adds all of its
+   local accumulator to cu without atomic updates, and the result is
+   the same bit for bit for any number of threads
+   ppart[m][n][0] = position x of particle n in tile m
+   ppart[m][n][1] = position y of particle n in tile m
+   ppart[m][n][2] = x velocity of particle n in tile m
+   ppart[m][n][3] = y velocity of particle n in tile m
+   ppart[m][n][4] = z velocity of particle n in tile m
+   cu[k][j][i] = ith component of current density at grid point j,k
+   kpic = number of particles per tile
+   qm = charge on particle, in units of e
+   dt = time interval between successive calculations
+   nppmx = maximum number of particles in tile
+   idimp = size of phase space = 5
+   nx/ny = system length in x/y direction
+   mx/my = number of grids in sorting cell in x/y
+   nxv = first dimension of current array, must be >= nx+1
+   nyv = second dimension of current array, must be >= ny+1
+   mx1 = (system length in x direction - 1)/mx + 1
+   mxy1 = mx1*my1, where my1 = (system length in y direction - 1)/my + 1
+   ipbc = particle boundary condition = (0,1,2,3) =
+   (none,2d periodic,2d reflecting,mixed reflecting/periodic)
+local data                                                            */
+#define MXV             33
+#define MYV             33
+   int my1, noff, moff, npoff, npp, mxv3;
+   int i, j, k, l, nn, mm, ic, kx, ky, ncx, ncy;
+   float edgelx, edgely, edgerx, edgery, dxp, dyp, amx, amy;
+   float x, y, dx, dy, vx, vy, vz;
+   float scu[3*MXV*MYV];
+/* float scu[3*(mx+1)*(my+1)]; */
+   mxv3 = 3*(mx + 1);
+   my1 = mxy1/mx1;
+/* set boundary values */
+   edgelx = 0.0;
+   edgely = 0.0;
+   edgerx = (float) nx;
+   edgery = (float) ny;
+   if (ipbc==2) {
+      edgelx = 1.0;
+      edgely = 1.0;
+      edgerx = (float) (nx-1);
+      edgery = (float) (ny-1);
+   }
+   else if (ipbc==3) {
+      edgelx = 1.0;
+      edgerx = (float) (nx-1);
+   }
+/* error if local array is too small */
+/* if ((mx >= MXV) || (my >= MYV))   */
+/*    return;                        */
+#pragma omp parallel \
+private(i,j,k,l,ic,kx,ky,ncx,ncy,noff,moff,npp,npoff,nn,mm,x,y,dxp,dyp, \
+amx,amy,dx,dy,vx,vy,vz,scu)
+   {
+/* loop over colors */
+   for (ic = 0; ic < 4; ic++) {
+      kx = ic%2;
+      ky = ic/2;
+      ncx = (mx1 - kx + 1)/2;
+      ncy = (my1 - ky + 1)/2;
+/* loop over tiles of one color */
+#pragma omp for
+      for (l = 0; l < ncx*ncy; l++) {
+         k = (2*(l/ncx) + ky)*mx1 + 2*(l%ncx) + kx;
+         noff = k/mx1;
+         moff = my*noff;
+         noff = mx*(k - mx1*noff);
+         npp = kpic[k];
+         npoff = nppmx*k;
+/* zero out local accumulator */
+         for (j = 0; j < mxv3*(my+1); j++) {
+            scu[j] = 0.0f;
+         }
+/* loop over particles in tile */
+         for (j = 0; j < npp; j++) {
+/* find interpolation weights */
+            x = ppart[idimp*(j+npoff)];
+            y = ppart[1+idimp*(j+npoff)];
+            nn = x;
+            mm = y;
+            dxp = qm*(x - (float) nn);
+            dyp = y - (float) mm;
+            nn = 3*(nn - noff) + mxv3*(mm - moff);
+            amx = qm - dxp;
+            amy = 1.0 - dyp;
+/* deposit current */
+            dx = amx*amy;
+            dy = dxp*amy;
+            vx = ppart[2+idimp*(j+npoff)];
+            vy = ppart[3+idimp*(j+npoff)];
+            vz = ppart[4+idimp*(j+npoff)];
+            scu[nn] += vx*dx;
+            scu[nn+1] += vy*dx;
+            scu[nn+2] += vz*dx;
+            dx = amx*dyp;
+            mm = nn + 3;
+            scu[mm] += vx*dy;
+            scu[mm+1] += vy*dy;
+            scu[mm+2] += vz*dy;
+            dy = dxp*dyp;
+            nn += mxv3;
+            scu[nn] += vx*dx;
+            scu[nn+1] += vy*dx;
+            scu[nn+2] += vz*dx;
+            mm = nn + 3;
+            scu[mm] += vx*dy;
+            scu[mm+1] += vy*dy;
+            scu[mm+2] += vz*dy;
+/* advance position half a time-step */
+            dx = x + vx*dt;
+            dy = y + vy*dt;
+/* reflecting boundary conditions */
+            if (ipbc==2) {
+               if ((dx < edgelx) || (dx >= edgerx)) {
+                  dx = ppart[idimp*(j+npoff)];
+                  ppart[2+idimp*(j+npoff)] = -ppart[2+idimp*(j+npoff)];
+               }
+               if ((dy < edgely) || (dy >= edgery)) {
+                  dy = ppart[1+idimp*(j+npoff)];
+                  ppart[3+idimp*(j+npoff)] = -ppart[3+idimp*(j+npoff)];
+               }
+            }
+/* mixed reflecting/periodic boundary conditions */
+            else if (ipbc==3) {
+               if ((dx < edgelx) || (dx >= edgerx)) {
+                  dx = ppart[idimp*(j+npoff)];
+                  ppart[2+idimp*(j+npoff)] = -ppart[2+idimp*(j+npoff)];
+               }
+            }
+/* set new position */
+            ppart[idimp*(j+npoff)] = dx;
+            ppart[1+idimp*(j+npoff)] = dy;
+         }
+/* deposit current to interior and edge points in global array */
+         nn = nxv - noff;
+         mm = nyv - moff;
+         nn = mx+1 < nn ? mx+1 : nn;
+         mm = my+1 < mm ? my+1 : mm;
+         for (j = 0; j < mm; j++) {
+            for (i = 0; i < nn; i++) {
+               cu[3*(i+noff+nxv*(j+moff))] += scu[3*i+mxv3*j];
+               cu[1+3*(i+noff+nxv*(j+moff))] += scu[1+3*i+mxv3*j];
+               cu[2+3*(i+noff+nxv*(j+moff))] += scu[2+3*i+mxv3*j];
+            }
+         }
+      }
+/* implicit barrier ends each color */
+   }
+   }
+   return;
+#undef MXV
+#undef MYV
+}
+
 /*--------------------------------------------------------------------*/
 void cgjppostf2l(float ppart[], float cu[], int kpic[], int ncl[],
                  int ihole[], float qm, float dt, int nppmx, int idimp,
@@ -4599,6 +4775,16 @@ void cgjppost2l_(float *ppart, float *cu, int *kpic, float *qm,
    return;
 }
 
+/*--------------------------------------------------------------------*/
+void cgjppost2lc_(float *ppart, float *cu, int *kpic, float *qm,
+                  float *dt, int *nppmx, int *idimp, int *nx, int *ny,
+                  int *mx, int *my, int *nxv, int *nyv, int *mx1,
+                  int *mxy1, int *ipbc) {
+   cgjppost2lc(ppart,cu,kpic,*qm,*dt,*nppmx,*idimp,*nx,*ny,*mx,*my,
+               *nxv,*nyv,*mx1,*mxy1,*ipbc);
+   return;
+}
+
 /*--------------------------------------------------------------------*/
 void cgjppostf2l_(float *ppart, float *cu, int *kpic, int *ncl,
                   int *ihole, float *qm, float *dt, int *nppmx, 
@@ -1700,6 +1700,181 @@ c deposit current to edge points in global array
 !$OMP END PARALLEL DO
       return
       end
+c-----------------------------------------------------------------------
+      subroutine GJPPOST2LC(ppart,cu,kpic,qm,dt,nppmx,idimp,nx,ny,mx,my
+     1,nxv,nyv,mx1,mxy1,ipbc)
+c for 2-1/2d code, this subroutine calculates particle current density
+c using first-order linear interpolation
+c in addition, particle positions are advanced a half time-step
+c OpenMP version using guard cells, without atomic updates
+c data deposited in tiles
+c particles stored segmented array
+c 41 flops/particle, 17 loads, 14 stores
+c input: all, output: ppart, cu
+c current density is approximated by values at the nearest grid points
+c cu(i,n,m)=qci*(1.-dx)*(1.-dy)
+c cu(i,n+1,m)=qci*dx*(1.-dy)
+c cu(i,n,m+1)=qci*(1.-dx)*dy
+c cu(i,n+1,m+1)=qci*dx*dy
+c where n,m = leftmost grid points and dx = x-n, dy = y-m
+c and qci = qm*vi, where i = x,y,z
+c tiles are processed in 4 passes, one for each color of a 2x2
+c checkerboard, (odd,even) tile in x by (odd,even) tile in y.  tiles
+c of the same color share no grid points, so each tile adds all of its
+c local accumulator to cu without atomic updates, and the result is
+c the same bit for bit for any number of threads
+c ppart(1,n,m) = position x of particle n in tile m
+c ppart(2,n,m) = position y of particle n in tile m
+c ppart(3,n,m) = x velocity of particle n in tile m
+c ppart(4,n,m) = y velocity of particle n in tile m
+c ppart(5,n,m) = z velocity of particle n in tile m
+c cu(i,j,k) = ith component of current density at grid point j,k
+c kpic = number of particles per tile
+c qm = charge on particle, in units of e
+c dt = time interval between successive calculations
+c nppmx = maximum number of particles in tile
+c idimp = size of phase space = 5
+c nx/ny = system length in x/y direction
+c mx/my = number of grids in sorting cell in x/y
+c nxv = first dimension of current array, must be >= nx+1
+c nyv = second dimension of current array, must be >= ny+1
+c mx1 = (system length in x direction - 1)/mx + 1
+c mxy1 = mx1*my1, where my1 = (system length in y direction - 1)/my + 1
+c ipbc = particle boundary condition = (0,1,2,3) =
+c (none,2d periodic,2d reflecting,mixed reflecting/periodic)
+      implicit none
+      integer nppmx, idimp, nx, ny, mx, my, nxv, nyv, mx1, mxy1, ipbc
+      real qm, dt
+      real ppart, cu
+      integer kpic
+      dimension ppart(idimp,nppmx,mxy1), cu(3,nxv,nyv)
+      dimension kpic(mxy1)
+c local data
+      integer MXV, MYV
+      parameter(MXV=33,MYV=33)
+      integer my1, noff, moff, npp
+      integer i, j, k, l, nn, mm, ic, kx, ky, ncx, ncy
+      real edgelx, edgely, edgerx, edgery, dxp, dyp, amx, amy
+      real x, y, dx, dy, vx, vy, vz
+      real scu
+      dimension scu(3,MXV,MYV)
+c     dimension scu(3,mx+1,my+1)
+      my1 = mxy1/mx1
+c set boundary values
+      edgelx = 0.0
+      edgely = 0.0
+      edgerx = real(nx)
+      edgery = real(ny)
+      if (ipbc.eq.2) then
+         edgelx = 1.0
+         edgely = 1.0
+         edgerx = real(nx-1)
+         edgery = real(ny-1)
+      else if (ipbc.eq.3) then
+         edgelx = 1.0
+         edgerx = real(nx-1)
+      endif
+c error if local array is too small
+c     if ((mx.ge.MXV).or.(my.ge.MYV)) return
+!$OMP PARALLEL
+!$OMP& PRIVATE(i,j,k,l,ic,kx,ky,ncx,ncy,noff,moff,npp,nn,mm,x,y,dxp,dyp,
+!$OMP& amx,amy,dx,dy,vx,vy,vz,scu)
+c loop over colors
+      do 90 ic = 1, 4
+      kx = mod(ic-1,2)
+      ky = (ic - 1)/2
+      ncx = (mx1 - kx + 1)/2
+      ncy = (my1 - ky + 1)/2
+c loop over tiles of one color
+!$OMP DO
+      do 80 l = 1, ncx*ncy
+      k = (2*((l - 1)/ncx) + ky)*mx1 + 2*mod(l-1,ncx) + kx + 1
+      noff = (k - 1)/mx1
+      moff = my*noff
+      noff = mx*(k - mx1*noff - 1)
+      npp = kpic(k)
+c zero out local accumulator
+      do 20 j = 1, my+1
+      do 10 i = 1, mx+1
+      scu(1,i,j) = 0.0
+      scu(2,i,j) = 0.0
+      scu(3,i,j) = 0.0
+   10 continue
+   20 continue
+c loop over particles in tile
+      do 30 j = 1, npp
+c find interpolation weights
+      x = ppart(1,j,k)
+      y = ppart(2,j,k)
+      nn = x
+      mm = y
+      dxp = qm*(x - real(nn))
+      dyp = y - real(mm)
+      nn = nn - noff + 1
+      mm = mm - moff + 1
+      amx = qm - dxp
+      amy = 1.0 - dyp
+c deposit current
+      dx = amx*amy
+      dy = dxp*amy
+      vx = ppart(3,j,k)
+      vy = ppart(4,j,k)
+      vz = ppart(5,j,k)
+      scu(1,nn,mm) = scu(1,nn,mm) + vx*dx
+      scu(2,nn,mm) = scu(2,nn,mm) + vy*dx
+      scu(3,nn,mm) = scu(3,nn,mm) + vz*dx
+      dx = amx*dyp
+      scu(1,nn+1,mm) = scu(1,nn+1,mm) + vx*dy
+      scu(2,nn+1,mm) = scu(2,nn+1,mm) + vy*dy
+      scu(3,nn+1,mm) = scu(3,nn+1,mm) + vz*dy
+      dy = dxp*dyp
+      scu(1,nn,mm+1) = scu(1,nn,mm+1) + vx*dx
+      scu(2,nn,mm+1) = scu(2,nn,mm+1) + vy*dx
+      scu(3,nn,mm+1) = scu(3,nn,mm+1) + vz*dx
+      scu(1,nn+1,mm+1) = scu(1,nn+1,mm+1) + vx*dy
+      scu(2,nn+1,mm+1) = scu(2,nn+1,mm+1) + vy*dy
+      scu(3,nn+1,mm+1) = scu(3,nn+1,mm+1) + vz*dy
+c advance position half a time-step
+      dx = x + vx*dt
+      dy = y + vy*dt
+c reflecting boundary conditions
+      if (ipbc.eq.2) then
+         if ((dx.lt.edgelx).or.(dx.ge.edgerx)) then
+            dx = ppart(1,j,k)
+            ppart(3,j,k) = -ppart(3,j,k)
+         endif
+         if ((dy.lt.edgely).or.(dy.ge.edgery)) then
+            dy = ppart(2,j,k)
+            ppart(4,j,k) = -ppart(4,j,k)
+         endif
+c mixed reflecting/periodic boundary conditions
+      else if (ipbc.eq.3) then
+         if ((dx.lt.edgelx).or.(dx.ge.edgerx)) then
+            dx = ppart(1,j,k)
+            ppart(3,j,k) = -ppart(3,j,k)
+         endif
+      endif
+c set new position
+      ppart(1,j,k) = dx
+      ppart(2,j,k) = dy
+   30 continue
+c deposit current to interior and edge points in global array
+      nn = min(mx+1,nxv-noff)
+      mm = min(my+1,nyv-moff)
+      do 50 j = 1, mm
+      do 40 i = 1, nn
+      cu(1,i+noff,j+moff) = cu(1,i+noff,j+moff) + scu(1,i,j)
+      cu(2,i+noff,j+moff) = cu(2,i+noff,j+moff) + scu(2,i,j)
+      cu(3,i+noff,j+moff) = cu(3,i+noff,j+moff) + scu(3,i,j)
+   40 continue
+   50 continue
+   80 continue
+!$OMP END DO
+c implicit barrier ends each color
+   90 continue
+!$OMP END PARALLEL
+      return
+      end
 c-----------------------------------------------------------------------
       subroutine GJPPOSTF2L(ppart,cu,kpic,ncl,ihole,qm,dt,nppmx,idimp,nx
      1,ny,mx,my,nxv,nyv,mx1,mxy1,ntmax,irc)
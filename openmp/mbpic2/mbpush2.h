@@ -47,6 +47,10 @@ void cgjppost2l(float ppart[], float cu[], int kpic[], float qm,
                 float dt, int nppmx, int idimp, int nx, int ny, int mx,
                 int my, int nxv, int nyv, int mx1, int mxy1, int ipbc);
 
+void cgjppost2lc(float ppart[], float cu[], int kpic[], float qm,
+                 float dt, int nppmx, int idimp, int nx, int ny, int mx,
+                 int my, int nxv, int nyv, int mx1, int mxy1, int ipbc);
+
 void cgjppostf2l(float ppart[], float cu[], int kpic[], int ncl[],
                  int ihole[], float qm, float dt, int nppmx, int idimp,
                  int nx, int ny, int mx, int my, int nxv, int nyv,
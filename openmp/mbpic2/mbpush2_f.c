@@ -57,6 +57,11 @@ void gjppost2l_(float *ppart, float *cu, int *kpic, float *qm,
                 int *mx, int *my, int *nxv, int *nyv, int *mx1,
                 int *mxy1, int *ipbc);
 
+void gjppost2lc_(float *ppart, float *cu, int *kpic, float *qm,
+                 float *dt, int *nppmx, int *idimp, int *nx, int *ny,
+                 int *mx, int *my, int *nxv, int *nyv, int *mx1,
+                 int *mxy1, int *ipbc);
+
 void gjppostf2l_(float *ppart, float *cu, int *kpic, int *ncl,
                  int *ihole, float *qm, float *dt, int *nppmx, 
                  int *idimp, int *nx, int *ny, int *mx, int *my,
@@ -237,6 +242,15 @@ void cgjppost2l(float ppart[], float cu[], int kpic[], float qm,
    return;
 }
 
+/*--------------------------------------------------------------------*/
+void cgjppost2lc(float ppart[], float cu[], int kpic[], float qm,
+                 float dt, int nppmx, int idimp, int nx, int ny, int mx,
+                 int my, int nxv, int nyv, int mx1, int mxy1, int ipbc) {
+   gjppost2lc_(ppart,cu,kpic,&qm,&dt,&nppmx,&idimp,&nx,&ny,&mx,&my,&nxv,
+               &nyv,&mx1,&mxy1,&ipbc);
+   return;
+}
+
 /*--------------------------------------------------------------------*/
 void cgjppostf2l(float ppart[], float cu[], int kpic[], int ncl[],
                  int ihole[], float qm, float dt, int nppmx, int idimp,
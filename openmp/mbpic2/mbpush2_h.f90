@@ -134,6 +134,19 @@
          integer, dimension(mxy1), intent(in) :: kpic
          end subroutine
       end interface
+!
+      interface
+         subroutine GJPPOST2LC(ppart,cu,kpic,qm,dt,nppmx,idimp,nx,ny,mx,&
+     &my,nxv,nyv,mx1,mxy1,ipbc)
+         implicit none
+         integer, intent(in) :: nppmx, idimp, nx, ny, mx, my, nxv, nyv
+         integer, intent(in) :: mx1, mxy1, ipbc
+         real, intent(in) :: qm, dt
+         real, dimension(idimp,nppmx,mxy1), intent(inout) :: ppart
+         real, dimension(3,nxv,nyv), intent(inout) :: cu
+         integer, dimension(mxy1), intent(in) :: kpic
+         end subroutine
+      end interface
 !
       interface
          subroutine GJPPOSTF2L(ppart,cu,kpic,ncl,ihole,qm,dt,nppmx,idimp&
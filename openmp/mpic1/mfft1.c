@@ -0,0 +1,368 @@
+/* parallel real to complex fft and field library for 1D OpenMP PIC */
+/* codes */
+/* written for the skeleton PIC codes */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <complex.h>
+#include <math.h>
+#include "mfft1.h"
+
+/* NTRB = number of elements in a row copied at a time in a transpose */
+#define NTRB                  64
+
+/*--------------------------------------------------------------------*/
+static void cfftpnl(float gr[], float gi[], int isign, int mixup[],
+                    float complex sct[], int indn, int nxh, int nx,
+                    int nb, int nbd) {
+/* this subroutine performs nb complex fast fourier transforms of length
+   n = 2**indn stored in a panel, with the element index slow and the
+   transform index fast, so that each butterfly is applied to nb unit
+   stride elements at once.  the panel is stored as separate real and
+   imaginary parts so that the butterflies do not need complex
+   arithmetic
+   gr/gi[k][j] = real/imaginary part of element k of transform j
+   isign = (-1,1) = (inverse,forward) transform
+   mixup = array of bit reversed addresses
+   sct = sine/cosine table
+   nxh/nx = half/whole length of real transform, used to set up tables
+   nb = number of transforms
+   nbd = second dimension of gr/gi >= nb
+local data                                                            */
+   int n, nh, nrb, nr, ns, ns2, km, kmr, i, j, k, l, j1, j2, k1, k2;
+   float wr, wi, tr, ti;
+   n = 1L<<indn;
+   nh = n/2;
+   nrb = nxh/n;
+   nr = nx/n;
+/* bit-reverse array elements */
+   for (k = 0; k < n; k++) {
+      k1 = (mixup[k] - 1)/nrb;
+      if (k < k1) {
+         j1 = nbd*k;
+         j2 = nbd*k1;
+         for (i = 0; i < nb; i++) {
+            tr = gr[i+j2];
+            ti = gi[i+j2];
+            gr[i+j2] = gr[i+j1];
+            gi[i+j2] = gi[i+j1];
+            gr[i+j1] = tr;
+            gi[i+j1] = ti;
+         }
+      }
+   }
+/* then transform */
+   ns = 1;
+   for (l = 0; l < indn; l++) {
+      ns2 = ns + ns;
+      km = nh/ns;
+      kmr = km*nr;
+      for (k = 0; k < km; k++) {
+         k1 = ns2*k;
+         k2 = k1 + ns;
+         for (j = 0; j < ns; j++) {
+            j1 = nbd*(j + k1);
+            j2 = nbd*(j + k2);
+            wr = crealf(sct[kmr*j]);
+            wi = cimagf(sct[kmr*j]);
+            if (isign > 0)
+               wi = -wi;
+            for (i = 0; i < nb; i++) {
+               tr = wr*gr[i+j2] - wi*gi[i+j2];
+               ti = wr*gi[i+j2] + wi*gr[i+j2];
+               gr[i+j2] = gr[i+j1] - tr;
+               gi[i+j2] = gi[i+j1] - ti;
+               gr[i+j1] += tr;
+               gi[i+j1] += ti;
+            }
+         }
+      }
+      ns = ns2;
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+static void cfft1rmn(float f[], float t[], int isign, int mixup[],
+                     float complex sct[], int indx, int ndim, int nxhd,
+                     int nblok) {
+/* this subroutine performs ndim one dimensional real to complex fast
+   fourier transforms and their inverses, using the four step algorithm
+   so that all threads share each transform.  the complex transform of
+   length N = nx/2 = N1*N2 is done as N2 transforms of length N1 with
+   stride N2, a multiplication by the twiddle factors W**(n2*k1), where
+   W = exp(-sqrt(-1)*2pi/N), and N1 transforms of length N2:
+   x(N2*n1+n2) -> y(k1,n2) -> X(k1+N1*k2)
+   each set of short transforms is divided into blocks of nblok
+   transforms, which are copied (or transposed) into a panel private to
+   each thread and transformed with cfftpnl.  the scrambling of the
+   real data into a complex transform is also done in parallel.
+   the data layout and results are the same as in FFT1RXX, FFT1R2X and
+   FFT1R3X, apart from rounding
+   f = input and output data, ndim components for each grid point:
+   for isign = -1, real f[ndim*j+c] for 0 <= j < nx, and complex
+   f[ndim*k+c] for fourier mode k on output.  for isign = 1, the reverse
+   t = scratch array, ndim complex arrays of length nxhd
+   isign = (-1,1) = (inverse,forward) transform
+   mixup = array of bit reversed addresses
+   sct = sine/cosine table
+   indx = exponent which determines length in x direction, nx=2**indx
+   ndim = number of components
+   nxhd = length of each component in t >= nx/2
+   nblok = number of transforms in a block
+local data                                                            */
+   int indx1, nx, nxh, nxhh, indn1, indn2, n1, n2, nb1, nb2;
+   int m, c, i, j, k, i0, nb, jj, j2, e, kk, joff, koff;
+   float ani, wr, wi;
+   float complex t1, t2, t3;
+   float *gr, *gi;
+   float complex *fc, *tc;
+   indx1 = indx - 1;
+   nx = 1L<<indx;
+   nxh = nx/2;
+   nxhh = nx/4;
+/* N1 <= N2 */
+   indn1 = indx1/2;
+   indn2 = indx1 - indn1;
+   n1 = 1L<<indn1;
+   n2 = 1L<<indn2;
+   nb1 = (n1 - 1)/nblok + 1;
+   nb2 = (n2 - 1)/nblok + 1;
+   fc = (float complex *) f;
+   tc = (float complex *) t;
+   ani = 0.5/(float) nx;
+#pragma omp parallel private(m,c,i,j,k,i0,nb,jj,j2,e,kk,joff,koff,wr, \
+wi,t1,t2,t3,gr,gi)
+   {
+      gr = (float *) malloc(2*nblok*n2*sizeof(float));
+      gi = &gr[nblok*n2];
+/* inverse fourier transform: move real source to complex temporary */
+      if (isign < 0) {
+#pragma omp for
+         for (j = 0; j < nxh; j++) {
+            for (c = 0; c < ndim; c++) {
+               koff = 2*(nxhd*c + j);
+               t[koff] = f[ndim*2*j+c];
+               t[koff+1] = f[ndim*(2*j+1)+c];
+            }
+         }
+      }
+/* forward fourier transform: move complex source to temporary */
+      else {
+#pragma omp for
+         for (j = 0; j < nxh; j++) {
+            for (c = 0; c < ndim; c++) {
+               tc[nxhd*c+j] = fc[ndim*j+c];
+            }
+         }
+/* scramble coefficients */
+#pragma omp for
+         for (j = 1; j < nxhh; j++) {
+            t3 = cimagf(sct[j]) + crealf(sct[j])*_Complex_I;
+            for (c = 0; c < ndim; c++) {
+               joff = nxhd*c;
+               t2 = conjf(tc[nxh-j+joff]);
+               t1 = tc[j+joff] + t2;
+               t2 = (tc[j+joff] - t2)*t3;
+               tc[j+joff] = t1 + t2;
+               tc[nxh-j+joff] = conjf(t1 - t2);
+            }
+         }
+#pragma omp single
+         for (c = 0; c < ndim; c++) {
+            joff = nxhd*c;
+            tc[nxhh+joff] = 2.0*conjf(tc[nxhh+joff]);
+            t1 = tc[joff];
+            tc[joff] = (crealf(t1) + cimagf(t1))
+                       + (crealf(t1) - cimagf(t1))*_Complex_I;
+         }
+      }
+/* transforms of length N1 with stride N2, by blocks of columns n2 */
+#pragma omp for
+      for (m = 0; m < ndim*nb2; m++) {
+         c = m/nb2;
+         i0 = nblok*(m%nb2);
+         nb = n2 - i0;
+         nb = nb < nblok ? nb : nblok;
+         joff = 2*(nxhd*c + i0);
+         for (k = 0; k < n1; k++) {
+            koff = joff + 2*n2*k;
+            kk = nblok*k;
+            for (i = 0; i < nb; i++) {
+               gr[i+kk] = t[2*i+koff];
+               gi[i+kk] = t[2*i+1+koff];
+            }
+         }
+         cfftpnl(gr,gi,isign,mixup,sct,indn1,nxh,nx,nb,nblok);
+/* multiply by twiddle factors W**(n2*k1) and copy panel back */
+/* W**e = sct[2*e] = -sct[2*e-N] */
+         for (k = 0; k < n1; k++) {
+            koff = joff + 2*n2*k;
+            kk = nblok*k;
+            for (i = 0; i < nb; i++) {
+               e = 2*k*(i + i0);
+               if (e < nxh) {
+                  wr = crealf(sct[e]);
+                  wi = cimagf(sct[e]);
+               }
+               else {
+                  wr = -crealf(sct[e-nxh]);
+                  wi = -cimagf(sct[e-nxh]);
+               }
+               if (isign > 0)
+                  wi = -wi;
+               t[2*i+koff] = wr*gr[i+kk] - wi*gi[i+kk];
+               t[2*i+1+koff] = wr*gi[i+kk] + wi*gr[i+kk];
+            }
+         }
+      }
+/* transforms of length N2 with unit stride, by blocks of rows k1 */
+#pragma omp for
+      for (m = 0; m < ndim*nb1; m++) {
+         c = m/nb1;
+         i0 = nblok*(m%nb1);
+         nb = n1 - i0;
+         nb = nb < nblok ? nb : nblok;
+         joff = 2*(nxhd*c + n2*i0);
+/* transpose block of rows into panel, NTRB elements at a time */
+         for (jj = 0; jj < n2; jj += NTRB) {
+            j2 = jj + NTRB < n2 ? jj + NTRB : n2;
+            for (i = 0; i < nb; i++) {
+               koff = joff + 2*n2*i;
+               for (j = jj; j < j2; j++) {
+                  gr[i+nblok*j] = t[2*j+koff];
+                  gi[i+nblok*j] = t[2*j+1+koff];
+               }
+            }
+         }
+         cfftpnl(gr,gi,isign,mixup,sct,indn2,nxh,nx,nb,nblok);
+/* copy panel to element k1 + N1*k2 of destination */
+         for (k = 0; k < n2; k++) {
+            kk = nblok*k;
+            j = i0 + n1*k;
+/* complex destination */
+            if (isign < 0) {
+               for (i = 0; i < nb; i++) {
+                  koff = 2*(ndim*(i + j) + c);
+                  f[koff] = gr[i+kk];
+                  f[koff+1] = gi[i+kk];
+               }
+            }
+/* real destination */
+            else {
+               for (i = 0; i < nb; i++) {
+                  koff = 2*ndim*(i + j) + c;
+                  f[koff] = gr[i+kk];
+                  f[koff+ndim] = gi[i+kk];
+               }
+            }
+         }
+      }
+/* unscramble coefficients and normalize */
+      if (isign < 0) {
+#pragma omp for
+         for (j = 1; j < nxhh; j++) {
+            t3 = cimagf(sct[j]) - crealf(sct[j])*_Complex_I;
+            for (c = 0; c < ndim; c++) {
+               t2 = conjf(fc[ndim*(nxh-j)+c]);
+               t1 = fc[ndim*j+c] + t2;
+               t2 = (fc[ndim*j+c] - t2)*t3;
+               fc[ndim*j+c] = ani*(t1 + t2);
+               fc[ndim*(nxh-j)+c] = ani*conjf(t1 - t2);
+            }
+         }
+#pragma omp single
+         for (c = 0; c < ndim; c++) {
+            fc[ndim*nxhh+c] = 2.0*ani*conjf(fc[ndim*nxhh+c]);
+            t1 = fc[c];
+            fc[c] = 2.0*ani*((crealf(t1) + cimagf(t1))
+                    + (crealf(t1) - cimagf(t1))*_Complex_I);
+         }
+      }
+      free(gr);
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cfft1rmx(float complex f[], float complex t[], int isign,
+              int mixup[], float complex sct[], int indx, int nxd,
+              int nxhd, int nblok) {
+/* this subroutine performs a one dimensional real to complex fast
+   fourier transform and its inverse in parallel, with the same
+   arguments and results as cfft1rxx, apart from rounding.
+   for isign = -1, input: f, output: f, t
+   for isign = 1, input: f, output: f, t
+   f = input and output data
+   t = complex scratch array
+   isign = (-1,1) = (inverse,forward) transform
+   if isign = 0, nothing is done, the tables are prepared by cwfft1rinit
+   mixup = array of bit reversed addresses
+   sct = sine/cosine table
+   indx = exponent which determines length in x direction, nx=2**indx
+   nxd = dimension of f >= nx
+   nxhd = dimension of t >= nx/2
+   nblok = number of short transforms done together in a block
+local data                                                            */
+   if (isign==0)
+      return;
+   cfft1rmn((float *)f,(float *)t,isign,mixup,sct,indx,1,nxhd,nblok);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cmpois1(float complex q[], float complex fx[], int isign,
+             float complex ffc[], float ax, float affp, float *we,
+             int nx) {
+/* this subroutine solves 1d poisson's equation in fourier space for
+   force/charge (or convolution of electric field over particle shape)
+   with periodic boundary conditions, with the modes divided among the
+   threads.  the results are the same as in cpois1, apart from the
+   rounding of the energy sum.
+   for isign = 0, input: isign,ax,affp,nx, output: ffc
+   for isign  /= 0, input: q,ffc,isign,nx, output: fx,we
+   q = charge density in fourier space, with the packed layout of
+   cfft1rxx
+   fx = force/charge in fourier space, with the same layout
+   ffc = complex form factor array, real part = potential, imaginary
+   part = smoothing
+   ax = half-width of particle in x direction
+   affp = normalization constant = nx/np
+   we = electric field energy
+   nx = system length in x direction
+local data                                                            */
+   int j, nxh;
+   float dnx, dkx, at1, at2;
+   float *qr, *fr, *ffr;
+   double wp;
+   nxh = nx/2;
+   dnx = 6.28318530717959/(float) nx;
+   qr = (float *) q;
+   fr = (float *) fx;
+   ffr = (float *) ffc;
+   if (isign==0) {
+#pragma omp parallel for private(j,dkx)
+      for (j = 1; j < nxh; j++) {
+         dkx = dnx*(float) j;
+         ffr[2*j+1] = exp(-.5*((dkx*ax)*(dkx*ax)));
+         ffr[2*j] = affp*ffr[2*j+1]/(dkx*dkx);
+      }
+      ffr[0] = affp;
+      ffr[1] = 1.0;
+      return;
+   }
+/* calculate force/charge and sum field energy */
+   wp = 0.0;
+#pragma omp parallel for private(j,at1,at2) reduction(+:wp)
+   for (j = 1; j < nxh; j++) {
+      at1 = ffr[2*j]*ffr[2*j+1];
+      at2 = dnx*(float) j*at1;
+      fr[2*j] = at2*qr[2*j+1];
+      fr[2*j+1] = -at2*qr[2*j];
+      wp += at1*(qr[2*j]*qr[2*j] + qr[2*j+1]*qr[2*j+1]);
+   }
+   fr[0] = 0.0;
+   fr[1] = 0.0;
+   *we = ((float) nx)*wp;
+   return;
+}
@@ -0,0 +1,9 @@
+/* header file for mfft1.c */
+
+void cfft1rmx(float complex f[], float complex t[], int isign,
+              int mixup[], float complex sct[], int indx, int nxd,
+              int nxhd, int nblok);
+
+void cmpois1(float complex q[], float complex fx[], int isign,
+             float complex ffc[], float ax, float affp, float *we,
+             int nx);
@@ -0,0 +1,160 @@
+/* particle buffer growth library for 1D OpenMP PIC codes */
+/* written for the skeleton PIC codes */
+
+#include <stdlib.h>
+#include <string.h>
+#include "mgrow1.h"
+
+/*--------------------------------------------------------------------*/
+int cgrowsize(int nold, int nneed, int nmin, float xtras, int kgrow) {
+/* this function returns a new size for a particle buffer of size nold
+   which needs to hold nneed entries.
+   if nneed > nold, the buffer grows by at least half its size, so that
+   the number of reallocations grows only logarithmically.
+   if kgrow = 2 and less than a quarter of the buffer is needed, it
+   shrinks to (1+xtras)*nneed, but not below nmin.
+   otherwise nold is returned
+   nmin = initial size of buffer
+   xtras = fraction of extra entries kept after shrinking
+   kgrow = (1,2) = (grow only,grow and shrink)
+local data                                                            */
+   int n;
+   if (nneed > nold) {
+      n = nold + nold/2;
+      return nneed > n ? nneed : n;
+   }
+   if ((kgrow==2) && (4*nneed < nold)) {
+      n = (1.0 + xtras)*nneed;
+      return n > nmin ? n : nmin;
+   }
+   return nold;
+}
+
+/*--------------------------------------------------------------------*/
+void *cgrowtile(void *a, int nold, int nnew, int ntile, int nsize) {
+/* this function copies a tiled array a[ntile][nold] with elements of
+   nsize bytes into a newly allocated array b[ntile][nnew], and frees a.
+   the first min(nold,nnew) elements of each tile are copied.
+   returns b, or NULL if there is not enough memory, in which case a is
+   not freed
+local data                                                            */
+   int k, n;
+   char *b;
+   b = (char *) malloc((size_t) nnew*ntile*nsize);
+   if (b==NULL)
+      return NULL;
+   n = nold < nnew ? nold : nnew;
+   for (k = 0; k < ntile; k++) {
+      memcpy(b+(size_t) nnew*nsize*k,(char *) a+(size_t) nold*nsize*k,
+             (size_t) n*nsize);
+   }
+   free(a);
+   return b;
+}
+
+/*--------------------------------------------------------------------*/
+void cppneed1l(int kpic[], int ncl[], int mx1, int *nhmax,
+               int *nppmax) {
+/* this subroutine finds the buffer sizes needed by cpporderf1l to
+   reorder particles, from the number of particles leaving each tile
+   in each direction, as found by cgppushf1l or cppholes1l.
+   the tile arrays are assumed to be periodic
+   input: kpic, ncl, mx1, output: nhmax, nppmax
+   kpic[k] = number of particles in tile k
+   ncl[k][i] = number of particles going to destination i, tile k
+   mx1 = (system length in x direction - 1)/mx + 1
+   nhmax = maximum number of particles leaving any tile, the size
+   needed for ppbuff and ihole
+   nppmax = maximum number of particles held by any tile while particles
+   are being reordered, the size needed for ppart
+local data                                                            */
+   int k, kl, kr, nh, nn, npp;
+   nh = 0;
+   npp = 0;
+   for (k = 0; k < mx1; k++) {
+      kl = k > 0 ? k - 1 : mx1 - 1;
+      kr = k < mx1 - 1 ? k + 1 : 0;
+      nn = ncl[2*k] + ncl[1+2*k];
+      nh = nn > nh ? nn : nh;
+/* holes are filled first, the rest is added at the end of the tile */
+      nn = ncl[1+2*kl] + ncl[2*kr] - nn;
+      nn = kpic[k] + (nn > 0 ? nn : 0);
+      npp = nn > npp ? nn : npp;
+   }
+   *nhmax = nh;
+   *nppmax = npp;
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cppholes1l(float ppart[], int kpic[], int ncl[], int ihole[],
+                int idimp, int nppmx, int nx, int mx, int mx1,
+                int ntmax, int *irc) {
+/* this subroutine finds particles which have left their tile after a
+   push with cgppushf1l, and stores their number in each direction,
+   location, and destination in ncl and ihole, as cgppushf1l does.
+   it is used to recover when ihole overflowed in cgppushf1l, after
+   ihole has been enlarged.  particle positions have already been
+   wrapped by periodic boundary conditions, so the direction in which
+   a particle left is taken from the sign of its velocity.
+   input: all except ncl, ihole, irc, output: ncl, ihole, irc
+   ppart[k][n][0] = position x of particle n in tile k
+   ppart[k][n][1] = velocity vx of particle n in tile k
+   kpic[k] = number of particles in tile k
+   ncl[k][i] = number of particles going to destination i, tile k
+   ihole[k][:][0] = location of hole in array left by departing particle
+   ihole[k][:][1] = direction destination of particle leaving hole
+   all for tile k
+   ihole[k][0][0] = ih, number of holes left (error, if negative)
+   idimp = size of phase space = 2
+   nppmx = maximum number of particles in tile
+   nx = system length in x direction
+   mx = number of grids in sorting cell in x
+   mx1 = (system length in x direction - 1)/mx + 1
+   ntmax = size of hole array for particles leaving tiles
+   irc = maximum overflow, returned only if error occurs, when irc > 0
+local data                                                            */
+   int noff, npp, npoff, nn, ih, nh, ist, j, k;
+   float edgelx, edgerx, dx;
+#pragma omp parallel for \
+private(j,k,noff,npp,npoff,nn,ih,nh,ist,dx,edgelx,edgerx)
+   for (k = 0; k < mx1; k++) {
+      noff = mx*k;
+      npp = kpic[k];
+      npoff = nppmx*k;
+      nn = nx - noff;
+      nn = mx < nn ? mx : nn;
+      edgelx = noff;
+      edgerx = noff + nn;
+      ih = 0;
+      nh = 0;
+      ncl[2*k] = 0;
+      ncl[1+2*k] = 0;
+/* loop over particles in tile */
+      for (j = 0; j < npp; j++) {
+         dx = ppart[idimp*(j+npoff)];
+/* ist = direction particle is going */
+         ist = 0;
+         if ((dx < edgelx) || (dx >= edgerx))
+            ist = ppart[1+idimp*(j+npoff)] > 0.0f ? 2 : 1;
+         if (ist > 0) {
+            ncl[ist+2*k-1] += 1;
+            ih += 1;
+            if (ih <= ntmax) {
+               ihole[2*(ih+(ntmax+1)*k)] = j + 1;
+               ihole[1+2*(ih+(ntmax+1)*k)] = ist;
+            }
+            else {
+               nh = 1;
+            }
+         }
+      }
+/* set error */
+      if (nh > 0) {
+         *irc = ih;
+         ih = -ih;
+      }
+      ihole[2*(ntmax+1)*k] = ih;
+   }
+   return;
+}
@@ -0,0 +1,12 @@
+/* header file for mgrow1.c */
+
+int cgrowsize(int nold, int nneed, int nmin, float xtras, int kgrow);
+
+void *cgrowtile(void *a, int nold, int nnew, int ntile, int nsize);
+
+void cppneed1l(int kpic[], int ncl[], int mx1, int *nhmax,
+               int *nppmax);
+
+void cppholes1l(float ppart[], int kpic[], int ncl[], int ihole[],
+                int idimp, int nppmx, int nx, int mx, int mx1,
+                int ntmax, int *irc);
@@ -7,6 +7,9 @@
 #include <sys/time.h>
 #include "mpush1.h"
 #include "omplib.h"
+#include "mgrow1.h"
+#include "cfglib.h"
+#include "mfft1.h"
 
 void dtimer(double *time, struct timeval *itime, int icntrl);
 
@@ -34,6 +37,12 @@ int main(int argc, char *argv[]) {
    int mx = 32;
 /* xtras = fraction of extra particles needed for particle management */
    float xtras = 0.2;
+/* kgrow = (0,1,2) = on particle buffer overflow (stop with error,grow */
+/* buffers,grow and shrink buffers)                                     */
+   int kgrow = 1;
+/* kfft = (0,1) = use (standard,parallel) fft and poisson solver */
+/* nbfft = number of short ffts transformed together when kfft=1 */
+   int kfft = 0, nbfft = 16;
 /* declare scalars for standard code */
    int j;
    int np, nx, nxh, nxe;
@@ -43,6 +52,10 @@ int main(int argc, char *argv[]) {
 /* declare scalars for OpenMP code */
    int nppmx, nppmx0, ntmax, npbmx, irc;
    int nvp;
+/* nppmin/ntmin/npbmin = initial sizes of particle buffers */
+/* nh/npp = buffer sizes needed to reorder particles */
+/* ngrow/nshrink = number of times buffers were enlarged/reduced */
+   int nppmin, ntmin, npbmin, nh, npp, n, ngrow = 0, nshrink = 0;
 
 /* declare arrays for standard code: */
 /* part = particle array */
@@ -81,6 +94,22 @@ int main(int argc, char *argv[]) {
    nvp = 0;
 /* printf("enter number of nodes:\n"); */
 /* scanf("%i",&nvp);                   */
+/* replace parameters with values from input decks or command line, */
+/* for example: cmpic1_f indx=20 npx=1048576 kfft=1                  */
+   irc = ccfgread(argc,argv,1);
+   ccfgint("indx",&indx); ccfgint("npx",&npx); ccfgflt("tend",&tend);
+   ccfgflt("dt",&dt); ccfgflt("vtx",&vtx); ccfgflt("vx0",&vx0);
+   ccfgint("mx",&mx); ccfgflt("xtras",&xtras); ccfgint("kgrow",&kgrow);
+   ccfgint("nvp",&nvp); ccfgint("kfft",&kfft); ccfgint("nbfft",&nbfft);
+   irc += ccfgend();
+   if (irc != 0) {
+      printf("invalid run time parameters\n");
+      exit(1);
+   }
+   if (nbfft < 1) {
+      printf("invalid fft block size, nbfft=%d\n",nbfft);
+      exit(1);
+   }
 /* initialize for shared memory parallel processing */
    cinit_omp(nvp);
 
@@ -129,6 +158,7 @@ int main(int argc, char *argv[]) {
    ppbuff = (float *) malloc(idimp*npbmx*mx1*sizeof(float));
    ncl = (int *) malloc(2*mx1*sizeof(int));
    ihole = (int *) malloc(2*(ntmax+1)*mx1*sizeof(int));
+   nppmin = nppmx0; ntmin = ntmax; npbmin = npbmx;
 /* copy ordered particle data for OpenMP: updates ppart and kpic */
    cppmovin1l(part,ppart,kpic,nppmx0,idimp,np,mx,mx1,&irc);
    if (irc != 0) { 
@@ -169,8 +199,14 @@ L500: if (nloop <= ntime)
 /* updates qe, fxe */
       dtimer(&dtime,&itime,-1);
       isign = -1;
-      cfft1rxx((float complex *)qe,(float complex *)fxe,isign,mixup,sct,
-               indx,nxe,nxh);
+      if (kfft==1) {
+         cfft1rmx((float complex *)qe,(float complex *)fxe,isign,mixup,
+                  sct,indx,nxe,nxh,nbfft);
+      }
+      else {
+         cfft1rxx((float complex *)qe,(float complex *)fxe,isign,mixup,
+                  sct,indx,nxe,nxh);
+      }
       dtimer(&dtime,&itime,1);
       time = (float) dtime;
       tfft += time;
@@ -179,8 +215,14 @@ L500: if (nloop <= ntime)
 /* updates fxe, we */
       dtimer(&dtime,&itime,-1);
       isign = -1;
-      cpois1((float complex *)qe,(float complex *)fxe,isign,ffc,ax,affp,
-             &we,nx);
+      if (kfft==1) {
+         cmpois1((float complex *)qe,(float complex *)fxe,isign,ffc,ax,
+                 affp,&we,nx);
+      }
+      else {
+         cpois1((float complex *)qe,(float complex *)fxe,isign,ffc,ax,
+                affp,&we,nx);
+      }
       dtimer(&dtime,&itime,1);
       time = (float) dtime;
       tfield += time;
@@ -189,8 +231,14 @@ L500: if (nloop <= ntime)
 /* updates fxe, qe */
       dtimer(&dtime,&itime,-1);
       isign = 1;
-      cfft1rxx((float complex *)fxe,(float complex *)qe,isign,mixup,sct,
-               indx,nxe,nxh);
+      if (kfft==1) {
+         cfft1rmx((float complex *)fxe,(float complex *)qe,isign,mixup,
+                  sct,indx,nxe,nxh,nbfft);
+      }
+      else {
+         cfft1rxx((float complex *)fxe,(float complex *)qe,isign,mixup,
+                  sct,indx,nxe,nxh);
+      }
       dtimer(&dtime,&itime,1);
       time = (float) dtime;
       tfft += time;
@@ -214,13 +262,63 @@ L500: if (nloop <= ntime)
       dtimer(&dtime,&itime,1);
       time = (float) dtime;
       tpush += time;
+
+/* reorder particles by tile with OpenMP: */
+      dtimer(&dtime,&itime,-1);
+      if ((irc != 0) && (kgrow > 0)) {
+/* enlarge ihole and find departing particles again */
+         cppneed1l(kpic,ncl,mx1,&nh,&npp);
+         ntmax = cgrowsize(ntmax,nh,ntmin,xtras,1);
+         free(ihole);
+         ihole = (int *) malloc(2*(ntmax+1)*mx1*sizeof(int));
+         irc = 0;
+         if (ihole==NULL)
+            irc = -1;
+         else
+            cppholes1l(ppart,kpic,ncl,ihole,idimp,nppmx0,nx,mx,mx1,
+                       ntmax,&irc);
+         ngrow += 1;
+      }
       if (irc != 0) {
          printf("cgppushf1l error: irc=%d\n",irc);
          exit(1);
       }
-
-/* reorder particles by tile with OpenMP: */
-      dtimer(&dtime,&itime,-1);
+/* check particle buffer sizes, enlarge or reduce them if needed */
+      if (kgrow > 0) {
+         cppneed1l(kpic,ncl,mx1,&nh,&npp);
+         n = cgrowsize(npbmx,nh,npbmin,xtras,kgrow);
+         if (n != npbmx) {
+            if (n > npbmx) ngrow += 1; else nshrink += 1;
+            npbmx = n;
+            free(ppbuff);
+            ppbuff = (float *) malloc(idimp*npbmx*mx1*sizeof(float));
+            if (ppbuff==NULL)
+               irc = -1;
+         }
+         n = cgrowsize(nppmx0,npp,nppmin,xtras,kgrow);
+         if ((n != nppmx0) && (irc==0)) {
+            if (n > nppmx0) ngrow += 1; else nshrink += 1;
+            ppart = (float *) cgrowtile(ppart,nppmx0,n,mx1,
+                                        idimp*sizeof(float));
+            nppmx0 = n;
+            if (ppart==NULL)
+               irc = -1;
+         }
+/* ihole holds the holes found by the push, so it is only reduced here */
+         n = cgrowsize(ntmax,nh,ntmin,xtras,kgrow);
+         if ((n < ntmax) && (irc==0)) {
+            nshrink += 1;
+            ihole = (int *) cgrowtile(ihole,ntmax+1,n+1,mx1,
+                                      2*sizeof(int));
+            ntmax = n;
+            if (ihole==NULL)
+               irc = -1;
+         }
+         if (irc != 0) {
+            printf("particle buffer allocation error: irc=%d\n",irc);
+            exit(1);
+         }
+      }
 /* updates ppart, ppbuff, kpic, ncl, ihole, and irc */
 /*    cpporder1l(ppart,ppbuff,kpic,ncl,ihole,idimp,nppmx0,nx,mx,mx1, */
 /*               npbmx,ntmax,&irc);                                  */
@@ -246,6 +344,11 @@ L2000:
 /* * * * end main iteration loop * * * */
 
    printf("ntime = %i\n",ntime);
+   if ((ngrow + nshrink) > 0) {
+      printf("particle buffers enlarged/reduced = %d,%d\n",ngrow,nshrink);
+      printf("final nppmx0, npbmx, ntmax = %d,%d,%d\n",nppmx0,npbmx,
+             ntmax);
+   }
    printf("Final Field, Kinetic and Total Energies:\n");
    printf("%e %e %e\n",we,wke,wke+we);
 
@@ -0,0 +1,166 @@
+/*---------------------------------------------------------------------*/
+/* FFT benchmark for 2D OpenMP PIC codes */
+/* compares the cache blocked ffts in mfft2.c with those in mpush2.c */
+#include <stdlib.h>
+#include <stdio.h>
+#include <complex.h>
+#include <math.h>
+#include <sys/time.h>
+#include "mpush2.h"
+#include "omplib.h"
+#include "cfglib.h"
+#include "mfft2.h"
+
+/*--------------------------------------------------------------------*/
+static double cbenchtime() {
+/* this function returns the wall clock time in seconds
+local data                                                            */
+   struct timeval tv;
+   gettimeofday(&tv,NULL);
+   return (double) tv.tv_sec + 1.0e-6*(double) tv.tv_usec;
+}
+
+/*--------------------------------------------------------------------*/
+static float cmaxdiff(float f[], float g[], int n) {
+/* this function returns the maximum absolute difference between f and
+   g, relative to the maximum absolute value of f
+local data                                                            */
+   int j;
+   float fmax = 0.0, dmax = 0.0;
+   for (j = 0; j < n; j++) {
+      fmax = fabsf(f[j]) > fmax ? fabsf(f[j]) : fmax;
+      dmax = fabsf(f[j]-g[j]) > dmax ? fabsf(f[j]-g[j]) : dmax;
+   }
+   if (fmax > 0.0)
+      dmax = dmax/fmax;
+   return dmax;
+}
+
+int main(int argc, char *argv[]) {
+/* indmin/indmax = smallest/largest exponent of grid sizes measured, */
+/* the grid is nx = ny = 2**ind                                      */
+   int indmin = 8, indmax = 13;
+/* nblok = number of rows or columns transformed together */
+   int nblok = 16;
+/* ntry = number of forward and inverse transforms timed */
+   int ntry = 4;
+/* nvp = number of shared memory nodes  (0=default) */
+   int nvp = 0;
+   int ind, indx, indy, nx, ny, nxh, nxe, nye, nxeh, nxyh, nxhy;
+   int j, k, n, l, irc;
+   double dtime, tf[4];
+   float err[2];
+   float *f = NULL, *f0 = NULL, *f1 = NULL;
+   int *mixup = NULL;
+   float complex *sct = NULL;
+
+/* replace parameters with values from command line, for example: */
+/* cfftbench2 indmin=8 indmax=11 nblok=8                          */
+   irc = ccfgread(argc,argv,1);
+   ccfgint("indmin",&indmin); ccfgint("indmax",&indmax);
+   ccfgint("nblok",&nblok); ccfgint("ntry",&ntry);
+   ccfgint("nvp",&nvp);
+   irc += ccfgend();
+   if ((irc != 0) || (nblok < 1) || (ntry < 1) || (indmin < 2)) {
+      printf("invalid run time parameters\n");
+      exit(1);
+   }
+   cinit_omp(nvp);
+
+   printf("times are msec for one inverse and one forward transform\n");
+   printf("%5s %9s %9s %7s %9s %9s %9s %7s %9s\n","grid","scalar",
+          "blocked","speedup","error","vector","blocked","speedup",
+          "error");
+   for (ind = indmin; ind <= indmax; ind++) {
+      indx = ind; indy = ind;
+      nx = 1L<<indx; ny = 1L<<indy; nxh = nx/2;
+      nxe = nx + 2; nye = ny + 1; nxeh = nxe/2;
+      nxyh = (nx > ny ? nx : ny)/2; nxhy = nxh > ny ? nxh : ny;
+      n = 2*nxe*nye;
+      f = (float *) malloc(n*sizeof(float));
+      f0 = (float *) malloc(n*sizeof(float));
+      f1 = (float *) malloc(n*sizeof(float));
+      mixup = (int *) malloc(nxhy*sizeof(int));
+      sct = (float complex *) malloc(nxyh*sizeof(float complex));
+      if ((f==NULL) || (f0==NULL) || (f1==NULL)) {
+         printf("grid %d x %d is too large\n",nx,ny);
+         exit(1);
+      }
+      cwfft2rinit(mixup,sct,indx,indy,nxhy,nxyh);
+/* random data in two components, zero in guard cells */
+      srand(1);
+      for (j = 0; j < n; j++) {
+         f0[j] = 0.0;
+      }
+      for (k = 0; k < ny; k++) {
+         for (j = 0; j < 2*nx; j++) {
+            f0[j+2*nxe*k] = (float) rand()/(float) RAND_MAX - 0.5;
+         }
+      }
+/* l = (0,1) = (scalar,vector) transform */
+      for (l = 0; l < 2; l++) {
+/* check blocked transform against existing one */
+         for (j = 0; j < n; j++) {
+            f[j] = f0[j];
+            f1[j] = f0[j];
+         }
+         if (l==0) {
+            cwfft2rmx((float complex *)f,-1,mixup,sct,indx,indy,nxeh,
+                      nye,nxhy,nxyh);
+            cwfft2rmxb((float complex *)f1,-1,mixup,sct,indx,indy,nxeh,
+                       nye,nxhy,nxyh,nblok);
+         }
+         else {
+            cwfft2rm2((float complex *)f,-1,mixup,sct,indx,indy,nxeh,
+                      nye,nxhy,nxyh);
+            cwfft2rm2b((float complex *)f1,-1,mixup,sct,indx,indy,nxeh,
+                       nye,nxhy,nxyh,nblok);
+         }
+         err[l] = cmaxdiff(f,f1,(l+1)*nxe*nye);
+/* time existing transform */
+         dtime = cbenchtime();
+         for (j = 0; j < ntry; j++) {
+            if (l==0) {
+               cwfft2rmx((float complex *)f,1,mixup,sct,indx,indy,nxeh,
+                         nye,nxhy,nxyh);
+               cwfft2rmx((float complex *)f,-1,mixup,sct,indx,indy,nxeh,
+                         nye,nxhy,nxyh);
+            }
+            else {
+               cwfft2rm2((float complex *)f,1,mixup,sct,indx,indy,nxeh,
+                         nye,nxhy,nxyh);
+               cwfft2rm2((float complex *)f,-1,mixup,sct,indx,indy,nxeh,
+                         nye,nxhy,nxyh);
+            }
+         }
+         tf[2*l] = 1.0e+3*(cbenchtime() - dtime)/(double) ntry;
+/* time blocked transform */
+         dtime = cbenchtime();
+         for (j = 0; j < ntry; j++) {
+            if (l==0) {
+               cwfft2rmxb((float complex *)f1,1,mixup,sct,indx,indy,
+                          nxeh,nye,nxhy,nxyh,nblok);
+               cwfft2rmxb((float complex *)f1,-1,mixup,sct,indx,indy,
+                          nxeh,nye,nxhy,nxyh,nblok);
+            }
+            else {
+               cwfft2rm2b((float complex *)f1,1,mixup,sct,indx,indy,
+                          nxeh,nye,nxhy,nxyh,nblok);
+               cwfft2rm2b((float complex *)f1,-1,mixup,sct,indx,indy,
+                          nxeh,nye,nxhy,nxyh,nblok);
+            }
+         }
+         tf[2*l+1] = 1.0e+3*(cbenchtime() - dtime)/(double) ntry;
+      }
+      printf("%5d %9.3f %9.3f %7.2f %9.2e %9.3f %9.3f %7.2f %9.2e\n",
+             nx,tf[0],tf[1],tf[0]/tf[1],err[0],tf[2],tf[3],tf[2]/tf[3],
+             err[1]);
+      free(f);
+      free(f0);
+      free(f1);
+      free(mixup);
+      free(sct);
+   }
+
+   return 0;
+}
@@ -0,0 +1,474 @@
+/* cache blocked real to complex fft library for 2D OpenMP PIC codes */
+/* written for the skeleton PIC codes */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <complex.h>
+#include "mpush2.h"
+#include "mfft2.h"
+
+/* NTRB = number of elements in a row copied at a time in a transpose */
+#define NTRB                  64
+
+/*--------------------------------------------------------------------*/
+static void cfftpnl(float gr[], float gi[], int isign, int mixup[],
+                    float complex sct[], int indn, int nxhy, int nxy,
+                    int nb, int nbd) {
+/* this subroutine performs nb complex fast fourier transforms of length
+   n = 2**indn stored in a panel, with the element index slow and the
+   transform index fast, so that each butterfly is applied to nb unit
+   stride elements at once.  the panel is stored as separate real and
+   imaginary parts so that the butterflies do not need complex
+   arithmetic
+   gr/gi[k][j] = real/imaginary part of element k of transform j
+   isign = (-1,1) = (inverse,forward) transform
+   mixup = array of bit reversed addresses
+   sct = sine/cosine table
+   nxhy/nxy = maximum of (nx/2,ny)/(nx,ny), used to set up tables
+   nb = number of transforms
+   nbd = second dimension of gr/gi >= nb
+local data                                                            */
+   int n, nh, nrb, nr, ns, ns2, km, kmr, i, j, k, l, j1, j2, k1, k2;
+   float wr, wi, tr, ti;
+   n = 1L<<indn;
+   nh = n/2;
+   nrb = nxhy/n;
+   nr = nxy/n;
+/* bit-reverse array elements */
+   for (k = 0; k < n; k++) {
+      k1 = (mixup[k] - 1)/nrb;
+      if (k < k1) {
+         j1 = nbd*k;
+         j2 = nbd*k1;
+         for (i = 0; i < nb; i++) {
+            tr = gr[i+j2];
+            ti = gi[i+j2];
+            gr[i+j2] = gr[i+j1];
+            gi[i+j2] = gi[i+j1];
+            gr[i+j1] = tr;
+            gi[i+j1] = ti;
+         }
+      }
+   }
+/* then transform */
+   ns = 1;
+   for (l = 0; l < indn; l++) {
+      ns2 = ns + ns;
+      km = nh/ns;
+      kmr = km*nr;
+      for (k = 0; k < km; k++) {
+         k1 = ns2*k;
+         k2 = k1 + ns;
+         for (j = 0; j < ns; j++) {
+            j1 = nbd*(j + k1);
+            j2 = nbd*(j + k2);
+            wr = crealf(sct[kmr*j]);
+            wi = cimagf(sct[kmr*j]);
+            if (isign > 0)
+               wi = -wi;
+            for (i = 0; i < nb; i++) {
+               tr = wr*gr[i+j2] - wi*gi[i+j2];
+               ti = wr*gi[i+j2] + wi*gr[i+j2];
+               gr[i+j2] = gr[i+j1] - tr;
+               gi[i+j2] = gi[i+j1] - ti;
+               gr[i+j1] += tr;
+               gi[i+j1] += ti;
+            }
+         }
+      }
+      ns = ns2;
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+static void cfftcols(float complex f[], int isign, int mixup[],
+                     float complex sct[], int indn, int ncol, int nlin,
+                     int ldl, int ldk, int nxhy, int nxy, int nblok) {
+/* this subroutine performs complex fast fourier transforms of length
+   n = 2**indn along the index of f with stride ldk.  there are ncol
+   adjacent transforms in each of nlin lines, where line m starts at
+   f[ldl*m].  blocks of nblok adjacent transforms are copied into a
+   panel private to each thread, transformed with cfftpnl, and copied
+   back, so that the strided accesses touch whole cache lines
+   isign = (-1,1) = (inverse,forward) transform
+   nxhy/nxy = maximum of (nx/2,ny)/(nx,ny), used to set up tables
+   nblok = number of transforms in a block
+local data                                                            */
+   int n, nbk, nt, m, i, k, i0, nb, joff, koff, kk;
+   float *fp, *gr, *gi;
+   n = 1L<<indn;
+   nbk = (ncol - 1)/nblok + 1;
+   nt = nbk*nlin;
+   fp = (float *) f;
+#pragma omp parallel private(m,i,k,i0,nb,joff,koff,kk,gr,gi)
+   {
+      gr = (float *) malloc(2*nblok*n*sizeof(float));
+      gi = &gr[nblok*n];
+#pragma omp for
+      for (m = 0; m < nt; m++) {
+         i0 = nblok*(m%nbk);
+         nb = ncol - i0;
+         nb = nb < nblok ? nb : nblok;
+         joff = ldl*(m/nbk) + i0;
+/* copy block of transforms into panel */
+         for (k = 0; k < n; k++) {
+            koff = 2*(joff + ldk*k);
+            kk = nblok*k;
+            for (i = 0; i < nb; i++) {
+               gr[i+kk] = fp[2*i+koff];
+               gi[i+kk] = fp[2*i+1+koff];
+            }
+         }
+         cfftpnl(gr,gi,isign,mixup,sct,indn,nxhy,nxy,nb,nblok);
+/* copy panel back */
+         for (k = 0; k < n; k++) {
+            koff = 2*(joff + ldk*k);
+            kk = nblok*k;
+            for (i = 0; i < nb; i++) {
+               fp[2*i+koff] = gr[i+kk];
+               fp[2*i+1+koff] = gi[i+kk];
+            }
+         }
+      }
+      free(gr);
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+static void cfftrows(float complex f[], int isign, int mixup[],
+                     float complex sct[], int indx, int nrow, int ldr,
+                     int nxhy, int nxy, float ani, int nblok) {
+/* this subroutine performs the x part of real to complex fast fourier
+   transforms of nrow rows of f, where row m starts at f[ldr*m].
+   blocks of nblok rows are transposed into a panel private to each
+   thread, so that the butterflies and the unscrambling of the
+   coefficients are applied to nblok rows at once, then transposed back
+   isign = (-1,1) = (inverse,forward) transform
+   indx = exponent which determines length in x direction
+   nxhy/nxy = maximum of (nx/2,ny)/(nx,ny), used to set up tables
+   ani = normalization of inverse transform
+   nblok = number of rows in a block
+local data                                                            */
+   int nx, nxh, nxhh, nbk, kmr, m, i, j, j0, jt, i0, nb, joff, j1, j2;
+   float an, t3r, t3i, ar, ai, br, bi, t1r, t1i, t2r, t2i;
+   float *fp, *gr, *gi;
+   nx = 1L<<indx;
+   nxh = nx/2;
+   nxhh = nx/4;
+   nbk = (nrow - 1)/nblok + 1;
+   kmr = nxy/nx;
+   fp = (float *) f;
+#pragma omp parallel \
+private(m,i,j,j0,jt,i0,nb,joff,j1,j2,an,t3r,t3i,ar,ai,br,bi,t1r,t1i, \
+t2r,t2i,gr,gi)
+   {
+      gr = (float *) malloc(2*nblok*nxh*sizeof(float));
+      gi = &gr[nblok*nxh];
+#pragma omp for
+      for (m = 0; m < nbk; m++) {
+         i0 = nblok*m;
+         nb = nrow - i0;
+         nb = nb < nblok ? nb : nblok;
+/* transpose block of rows into panel, NTRB elements at a time */
+         for (j0 = 0; j0 < nxh; j0 += NTRB) {
+            jt = j0 + NTRB < nxh ? j0 + NTRB : nxh;
+            for (i = 0; i < nb; i++) {
+               joff = 2*ldr*(i + i0);
+               for (j = j0; j < jt; j++) {
+                  gr[i+nblok*j] = fp[2*j+joff];
+                  gi[i+nblok*j] = fp[2*j+1+joff];
+               }
+            }
+         }
+/* scramble coefficients */
+         if (isign > 0) {
+            for (j = 1; j < nxhh; j++) {
+               t3r = cimagf(sct[kmr*j]);
+               t3i = crealf(sct[kmr*j]);
+               j1 = nblok*j;
+               j2 = nblok*(nxh - j);
+               for (i = 0; i < nb; i++) {
+                  ar = gr[i+j1];
+                  ai = gi[i+j1];
+                  br = gr[i+j2];
+                  bi = -gi[i+j2];
+                  t1r = ar + br;
+                  t1i = ai + bi;
+                  ar -= br;
+                  ai -= bi;
+                  t2r = ar*t3r - ai*t3i;
+                  t2i = ar*t3i + ai*t3r;
+                  gr[i+j1] = t1r + t2r;
+                  gi[i+j1] = t1i + t2i;
+                  gr[i+j2] = t1r - t2r;
+                  gi[i+j2] = t2i - t1i;
+               }
+            }
+            j1 = nblok*nxhh;
+            for (i = 0; i < nb; i++) {
+               gr[i+j1] = 2.0f*gr[i+j1];
+               gi[i+j1] = -2.0f*gi[i+j1];
+               ar = gr[i];
+               ai = gi[i];
+               gr[i] = ar + ai;
+               gi[i] = ar - ai;
+            }
+         }
+/* transform in x */
+         cfftpnl(gr,gi,isign,mixup,sct,indx-1,nxhy,nxy,nb,nblok);
+/* unscramble coefficients and normalize */
+         if (isign < 0) {
+            for (j = 1; j < nxhh; j++) {
+               t3r = cimagf(sct[kmr*j]);
+               t3i = -crealf(sct[kmr*j]);
+               j1 = nblok*j;
+               j2 = nblok*(nxh - j);
+               for (i = 0; i < nb; i++) {
+                  ar = gr[i+j1];
+                  ai = gi[i+j1];
+                  br = gr[i+j2];
+                  bi = -gi[i+j2];
+                  t1r = ar + br;
+                  t1i = ai + bi;
+                  ar -= br;
+                  ai -= bi;
+                  t2r = ar*t3r - ai*t3i;
+                  t2i = ar*t3i + ai*t3r;
+                  gr[i+j1] = ani*(t1r + t2r);
+                  gi[i+j1] = ani*(t1i + t2i);
+                  gr[i+j2] = ani*(t1r - t2r);
+                  gi[i+j2] = ani*(t2i - t1i);
+               }
+            }
+            an = 2.0*ani;
+            j1 = nblok*nxhh;
+            for (i = 0; i < nb; i++) {
+               gr[i+j1] = an*gr[i+j1];
+               gi[i+j1] = -an*gi[i+j1];
+               ar = gr[i];
+               ai = gi[i];
+               gr[i] = an*(ar + ai);
+               gi[i] = an*(ar - ai);
+            }
+         }
+/* transpose panel back */
+         for (j0 = 0; j0 < nxh; j0 += NTRB) {
+            jt = j0 + NTRB < nxh ? j0 + NTRB : nxh;
+            for (i = 0; i < nb; i++) {
+               joff = 2*ldr*(i + i0);
+               for (j = j0; j < jt; j++) {
+                  fp[2*j+joff] = gr[i+nblok*j];
+                  fp[2*j+1+joff] = gi[i+nblok*j];
+               }
+            }
+         }
+      }
+      free(gr);
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cfft2rmxxb(float complex f[], int isign, int mixup[],
+                float complex sct[], int indx, int indy, int nyi,
+                int nyp, int nxhd, int nyd, int nxhyd, int nxyhd,
+                int nblok) {
+/* this subroutine performs the x part of a two dimensional real to
+   complex fast fourier transform and its inverse, for a subset of y,
+   as in cfft2rmxx.  blocks of nblok rows are transposed into a private
+   panel, so that each butterfly is applied to nblok rows at once with
+   unit stride, then transposed back.  results are the same as
+   cfft2rmxx
+   nblok = number of rows in a block
+local data                                                            */
+   int indx1, indx1y, nx, ny, nxy, nxhy;
+   float ani;
+   if (isign==0)
+      return;
+   indx1 = indx - 1;
+   indx1y = indx1 > indy ? indx1 : indy;
+   nx = 1L<<indx;
+   ny = 1L<<indy;
+   nxy = nx > ny ? nx : ny;
+   nxhy = 1L<<indx1y;
+   ani = 0.5/(((float) nx)*((float) ny));
+   cfftrows(&f[nxhd*(nyi-1)],isign,mixup,sct,indx,nyp,nxhd,nxhy,nxy,
+            ani,nblok);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cfft2rmxyb(float complex f[], int isign, int mixup[],
+                float complex sct[], int indx, int indy, int nxi,
+                int nxp, int nxhd, int nyd, int nxhyd, int nxyhd,
+                int nblok) {
+/* this subroutine performs the y part of a two dimensional real to
+   complex fast fourier transform and its inverse, for a subset of x,
+   as in cfft2rmxy.  blocks of nblok columns are copied into a private
+   panel, so that each butterfly is applied to nblok columns at once
+   with unit stride, then copied back.  results are the same as
+   cfft2rmxy
+   nblok = number of columns in a block
+local data                                                            */
+   int indx1, indx1y, nx, ny, nyh, nxy, nxhy, k, k1, koff;
+   float complex t1;
+   if (isign==0)
+      return;
+   indx1 = indx - 1;
+   indx1y = indx1 > indy ? indx1 : indy;
+   nx = 1L<<indx;
+   ny = 1L<<indy;
+   nyh = ny/2;
+   nxy = nx > ny ? nx : ny;
+   nxhy = 1L<<indx1y;
+/* scramble modes kx = 0, nx/2 */
+   if ((isign > 0) && (nxi==1)) {
+      for (k = 1; k < nyh; k++) {
+         koff = nxhd*k;
+         k1 = nxhd*ny - koff;
+         t1 = cimagf(f[k1]) + crealf(f[k1])*_Complex_I;
+         f[k1] = conjf(f[koff] - t1);
+         f[koff] += t1;
+      }
+   }
+/* transform in y */
+   cfftcols(&f[nxi-1],isign,mixup,sct,indy,nxp,1,0,nxhd,nxhy,nxy,
+            nblok);
+/* unscramble modes kx = 0, nx/2 */
+   if ((isign < 0) && (nxi==1)) {
+      for (k = 1; k < nyh; k++) {
+         koff = nxhd*k;
+         k1 = nxhd*ny - koff;
+         t1 = f[k1];
+         f[k1] = 0.5*(cimagf(f[koff] + t1)
+                  + crealf(f[koff] - t1)*_Complex_I);
+         f[koff] = 0.5*(crealf(f[koff] + t1)
+                    + cimagf(f[koff] - t1)*_Complex_I);
+      }
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cfft2rm2yb(float complex f[], int isign, int mixup[],
+                float complex sct[], int indx, int indy, int nxi,
+                int nxp, int nxhd, int nyd, int nxhyd, int nxyhd,
+                int nblok) {
+/* this subroutine performs the y part of 2 two dimensional real to
+   complex fast fourier transforms and their inverses, for a subset of
+   x, as in cfft2rm2y.  both components of nblok/2 columns are copied
+   into a private panel, so that each butterfly is applied to nblok
+   transforms at once with unit stride, then copied back.  results are
+   the same as cfft2rm2y
+   nblok = number of transforms in a block
+local data                                                            */
+   int indx1, indx1y, nx, ny, nyh, nxy, nxhy, k, k1, koff, jj;
+   float complex t1;
+   if (isign==0)
+      return;
+   indx1 = indx - 1;
+   indx1y = indx1 > indy ? indx1 : indy;
+   nx = 1L<<indx;
+   ny = 1L<<indy;
+   nyh = ny/2;
+   nxy = nx > ny ? nx : ny;
+   nxhy = 1L<<indx1y;
+/* scramble modes kx = 0, nx/2 */
+   if ((isign > 0) && (nxi==1)) {
+      for (k = 1; k < nyh; k++) {
+         koff = 2*nxhd*k;
+         k1 = 2*nxhd*ny - koff;
+         for (jj = 0; jj < 2; jj++) {
+            t1 = cimagf(f[jj+k1]) + crealf(f[jj+k1])*_Complex_I;
+            f[jj+k1] = conjf(f[jj+koff] - t1);
+            f[jj+koff] += t1;
+         }
+      }
+   }
+/* transform in y */
+   cfftcols(&f[2*(nxi-1)],isign,mixup,sct,indy,2*nxp,1,0,2*nxhd,nxhy,
+            nxy,nblok);
+/* unscramble modes kx = 0, nx/2 */
+   if ((isign < 0) && (nxi==1)) {
+      for (k = 1; k < nyh; k++) {
+         koff = 2*nxhd*k;
+         k1 = 2*nxhd*ny - koff;
+         for (jj = 0; jj < 2; jj++) {
+            t1 = f[jj+k1];
+            f[jj+k1] = 0.5*(cimagf(f[jj+koff] + t1)
+                        + crealf(f[jj+koff] - t1)*_Complex_I);
+            f[jj+koff] = 0.5*(crealf(f[jj+koff] + t1)
+                          + cimagf(f[jj+koff] - t1)*_Complex_I);
+         }
+      }
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cwfft2rmxb(float complex f[], int isign, int mixup[],
+                float complex sct[], int indx, int indy, int nxhd,
+                int nyd, int nxhyd, int nxyhd, int nblok) {
+/* wrapper function for real to complex fft, with packed data */
+/* cache blocked version of cwfft2rmx */
+/* local data */
+   int nxh, ny;
+   static int nxi = 1, nyi = 1;
+/* calculate range of indices */
+   nxh = 1L<<(indx - 1);
+   ny = 1L<<indy;
+/* inverse fourier transform */
+   if (isign < 0) {
+/* perform x fft */
+      cfft2rmxxb(f,isign,mixup,sct,indx,indy,nyi,ny,nxhd,nyd,nxhyd,
+                 nxyhd,nblok);
+/* perform y fft */
+      cfft2rmxyb(f,isign,mixup,sct,indx,indy,nxi,nxh,nxhd,nyd,nxhyd,
+                 nxyhd,nblok);
+   }
+/* forward fourier transform */
+   else if (isign > 0) {
+/* perform y fft */
+      cfft2rmxyb(f,isign,mixup,sct,indx,indy,nxi,nxh,nxhd,nyd,nxhyd,
+                 nxyhd,nblok);
+/* perform x fft */
+      cfft2rmxxb(f,isign,mixup,sct,indx,indy,nyi,ny,nxhd,nyd,nxhyd,
+                 nxyhd,nblok);
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cwfft2rm2b(float complex f[], int isign, int mixup[],
+                float complex sct[], int indx, int indy, int nxhd,
+                int nyd, int nxhyd, int nxyhd, int nblok) {
+/* wrapper function for 2 2d real to complex ffts, with packed data */
+/* cache blocked version of cwfft2rm2, the x part is not blocked */
+/* local data */
+   int nxh, ny;
+   static int nxi = 1, nyi = 1;
+/* calculate range of indices */
+   nxh = 1L<<(indx - 1);
+   ny = 1L<<indy;
+/* inverse fourier transform */
+   if (isign < 0) {
+/* perform x fft */
+      cfft2rm2x(f,isign,mixup,sct,indx,indy,nyi,ny,nxhd,nyd,nxhyd,
+                nxyhd);
+/* perform y fft */
+      cfft2rm2yb(f,isign,mixup,sct,indx,indy,nxi,nxh,nxhd,nyd,nxhyd,
+                 nxyhd,nblok);
+   }
+/* forward fourier transform */
+   else if (isign > 0) {
+/* perform y fft */
+      cfft2rm2yb(f,isign,mixup,sct,indx,indy,nxi,nxh,nxhd,nyd,nxhyd,
+                 nxyhd,nblok);
+/* perform x fft */
+      cfft2rm2x(f,isign,mixup,sct,indx,indy,nyi,ny,nxhd,nyd,nxhyd,
+                nxyhd);
+   }
+   return;
+}
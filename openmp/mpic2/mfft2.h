@@ -0,0 +1,24 @@
+/* header file for mfft2.c */
+
+void cfft2rmxxb(float complex f[], int isign, int mixup[],
+                float complex sct[], int indx, int indy, int nyi,
+                int nyp, int nxhd, int nyd, int nxhyd, int nxyhd,
+                int nblok);
+
+void cfft2rmxyb(float complex f[], int isign, int mixup[],
+                float complex sct[], int indx, int indy, int nxi,
+                int nxp, int nxhd, int nyd, int nxhyd, int nxyhd,
+                int nblok);
+
+void cfft2rm2yb(float complex f[], int isign, int mixup[],
+                float complex sct[], int indx, int indy, int nxi,
+                int nxp, int nxhd, int nyd, int nxhyd, int nxyhd,
+                int nblok);
+
+void cwfft2rmxb(float complex f[], int isign, int mixup[],
+                float complex sct[], int indx, int indy, int nxhd,
+                int nyd, int nxhyd, int nxyhd, int nblok);
+
+void cwfft2rm2b(float complex f[], int isign, int mixup[],
+                float complex sct[], int indx, int indy, int nxhd,
+                int nyd, int nxhyd, int nxyhd, int nblok);
@@ -0,0 +1,199 @@
+/* particle buffer growth library for 2D OpenMP PIC codes */
+/* written for the skeleton PIC codes */
+
+#include <stdlib.h>
+#include <string.h>
+#include "mgrow2.h"
+
+/*--------------------------------------------------------------------*/
+int cgrowsize(int nold, int nneed, int nmin, float xtras, int kgrow) {
+/* this function returns a new size for a particle buffer of size nold
+   which needs to hold nneed entries.
+   if nneed > nold, the buffer grows by at least half its size, so that
+   the number of reallocations grows only logarithmically.
+   if kgrow = 2 and less than a quarter of the buffer is needed, it
+   shrinks to (1+xtras)*nneed, but not below nmin.
+   otherwise nold is returned
+   nmin = initial size of buffer
+   xtras = fraction of extra entries kept after shrinking
+   kgrow = (1,2) = (grow only,grow and shrink)
+local data                                                            */
+   int n;
+   if (nneed > nold) {
+      n = nold + nold/2;
+      return nneed > n ? nneed : n;
+   }
+   if ((kgrow==2) && (4*nneed < nold)) {
+      n = (1.0 + xtras)*nneed;
+      return n > nmin ? n : nmin;
+   }
+   return nold;
+}
+
+/*--------------------------------------------------------------------*/
+void *cgrowtile(void *a, int nold, int nnew, int ntile, int nsize) {
+/* this function copies a tiled array a[ntile][nold] with elements of
+   nsize bytes into a newly allocated array b[ntile][nnew], and frees a.
+   the first min(nold,nnew) elements of each tile are copied.
+   returns b, or NULL if there is not enough memory, in which case a is
+   not freed
+local data                                                            */
+   int k, n;
+   char *b;
+   b = (char *) malloc((size_t) nnew*ntile*nsize);
+   if (b==NULL)
+      return NULL;
+   n = nold < nnew ? nold : nnew;
+/* copy in parallel, so that each tile of b is first touched by the */
+/* thread which processes it                                         */
+#pragma omp parallel for schedule(static)
+   for (k = 0; k < ntile; k++) {
+      memcpy(b+(size_t) nnew*nsize*k,(char *) a+(size_t) nold*nsize*k,
+             (size_t) n*nsize);
+   }
+   free(a);
+   return b;
+}
+
+/*--------------------------------------------------------------------*/
+void cppneed2l(int kpic[], int ncl[], int mx1, int my1, int *nhmax,
+               int *nppmax) {
+/* this subroutine finds the buffer sizes needed by cpporderf2l to
+   reorder particles, from the number of particles leaving each tile
+   in each direction, as found by cgppushf2l or cppholes2l.
+   the tile arrays are assumed to be arranged in 2D linear memory, with
+   periodic boundary conditions
+   input: kpic, ncl, mx1, my1, output: nhmax, nppmax
+   kpic[k] = number of particles in tile k
+   ncl[k][i] = number of particles going to destination i, tile k
+   mx1 = (system length in x direction - 1)/mx + 1
+   my1 = (system length in y direction - 1)/my + 1
+   nhmax = maximum number of particles leaving any tile, the size
+   needed for ppbuff and ihole
+   nppmax = maximum number of particles held by any tile while particles
+   are being reordered, the size needed for ppart
+local data                                                            */
+   int mxy1, k, j, kx, ky, jx, jy, nh, nn, npp;
+   int *ninc;
+   mxy1 = mx1*my1;
+   ninc = (int *) calloc(mxy1,sizeof(int));
+/* add particles leaving each tile to the destination tile */
+   nh = 0;
+   for (k = 0; k < mxy1; k++) {
+      ky = k/mx1;
+      kx = k - mx1*ky;
+      nn = 0;
+      for (j = 0; j < 8; j++) {
+         if (ncl[j+8*k] > 0) {
+/* direction j+1 = jx + 3*jy, jx/jy = (0,1,2) = (stay,lower,upper) */
+            jx = (j + 1)%3;
+            jy = (j + 1)/3;
+            jx = kx + (jx==2) - (jx==1);
+            jy = ky + (jy==2) - (jy==1);
+            jx += jx < 0 ? mx1 : (jx >= mx1 ? -mx1 : 0);
+            jy += jy < 0 ? my1 : (jy >= my1 ? -my1 : 0);
+            ninc[jx+mx1*jy] += ncl[j+8*k];
+            nn += ncl[j+8*k];
+         }
+      }
+      nh = nn > nh ? nn : nh;
+      ninc[k] -= nn;
+   }
+/* holes are filled first, the rest is added at the end of the tile */
+   npp = 0;
+   for (k = 0; k < mxy1; k++) {
+      nn = kpic[k] + (ninc[k] > 0 ? ninc[k] : 0);
+      npp = nn > npp ? nn : npp;
+   }
+   free(ninc);
+   *nhmax = nh;
+   *nppmax = npp;
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cppholes2l(float ppart[], int kpic[], int ncl[], int ihole[],
+                int idimp, int nppmx, int nx, int ny, int mx, int my,
+                int mx1, int mxy1, int ntmax, int *irc) {
+/* this subroutine finds particles which have left their tile after a
+   push with cgppushf2l, and stores their number in each direction,
+   location, and destination in ncl and ihole, as cgppushf2l does.
+   it is used to recover when ihole overflowed in cgppushf2l, after
+   ihole has been enlarged.  particle positions have already been
+   wrapped by periodic boundary conditions, so the direction in which
+   a particle left is taken from the sign of its velocity.
+   input: all except ncl, ihole, irc, output: ncl, ihole, irc
+   ppart[k][n][0] = position x of particle n in tile k
+   ppart[k][n][1] = position y of particle n in tile k
+   ppart[k][n][2] = velocity vx of particle n in tile k
+   ppart[k][n][3] = velocity vy of particle n in tile k
+   kpic[k] = number of particles in tile k
+   ncl[k][i] = number of particles going to destination i, tile k
+   ihole[k][:][0] = location of hole in array left by departing particle
+   ihole[k][:][1] = direction destination of particle leaving hole
+   all for tile k
+   ihole[k][0][0] = ih, number of holes left (error, if negative)
+   idimp = size of phase space = 4
+   nppmx = maximum number of particles in tile
+   nx/ny = system length in x/y direction
+   mx/my = number of grids in sorting cell in x/y
+   mx1 = (system length in x direction - 1)/mx + 1
+   mxy1 = mx1*my1, where my1 = (system length in y direction - 1)/my + 1
+   ntmax = size of hole array for particles leaving tiles
+   irc = maximum overflow, returned only if error occurs, when irc > 0
+local data                                                            */
+   int noff, moff, npp, npoff, nn, mm, ih, nh, ist, j, k;
+   float edgelx, edgely, edgerx, edgery, dx, dy;
+#pragma omp parallel for \
+private(j,k,noff,moff,npp,npoff,nn,mm,ih,nh,ist,dx,dy,edgelx,edgely, \
+edgerx,edgery)
+   for (k = 0; k < mxy1; k++) {
+      noff = k/mx1;
+      moff = my*noff;
+      noff = mx*(k - mx1*noff);
+      npp = kpic[k];
+      npoff = nppmx*k;
+      nn = nx - noff;
+      nn = mx < nn ? mx : nn;
+      mm = ny - moff;
+      mm = my < mm ? my : mm;
+      edgelx = noff;
+      edgerx = noff + nn;
+      edgely = moff;
+      edgery = moff + mm;
+      ih = 0;
+      nh = 0;
+      for (j = 0; j < 8; j++) {
+         ncl[j+8*k] = 0;
+      }
+/* loop over particles in tile */
+      for (j = 0; j < npp; j++) {
+         dx = ppart[idimp*(j+npoff)];
+         dy = ppart[1+idimp*(j+npoff)];
+/* ist = direction particle is going */
+         ist = 0;
+         if ((dx < edgelx) || (dx >= edgerx))
+            ist = ppart[2+idimp*(j+npoff)] > 0.0f ? 2 : 1;
+         if ((dy < edgely) || (dy >= edgery))
+            ist += ppart[3+idimp*(j+npoff)] > 0.0f ? 6 : 3;
+         if (ist > 0) {
+            ncl[ist+8*k-1] += 1;
+            ih += 1;
+            if (ih <= ntmax) {
+               ihole[2*(ih+(ntmax+1)*k)] = j + 1;
+               ihole[1+2*(ih+(ntmax+1)*k)] = ist;
+            }
+            else {
+               nh = 1;
+            }
+         }
+      }
+/* set error */
+      if (nh > 0) {
+         *irc = ih;
+         ih = -ih;
+      }
+      ihole[2*(ntmax+1)*k] = ih;
+   }
+   return;
+}
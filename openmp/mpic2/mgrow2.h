@@ -0,0 +1,12 @@
+/* header file for mgrow2.c */
+
+int cgrowsize(int nold, int nneed, int nmin, float xtras, int kgrow);
+
+void *cgrowtile(void *a, int nold, int nnew, int ntile, int nsize);
+
+void cppneed2l(int kpic[], int ncl[], int mx1, int my1, int *nhmax,
+               int *nppmax);
+
+void cppholes2l(float ppart[], int kpic[], int ncl[], int ihole[],
+                int idimp, int nppmx, int nx, int ny, int mx, int my,
+                int mx1, int mxy1, int ntmax, int *irc);
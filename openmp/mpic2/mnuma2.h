@@ -0,0 +1,12 @@
+/* header file for mnuma2.c */
+
+int csocket(int cpu);
+
+void cfirsttouch2l(float ppart[], float ppbuff[], int ihole[], int idimp,
+                   int nppmx, int npbmx, int ntmax, int mxy1);
+
+void cfirsttouch2f(float q[], float fxy[], int ndim, int mx, int my,
+                   int nxe, int nye, int mx1, int mxy1);
+
+void cnumabw2(float ppart[], int kpic[], int idimp, int nppmx, int mxy1,
+              int ntry);
@@ -4,11 +4,20 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <complex.h>
-#include <sys/time.h>
+#include <math.h>
 #include "mpush2.h"
 #include "omplib.h"
-
-void dtimer(double *time, struct timeval *itime, int icntrl);
+#include "proflib.h"
+#include "cfglib.h"
+#include "mgrow2.h"
+#include "mtune2.h"
+#include "msched2.h"
+#include "mnuma2.h"
+#include "mspec2.h"
+#include "mtask2.h"
+#include "mfft2.h"
+#include "ptpool.h"
+#include "mpth2.h"
 
 int main(int argc, char *argv[]) {
 /* indx/indy = exponent which determines grid points in x/y direction: */
@@ -25,6 +34,21 @@ int main(int argc, char *argv[]) {
 /* vtx/vty = thermal velocity of electrons in x/y direction */
 /* vx0/vy0 = drift velocity of electrons in x/y direction */
    float vtx = 1.0, vty = 1.0, vx0 = 0.0, vy0 = 0.0;
+/* kdistr = (0,1) = initial density is (uniform,uniform plus a gaussian */
+/* peak at the center)                                                  */
+/* ampg = fraction of particles in the peak, in each direction */
+/* sigx/sigy = width of the peak in x/y direction, in grid units */
+   int kdistr = 0;
+   float ampg = 0.4, sigx = 32.0, sigy = 32.0;
+/* nspec = number of species, species 0,2,.. are electrons and species */
+/* 1,3,.. are ions, each with npx*npy particles                       */
+/* rmass = ion/electron mass ratio */
+/* vdb = drift velocity in x of species 2 and 3, twice that of species */
+/* 4 and 5, and so on                                                  */
+/* kspec = (0,1) = process species (one at a time with the single */
+/* species procedures,all together with the multi-species procedures) */
+   int nspec = 1, kspec = 0;
+   float rmass = 100.0, vdb = 1.0;
 /* ax/ay = smoothed particle size in x/y direction */
    float ax = .912871, ay = .912871;
 /* idimp = number of particle coordinates = 4 */
@@ -34,17 +58,68 @@ int main(int argc, char *argv[]) {
    float wke = 0.0, we = 0.0, wt = 0.0;
 /* mx/my = number of grids in x/y in sorting tiles */
    int mx = 16, my = 16;
+/* ktune = (0,1) = (no,yes) replace mx, my with the fastest tile size, */
+/* found by timing a few steps at startup                             */
+   int ktune = 0;
 /* xtras = fraction of extra particles needed for particle management */
    float xtras = 0.2;
+/* kdepo = (0,1) = deposit tile edges with (atomic updates,colored */
+/* tile schedule)                                                  */
+   int kdepo = 0;
+/* kgrow = (0,1,2) = on particle buffer overflow (stop with error,grow */
+/* buffers,grow and shrink buffers)                                     */
+   int kgrow = 1;
+/* ksched = (0,1) = divide tiles among threads (in equal blocks,in lists */
+/* balanced by the number of particles in each tile)                    */
+   int ksched = 0;
+/* kprof = (0,1,2,3) = print (no profile,profile summary,summary and  */
+/* per step CSV file prof.csv,summary and per step JSON file prof.json) */
+/* kperf = (0,1) = (no,yes) read hardware counters in profile         */
+   int kprof = 0, kperf = 0;
+/* kaff = (0,1,2) = (do not pin threads,pin threads to consecutive */
+/* processors,spread threads evenly over processors)               */
+/* knuma = (0,1) = (no,yes) first touch tiled particle and field arrays */
+/* by the thread which processes each tile                             */
+/* kbw = (0,1) = (no,yes) print particle array bandwidth of each socket */
+   int kaff = 0, knuma = 0, kbw = 0;
+/* ktask = (0,1,2) = (run the phases of a step one after another,overlap */
+/* reorder with deposit and fft of the charge using OpenMP tasks,same   */
+/* and write task timelines to file trace.csv)                          */
+   int ktask = 0;
+/* kfft = (0,1) = (standard,cache blocked) real to complex ffts */
+/* nbfft = number of rows or columns transformed together in a block */
+   int kfft = 0, nbfft = 16;
+/* kpth = (0,1) = push, deposit and reorder particles with (OpenMP,a */
+/* persistent Pthreads pool of nvp threads, pinned if kaff > 0)      */
+   int kpth = 0;
 /* declare scalars for standard code */
    int j;
    int np, nx, ny, nxh, nyh, nxe, nye, nxeh, nxyh, nxhy;
    int mx1, my1, mxy1, ntime, nloop, isign;
    float qbme, affp;
+/* is = species index */
+/* vtxs/vtys/vx0s = thermal/drift velocities of a species */
+   int is;
+   float vtxs, vtys, vx0s, vy0s;
 
 /* declare scalars for OpenMP code */
    int nppmx, nppmx0, ntmax, npbmx, irc;
    int nvp;
+/* nppmin/ntmin/npbmin = initial sizes of particle buffers */
+/* nh/npp = buffer sizes needed to reorder particles */
+/* ngrow/nshrink = number of times buffers were enlarged/reduced */
+   int nppmin, ntmin, npbmin, nh, npp, n, ngrow = 0, nshrink = 0;
+/* nhs/npps = buffer sizes needed by one species */
+   int nhs, npps;
+/* ltask = (0,1) = charge for this step (is not,is) already deposited and */
+/* x transformed by the task graph                                        */
+   int ltask = 0;
+/* nth = number of threads */
+/* sbal/tbal = load imbalance of static schedule/tile lists */
+/* ssbal/stbal = sum of load imbalances over time steps */
+   int nth;
+   float sbal, tbal;
+   double ssbal = 0.0, stbal = 0.0;
 
 /* declare arrays for standard code: */
 /* part = original particle array */
@@ -60,7 +135,12 @@ int main(int argc, char *argv[]) {
 /* sct = sine/cosine table for FFT */
    float complex *sct = NULL;
 
+/* qms/qbms = charge/charge-to-mass ratio of each species */
+/* wkes = kinetic energy/mass of each species */
+   float *qms = NULL, *qbms = NULL, *wkes = NULL;
+
 /* declare arrays for OpenMP (tiled) code: */
+/* the tiled arrays hold the species one after another, mxy1 tiles each */
 /* ppart = tiled particle array */
 /* ppbuff = buffer array for reordering tiled particle array */
    float *ppart = NULL, *ppbuff = NULL;
@@ -70,24 +150,96 @@ int main(int argc, char *argv[]) {
    int *ncl = NULL;
 /* ihole = location/destination of each particle departing tile */
    int *ihole = NULL;
+/* ktile/kstart = tiles of each thread/start of each list in ktile */
+   int *ktile = NULL, *kstart = NULL;
+/* kpict = number of particles of all species in each tile */
+   int *kpict = NULL;
+/* trace = thread and start/end times of each task in task graph */
+   double *trace = NULL;
 
 /* declare and initialize timing data */
    float time;
-   struct timeval itime;
    float tdpost = 0.0, tguard = 0.0, tfft = 0.0, tfield = 0.0;
-   float tpush = 0.0, tsort = 0.0;
-   double dtime;
+   float tpush = 0.0, tsort = 0.0, ttask = 0.0;
+/* tbest/tdef = time per particle per step with best/default tiles */
+   double tbest, tdef;
+/* tprof = profile data for each region, dimension 5*64 */
+   double tprof[320];
 
    irc = 0;
 /* nvp = number of shared memory nodes  (0=default) */
    nvp = 0;
 /* printf("enter number of nodes:\n"); */
 /* scanf("%i",&nvp);                   */
+/* replace parameters with values from input decks or command line, */
+/* for example: cmpic2 indx=10 npx=1024 npy=1024                    */
+   irc = ccfgread(argc,argv,1);
+   ccfgint("indx",&indx); ccfgint("indy",&indy); ccfgint("npx",&npx);
+   ccfgint("npy",&npy); ccfgflt("tend",&tend); ccfgflt("dt",&dt);
+   ccfgflt("vtx",&vtx); ccfgflt("vty",&vty); ccfgflt("vx0",&vx0);
+   ccfgflt("vy0",&vy0); ccfgint("mx",&mx); ccfgint("my",&my);
+   ccfgflt("xtras",&xtras); ccfgint("kprof",&kprof);
+   ccfgint("kperf",&kperf); ccfgint("nvp",&nvp);
+   ccfgint("kdepo",&kdepo); ccfgint("kgrow",&kgrow);
+   ccfgint("ktune",&ktune); ccfgint("ksched",&ksched);
+   ccfgint("kdistr",&kdistr); ccfgflt("ampg",&ampg);
+   ccfgflt("sigx",&sigx); ccfgflt("sigy",&sigy);
+   ccfgint("kaff",&kaff); ccfgint("knuma",&knuma); ccfgint("kbw",&kbw);
+   ccfgint("nspec",&nspec); ccfgint("kspec",&kspec);
+   ccfgflt("rmass",&rmass); ccfgflt("vdb",&vdb); ccfgint("ktask",&ktask);
+   ccfgint("kfft",&kfft); ccfgint("nbfft",&nbfft);
+   ccfgint("kpth",&kpth);
+   irc += ccfgend();
+   if (irc != 0) {
+      printf("invalid run time parameters\n");
+      exit(1);
+   }
+   if (nbfft < 1) {
+      printf("invalid fft block size, nbfft=%d\n",nbfft);
+      exit(1);
+   }
+   if (nspec < 1) {
+      printf("invalid number of species, nspec=%d\n",nspec);
+      exit(1);
+   }
+/* the multi-species procedures divide tiles in equal blocks */
+   if (kspec==1)
+      ksched = 0;
+/* the thread pool processes one species at a time in equal blocks, */
+/* and deposits tile edges with atomic updates                      */
+   if (kpth==1) {
+      if (kspec != 0)
+         printf("kpth = 1 does not support kspec = %d, set to 0\n",kspec);
+      if (ksched != 0)
+         printf("kpth = 1 does not support ksched = %d, set to 0\n",
+                ksched);
+      if (kdepo != 0)
+         printf("kpth = 1 does not support kdepo = %d, set to 0\n",kdepo);
+      if (ktask != 0)
+         printf("kpth = 1 does not support ktask = %d, set to 0\n",ktask);
+      kspec = 0;
+      ksched = 0;
+      kdepo = 0;
+      ktask = 0;
+   }
 /* initialize for shared memory parallel processing */
    cinit_omp(nvp);
+   nth = cgetnthsize();
+/* pin threads to processors and report them */
+   if (kaff > 0)
+      caffin_omp(kaff);
+/* start thread pool for particle procedures */
+   if (kpth==1) {
+      irc = 0;
+      cinit_ptp(nvp,kaff > 0,&irc);
+      if (irc != 0) {
+         printf("cinit_ptp error: irc=%d\n",irc);
+         exit(1);
+      }
+   }
 
 /* initialize scalars for standard code */
-/* np = total number of particles in simulation */
+/* np = number of particles of each species in simulation */
 /* nx/ny = number of grid points in x/y direction */
    np = npx*npy; nx = 1L<<indx; ny = 1L<<indy;
    nxh = nx/2; nyh = 1 > ny/2 ? 1 : ny/2;
@@ -102,13 +254,16 @@ int main(int argc, char *argv[]) {
    affp = (float) (nx*ny)/(float ) np;
 
 /* allocate data for standard code */
-   part = (float *) malloc(idimp*np*sizeof(float));
+   part = (float *) malloc(idimp*np*nspec*sizeof(float));
    qe = (float *) malloc(nxe*nye*sizeof(float));
    fxye = (float *) malloc(ndim*nxe*nye*sizeof(float));
    ffc = (float complex *) malloc(nxh*nyh*sizeof(float complex));
    mixup = (int *) malloc(nxhy*sizeof(int));
    sct = (float complex *) malloc(nxyh*sizeof(float complex));
-   kpic = (int *) malloc(mxy1*sizeof(int));
+   kpic = (int *) malloc(mxy1*nspec*sizeof(int));
+   qms = (float *) malloc(nspec*sizeof(float));
+   qbms = (float *) malloc(nspec*sizeof(float));
+   wkes = (float *) malloc(nspec*sizeof(float));
 
 /* prepare fft tables */
    cwfft2rinit(mixup,sct,indx,indy,nxhy,nxyh);
@@ -116,34 +271,113 @@ int main(int argc, char *argv[]) {
    isign = 0;
    cmpois22((float complex *)qe,(float complex *)fxye,isign,ffc,ax,ay,
              affp,&we,nx,ny,nxeh,nye,nxh,nyh);
-/* initialize electrons */
-   cdistr2(part,vtx,vty,vx0,vy0,npx,npy,idimp,np,nx,ny,ipbc);
+/* initialize electrons and ions */
+   for (is = 0; is < nspec; is++) {
+      vtxs = vtx;
+      vtys = vty;
+      vx0s = vx0;
+      vy0s = vy0;
+      qms[is] = qme;
+      qbms[is] = qbme;
+      if ((is%2)==1) {
+         vtxs = vtx/sqrtf(rmass);
+         vtys = vty/sqrtf(rmass);
+         vx0s = 0.0;
+         vy0s = 0.0;
+         qms[is] = -qme;
+         qbms[is] = -qbme/rmass;
+      }
+      if (is > 1) {
+         vx0s = vdb*(float) (is/2);
+         vy0s = 0.0;
+      }
+      if (kdistr==1)
+         cdistr2g(&part[idimp*np*is],vtxs,vtys,vx0s,vy0s,ampg,sigx,sigy,
+                  npx,npy,idimp,np,nx,ny,ipbc);
+      else
+         cdistr2(&part[idimp*np*is],vtxs,vtys,vx0s,vy0s,npx,npy,idimp,
+                 np,nx,ny,ipbc);
+   }
+   if (nspec > 1)
+      printf("number of species = %d\n",nspec);
+
+/* choose tile size by timing deposit, push and reorder: updates mx, my */
+   if (ktune==1) {
+      cmtune2(part,qme,qbme,dt,idimp,np,nx,ny,nxe,nye,xtras,kdepo,3,
+              &mx,&my,&tbest,&tdef);
+      printf("tile size chosen: mx,my = %d,%d\n",mx,my);
+      if ((tdef > 0.0) && (tbest > 0.0))
+         printf("speedup over default tile size = %f\n",tdef/tbest);
+      mx1 = (nx - 1)/mx + 1; my1 = (ny - 1)/my + 1; mxy1 = mx1*my1;
+      free(kpic);
+      kpic = (int *) malloc(mxy1*nspec*sizeof(int));
+   }
 
 /* find number of particles in each of mx, my tiles: updates kpic, nppmx */
-   cdblkp2l(part,kpic,&nppmx,idimp,np,mx,my,mx1,mxy1,&irc);
-   if (irc != 0) { 
-      printf("cdblkp2l error, irc=%d\n",irc);
-      exit(1);
+/* nppmx is the largest of all species                                   */
+   nppmx = 0;
+   for (is = 0; is < nspec; is++) {
+      cdblkp2l(&part[idimp*np*is],&kpic[mxy1*is],&npps,idimp,np,mx,my,
+               mx1,mxy1,&irc);
+      if (irc != 0) { 
+         printf("cdblkp2l error, irc=%d\n",irc);
+         exit(1);
+      }
+      nppmx = npps > nppmx ? npps : nppmx;
    }
 /* allocate vector particle data */
    nppmx0 = (1.0 + xtras)*nppmx;
    ntmax = xtras*nppmx;
    npbmx = xtras*nppmx;
-   ppart = (float *) malloc(idimp*nppmx0*mxy1*sizeof(float));
-   ppbuff = (float *) malloc(idimp*npbmx*mxy1*sizeof(float));
-   ncl = (int *) malloc(8*mxy1*sizeof(int));
-   ihole = (int *) malloc(2*(ntmax+1)*mxy1*sizeof(int));
-/* copy ordered particle data for OpenMP: updates ppart and kpic */
-   cppmovin2l(part,ppart,kpic,nppmx0,idimp,np,mx,my,mx1,mxy1,&irc);
-   if (irc != 0) { 
-      printf("cppmovin2l overflow error, irc=%d\n",irc);
-      exit(1);
+   ppart = (float *) malloc(idimp*nppmx0*mxy1*nspec*sizeof(float));
+   ppbuff = (float *) malloc(idimp*npbmx*mxy1*nspec*sizeof(float));
+   ncl = (int *) malloc(8*mxy1*nspec*sizeof(int));
+   ihole = (int *) malloc(2*(ntmax+1)*mxy1*nspec*sizeof(int));
+   ktile = (int *) malloc(mxy1*sizeof(int));
+   kpict = (int *) malloc(mxy1*sizeof(int));
+   trace = (double *) malloc(12*my1*sizeof(double));
+   kstart = (int *) malloc((nth+1)*sizeof(int));
+   nppmin = nppmx0; ntmin = ntmax; npbmin = npbmx;
+/* place memory of each tile on socket of thread which processes it */
+   if (knuma==1) {
+      for (is = 0; is < nspec; is++) {
+         cfirsttouch2l(&ppart[idimp*nppmx0*mxy1*is],
+                       &ppbuff[idimp*npbmx*mxy1*is],
+                       &ihole[2*(ntmax+1)*mxy1*is],idimp,nppmx0,npbmx,
+                       ntmax,mxy1);
+      }
+      cfirsttouch2f(qe,fxye,ndim,mx,my,nxe,nye,mx1,mxy1);
    }
+   for (is = 0; is < nspec; is++) {
+/* copy ordered particle data for OpenMP: updates ppart and kpic */
+      cppmovin2l(&part[idimp*np*is],&ppart[idimp*nppmx0*mxy1*is],
+                 &kpic[mxy1*is],nppmx0,idimp,np,mx,my,mx1,mxy1,&irc);
+      if (irc != 0) { 
+         printf("cppmovin2l overflow error, irc=%d\n",irc);
+         exit(1);
+      }
 /* sanity check */
-   cppcheck2l(ppart,kpic,idimp,nppmx0,nx,ny,mx,my,mx1,my1,&irc);
-   if (irc != 0) {
-      printf("%d,cppcheck2l error: irc=%d\n",ntime,irc);
-      exit(1);
+      cppcheck2l(&ppart[idimp*nppmx0*mxy1*is],&kpic[mxy1*is],idimp,
+                 nppmx0,nx,ny,mx,my,mx1,my1,&irc);
+      if (irc != 0) {
+         printf("%d,cppcheck2l error: irc=%d\n",ntime,irc);
+         exit(1);
+      }
+   }
+/* measure bandwidth of each socket for tiled particle array */
+   if (kbw==1)
+      cnumabw2(ppart,kpic,idimp,nppmx0,mxy1,5);
+
+/* initialize profiler for all threads */
+   if (cprofinit(0,kperf,0)==1)
+      printf("hardware counters not available\n");
+   if (kprof==2)
+      cprofopen("prof.csv",1);
+   else if (kprof==3)
+      cprofopen("prof.json",2);
+   if (ktask==2) {
+      if (ctraceopen("trace.csv")==1)
+         printf("cannot open task trace file trace.csv\n");
    }
 
 /* * * * start main iteration loop * * * */
@@ -151,87 +385,278 @@ int main(int argc, char *argv[]) {
 L500: if (nloop <= ntime)
          goto L2000;
 /*    printf("ntime = %i\n",ntime); */
+      cprofbeg("step");
 
-/* deposit charge with OpenMP: updates qe */
-      dtimer(&dtime,&itime,-1);
-      for (j = 0; j < nxe*nye; j++) {
-         qe[j] = 0.0;
+/* divide tiles among threads by particle count: updates ktile, kstart */
+/* a grid point of a tile costs about a quarter of a particle          */
+/* the lists are found from the particles of all species              */
+      if (ksched==1) {
+         cprofbeg("sched");
+         for (j = 0; j < mxy1; j++) {
+            kpict[j] = 0;
+            for (is = 0; is < nspec; is++) {
+               kpict[j] += kpic[j+mxy1*is];
+            }
+         }
+         csched2(kpict,ktile,kstart,mx*my/4,nth,mxy1,&sbal,&tbal);
+         ssbal += sbal;
+         stbal += tbal;
+         cprofend();
       }
-      cgppost2l(ppart,qe,kpic,qme,nppmx0,idimp,mx,my,nxe,nye,mx1,mxy1);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tdpost += time;
+
+/* deposit charge with OpenMP: updates qe */
+/* skipped if the task graph of the previous step deposited it */
+      if (ltask==0) {
+         cprofbeg("deposit");
+         for (j = 0; j < nxe*nye; j++) {
+            qe[j] = 0.0;
+         }
+         if ((kspec==1) && (kdepo==0)) {
+            cgppost2lm(ppart,qe,kpic,qms,nppmx0,idimp,mx,my,nxe,nye,mx1,
+                       mxy1,nspec);
+         }
+         else {
+            for (is = 0; is < nspec; is++) {
+               if (kdepo==1)
+                  cgppost2lc(&ppart[idimp*nppmx0*mxy1*is],qe,
+                             &kpic[mxy1*is],qms[is],nppmx0,idimp,mx,my,
+                             nxe,nye,mx1,mxy1);
+               else if (kpth==1)
+                  cptgppost2l(&ppart[idimp*nppmx0*mxy1*is],qe,
+                              &kpic[mxy1*is],qms[is],nppmx0,idimp,mx,
+                              my,nxe,nye,mx1,mxy1);
+               else if (ksched==1)
+                  cgppost2ls(&ppart[idimp*nppmx0*mxy1*is],qe,
+                             &kpic[mxy1*is],ktile,kstart,qms[is],nppmx0,
+                             idimp,mx,my,nxe,nye,mx1,mxy1,nth);
+               else
+                  cgppost2l(&ppart[idimp*nppmx0*mxy1*is],qe,
+                            &kpic[mxy1*is],qms[is],nppmx0,idimp,mx,my,
+                            nxe,nye,mx1,mxy1);
+            }
+         }
+         tdpost += cprofend();
 
 /* add guard cells with OpenMP: updates qe */
-      dtimer(&dtime,&itime,-1);
-      caguard2l(qe,nx,ny,nxe,nye);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tguard += time;
+         cprofbeg("guard");
+         caguard2l(qe,nx,ny,nxe,nye);
+         tguard += cprofend();
+      }
 
 /* transform charge to fourier space with OpenMP: updates qe */
-      dtimer(&dtime,&itime,-1);
+      cprofbeg("fft");
       isign = -1;
-      cwfft2rmx((float complex *)qe,isign,mixup,sct,indx,indy,nxeh,
-                nye,nxhy,nxyh);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tfft += time;
+      if (ltask==0) {
+         if (kfft==0)
+            cwfft2rmx((float complex *)qe,isign,mixup,sct,indx,indy,
+                      nxeh,nye,nxhy,nxyh);
+         else
+            cwfft2rmxb((float complex *)qe,isign,mixup,sct,indx,indy,
+                       nxeh,nye,nxhy,nxyh,nbfft);
+      }
+/* only the y part is left after the task graph */
+      else {
+         if (kfft==0)
+            cfft2rmxy((float complex *)qe,isign,mixup,sct,indx,indy,1,
+                      nxh,nxeh,nye,nxhy,nxyh);
+         else
+            cfft2rmxyb((float complex *)qe,isign,mixup,sct,indx,indy,1,
+                       nxh,nxeh,nye,nxhy,nxyh,nbfft);
+      }
+      tfft += cprofend();
 
 /* calculate force/charge in fourier space with OpenMP: updates fxye, we */
-      dtimer(&dtime,&itime,-1);
+      cprofbeg("field");
       isign = -1;
       cmpois22((float complex *)qe,(float complex *)fxye,isign,ffc,ax,
                ay,affp,&we,nx,ny,nxeh,nye,nxh,nyh);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tfield += time;
+      tfield += cprofend();
 
 /* transform force to real space with OpenMP: updates fxye */
-      dtimer(&dtime,&itime,-1);
+      cprofbeg("fft");
       isign = 1;
-      cwfft2rm2((float complex *)fxye,isign,mixup,sct,indx,indy,nxeh,
-                nye,nxhy,nxyh);
+      if (kfft==0)
+         cwfft2rm2((float complex *)fxye,isign,mixup,sct,indx,indy,nxeh,
+                   nye,nxhy,nxyh);
+      else
+         cwfft2rm2b((float complex *)fxye,isign,mixup,sct,indx,indy,
+                    nxeh,nye,nxhy,nxyh,nbfft);
 
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tfft += time;
+      tfft += cprofend();
 
 /* copy guard cells with OpenMP: updates fxye */
-      dtimer(&dtime,&itime,-1);
+      cprofbeg("guard");
       ccguard2l(fxye,nx,ny,nxe,nye);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tguard += time;
+      tguard += cprofend();
 
 /* push particles with OpenMP: */
-      wke = 0.0;
-      dtimer(&dtime,&itime,-1);
+      for (is = 0; is < nspec; is++) {
+         wkes[is] = 0.0;
+      }
+      cprofbeg("push");
 /* updates ppart, wke */
 /*    cgppush2l(ppart,fxye,kpic,qbme,dt,&wke,idimp,nppmx0,nx,ny,mx,my, */
 /*              nxe,nye,mx1,mxy1,ipbc);                                */
-/* updates ppart, ncl, ihole, wke, irc */
-      cgppushf2l(ppart,fxye,kpic,ncl,ihole,qbme,dt,&wke,idimp,nppmx0,
-                 nx,ny,mx,my,nxe,nye,mx1,mxy1,ntmax,&irc);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tpush += time;
+/* updates ppart, ncl, ihole, wkes, irc */
+      if (kspec==1) {
+         cgppushf2lm(ppart,fxye,kpic,ncl,ihole,qbms,dt,wkes,idimp,nppmx0,
+                     nx,ny,mx,my,nxe,nye,mx1,mxy1,ntmax,nspec,&irc);
+      }
+      else {
+         for (is = 0; is < nspec; is++) {
+            if (kpth==1)
+               cptgppushf2l(&ppart[idimp*nppmx0*mxy1*is],fxye,
+                            &kpic[mxy1*is],&ncl[8*mxy1*is],
+                            &ihole[2*(ntmax+1)*mxy1*is],qbms[is],dt,
+                            &wkes[is],idimp,nppmx0,nx,ny,mx,my,nxe,nye,
+                            mx1,mxy1,ntmax,&irc);
+            else if (ksched==1)
+               cgppushf2ls(&ppart[idimp*nppmx0*mxy1*is],fxye,
+                           &kpic[mxy1*is],&ncl[8*mxy1*is],
+                           &ihole[2*(ntmax+1)*mxy1*is],ktile,kstart,
+                           qbms[is],dt,&wkes[is],idimp,nppmx0,nx,ny,mx,
+                           my,nxe,nye,mx1,mxy1,ntmax,nth,&irc);
+            else
+               cgppushf2l(&ppart[idimp*nppmx0*mxy1*is],fxye,
+                          &kpic[mxy1*is],&ncl[8*mxy1*is],
+                          &ihole[2*(ntmax+1)*mxy1*is],qbms[is],dt,
+                          &wkes[is],idimp,nppmx0,nx,ny,mx,my,nxe,nye,mx1,
+                          mxy1,ntmax,&irc);
+         }
+      }
+/* kinetic energy of all species, mass of a species is qm/qbm */
+      wke = 0.0;
+      for (is = 0; is < nspec; is++) {
+         wke += wkes[is]*(qms[is]/qbms[is]);
+      }
+      tpush += cprofend();
+      if ((irc != 0) && (kgrow > 0)) {
+/* enlarge ihole and find departing particles again */
+         cprofbeg("grow");
+         nh = 0;
+         for (is = 0; is < nspec; is++) {
+            cppneed2l(&kpic[mxy1*is],&ncl[8*mxy1*is],mx1,my1,&nhs,&npps);
+            nh = nhs > nh ? nhs : nh;
+         }
+         ntmax = cgrowsize(ntmax,nh,ntmin,xtras,1);
+         free(ihole);
+         ihole = (int *) malloc(2*(ntmax+1)*mxy1*nspec*sizeof(int));
+         irc = 0;
+         if (ihole==NULL)
+            irc = -1;
+         for (is = 0; is < nspec; is++) {
+            if (irc != 0)
+               break;
+            cppholes2l(&ppart[idimp*nppmx0*mxy1*is],&kpic[mxy1*is],
+                       &ncl[8*mxy1*is],&ihole[2*(ntmax+1)*mxy1*is],idimp,
+                       nppmx0,nx,ny,mx,my,mx1,mxy1,ntmax,&irc);
+         }
+         ngrow += 1;
+         cprofend();
+      }
       if (irc != 0) {
          printf("cgppushf2l error: irc=%d\n",irc);
          exit(1);
       }
 
+/* check particle buffer sizes, enlarge or reduce them if needed */
+      if (kgrow > 0) {
+         cprofbeg("grow");
+         nh = 0;
+         npp = 0;
+         for (is = 0; is < nspec; is++) {
+            cppneed2l(&kpic[mxy1*is],&ncl[8*mxy1*is],mx1,my1,&nhs,&npps);
+            nh = nhs > nh ? nhs : nh;
+            npp = npps > npp ? npps : npp;
+         }
+         n = cgrowsize(npbmx,nh,npbmin,xtras,kgrow);
+         if (n != npbmx) {
+            if (n > npbmx) ngrow += 1; else nshrink += 1;
+            npbmx = n;
+            free(ppbuff);
+            ppbuff = (float *) malloc(idimp*npbmx*mxy1*nspec*
+                                      sizeof(float));
+            if (ppbuff==NULL)
+               irc = -1;
+         }
+         n = cgrowsize(nppmx0,npp,nppmin,xtras,kgrow);
+         if ((n != nppmx0) && (irc==0)) {
+            if (n > nppmx0) ngrow += 1; else nshrink += 1;
+            ppart = (float *) cgrowtile(ppart,nppmx0,n,mxy1*nspec,
+                                        idimp*sizeof(float));
+            nppmx0 = n;
+            if (ppart==NULL)
+               irc = -1;
+         }
+/* ihole holds the holes found by the push, so it is only reduced here */
+         n = cgrowsize(ntmax,nh,ntmin,xtras,kgrow);
+         if ((n < ntmax) && (irc==0)) {
+            nshrink += 1;
+            ihole = (int *) cgrowtile(ihole,ntmax+1,n+1,mxy1*nspec,
+                                      2*sizeof(int));
+            ntmax = n;
+            if (ihole==NULL)
+               irc = -1;
+         }
+         cprofend();
+         if (irc != 0) {
+            printf("particle buffer allocation error: irc=%d\n",irc);
+            exit(1);
+         }
+      }
+
+/* reorder particles, then deposit charge and start its fft for the next */
+/* step with a graph of OpenMP tasks: updates ppart, ppbuff, kpic, ncl, */
+/* qe, and irc                                                           */
+      ltask = 0;
+      if ((ktask > 0) && (ntime+1 < nloop)) {
+         cprofbeg("task");
+         cppordpost2t(ppart,ppbuff,kpic,ncl,ihole,qe,qms,mixup,sct,trace,
+                      idimp,nppmx0,nx,ny,mx,my,nxe,nye,mx1,my1,npbmx,
+                      ntmax,nspec,indx,indy,nxhy,nxyh,&irc);
+         ttask += cprofend();
+         if (ktask==2)
+            ctracewrite(trace,ntime,my1);
+         ltask = 1;
+      }
+      else {
 /* reorder particles by tile with OpenMP: */
-      dtimer(&dtime,&itime,-1);
+         cprofbeg("sort");
 /* updates ppart, ppbuff, kpic, ncl, ihole, and irc */
 /*    cpporder2l(ppart,ppbuff,kpic,ncl,ihole,idimp,nppmx0,nx,ny,mx,my, */
 /*               mx1,my1,npbmx,ntmax,&irc);                            */
 /* updates ppart, ppbuff, kpic, ncl, and irc */
-      cpporderf2l(ppart,ppbuff,kpic,ncl,ihole,idimp,nppmx0,mx1,my1,
-                  npbmx,ntmax,&irc);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tsort += time;
+         if (kspec==1) {
+            cpporderf2lm(ppart,ppbuff,kpic,ncl,ihole,idimp,nppmx0,mx1,
+                         my1,npbmx,ntmax,nspec,&irc);
+         }
+         else {
+            for (is = 0; is < nspec; is++) {
+               if (irc != 0)
+                  break;
+               if (kpth==1)
+                  cptpporderf2l(&ppart[idimp*nppmx0*mxy1*is],
+                                &ppbuff[idimp*npbmx*mxy1*is],
+                                &kpic[mxy1*is],&ncl[8*mxy1*is],
+                                &ihole[2*(ntmax+1)*mxy1*is],idimp,
+                                nppmx0,mx1,my1,npbmx,ntmax,&irc);
+               else if (ksched==1)
+                  cpporderf2ls(&ppart[idimp*nppmx0*mxy1*is],
+                               &ppbuff[idimp*npbmx*mxy1*is],
+                               &kpic[mxy1*is],&ncl[8*mxy1*is],
+                               &ihole[2*(ntmax+1)*mxy1*is],ktile,kstart,
+                               idimp,nppmx0,mx1,my1,npbmx,ntmax,nth,
+                               &irc);
+               else
+                  cpporderf2l(&ppart[idimp*nppmx0*mxy1*is],
+                              &ppbuff[idimp*npbmx*mxy1*is],
+                              &kpic[mxy1*is],&ncl[8*mxy1*is],
+                              &ihole[2*(ntmax+1)*mxy1*is],idimp,nppmx0,
+                              mx1,my1,npbmx,ntmax,&irc);
+            }
+         }
+         tsort += cprofend();
+      }
       if (irc != 0) {
          printf("cpporderf2l error: ntmax, irc=%d,%d\n",ntmax,irc);
          exit(1);
@@ -241,6 +666,8 @@ L500: if (nloop <= ntime)
          printf("Initial Field, Kinetic and Total Energies:\n");
          printf("%e %e %e\n",we,wke,wke+we);
       }
+      cprofend();
+      cprofstep(ntime);
       ntime += 1;
       goto L500;
 L2000:
@@ -248,6 +675,17 @@ L2000:
 /* * * * end main iteration loop * * * */
 
    printf("ntime = %i\n",ntime);
+   if ((ngrow + nshrink) > 0) {
+      printf("particle buffers enlarged/reduced = %d,%d\n",ngrow,nshrink);
+      printf("final nppmx0, npbmx, ntmax = %d,%d,%d\n",nppmx0,npbmx,
+             ntmax);
+   }
+   if ((ksched==1) && (ntime > 0)) {
+      printf("average load imbalance (max/mean work of %d threads):\n",
+             nth);
+      printf("static schedule = %f, tile lists = %f\n",ssbal/ntime,
+             stbal/ntime);
+   }
    printf("Final Field, Kinetic and Total Energies:\n");
    printf("%e %e %e\n",we,wke,wke+we);
 
@@ -258,20 +696,38 @@ L2000:
    printf("fft time = %f\n",tfft);
    printf("push time = %f\n",tpush);
    printf("sort time = %f\n",tsort);
+   if (ktask > 0)
+      printf("task graph time = %f\n",ttask);
    tfield += tguard + tfft;
    printf("total solver time = %f\n",tfield);
-   time = tdpost + tpush + tsort;
+   time = tdpost + tpush + tsort + ttask;
    printf("total particle time = %f\n",time);
    wt = time + tfield;
    printf("total time = %f\n",wt);
+   if (ntime > 0)
+      printf("time per step (usec) = %f\n",1.0e+06*wt/ntime);
    printf("\n");
 
-   wt = 1.0e+09/(((float) nloop)*((float) np));
+   wt = 1.0e+09/(((float) nloop)*((float) np)*((float) nspec));
    printf("Push Time (nsec) = %f\n",tpush*wt);
    printf("Deposit Time (nsec) = %f\n",tdpost*wt);
    printf("Sort Time (nsec) = %f\n",tsort*wt);
+   if (ktask > 0)
+      printf("Task Graph Time (nsec) = %f\n",ttask*wt);
    printf("Total Particle Time (nsec) = %f\n",time*wt);
    printf("\n");
 
+/* print profile */
+   if (kprof > 0) {
+      cprofget(tprof,320);
+      cprofprint(tprof,tprof,1);
+      printf("\n");
+   }
+   cprofexit();
+   if (kpth==1)
+      cend_ptp();
+   if (ktask==2)
+      ctraceclose();
+
    return 0;
 }
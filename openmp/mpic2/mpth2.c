@@ -0,0 +1,521 @@
+/* 2D tiled particle procedures for the persistent Pthreads pool */
+/* same algorithms as cgppushf2l, cgppost2l and cpporderf2l in mpush2.c, */
+/* with the tile loops divided among the threads of ptpool.c in equal   */
+/* blocks, instead of by OpenMP                                         */
+/* written for the skeleton PIC codes */
+
+#include <stdlib.h>
+#include "ptpool.h"
+#include "mpth2.h"
+
+/* argument lists of the thread procedures */
+struct pushargs {
+   float *ppart, *fxy;
+   int *kpic, *ncl, *ihole;
+   float qbm, dt;
+   double *sum;
+   int idimp, nppmx, nx, ny, mx, my, nxv, mx1, ntmax;
+   int *irc;
+};
+
+struct postargs {
+   float *ppart, *q;
+   int *kpic;
+   float qm;
+   int nppmx, idimp, mx, my, nxv, nyv, mx1;
+};
+
+struct orderargs {
+   float *ppart, *ppbuff;
+   int *kpic, *ncl, *ihole;
+   int idimp, nppmx, mx1, my1, npbmx, ntmax;
+   int *irc;
+};
+
+/*--------------------------------------------------------------------*/
+static void caddf(float *a, float b) {
+/* atomic update a = a + b, for tile edges shared by several threads
+local data                                                            */
+   float old, new;
+   __atomic_load(a,&old,__ATOMIC_RELAXED);
+   do {
+      new = old + b;
+   } while (!__atomic_compare_exchange(a,&old,&new,1,__ATOMIC_RELAXED,
+                                       __ATOMIC_RELAXED));
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+static void cptpush(void *arg, int ith, int nb, int ne) {
+/* thread ith pushes the particles in tiles nb <= k < ne.
+   see cgppushf2l for the algorithm.  the kinetic energy sum of the
+   thread is stored in sum[8*ith], one cache line apart
+local data                                                            */
+   struct pushargs *a;
+   float *ppart, *fxy;
+   int *kpic, *ncl, *ihole;
+   int idimp, nppmx, nx, ny, mx, my, nxv, mx1, ntmax;
+   int noff, moff, npoff, npp;
+   int i, j, k, ih, nh, nn, mm, mxv;
+   float qtm, dt, dxp, dyp, amx, amy;
+   float x, y, dx, dy, vx, vy;
+   float anx, any, edgelx, edgely, edgerx, edgery;
+   float *sfxy;
+   double sum1, sum2;
+   a = (struct pushargs *) arg;
+   ppart = a->ppart; fxy = a->fxy; kpic = a->kpic; ncl = a->ncl;
+   ihole = a->ihole; idimp = a->idimp; nppmx = a->nppmx; nx = a->nx;
+   ny = a->ny; mx = a->mx; my = a->my; nxv = a->nxv; mx1 = a->mx1;
+   ntmax = a->ntmax;
+   dt = a->dt;
+   mxv = mx + 1;
+   qtm = a->qbm*dt;
+   anx = (float) nx;
+   any = (float) ny;
+   sum2 = 0.0;
+/* allocate local fields for this thread */
+   sfxy = (float *) malloc(2*mxv*(my+1)*sizeof(float));
+/* loop over tiles of this thread */
+   for (k = nb; k < ne; k++) {
+      noff = k/mx1;
+      moff = my*noff;
+      noff = mx*(k - mx1*noff);
+      npp = kpic[k];
+      npoff = nppmx*k;
+      nn = nx - noff;
+      nn = mx < nn ? mx : nn;
+      mm = ny - moff;
+      mm = my < mm ? my : mm;
+      edgelx = noff;
+      edgerx = noff + nn;
+      edgely = moff;
+      edgery = moff + mm;
+      ih = 0;
+      nh = 0;
+      nn += 1;
+      mm += 1;
+/* load local fields from global array */
+      for (j = 0; j < mm; j++) {
+         for (i = 0; i < nn; i++) {
+            sfxy[2*(i+mxv*j)] = fxy[2*(i+noff+nxv*(j+moff))];
+            sfxy[1+2*(i+mxv*j)] = fxy[1+2*(i+noff+nxv*(j+moff))];
+         }
+      }
+/* clear counters */
+      for (j = 0; j < 8; j++) {
+         ncl[j+8*k] = 0;
+      }
+      sum1 = 0.0;
+/* loop over particles in tile */
+      for (j = 0; j < npp; j++) {
+/* find interpolation weights */
+         x = ppart[idimp*(j+npoff)];
+         y = ppart[1+idimp*(j+npoff)];
+         nn = x;
+         mm = y;
+         dxp = x - (float) nn;
+         dyp = y - (float) mm;
+         nn = 2*(nn - noff) + 2*mxv*(mm - moff);
+         amx = 1.0f - dxp;
+         amy = 1.0f - dyp;
+/* find acceleration */
+         dx = amx*sfxy[nn];
+         dy = amx*sfxy[nn+1];
+         dx = amy*(dxp*sfxy[nn+2] + dx);
+         dy = amy*(dxp*sfxy[nn+3] + dy);
+         nn += 2*mxv;
+         vx = amx*sfxy[nn];
+         vy = amx*sfxy[nn+1];
+         dx += dyp*(dxp*sfxy[nn+2] + vx);
+         dy += dyp*(dxp*sfxy[nn+3] + vy);
+/* new velocity */
+         vx = ppart[2+idimp*(j+npoff)];
+         vy = ppart[3+idimp*(j+npoff)];
+         dx = vx + qtm*dx;
+         dy = vy + qtm*dy;
+/* average kinetic energy */
+         vx += dx;
+         vy += dy;
+         sum1 += (vx*vx + vy*vy);
+         ppart[2+idimp*(j+npoff)] = dx;
+         ppart[3+idimp*(j+npoff)] = dy;
+/* new position */
+         dx = x + dx*dt;
+         dy = y + dy*dt;
+/* find particles going out of bounds */
+         mm = 0;
+/* count how many particles are going in each direction in ncl   */
+/* save their address and destination in ihole                   */
+/* use periodic boundary conditions and check for roundoff error */
+/* mm = direction particle is going                              */
+         if (dx >= edgerx) {
+            if (dx >= anx)
+               dx -= anx;
+            mm = 2;
+         }
+         else if (dx < edgelx) {
+            if (dx < 0.0f) {
+               dx += anx;
+               if (dx < anx)
+                  mm = 1;
+               else
+                  dx = 0.0;
+            }
+            else {
+               mm = 1;
+            }
+         }
+         if (dy >= edgery) {
+            if (dy >= any)
+               dy -= any;
+            mm += 6;
+         }
+         else if (dy < edgely) {
+            if (dy < 0.0) {
+               dy += any;
+               if (dy < any)
+                  mm += 3;
+               else
+                  dy = 0.0;
+            }
+            else {
+               mm += 3;
+            }
+         }
+/* set new position */
+         ppart[idimp*(j+npoff)] = dx;
+         ppart[1+idimp*(j+npoff)] = dy;
+/* increment counters */
+         if (mm > 0) {
+            ncl[mm+8*k-1] += 1;
+            ih += 1;
+            if (ih <= ntmax) {
+               ihole[2*(ih+(ntmax+1)*k)] = j + 1;
+               ihole[1+2*(ih+(ntmax+1)*k)] = mm;
+            }
+            else {
+               nh = 1;
+            }
+         }
+      }
+      sum2 += sum1;
+/* set error and end of file flag */
+/* ihole overflow */
+      if (nh > 0) {
+         *(a->irc) = ih;
+         ih = -ih;
+      }
+      ihole[2*(ntmax+1)*k] = ih;
+   }
+   free(sfxy);
+   a->sum[8*ith] = sum2;
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+static void cptdepo(void *arg, int ith, int nb, int ne) {
+/* thread ith deposits the charge of the particles in tiles nb <= k < ne.
+   see cgppost2l for the algorithm
+local data                                                            */
+   struct postargs *a;
+   float *ppart, *q;
+   int *kpic;
+   int nppmx, idimp, mx, my, nxv, nyv, mx1;
+   int noff, moff, npoff, npp, mxv;
+   int i, j, k, nn, mm;
+   float qm, x, y, dxp, dyp, amx, amy;
+   float *sq;
+   a = (struct postargs *) arg;
+   ppart = a->ppart; q = a->q; kpic = a->kpic; qm = a->qm;
+   nppmx = a->nppmx; idimp = a->idimp; mx = a->mx; my = a->my;
+   nxv = a->nxv; nyv = a->nyv; mx1 = a->mx1;
+   mxv = mx + 1;
+/* allocate local accumulator for this thread */
+   sq = (float *) malloc(mxv*(my+1)*sizeof(float));
+/* loop over tiles of this thread */
+   for (k = nb; k < ne; k++) {
+      noff = k/mx1;
+      moff = my*noff;
+      noff = mx*(k - mx1*noff);
+      npp = kpic[k];
+      npoff = nppmx*k;
+/* zero out local accumulator */
+      for (j = 0; j < mxv*(my+1); j++) {
+         sq[j] = 0.0f;
+      }
+/* loop over particles in tile */
+      for (j = 0; j < npp; j++) {
+/* find interpolation weights */
+         x = ppart[idimp*(j+npoff)];
+         y = ppart[1+idimp*(j+npoff)];
+         nn = x;
+         mm = y;
+         dxp = qm*(x - (float) nn);
+         dyp = y - (float) mm;
+         nn = nn - noff + mxv*(mm - moff);
+         amx = qm - dxp;
+         amy = 1.0f - dyp;
+/* deposit charge within tile to local accumulator */
+         x = sq[nn] + amx*amy;
+         y = sq[nn+1] + dxp*amy;
+         sq[nn] = x;
+         sq[nn+1] = y;
+         nn += mxv;
+         x = sq[nn] + amx*dyp;
+         y = sq[nn+1] + dxp*dyp;
+         sq[nn] = x;
+         sq[nn+1] = y;
+      }
+/* deposit charge to interior points in global array */
+      nn = nxv - noff;
+      mm = nyv - moff;
+      nn = mx < nn ? mx : nn;
+      mm = my < mm ? my : mm;
+      for (j = 1; j < mm; j++) {
+         for (i = 1; i < nn; i++) {
+            q[i+noff+nxv*(j+moff)] += sq[i+mxv*j];
+         }
+      }
+/* deposit charge to edge points in global array */
+      mm = nyv - moff;
+      mm = my+1 < mm ? my+1 : mm;
+      for (i = 1; i < nn; i++) {
+         caddf(&q[i+noff+nxv*moff],sq[i]);
+         if (mm > my) {
+            caddf(&q[i+noff+nxv*(mm+moff-1)],sq[i+mxv*(mm-1)]);
+         }
+      }
+      nn = nxv - noff;
+      nn = mx+1 < nn ? mx+1 : nn;
+      for (j = 0; j < mm; j++) {
+         caddf(&q[noff+nxv*(j+moff)],sq[mxv*j]);
+         if (nn > mx) {
+            caddf(&q[nn+noff-1+nxv*(j+moff)],sq[nn-1+mxv*j]);
+         }
+      }
+   }
+   free(sq);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+static void cptorder(void *arg, int ith, int nb, int ne) {
+/* thread ith reorders the particles in tiles nb <= k < ne.
+   see cpporderf2l for the algorithm.  the two phases are separated by
+   a barrier of the pool, so that one job performs the whole reorder
+local data                                                            */
+   struct orderargs *a;
+   float *ppart, *ppbuff;
+   int *kpic, *ncl, *ihole;
+   int idimp, nppmx, mx1, my1, npbmx, ntmax;
+   int npp, ncoff;
+   int i, j, k, ii, kx, ky, ih, nh, ist, isum;
+   int ip, j1, j2, kxl, kxr, kk, kl, kr;
+   int ks[8];
+   a = (struct orderargs *) arg;
+   ppart = a->ppart; ppbuff = a->ppbuff; kpic = a->kpic; ncl = a->ncl;
+   ihole = a->ihole; idimp = a->idimp; nppmx = a->nppmx; mx1 = a->mx1;
+   my1 = a->my1; npbmx = a->npbmx; ntmax = a->ntmax;
+/* buffer particles that are leaving tile: update ppbuff, ncl */
+/* loop over tiles of this thread */
+   for (k = nb; k < ne; k++) {
+/* find address offset for ordered ppbuff array */
+      isum = 0;
+      for (j = 0; j < 8; j++) {
+         ist = ncl[j+8*k];
+         ncl[j+8*k] = isum;
+         isum += ist;
+      }
+      nh = ihole[2*(ntmax+1)*k];
+      ip = 0;
+/* loop over particles leaving tile */
+      for (j = 0; j < nh; j++) {
+/* buffer particles that are leaving tile, in direction order */
+         j1 = ihole[2*(j+1+(ntmax+1)*k)] - 1;
+         ist = ihole[1+2*(j+1+(ntmax+1)*k)];
+         ii = ncl[ist+8*k-1];
+         if (ii < npbmx) {
+            for (i = 0; i < idimp; i++) {
+               ppbuff[i+idimp*(ii+npbmx*k)]
+               = ppart[i+idimp*(j1+nppmx*k)];
+            }
+         }
+         else {
+            ip = 1;
+         }
+         ncl[ist+8*k-1] = ii + 1;
+      }
+/* set error */
+      if (ip > 0)
+         *(a->irc) = ncl[7+8*k];
+   }
+/* wait until all tiles are buffered */
+   cptpbarrier(ith);
+/* ppbuff overflow */
+   if (*(a->irc) > 0)
+      return;
+
+/* copy incoming particles from buffer into ppart: update ppart, kpic */
+/* loop over tiles of this thread */
+   for (k = nb; k < ne; k++) {
+      npp = kpic[k];
+      ky = k/mx1;
+/* loop over tiles in y, assume periodic boundary conditions */
+      kk = ky*mx1;
+/* find tile above */
+      kl = ky - 1;
+      if (kl < 0)
+         kl += my1;
+      kl = kl*mx1;
+/* find tile below */
+      kr = ky + 1;
+      if (kr >= my1)
+          kr -= my1;
+      kr = kr*mx1;
+/* loop over tiles in x, assume periodic boundary conditions */
+      kx = k - ky*mx1;
+      kxl = kx - 1;
+      if (kxl < 0)
+         kxl += mx1;
+      kxr = kx + 1;
+      if (kxr >= mx1)
+         kxr -= mx1;
+/* find tile number for different directions */
+      ks[0] = kxr + kk;
+      ks[1] = kxl + kk;
+      ks[2] = kx + kr;
+      ks[3] = kxr + kr;
+      ks[4] = kxl + kr;
+      ks[5] = kx + kl;
+      ks[6] = kxr + kl;
+      ks[7] = kxl + kl;
+/* loop over directions */
+      nh = ihole[2*(ntmax+1)*k];
+      ncoff = 0;
+      ih = 0;
+      ist = 0;
+      j1 = 0;
+      for (ii = 0; ii < 8; ii++) {
+         if (ii > 0)
+            ncoff = ncl[ii-1+8*ks[ii]];
+/* ip = number of particles coming from direction ii */
+         ip = ncl[ii+8*ks[ii]] - ncoff;
+         for (j = 0; j < ip; j++) {
+            ih += 1;
+/* insert incoming particles into holes */
+            if (ih <= nh) {
+               j1 = ihole[2*(ih+(ntmax+1)*k)] - 1;
+            }
+/* place overflow at end of array */
+            else {
+               j1 = npp;
+               npp += 1;
+            }
+            if (j1 < nppmx) {
+               for (i = 0; i < idimp; i++) {
+                  ppart[i+idimp*(j1+nppmx*k)]
+                  = ppbuff[i+idimp*(j+ncoff+npbmx*ks[ii])];
+                }
+            }
+            else {
+               ist = 1;
+            }
+         }
+      }
+/* set error */
+      if (ist > 0)
+         *(a->irc) = j1+1;
+/* fill up remaining holes in particle array with particles from bottom */
+      if (ih < nh) {
+         ip = nh - ih;
+         for (j = 0; j < ip; j++) {
+            j1 = npp - j - 1;
+            j2 = ihole[2*(nh-j+(ntmax+1)*k)] - 1;
+            if (j1 > j2) {
+/* move particle only if it is below current hole */
+               for (i = 0; i < idimp; i++) {
+                  ppart[i+idimp*(j2+nppmx*k)]
+                  = ppart[i+idimp*(j1+nppmx*k)];
+               }
+            }
+         }
+         npp -= ip;
+      }
+      kpic[k] = npp;
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cptgppushf2l(float ppart[], float fxy[], int kpic[], int ncl[],
+                  int ihole[], float qbm, float dt, float *ek,
+                  int idimp, int nppmx, int nx, int ny, int mx, int my,
+                  int nxv, int nyv, int mx1, int mxy1, int ntmax,
+                  int *irc) {
+/* for 2d code, this subroutine updates particle co-ordinates and
+   velocities using leap-frog scheme in time and first-order linear
+   interpolation in space, with periodic boundary conditions.
+   also determines list of particles which are leaving this tile
+   Pthreads pool version of cgppushf2l, with the same arguments.
+   the tiles are divided among the threads of the pool in equal blocks.
+   the pool must have been started by cinit_ptp
+   nyv = third dimension of field arrays, must be >= ny+1
+local data                                                            */
+   int i, nth;
+   double sum2;
+   double *sum;
+   struct pushargs a;
+   nth = cgetnth_ptp();
+   sum = (double *) malloc(8*nth*sizeof(double));
+   a.ppart = ppart; a.fxy = fxy; a.kpic = kpic; a.ncl = ncl;
+   a.ihole = ihole; a.qbm = qbm; a.dt = dt; a.sum = sum;
+   a.idimp = idimp; a.nppmx = nppmx; a.nx = nx; a.ny = ny; a.mx = mx;
+   a.my = my; a.nxv = nxv; a.mx1 = mx1; a.ntmax = ntmax; a.irc = irc;
+   cptpfor(cptpush,&a,mxy1);
+/* add energies of threads in thread order */
+   sum2 = 0.0;
+   for (i = 0; i < nth; i++) {
+      sum2 += sum[8*i];
+   }
+   free(sum);
+/* normalize kinetic energy */
+   *ek += 0.125f*sum2;
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cptgppost2l(float ppart[], float q[], int kpic[], float qm,
+                 int nppmx, int idimp, int mx, int my, int nxv, int nyv,
+                 int mx1, int mxy1) {
+/* for 2d code, this subroutine calculates particle charge density
+   using first-order linear interpolation, periodic boundaries
+   Pthreads pool version of cgppost2l, with the same arguments.
+   the tiles are divided among the threads of the pool in equal blocks,
+   and the tile edges are added with atomic compare and swap
+local data                                                            */
+   struct postargs a;
+   a.ppart = ppart; a.q = q; a.kpic = kpic; a.qm = qm; a.nppmx = nppmx;
+   a.idimp = idimp; a.mx = mx; a.my = my; a.nxv = nxv; a.nyv = nyv;
+   a.mx1 = mx1;
+   cptpfor(cptdepo,&a,mxy1);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cptpporderf2l(float ppart[], float ppbuff[], int kpic[], int ncl[],
+                   int ihole[], int idimp, int nppmx, int mx1, int my1,
+                   int npbmx, int ntmax, int *irc) {
+/* this subroutine sorts particles by x,y grid in tiles of mx, my
+   linear interpolation, with periodic boundary conditions
+   tiles are assumed to be arranged in 2D linear memory
+   Pthreads pool version of cpporderf2l, with the same arguments.
+   both phases are performed by one job of the pool, separated by
+   cptpbarrier, instead of by two parallel loops
+local data                                                            */
+   struct orderargs a;
+   a.ppart = ppart; a.ppbuff = ppbuff; a.kpic = kpic; a.ncl = ncl;
+   a.ihole = ihole; a.idimp = idimp; a.nppmx = nppmx; a.mx1 = mx1;
+   a.my1 = my1; a.npbmx = npbmx; a.ntmax = ntmax; a.irc = irc;
+   cptpfor(cptorder,&a,mx1*my1);
+   return;
+}
@@ -0,0 +1,15 @@
+/* header file for mpth2.c */
+
+void cptgppushf2l(float ppart[], float fxy[], int kpic[], int ncl[],
+                  int ihole[], float qbm, float dt, float *ek,
+                  int idimp, int nppmx, int nx, int ny, int mx, int my,
+                  int nxv, int nyv, int mx1, int mxy1, int ntmax,
+                  int *irc);
+
+void cptgppost2l(float ppart[], float q[], int kpic[], float qm,
+                 int nppmx, int idimp, int mx, int my, int nxv, int nyv,
+                 int mx1, int mxy1);
+
+void cptpporderf2l(float ppart[], float ppbuff[], int kpic[], int ncl[],
+                   int ihole[], int idimp, int nppmx, int mx1, int my1,
+                   int npbmx, int ntmax, int *irc);
@@ -144,6 +144,125 @@ local data                                                            */
    return;
 }
 
+/*--------------------------------------------------------------------*/
+void cdistr2g(float part[], float vtx, float vty, float vdx, float vdy,
+              float ampg, float sigx, float sigy, int npx, int npy,
+              int idimp, int nop, int nx, int ny, int ipbc) {
+/* for 2d code, this subroutine calculates initial particle co-ordinates
+   and velocities with density peaked at the center of the system and
+   maxwellian velocity with drift
+   in each direction, the density is a uniform background plus a
+   gaussian which holds a fraction ampg of the particles.  co-ordinates
+   are found by inverting the cumulative distribution at evenly spaced
+   points, so that the loading is quiet, as in cdistr2.
+   part[n][0] = position x of particle n
+   part[n][1] = position y of particle n
+   part[n][2] = velocity vx of particle n
+   part[n][3] = velocity vy of particle n
+   vtx/vty = thermal velocity of electrons in x/y direction
+   vdx/vdy = drift velocity of beam electrons in x/y direction
+   ampg = fraction of particles in gaussian, in each direction, 0 to 1
+   sigx/sigy = width of gaussian in x/y direction, in grid units
+   npx/npy = initial number of particles distributed in x/y direction
+   idimp = size of phase space = 4
+   nop = number of particles
+   nx/ny = system length in x/y direction
+   ipbc = particle boundary condition = (0,1,2,3) =
+   (none,2d periodic,2d reflecting,mixed reflecting/periodic)
+   ranorm = gaussian random number with zero mean and unit variance
+local data                                                            */
+   int j, k, k1, n, npxy;
+   float edgelx, edgely, at1, at2, sum1, sum2;
+   double dsum1, dsum2, ag, ax, e0, u, t, t0, t1;
+   npxy = npx*npy;
+/* set boundary values */
+   edgelx = 0.0;
+   edgely = 0.0;
+   at1 = (float) nx;
+   at2 = (float) ny;
+   if (ipbc==2) {
+      edgelx = 1.0;
+      edgely = 1.0;
+      at1 = (float) (nx-2);
+      at2 = (float) (ny-2);
+   }
+   else if (ipbc==3) {
+      edgelx = 1.0;
+      at1 = (float) (nx-2);
+   }
+/* find x co-ordinates by bisection, t = fraction of system length */
+/* part[j][2] is used as temporary storage                         */
+   ag = sigx > 0.0 ? ampg : 0.0;
+   ax = ag > 0.0 ? at1/(sqrt(2.0)*sigx) : 0.0;
+   e0 = erf(-0.5*ax);
+   for (j = 0; j < npx; j++) {
+      u = ((double) j + 0.5)/(double) npx;
+      t0 = 0.0;
+      t1 = 1.0;
+      for (n = 0; n < 40; n++) {
+         t = 0.5*(t0 + t1);
+         dsum1 = (1.0 - ag)*t;
+         if (ag > 0.0)
+            dsum1 += ag*(erf(ax*(t - 0.5)) - e0)/(-2.0*e0);
+         if (dsum1 < u)
+            t0 = t;
+         else
+            t1 = t;
+      }
+      part[2+idimp*j] = edgelx + at1*0.5*(t0 + t1);
+   }
+/* find y co-ordinates by bisection, part[k][3] is temporary storage */
+   ag = sigy > 0.0 ? ampg : 0.0;
+   ax = ag > 0.0 ? at2/(sqrt(2.0)*sigy) : 0.0;
+   e0 = erf(-0.5*ax);
+   for (k = 0; k < npy; k++) {
+      u = ((double) k + 0.5)/(double) npy;
+      t0 = 0.0;
+      t1 = 1.0;
+      for (n = 0; n < 40; n++) {
+         t = 0.5*(t0 + t1);
+         dsum1 = (1.0 - ag)*t;
+         if (ag > 0.0)
+            dsum1 += ag*(erf(ax*(t - 0.5)) - e0)/(-2.0*e0);
+         if (dsum1 < u)
+            t0 = t;
+         else
+            t1 = t;
+      }
+      part[3+idimp*k] = edgely + at2*0.5*(t0 + t1);
+   }
+/* peaked density profile */
+   for (k = 0; k < npy; k++) {
+      k1 = idimp*npx*k;
+      for (j = 0; j < npx; j++) {
+         part[idimp*j+k1] = part[2+idimp*j];
+         part[1+idimp*j+k1] = part[3+idimp*k];
+      }
+   }
+/* maxwellian velocity distribution */
+   for (j = 0; j < npxy; j++) {
+      part[2+idimp*j] = vtx*ranorm();
+      part[3+idimp*j] = vty*ranorm();
+   }
+/* add correct drift */
+   dsum1 = 0.0;
+   dsum2 = 0.0;
+   for (j = 0; j < npxy; j++) {
+      dsum1 += part[2+idimp*j];
+      dsum2 += part[3+idimp*j];
+   }
+   sum1 = dsum1;
+   sum2 = dsum2;
+   at1 = 1.0/(float) npxy;
+   sum1 = at1*sum1 - vdx;
+   sum2 = at1*sum2 - vdy;
+   for (j = 0; j < npxy; j++) {
+      part[2+idimp*j] -= sum1;
+      part[3+idimp*j] -= sum2;
+   }
+   return;
+}
+
 /*--------------------------------------------------------------------*/
 void cdblkp2l(float part[], int kpic[], int *nppmx, int idimp, int nop,
               int mx, int my, int mx1, int mxy1, int *irc) {
@@ -362,16 +481,12 @@ void cgppush2l(float ppart[], float fxy[], int kpic[], float qbm,
    ipbc = particle boundary condition = (0,1,2,3) =
    (none,2d periodic,2d reflecting,mixed reflecting/periodic)
 local data                                                            */
-#define MXV             33
-#define MYV             33
    int noff, moff, npoff, npp;
    int i, j, k, nn, mm, mxv;
    float qtm, edgelx, edgely, edgerx, edgery, dxp, dyp, amx, amy;
    float x, y, dx, dy, vx, vy;
-   float sfxy[2*MXV*MYV];
-/* float sfxy[2*(mx+1)*(my+1)]; */
+   float *sfxy;
    double sum1, sum2;
-/* mxv = MXV; */
    mxv = mx+1;
    qtm = qbm*dt;
    sum2 = 0.0;
@@ -390,14 +505,15 @@ local data                                                            */
       edgelx = 1.0f;
       edgerx = (float) (nx-1);
    }
-/* error if local array is too small */
-/* if ((mx >= MXV) || (my >= MYV))   */
-/*    return;                        */
 /* loop over tiles */
-#pragma omp parallel for \
+#pragma omp parallel \
 private(i,j,k,noff,moff,npp,npoff,nn,mm,x,y,dxp,dyp,amx,amy,dx,dy, \
 vx,vy,sum1,sfxy) \
 reduction(+:sum2)
+   {
+/* allocate local fields for each thread */
+   sfxy = (float *) malloc(2*mxv*(my+1)*sizeof(float));
+#pragma omp for
    for (k = 0; k < mxy1; k++) {
       noff = k/mx1;
       moff = my*noff;
@@ -474,11 +590,11 @@ reduction(+:sum2)
       }
       sum2 += sum1;
    }
+   free(sfxy);
+   }
 /* normalize kinetic energy */
    *ek += 0.125f*sum2;
    return;
-#undef MXV
-#undef MYV
 }
 
 /*--------------------------------------------------------------------*/
@@ -535,29 +651,27 @@ void cgppushf2l(float ppart[], float fxy[], int kpic[], int ncl[],
    irc = maximum overflow, returned only if error occurs, when irc > 0
    optimized version
 local data                                                            */
-#define MXV             33
-#define MYV             33
    int noff, moff, npoff, npp;
    int i, j, k, ih, nh, nn, mm, mxv;
    float qtm, dxp, dyp, amx, amy;
    float x, y, dx, dy, vx, vy;
    float anx, any, edgelx, edgely, edgerx, edgery;
-   float sfxy[2*MXV*MYV];
-/* float sfxy[2*(mx+1)*(my+1)]; */
+   float *sfxy;
    double sum1, sum2;
    mxv = mx + 1;
    qtm = qbm*dt;
    anx = (float) nx;
    any = (float) ny;
    sum2 = 0.0;
-/* error if local array is too small */
-/* if ((mx >= MXV) || (my >= MYV))   */
-/*    return;                        */
 /* loop over tiles */
-#pragma omp parallel for \
+#pragma omp parallel \
 private(i,j,k,noff,moff,npp,npoff,nn,mm,ih,nh,x,y,dxp,dyp,amx,amy, \
 dx,dy,vx,vy,edgelx,edgely,edgerx,edgery,sum1,sfxy) \
 reduction(+:sum2)
+   {
+/* allocate local fields for each thread */
+   sfxy = (float *) malloc(2*mxv*(my+1)*sizeof(float));
+#pragma omp for
    for (k = 0; k < mxy1; k++) {
       noff = k/mx1;
       moff = my*noff;
@@ -689,11 +803,11 @@ reduction(+:sum2)
       }
       ihole[2*(ntmax+1)*k] = ih;
    }
+   free(sfxy);
+   }
 /* normalize kinetic energy */
    *ek += 0.125f*sum2;
    return;
-#undef MXV
-#undef MYV
 }
 
 /*--------------------------------------------------------------------*/
@@ -726,20 +840,18 @@ void cgppost2l(float ppart[], float q[], int kpic[], float qm,
    mx1 = (system length in x direction - 1)/mx + 1
    mxy1 = mx1*my1, where my1 = (system length in y direction - 1)/my + 1
 local data                                                            */
-#define MXV             33
-#define MYV             33
    int noff, moff, npoff, npp, mxv;
    int i, j, k, nn, mm;
    float x, y, dxp, dyp, amx, amy;
-   float sq[MXV*MYV];
-/* float sq[(mx+1)*(my+1)]; */
+   float *sq;
    mxv = mx + 1;
-/* error if local array is too small */
-/* if ((mx >= MXV) || (my >= MYV))   */
-/*    return;                        */
 /* loop over tiles */
-#pragma omp parallel for \
+#pragma omp parallel \
 private(i,j,k,noff,moff,npp,npoff,nn,mm,x,y,dxp,dyp,amx,amy,sq)
+   {
+/* allocate local accumulator for each thread */
+   sq = (float *) malloc(mxv*(my+1)*sizeof(float));
+#pragma omp for
    for (k = 0; k < mxy1; k++) {
       noff = k/mx1;
       moff = my*noff;
@@ -805,9 +917,117 @@ private(i,j,k,noff,moff,npp,npoff,nn,mm,x,y,dxp,dyp,amx,amy,sq)
          }
       }
    }
+   free(sq);
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cgppost2lc(float ppart[], float q[], int kpic[], float qm,
+                int nppmx, int idimp, int mx, int my, int nxv, int nyv,
+                int mx1, int mxy1) {
+/* for 2d code, this subroutine calculates particle charge density
+   using first-order linear interpolation, periodic boundaries
+   OpenMP version using guard cells, without atomic updates
+   data deposited in tiles
+   particles stored segmented array
+   17 flops/particle, 6 loads, 4 stores
+   input: all, output: q
+   charge density is approximated by values at the nearest grid points
+   q(n,m)=qm*(1.-dx)*(1.-dy)
+   q(n+1,m)=qm*dx*(1.-dy)
+   q(n,m+1)=qm*(1.-dx)*dy
+   q(n+1,m+1)=qm*dx*dy
+   where n,m = leftmost grid points and dx = x-n, dy = y-m
+   tiles are processed in 4 passes, one for each color of a 2x2
+   checkerboard, (even,odd) tile in x by (even,odd) tile in y.  tiles
+   of the same color share no grid points, so each tile adds all of its
+   local accumulator to q without atomic updates.  each grid point
+   receives its contributions in the same order for any number of
+   threads, so the result is reproducible bit for bit
+   ppart[m][n][0] = position x of particle n in tile m
+   ppart[m][n][1] = position y of particle n in tile m
+   q[k][j] = charge density at grid point j,k
+   kpic = number of particles per tile
+   qm = charge on particle, in units of e
+   nppmx = maximum number of particles in tile
+   idimp = size of phase space = 4
+   mx/my = number of grids in sorting cell in x/y
+   nxv = first dimension of charge array, must be >= nx+1
+   nyv = second dimension of charge array, must be >= ny+1
+   mx1 = (system length in x direction - 1)/mx + 1
+   mxy1 = mx1*my1, where my1 = (system length in y direction - 1)/my + 1
+local data                                                            */
+   int my1, noff, moff, npoff, npp, mxv;
+   int i, j, k, l, nn, mm, ic, kx, ky, ncx, ncy;
+   float x, y, dxp, dyp, amx, amy;
+   float *sq;
+   mxv = mx + 1;
+   my1 = mxy1/mx1;
+#pragma omp parallel \
+private(i,j,k,l,ic,kx,ky,ncx,ncy,noff,moff,npp,npoff,nn,mm,x,y,dxp, \
+dyp,amx,amy,sq)
+   {
+/* allocate local accumulator for each thread */
+   sq = (float *) malloc(mxv*(my+1)*sizeof(float));
+/* loop over colors */
+   for (ic = 0; ic < 4; ic++) {
+      kx = ic%2;
+      ky = ic/2;
+      ncx = (mx1 - kx + 1)/2;
+      ncy = (my1 - ky + 1)/2;
+/* loop over tiles of one color */
+#pragma omp for
+      for (l = 0; l < ncx*ncy; l++) {
+         k = (2*(l/ncx) + ky)*mx1 + 2*(l%ncx) + kx;
+         noff = k/mx1;
+         moff = my*noff;
+         noff = mx*(k - mx1*noff);
+         npp = kpic[k];
+         npoff = nppmx*k;
+/* zero out local accumulator */
+         for (j = 0; j < mxv*(my+1); j++) {
+            sq[j] = 0.0f;
+         }
+/* loop over particles in tile */
+         for (j = 0; j < npp; j++) {
+/* find interpolation weights */
+            x = ppart[idimp*(j+npoff)];
+            y = ppart[1+idimp*(j+npoff)];
+            nn = x;
+            mm = y;
+            dxp = qm*(x - (float) nn);
+            dyp = y - (float) mm;
+            nn = nn - noff + mxv*(mm - moff);
+            amx = qm - dxp;
+            amy = 1.0f - dyp;
+/* deposit charge within tile to local accumulator */
+            x = sq[nn] + amx*amy;
+            y = sq[nn+1] + dxp*amy;
+            sq[nn] = x;
+            sq[nn+1] = y;
+            nn += mxv;
+            x = sq[nn] + amx*dyp;
+            y = sq[nn+1] + dxp*dyp;
+            sq[nn] = x;
+            sq[nn+1] = y;
+         }
+/* deposit charge to interior and edge points in global array */
+         nn = nxv - noff;
+         mm = nyv - moff;
+         nn = mx+1 < nn ? mx+1 : nn;
+         mm = my+1 < mm ? my+1 : mm;
+         for (j = 0; j < mm; j++) {
+            for (i = 0; i < nn; i++) {
+               q[i+noff+nxv*(j+moff)] += sq[i+mxv*j];
+            }
+         }
+      }
+/* implicit barrier ends each color */
+   }
+   free(sq);
+   }
    return;
-#undef MXV
-#undef MYV
 }
 
 /*--------------------------------------------------------------------*/
@@ -2210,6 +2430,16 @@ void cdistr2_(float *part, float *vtx, float *vty, float *vdx, float *vdy,
    return;
 }
 
+/*--------------------------------------------------------------------*/
+void cdistr2g_(float *part, float *vtx, float *vty, float *vdx,
+               float *vdy, float *ampg, float *sigx, float *sigy,
+               int *npx, int *npy, int *idimp, int *nop, int *nx, int *ny,
+               int *ipbc) {
+   cdistr2g(part,*vtx,*vty,*vdx,*vdy,*ampg,*sigx,*sigy,*npx,*npy,*idimp,
+            *nop,*nx,*ny,*ipbc);
+   return;
+}
+
 /*--------------------------------------------------------------------*/
 void cdblkp2l_(float *part, int *kpic, int *nppmx, int *idimp, int *nop,
                int *mx, int *my, int *mx1, int *mxy1, int *irc) {
@@ -2264,6 +2494,15 @@ void cgppost2l_(float *ppart, float *q, int *kpic, float *qm,
    return;
 }
 
+/*--------------------------------------------------------------------*/
+void cgppost2lc_(float *ppart, float *q, int *kpic, float *qm,
+                 int *nppmx, int *idimp, int *mx, int *my, int *nxv,
+                 int *nyv, int *mx1, int *mxy1) {
+   cgppost2lc(ppart,q,kpic,*qm,*nppmx,*idimp,*mx,*my,*nxv,*nyv,*mx1,
+              *mxy1);
+   return;
+}
+
 /*--------------------------------------------------------------------*/
 void cpporder2l_(float *ppart, float *ppbuff, int *kpic, int *ncl,
                  int *ihole, int *idimp, int *nppmx, int *nx, int *ny,
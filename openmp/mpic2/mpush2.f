@@ -75,6 +75,136 @@ c add correct drift
    50 continue
       return
       end
+c-----------------------------------------------------------------------
+      subroutine DISTR2G(part,vtx,vty,vdx,vdy,ampg,sigx,sigy,npx,npy,   
+     1idimp,nop,nx,ny,ipbc)
+c for 2d code, this subroutine calculates initial particle co-ordinates
+c and velocities with density peaked at the center of the system and
+c maxwellian velocity with drift
+c in each direction, the density is a uniform background plus a
+c gaussian which holds a fraction ampg of the particles.  co-ordinates
+c are found by inverting the cumulative distribution at evenly spaced
+c points, so that the loading is quiet, as in DISTR2.
+c part(1,n) = position x of particle n
+c part(2,n) = position y of particle n
+c part(3,n) = velocity vx of particle n
+c part(4,n) = velocity vy of particle n
+c vtx/vty = thermal velocity of electrons in x/y direction
+c vdx/vdy = drift velocity of beam electrons in x/y direction
+c ampg = fraction of particles in gaussian, in each direction, 0 to 1
+c sigx/sigy = width of gaussian in x/y direction, in grid units
+c npx/npy = initial number of particles distributed in x/y direction
+c idimp = size of phase space = 4
+c nop = number of particles
+c nx/ny = system length in x/y direction
+c ipbc = particle boundary condition = (0,1,2,3) =
+c (none,2d periodic,2d reflecting,mixed reflecting/periodic)
+c ranorm = gaussian random number with zero mean and unit variance
+      implicit none
+      integer npx, npy, idimp, nop, nx, ny, ipbc
+      real vtx, vty, vdx, vdy, ampg, sigx, sigy
+      real part
+      dimension part(idimp,nop)
+c local data
+      integer j, k, k1, n, npxy
+      real edgelx, edgely, at1, at2, sum1, sum2
+      double precision dsum1, dsum2, ag, ax, e0, u, t, t0, t1
+      double precision ranorm
+      npxy = npx*npy
+c set boundary values
+      edgelx = 0.0
+      edgely = 0.0
+      at1 = real(nx)
+      at2 = real(ny)
+      if (ipbc.eq.2) then
+         edgelx = 1.0
+         edgely = 1.0
+         at1 = real(nx-2)
+         at2 = real(ny-2)
+      else if (ipbc.eq.3) then
+         edgelx = 1.0
+         at1 = real(nx-2)
+      endif
+c find x co-ordinates by bisection, t = fraction of system length
+c part(3,j) is used as temporary storage
+      ag = 0.0d0
+      if (sigx.gt.0.0) ag = ampg
+      ax = 0.0d0
+      if (ag.gt.0.0d0) ax = at1/(sqrt(2.0d0)*sigx)
+      e0 = erf(-0.5d0*ax)
+      do 20 j = 1, npx
+      u = (dble(j) - 0.5d0)/dble(npx)
+      t0 = 0.0d0
+      t1 = 1.0d0
+      do 10 n = 1, 40
+      t = 0.5d0*(t0 + t1)
+      dsum1 = (1.0d0 - ag)*t
+      if (ag.gt.0.0d0) then
+         dsum1 = dsum1 + ag*(erf(ax*(t - 0.5d0)) - e0)/(-2.0d0*e0)
+      endif
+      if (dsum1.lt.u) then
+         t0 = t
+      else
+         t1 = t
+      endif
+   10 continue
+      part(3,j) = edgelx + at1*0.5d0*(t0 + t1)
+   20 continue
+c find y co-ordinates by bisection, part(4,k) is temporary storage
+      ag = 0.0d0
+      if (sigy.gt.0.0) ag = ampg
+      ax = 0.0d0
+      if (ag.gt.0.0d0) ax = at2/(sqrt(2.0d0)*sigy)
+      e0 = erf(-0.5d0*ax)
+      do 40 k = 1, npy
+      u = (dble(k) - 0.5d0)/dble(npy)
+      t0 = 0.0d0
+      t1 = 1.0d0
+      do 30 n = 1, 40
+      t = 0.5d0*(t0 + t1)
+      dsum1 = (1.0d0 - ag)*t
+      if (ag.gt.0.0d0) then
+         dsum1 = dsum1 + ag*(erf(ax*(t - 0.5d0)) - e0)/(-2.0d0*e0)
+      endif
+      if (dsum1.lt.u) then
+         t0 = t
+      else
+         t1 = t
+      endif
+   30 continue
+      part(4,k) = edgely + at2*0.5d0*(t0 + t1)
+   40 continue
+c peaked density profile
+      do 60 k = 1, npy
+      k1 = npx*(k - 1)
+      do 50 j = 1, npx
+      part(1,j+k1) = part(3,j)
+      part(2,j+k1) = part(4,k)
+   50 continue
+   60 continue
+c maxwellian velocity distribution
+      do 70 j = 1, npxy
+      part(3,j) = vtx*ranorm()
+      part(4,j) = vty*ranorm()
+   70 continue
+c add correct drift
+      dsum1 = 0.0d0
+      dsum2 = 0.0d0
+      do 80 j = 1, npxy
+      dsum1 = dsum1 + part(3,j)
+      dsum2 = dsum2 + part(4,j)
+   80 continue
+      sum1 = dsum1
+      sum2 = dsum2
+      at1 = 1.0/real(npxy)
+      sum1 = at1*sum1 - vdx
+      sum2 = at1*sum2 - vdy
+      do 90 j = 1, npxy
+      part(3,j) = part(3,j) - sum1
+      part(4,j) = part(4,j) - sum2
+   90 continue
+      return
+      end
 c-----------------------------------------------------------------------
       subroutine DBLKP2L(part,kpic,nppmx,idimp,nop,mx,my,mx1,mxy1,irc)
 c this subroutine finds the maximum number of particles in each tile of
@@ -306,8 +436,8 @@ c local data
       real qtm, edgelx, edgely, edgerx, edgery, dxp, dyp, amx, amy
       real x, y, dx, dy, vx, vy
       real sfxy
-      dimension sfxy(2,MXV,MYV)
-c     dimension sfxy(2,mx+1,my+1)
+c     dimension sfxy(2,MXV,MYV)
+      dimension sfxy(2,mx+1,my+1)
       double precision sum1, sum2
       qtm = qbm*dt
       sum2 = 0.0d0
@@ -478,8 +608,8 @@ c local data
       real x, y, dx, dy, vx, vy
       real anx, any, edgelx, edgely, edgerx, edgery
       real sfxy
-      dimension sfxy(2,MXV,MYV)
-c     dimension sfxy(2,mx+1,my+1)
+c     dimension sfxy(2,MXV,MYV)
+      dimension sfxy(2,mx+1,my+1)
       double precision sum1, sum2
       qtm = qbm*dt
       anx = real(nx)
@@ -732,6 +862,120 @@ c deposit charge to edge points in global array
 !$OMP END PARALLEL DO
       return
       end
+c-----------------------------------------------------------------------
+      subroutine GPPOST2LC(ppart,q,kpic,qm,nppmx,idimp,mx,my,nxv,nyv,mx1
+     1,mxy1)
+c for 2d code, this subroutine calculates particle charge density
+c using first-order linear interpolation, periodic boundaries
+c OpenMP version using guard cells, without atomic updates
+c data deposited in tiles
+c particles stored segmented array
+c 17 flops/particle, 6 loads, 4 stores
+c input: all, output: q
+c charge density is approximated by values at the nearest grid points
+c q(n,m)=qm*(1.-dx)*(1.-dy)
+c q(n+1,m)=qm*dx*(1.-dy)
+c q(n,m+1)=qm*(1.-dx)*dy
+c q(n+1,m+1)=qm*dx*dy
+c where n,m = leftmost grid points and dx = x-n, dy = y-m
+c tiles are processed in 4 passes, one for each color of a 2x2
+c checkerboard, (odd,even) tile in x by (odd,even) tile in y.  tiles
+c of the same color share no grid points, so each tile adds all of its
+c local accumulator to q without atomic updates.  each grid point
+c receives its contributions in the same order for any number of
+c threads, so the result is reproducible bit for bit
+c ppart(1,n,m) = position x of particle n in tile m
+c ppart(2,n,m) = position y of particle n in tile m
+c q(j,k) = charge density at grid point j,k
+c kpic = number of particles per tile
+c qm = charge on particle, in units of e
+c nppmx = maximum number of particles in tile
+c idimp = size of phase space = 4
+c mx/my = number of grids in sorting cell in x/y
+c nxv = first dimension of charge array, must be >= nx+1
+c nyv = second dimension of charge array, must be >= ny+1
+c mx1 = (system length in x direction - 1)/mx + 1
+c mxy1 = mx1*my1, where my1 = (system length in y direction - 1)/my + 1
+      implicit none
+      integer nppmx, idimp, mx, my, nxv, nyv, mx1, mxy1
+      real qm
+      real ppart, q
+      integer kpic
+      dimension ppart(idimp,nppmx,mxy1), q(nxv,nyv)
+      dimension kpic(mxy1)
+c local data
+      integer MXV, MYV
+      parameter(MXV=33,MYV=33)
+      integer my1, noff, moff, npp
+      integer i, j, k, l, nn, mm, ic, kx, ky, ncx, ncy
+      real x, y, dxp, dyp, amx, amy
+      real sq
+c     dimension sq(MXV,MYV)
+      dimension sq(mx+1,my+1)
+      my1 = mxy1/mx1
+c error if local array is too small
+c     if ((mx.ge.MXV).or.(my.ge.MYV)) return
+!$OMP PARALLEL
+!$OMP& PRIVATE(i,j,k,l,ic,kx,ky,ncx,ncy,noff,moff,npp,nn,mm,x,y,dxp,dyp,
+!$OMP& amx,amy,sq)
+c loop over colors
+      do 70 ic = 1, 4
+      kx = mod(ic-1,2)
+      ky = (ic - 1)/2
+      ncx = (mx1 - kx + 1)/2
+      ncy = (my1 - ky + 1)/2
+c loop over tiles of one color
+!$OMP DO
+      do 60 l = 1, ncx*ncy
+      k = (2*((l - 1)/ncx) + ky)*mx1 + 2*mod(l-1,ncx) + kx + 1
+      noff = (k - 1)/mx1
+      moff = my*noff
+      noff = mx*(k - mx1*noff - 1)
+      npp = kpic(k)
+c zero out local accumulator
+      do 20 j = 1, my+1
+      do 10 i = 1, mx+1
+      sq(i,j) = 0.0
+   10 continue
+   20 continue
+c loop over particles in tile
+      do 30 j = 1, npp
+c find interpolation weights
+      x = ppart(1,j,k)
+      y = ppart(2,j,k)
+      nn = x
+      mm = y
+      dxp = qm*(x - real(nn))
+      dyp = y - real(mm)
+      nn = nn - noff + 1
+      mm = mm - moff + 1
+      amx = qm - dxp
+      amy = 1.0 - dyp
+c deposit charge within tile to local accumulator
+      x = sq(nn,mm) + amx*amy
+      y = sq(nn+1,mm) + dxp*amy
+      sq(nn,mm) = x
+      sq(nn+1,mm) = y
+      x = sq(nn,mm+1) + amx*dyp
+      y = sq(nn+1,mm+1) + dxp*dyp
+      sq(nn,mm+1) = x
+      sq(nn+1,mm+1) = y
+   30 continue
+c deposit charge to interior and edge points in global array
+      nn = min(mx+1,nxv-noff)
+      mm = min(my+1,nyv-moff)
+      do 50 j = 1, mm
+      do 40 i = 1, nn
+      q(i+noff,j+moff) = q(i+noff,j+moff) + sq(i,j)
+   40 continue
+   50 continue
+   60 continue
+!$OMP END DO
+c implicit barrier ends each color
+   70 continue
+!$OMP END PARALLEL
+      return
+      end
 c-----------------------------------------------------------------------
       subroutine PPORDER2L(ppart,ppbuff,kpic,ncl,ihole,idimp,nppmx,nx,ny
      1,mx,my,mx1,my1,npbmx,ntmax,irc)
@@ -6,6 +6,10 @@ void cdistr2(float part[], float vtx, float vty, float vdx, float vdy,
              int npx, int npy, int idimp, int nop, int nx, int ny,
              int ipbc);
 
+void cdistr2g(float part[], float vtx, float vty, float vdx, float vdy,
+              float ampg, float sigx, float sigy, int npx, int npy,
+              int idimp, int nop, int nx, int ny, int ipbc);
+
 void cdblkp2l(float part[], int kpic[], int *nppmx, int idimp, int nop,
               int mx, int my, int mx1, int mxy1, int *irc);
 
@@ -31,6 +35,10 @@ void cgppost2l(float ppart[], float q[], int kpic[], float qm,
                int nppmx, int idimp, int mx, int my, int nxv, int nyv,
                int mx1, int mxy1);
 
+void cgppost2lc(float ppart[], float q[], int kpic[], float qm,
+                int nppmx, int idimp, int mx, int my, int nxv, int nyv,
+                int mx1, int mxy1);
+
 void cpporder2l(float ppart[], float ppbuff[], int kpic[], int ncl[],
                 int ihole[], int idimp, int nppmx, int nx, int ny,
                 int mx, int my, int mx1, int my1, int npbmx, int ntmax,
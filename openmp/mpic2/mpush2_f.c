@@ -11,6 +11,11 @@ void distr2_(float *part, float *vtx, float *vty, float *vdx, float *vdy,
              int *npx, int *npy, int *idimp, int *nop, int *nx, int *ny,
              int *ipbc);
 
+void distr2g_(float *part, float *vtx, float *vty, float *vdx,
+              float *vdy, float *ampg, float *sigx, float *sigy,
+              int *npx, int *npy, int *idimp, int *nop, int *nx, int *ny,
+              int *ipbc);
+
 void dblkp2l_(float *part, int *kpic, int *nppmx, int *idimp, int *nop,
               int *mx, int *my, int *mx1, int *mxy1, int *irc);
 
@@ -37,6 +42,10 @@ void gppost2l_(float *ppart, float *q, int *kpic, float *qm,
                int *nppmx, int *idimp, int *mx, int *my, int *nxv,
                int *nyv, int *mx1, int *mxy1);
 
+void gppost2lc_(float *ppart, float *q, int *kpic, float *qm,
+                int *nppmx, int *idimp, int *mx, int *my, int *nxv,
+                int *nyv, int *mx1, int *mxy1);
+
 void cguard2l_(float *fxy, int *nx, int *ny, int *nxe, int *nye);
 
 void aguard2l_(float *q, int *nx, int *ny, int *nxe, int *nye);
@@ -97,6 +106,15 @@ void cdistr2(float part[], float vtx, float vty, float vdx, float vdy,
    return;
 }
 
+/*--------------------------------------------------------------------*/
+void cdistr2g(float part[], float vtx, float vty, float vdx, float vdy,
+              float ampg, float sigx, float sigy, int npx, int npy,
+              int idimp, int nop, int nx, int ny, int ipbc) {
+   distr2g_(part,&vtx,&vty,&vdx,&vdy,&ampg,&sigx,&sigy,&npx,&npy,&idimp,
+            &nop,&nx,&ny,&ipbc);
+   return;
+}
+
 /*--------------------------------------------------------------------*/
 void cdblkp2l(float part[], int kpic[], int *nppmx, int idimp, int nop,
               int mx, int my, int mx1, int mxy1, int *irc) {
@@ -150,6 +168,15 @@ void cgppost2l(float ppart[], float q[], int kpic[], float qm,
    return;
 }
 
+/*--------------------------------------------------------------------*/
+void cgppost2lc(float ppart[], float q[], int kpic[], float qm,
+                int nppmx, int idimp, int mx, int my, int nxv, int nyv,
+                int mx1, int mxy1) {
+   gppost2lc_(ppart,q,kpic,&qm,&nppmx,&idimp,&mx,&my,&nxv,&nyv,&mx1,
+              &mxy1);
+   return;
+}
+
 /*--------------------------------------------------------------------*/
 void cpporder2l(float ppart[], float ppbuff[], int kpic[], int ncl[],
                 int ihole[], int idimp, int nppmx, int nx, int ny,
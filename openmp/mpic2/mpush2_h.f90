@@ -12,6 +12,16 @@
          real, dimension(idimp,nop), intent(inout) :: part
          end subroutine
       end interface
+!
+      interface
+         subroutine DISTR2G(part,vtx,vty,vdx,vdy,ampg,sigx,sigy,npx,npy,&
+     &idimp,nop,nx,ny,ipbc)
+         implicit none
+         integer, intent(in) :: npx, npy, idimp, nop, nx, ny, ipbc
+         real, intent(in) :: vtx, vty, vdx, vdy, ampg, sigx, sigy
+         real, dimension(idimp,nop), intent(inout) :: part
+         end subroutine
+      end interface
 !
       interface
          subroutine DBLKP2L(part,kpic,nppmx,idimp,nop,mx,my,mx1,mxy1,irc&
@@ -90,6 +100,19 @@
          integer, dimension(mxy1), intent(in) :: kpic
          end subroutine
       end interface
+!
+      interface
+         subroutine GPPOST2LC(ppart,q,kpic,qm,nppmx,idimp,mx,my,nxv,nyv&
+     &,mx1,mxy1)
+         implicit none
+         integer, intent(in) :: nppmx, idimp, mx, my, nxv, nyv
+         integer, intent(in) :: mx1, mxy1
+         real, intent(in) :: qm
+         real, dimension(idimp,nppmx,mxy1), intent(in) :: ppart
+         real, dimension(nxv,nyv), intent(inout) :: q
+         integer, dimension(mxy1), intent(in) :: kpic
+         end subroutine
+      end interface
 !
       interface
          subroutine PPORDER2L(ppart,ppbuff,kpic,ncl,ihole,idimp,nppmx,nx&
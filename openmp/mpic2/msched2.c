@@ -0,0 +1,633 @@
+/* load balanced tile scheduler for 2D OpenMP PIC codes */
+/* written for the skeleton PIC codes */
+
+#include <stdlib.h>
+#include "msched2.h"
+
+/*--------------------------------------------------------------------*/
+static int ccmpkey(const void *a, const void *b) {
+/* compares two sort keys, for qsort in decreasing order */
+   long long ka, kb;
+   ka = *(const long long *) a;
+   kb = *(const long long *) b;
+   return (ka < kb) - (ka > kb);
+}
+
+/*--------------------------------------------------------------------*/
+void csched2(int kpic[], int ktile[], int kstart[], int nfix, int nth,
+             int mxy1, float *sbal, float *tbal) {
+/* this subroutine divides the tiles among nth threads so that each
+   thread has nearly the same work, using the number of particles in
+   each tile as a cost model.  the cost of tile k is kpic[k] + nfix.
+   tiles are taken in order of decreasing cost, and each is given to the
+   thread with the least work so far (longest processing time first),
+   which is within 4/3 of the best possible division.
+   the tiles of thread i are ktile[kstart[i]:kstart[i+1]-1], in
+   increasing order.
+   also returns the load imbalance, the largest work of a thread divided
+   by the average work, for these lists and for the default static
+   schedule, which gives each thread a contiguous block of mxy1/nth
+   tiles
+   input: kpic, nfix, nth, mxy1, output: ktile, kstart, sbal, tbal
+   kpic[k] = number of particles in tile k
+   ktile = tile numbers of all threads, dimension mxy1
+   kstart[i] = start of list of thread i in ktile, dimension nth+1
+   nfix = cost of a tile without particles, in units of particles
+   nth = number of threads
+   mxy1 = number of tiles
+   sbal = load imbalance of default static schedule
+   tbal = load imbalance of ktile lists
+local data                                                            */
+   int i, j, k, n, nq, nr, imin;
+   int *kown;
+   long long cost, lmax, ltot;
+   long long *key, *load;
+   key = (long long *) malloc(mxy1*sizeof(long long));
+   load = (long long *) malloc(nth*sizeof(long long));
+   kown = (int *) malloc(mxy1*sizeof(int));
+/* default static schedule: first mxy1%nth threads have one more tile */
+   nq = mxy1/nth;
+   nr = mxy1 - nq*nth;
+   k = 0;
+   ltot = 0;
+   lmax = 0;
+   for (i = 0; i < nth; i++) {
+      n = i < nr ? nq + 1 : nq;
+      cost = 0;
+      for (j = 0; j < n; j++) {
+         cost += kpic[k] + nfix;
+         k += 1;
+      }
+      ltot += cost;
+      lmax = cost > lmax ? cost : lmax;
+   }
+   *sbal = 1.0;
+   if (ltot > 0)
+      *sbal = (double) nth*(double) lmax/(double) ltot;
+/* sort tiles by decreasing cost, with tile number in low 32 bits */
+   for (k = 0; k < mxy1; k++) {
+      key[k] = ((long long) (kpic[k] + nfix) << 32) + k;
+   }
+   qsort(key,mxy1,sizeof(long long),ccmpkey);
+/* give each tile to thread with least work */
+   for (i = 0; i < nth; i++) {
+      load[i] = 0;
+   }
+   for (n = 0; n < mxy1; n++) {
+      k = key[n] & 0xffffffffLL;
+      imin = 0;
+      for (i = 1; i < nth; i++) {
+         if (load[i] < load[imin])
+            imin = i;
+      }
+      load[imin] += kpic[k] + nfix;
+      kown[k] = imin;
+   }
+   lmax = 0;
+   for (i = 0; i < nth; i++) {
+      lmax = load[i] > lmax ? load[i] : lmax;
+   }
+   *tbal = 1.0;
+   if (ltot > 0)
+      *tbal = (double) nth*(double) lmax/(double) ltot;
+/* find start of each list */
+   for (i = 0; i <= nth; i++) {
+      kstart[i] = 0;
+   }
+   for (k = 0; k < mxy1; k++) {
+      kstart[kown[k]+1] += 1;
+   }
+   for (i = 0; i < nth; i++) {
+      kstart[i+1] += kstart[i];
+      load[i] = kstart[i];
+   }
+/* copy tiles into lists, in increasing order */
+   for (k = 0; k < mxy1; k++) {
+      i = kown[k];
+      ktile[load[i]] = k;
+      load[i] += 1;
+   }
+   free(kown);
+   free(load);
+   free(key);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cgppushf2ls(float ppart[], float fxy[], int kpic[], int ncl[],
+                 int ihole[], int ktile[], int kstart[], float qbm,
+                 float dt, float *ek, int idimp, int nppmx, int nx,
+                 int ny, int mx, int my, int nxv, int nyv, int mx1,
+                 int mxy1, int ntmax, int nth, int *irc) {
+/* for 2d code, this subroutine updates particle co-ordinates and
+   velocities using leap-frog scheme in time and first-order linear
+   interpolation in space, with periodic boundary conditions.
+   also determines list of particles which are leaving this tile
+   OpenMP version using guard cells, with tiles scheduled by csched2
+   data read in tiles
+   particles stored segmented array
+   44 flops/particle, 12 loads, 4 stores
+   input: all except ncl, ihole, irc, output: ppart, ncl, ihole, ek, irc
+   equations used are:
+   vx(t+dt/2) = vx(t-dt/2) + (q/m)*fx(x(t),y(t))*dt,
+   vy(t+dt/2) = vy(t-dt/2) + (q/m)*fy(x(t),y(t))*dt,
+   where q/m is charge/mass, and
+   x(t+dt) = x(t) + vx(t+dt/2)*dt, y(t+dt) = y(t) + vy(t+dt/2)*dt
+   fx(x(t),y(t)) and fy(x(t),y(t)) are approximated by interpolation from
+   the nearest grid points:
+   fx(x,y) = (1-dy)*((1-dx)*fx(n,m)+dx*fx(n+1,m)) + dy*((1-dx)*fx(n,m+1)
+      + dx*fx(n+1,m+1))
+   fy(x,y) = (1-dy)*((1-dx)*fy(n,m)+dx*fy(n+1,m)) + dy*((1-dx)*fy(n,m+1)
+      + dx*fy(n+1,m+1))
+   where n,m = leftmost grid points and dx = x-n, dy = y-m
+   ppart[m][n][0] = position x of particle n in tile m
+   ppart[m][n][1] = position y of particle n in tile m
+   ppart[m][n][2] = velocity vx of particle n in tile m
+   ppart[m][n][3] = velocity vy of particle n in tile m
+   fxy[k][j][0] = x component of force/charge at grid (j,k)
+   fxy[k][j][1] = y component of force/charge at grid (j,k)
+   that is, convolution of electric field over particle shape
+   kpic[k] = number of particles in tile k
+   ncl[k][i] = number of particles going to destination i, tile k
+   ihole[k][:][0] = location of hole in array left by departing particle
+   ihole[k][:][1] = destination of particle leaving hole
+   ihole[k][0][0] = ih, number of holes left (error, if negative)
+   ktile = tile numbers of all threads, from csched2
+   kstart[i] = start of list of thread i in ktile
+   qbm = particle charge/mass
+   dt = time interval between successive calculations
+   kinetic energy/mass at time t is also calculated, using
+   ek = .125*sum((vx(t+dt/2)+vx(t-dt/2))**2+(vy(t+dt/2)+vy(t-dt/2))**2)
+   idimp = size of phase space = 4
+   nppmx = maximum number of particles in tile
+   nx/ny = system length in x/y direction
+   mx/my = number of grids in sorting cell in x/y
+   nxv = second dimension of field arrays, must be >= nx+1
+   nyv = third dimension of field arrays, must be >= ny+1
+   mx1 = (system length in x direction - 1)/mx + 1
+   mxy1 = mx1*my1, where my1 = (system length in y direction - 1)/my + 1
+   ntmax = size of hole array for particles leaving tiles
+   nth = number of tile lists in ktile
+   irc = maximum overflow, returned only if error occurs, when irc > 0
+   optimized version
+local data                                                            */
+   int noff, moff, npoff, npp;
+   int i, j, k, il, ik, ih, nh, nn, mm, mxv;
+   float qtm, dxp, dyp, amx, amy;
+   float x, y, dx, dy, vx, vy;
+   float anx, any, edgelx, edgely, edgerx, edgery;
+   float *sfxy;
+   double sum1, sum2;
+   mxv = mx + 1;
+   qtm = qbm*dt;
+   anx = (float) nx;
+   any = (float) ny;
+   sum2 = 0.0;
+/* loop over tile lists */
+#pragma omp parallel \
+private(i,j,k,il,ik,noff,moff,npp,npoff,nn,mm,ih,nh,x,y,dxp,dyp,amx, \
+amy,dx,dy,vx,vy,edgelx,edgely,edgerx,edgery,sum1,sfxy) \
+reduction(+:sum2)
+   {
+/* allocate local fields for each thread */
+   sfxy = (float *) malloc(2*mxv*(my+1)*sizeof(float));
+#pragma omp for schedule(static,1)
+   for (il = 0; il < nth; il++) {
+      for (ik = kstart[il]; ik < kstart[il+1]; ik++) {
+         k = ktile[ik];
+         noff = k/mx1;
+         moff = my*noff;
+         noff = mx*(k - mx1*noff);
+         npp = kpic[k];
+         npoff = nppmx*k;
+         nn = nx - noff;
+         nn = mx < nn ? mx : nn;
+         mm = ny - moff;
+         mm = my < mm ? my : mm;
+         edgelx = noff;
+         edgerx = noff + nn;
+         edgely = moff;
+         edgery = moff + mm;
+         ih = 0;
+         nh = 0;
+         nn += 1;
+         mm += 1;
+/* load local fields from global array */
+         for (j = 0; j < mm; j++) {
+            for (i = 0; i < nn; i++) {
+               sfxy[2*(i+mxv*j)] = fxy[2*(i+noff+nxv*(j+moff))];
+               sfxy[1+2*(i+mxv*j)] = fxy[1+2*(i+noff+nxv*(j+moff))];
+            }
+         }
+/* clear counters */
+         for (j = 0; j < 8; j++) {
+            ncl[j+8*k] = 0;
+         }
+         sum1 = 0.0;
+/* loop over particles in tile */
+         for (j = 0; j < npp; j++) {
+/* find interpolation weights */
+            x = ppart[idimp*(j+npoff)];
+            y = ppart[1+idimp*(j+npoff)];
+            nn = x;
+            mm = y;
+            dxp = x - (float) nn;
+            dyp = y - (float) mm;
+            nn = 2*(nn - noff) + 2*mxv*(mm - moff);
+            amx = 1.0f - dxp;
+            amy = 1.0f - dyp;
+/* find acceleration */
+            dx = amx*sfxy[nn];
+            dy = amx*sfxy[nn+1];
+            dx = amy*(dxp*sfxy[nn+2] + dx);
+            dy = amy*(dxp*sfxy[nn+3] + dy);
+            nn += 2*mxv;
+            vx = amx*sfxy[nn];
+            vy = amx*sfxy[nn+1];
+            dx += dyp*(dxp*sfxy[nn+2] + vx);
+            dy += dyp*(dxp*sfxy[nn+3] + vy);
+/* new velocity */
+            vx = ppart[2+idimp*(j+npoff)];
+            vy = ppart[3+idimp*(j+npoff)];
+            dx = vx + qtm*dx;
+            dy = vy + qtm*dy;
+/* average kinetic energy */
+            vx += dx;
+            vy += dy;
+            sum1 += (vx*vx + vy*vy);
+            ppart[2+idimp*(j+npoff)] = dx;
+            ppart[3+idimp*(j+npoff)] = dy;
+/* new position */
+            dx = x + dx*dt;
+            dy = y + dy*dt;
+/* find particles going out of bounds */
+            mm = 0;
+/* count how many particles are going in each direction in ncl   */
+/* save their address and destination in ihole                   */
+/* use periodic boundary conditions and check for roundoff error */
+/* mm = direction particle is going                              */
+            if (dx >= edgerx) {
+               if (dx >= anx)
+                  dx -= anx;
+               mm = 2;
+            }
+            else if (dx < edgelx) {
+               if (dx < 0.0f) {
+                  dx += anx;
+                  if (dx < anx)
+                     mm = 1;
+                  else
+                     dx = 0.0;
+               }
+               else {
+                  mm = 1;
+               }
+            }
+            if (dy >= edgery) {
+               if (dy >= any)
+                  dy -= any;
+               mm += 6;
+            }
+            else if (dy < edgely) {
+               if (dy < 0.0) {
+                  dy += any;
+                  if (dy < any)
+                     mm += 3;
+                  else
+                     dy = 0.0;
+               }
+               else {
+                  mm += 3;
+               }
+            }
+/* set new position */
+            ppart[idimp*(j+npoff)] = dx;
+            ppart[1+idimp*(j+npoff)] = dy;
+/* increment counters */
+            if (mm > 0) {
+               ncl[mm+8*k-1] += 1;
+               ih += 1;
+               if (ih <= ntmax) {
+                  ihole[2*(ih+(ntmax+1)*k)] = j + 1;
+                  ihole[1+2*(ih+(ntmax+1)*k)] = mm;
+               }
+               else {
+                  nh = 1;
+               }
+            }
+         }
+         sum2 += sum1;
+/* set error and end of file flag */
+/* ihole overflow */
+         if (nh > 0) {
+            *irc = ih;
+            ih = -ih;
+         }
+         ihole[2*(ntmax+1)*k] = ih;
+      }
+   }
+   free(sfxy);
+   }
+/* normalize kinetic energy */
+   *ek += 0.125f*sum2;
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cgppost2ls(float ppart[], float q[], int kpic[], int ktile[],
+                int kstart[], float qm, int nppmx, int idimp, int mx,
+                int my, int nxv, int nyv, int mx1, int mxy1, int nth) {
+/* for 2d code, this subroutine calculates particle charge density
+   using first-order linear interpolation, periodic boundaries
+   OpenMP version using guard cells, with tiles scheduled by csched2
+   data deposited in tiles
+   particles stored segmented array
+   17 flops/particle, 6 loads, 4 stores
+   input: all, output: q
+   charge density is approximated by values at the nearest grid points
+   q(n,m)=qm*(1.-dx)*(1.-dy)
+   q(n+1,m)=qm*dx*(1.-dy)
+   q(n,m+1)=qm*(1.-dx)*dy
+   q(n+1,m+1)=qm*dx*dy
+   where n,m = leftmost grid points and dx = x-n, dy = y-m
+   ppart[m][n][0] = position x of particle n in tile m
+   ppart[m][n][1] = position y of particle n in tile m
+   q[k][j] = charge density at grid point j,k
+   kpic = number of particles per tile
+   ktile = tile numbers of all threads, from csched2
+   kstart[i] = start of list of thread i in ktile
+   qm = charge on particle, in units of e
+   nppmx = maximum number of particles in tile
+   idimp = size of phase space = 4
+   mx/my = number of grids in sorting cell in x/y
+   nxv = first dimension of charge array, must be >= nx+1
+   nyv = second dimension of charge array, must be >= ny+1
+   mx1 = (system length in x direction - 1)/mx + 1
+   mxy1 = mx1*my1, where my1 = (system length in y direction - 1)/my + 1
+   nth = number of tile lists in ktile
+local data                                                            */
+   int noff, moff, npoff, npp, mxv;
+   int i, j, k, il, ik, nn, mm;
+   float x, y, dxp, dyp, amx, amy;
+   float *sq;
+   mxv = mx + 1;
+/* loop over tile lists */
+#pragma omp parallel \
+private(i,j,k,il,ik,noff,moff,npp,npoff,nn,mm,x,y,dxp,dyp,amx,amy,sq)
+   {
+/* allocate local accumulator for each thread */
+   sq = (float *) malloc(mxv*(my+1)*sizeof(float));
+#pragma omp for schedule(static,1)
+   for (il = 0; il < nth; il++) {
+      for (ik = kstart[il]; ik < kstart[il+1]; ik++) {
+         k = ktile[ik];
+         noff = k/mx1;
+         moff = my*noff;
+         noff = mx*(k - mx1*noff);
+         npp = kpic[k];
+         npoff = nppmx*k;
+/* zero out local accumulator */
+         for (j = 0; j < mxv*(my+1); j++) {
+            sq[j] = 0.0f;
+         }
+/* loop over particles in tile */
+         for (j = 0; j < npp; j++) {
+/* find interpolation weights */
+            x = ppart[idimp*(j+npoff)];
+            y = ppart[1+idimp*(j+npoff)];
+            nn = x;
+            mm = y;
+            dxp = qm*(x - (float) nn);
+            dyp = y - (float) mm;
+            nn = nn - noff + mxv*(mm - moff);
+            amx = qm - dxp;
+            amy = 1.0f - dyp;
+/* deposit charge within tile to local accumulator */
+            x = sq[nn] + amx*amy;
+            y = sq[nn+1] + dxp*amy;
+            sq[nn] = x;
+            sq[nn+1] = y;
+            nn += mxv;
+            x = sq[nn] + amx*dyp;
+            y = sq[nn+1] + dxp*dyp;
+            sq[nn] = x;
+            sq[nn+1] = y;
+         }
+/* deposit charge to interior points in global array */
+         nn = nxv - noff;
+         mm = nyv - moff;
+         nn = mx < nn ? mx : nn;
+         mm = my < mm ? my : mm;
+         for (j = 1; j < mm; j++) {
+            for (i = 1; i < nn; i++) {
+               q[i+noff+nxv*(j+moff)] += sq[i+mxv*j];
+            }
+         }
+/* deposit charge to edge points in global array */
+         mm = nyv - moff;
+         mm = my+1 < mm ? my+1 : mm;
+         for (i = 1; i < nn; i++) {
+#pragma omp atomic
+            q[i+noff+nxv*moff] += sq[i];
+            if (mm > my) {
+#pragma omp atomic
+               q[i+noff+nxv*(mm+moff-1)] += sq[i+mxv*(mm-1)];
+            }
+         }
+         nn = nxv - noff;
+         nn = mx+1 < nn ? mx+1 : nn;
+         for (j = 0; j < mm; j++) {
+#pragma omp atomic
+            q[noff+nxv*(j+moff)] += sq[mxv*j];
+            if (nn > mx) {
+#pragma omp atomic
+               q[nn+noff-1+nxv*(j+moff)] += sq[nn-1+mxv*j];
+            }
+         }
+      }
+   }
+   free(sq);
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cpporderf2ls(float ppart[], float ppbuff[], int kpic[], int ncl[],
+                  int ihole[], int ktile[], int kstart[], int idimp,
+                  int nppmx, int mx1, int my1, int npbmx, int ntmax,
+                  int nth, int *irc) {
+/* this subroutine sorts particles by x,y grid in tiles of mx, my
+   linear interpolation, with periodic boundary conditions
+   tiles are assumed to be arranged in 2D linear memory
+   the algorithm has 2 steps.  first, a prefix scan of ncl is performed
+   and departing particles are buffered in ppbuff in direction order.
+   then we copy the incoming particles from other tiles into ppart.
+   it assumes that the number, location, and destination of particles 
+   leaving a tile have been previously stored in ncl and ihole by the
+   cgppushf2l or cgppushf2ls procedure.
+   tiles are scheduled by csched2.
+   input: all except ppbuff, irc
+   output: ppart, ppbuff, kpic, ncl, irc
+   ppart[k][n][0] = position x of particle n in tile k
+   ppart[k][n][1] = position y of particle n in tile k 
+   ppbuff[k][n][i] = i co-ordinate of particle n in tile k
+   kpic[k] = number of particles in tile k
+   ncl[k][i] = number of particles going to destination i, tile k
+   ihole[k][:][0] = location of hole in array left by departing particle
+   ihole[k][:][1] = direction destination of particle leaving hole
+   all for tile k
+   ihole[k][0][0] = ih, number of holes left (error, if negative)
+   ktile = tile numbers of all threads, from csched2
+   kstart[i] = start of list of thread i in ktile
+   idimp = size of phase space = 4
+   nppmx = maximum number of particles in tile
+   mx1 = (system length in x direction - 1)/mx + 1
+   my1 = (system length in y direction - 1)/my + 1
+   npbmx = size of buffer array ppbuff
+   ntmax = size of hole array for particles leaving tiles
+   nth = number of tile lists in ktile
+   irc = maximum overflow, returned only if error occurs, when irc > 0
+local data                                                            */
+   int npp, ncoff;
+   int i, j, k, il, ik, ii, kx, ky, ih, nh, ist, isum;
+   int ip, j1, j2, kxl, kxr, kk, kl, kr;
+   int ks[8];
+/* buffer particles that are leaving tile: update ppbuff, ncl */
+/* loop over tile lists */
+#pragma omp parallel for schedule(static,1) \
+private(i,j,k,ik,isum,ist,nh,ip,j1,ii)
+   for (il = 0; il < nth; il++) {
+      for (ik = kstart[il]; ik < kstart[il+1]; ik++) {
+         k = ktile[ik];
+/* find address offset for ordered ppbuff array */
+         isum = 0;
+         for (j = 0; j < 8; j++) {
+            ist = ncl[j+8*k];
+            ncl[j+8*k] = isum;
+            isum += ist;
+         }
+         nh = ihole[2*(ntmax+1)*k];
+         ip = 0;
+/* loop over particles leaving tile */
+         for (j = 0; j < nh; j++) {
+/* buffer particles that are leaving tile, in direction order */
+            j1 = ihole[2*(j+1+(ntmax+1)*k)] - 1;
+            ist = ihole[1+2*(j+1+(ntmax+1)*k)];
+            ii = ncl[ist+8*k-1];
+            if (ii < npbmx) {
+               for (i = 0; i < idimp; i++) {
+                  ppbuff[i+idimp*(ii+npbmx*k)]
+                  = ppart[i+idimp*(j1+nppmx*k)];
+               }
+            }
+            else {
+               ip = 1;
+            }
+            ncl[ist+8*k-1] = ii + 1;
+         }
+/* set error */
+         if (ip > 0)
+            *irc = ncl[7+8*k];
+      }
+   }
+/* ppbuff overflow */
+   if (*irc > 0)
+      return;
+
+/* copy incoming particles from buffer into ppart: update ppart, kpic */
+/* loop over tile lists */
+#pragma omp parallel for schedule(static,1) \
+private(i,j,k,ik,ii,kk,npp,kx,ky,kl,kr,kxl,kxr,ih,nh,ncoff,ist,j1,j2,ip, \
+ks)
+   for (il = 0; il < nth; il++) {
+      for (ik = kstart[il]; ik < kstart[il+1]; ik++) {
+         k = ktile[ik];
+         npp = kpic[k];
+         ky = k/mx1;
+/* loop over tiles in y, assume periodic boundary conditions */
+         kk = ky*mx1;
+/* find tile above */
+         kl = ky - 1;
+         if (kl < 0)
+            kl += my1;
+         kl = kl*mx1;
+/* find tile below */
+         kr = ky + 1;
+         if (kr >= my1)
+             kr -= my1;
+         kr = kr*mx1;
+/* loop over tiles in x, assume periodic boundary conditions */
+         kx = k - ky*mx1;
+         kxl = kx - 1;
+         if (kxl < 0)
+            kxl += mx1;
+         kxr = kx + 1;
+         if (kxr >= mx1)
+            kxr -= mx1;
+/* find tile number for different directions */
+         ks[0] = kxr + kk;
+         ks[1] = kxl + kk;
+         ks[2] = kx + kr;
+         ks[3] = kxr + kr;
+         ks[4] = kxl + kr;
+         ks[5] = kx + kl;
+         ks[6] = kxr + kl;
+         ks[7] = kxl + kl;
+/* loop over directions */
+         nh = ihole[2*(ntmax+1)*k];
+         ncoff = 0;
+         ih = 0;
+         ist = 0;
+         j1 = 0;
+         for (ii = 0; ii < 8; ii++) {
+            if (ii > 0)
+               ncoff = ncl[ii-1+8*ks[ii]];
+/* ip = number of particles coming from direction ii */
+            ip = ncl[ii+8*ks[ii]] - ncoff;
+            for (j = 0; j < ip; j++) {
+               ih += 1;
+/* insert incoming particles into holes */
+               if (ih <= nh) {
+                  j1 = ihole[2*(ih+(ntmax+1)*k)] - 1;
+               }
+/* place overflow at end of array */
+               else {
+                  j1 = npp;
+                  npp += 1;
+               }
+               if (j1 < nppmx) {
+                  for (i = 0; i < idimp; i++) {
+                     ppart[i+idimp*(j1+nppmx*k)]
+                     = ppbuff[i+idimp*(j+ncoff+npbmx*ks[ii])];
+                   }
+               }
+               else {
+                  ist = 1;
+               }
+            }
+         }
+/* set error */
+         if (ist > 0)
+            *irc = j1+1;
+/* fill up remaining holes in particle array with particles from bottom */
+         if (ih < nh) {
+            ip = nh - ih;
+            for (j = 0; j < ip; j++) {
+               j1 = npp - j - 1;
+               j2 = ihole[2*(nh-j+(ntmax+1)*k)] - 1;
+               if (j1 > j2) {
+/* move particle only if it is below current hole */
+                  for (i = 0; i < idimp; i++) {
+                     ppart[i+idimp*(j2+nppmx*k)]
+                     = ppart[i+idimp*(j1+nppmx*k)];
+                  }
+               }
+            }
+            npp -= ip;
+         }
+         kpic[k] = npp;
+      }
+   }
+   return;
+}
+
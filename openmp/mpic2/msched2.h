@@ -0,0 +1,19 @@
+/* header file for msched2.c */
+
+void csched2(int kpic[], int ktile[], int kstart[], int nfix, int nth,
+             int mxy1, float *sbal, float *tbal);
+
+void cgppushf2ls(float ppart[], float fxy[], int kpic[], int ncl[],
+                 int ihole[], int ktile[], int kstart[], float qbm,
+                 float dt, float *ek, int idimp, int nppmx, int nx,
+                 int ny, int mx, int my, int nxv, int nyv, int mx1,
+                 int mxy1, int ntmax, int nth, int *irc);
+
+void cgppost2ls(float ppart[], float q[], int kpic[], int ktile[],
+                int kstart[], float qm, int nppmx, int idimp, int mx,
+                int my, int nxv, int nyv, int mx1, int mxy1, int nth);
+
+void cpporderf2ls(float ppart[], float ppbuff[], int kpic[], int ncl[],
+                  int ihole[], int ktile[], int kstart[], int idimp,
+                  int nppmx, int mx1, int my1, int npbmx, int ntmax,
+                  int nth, int *irc);
@@ -0,0 +1,540 @@
+/* multi-species library for 2D OpenMP PIC codes */
+/* written for the skeleton PIC codes */
+
+#include <stdlib.h>
+#include "mspec2.h"
+
+/*--------------------------------------------------------------------*/
+void cgppushf2lm(float ppart[], float fxy[], int kpic[], int ncl[],
+                 int ihole[], float qbm[], float dt, float ek[],
+                 int idimp, int nppmx, int nx, int ny, int mx, int my,
+                 int nxv, int nyv, int mx1, int mxy1, int ntmax, int nsp,
+                 int *irc) {
+/* for 2d code, this subroutine updates particle co-ordinates and
+   velocities of nsp species using leap-frog scheme in time and
+   first-order linear interpolation in space, with periodic boundary
+   conditions.
+   also determines list of particles which are leaving this tile
+   OpenMP version using guard cells
+   the fields of each tile are read once for all species
+   particles stored segmented array, with species m in tiles
+   m*mxy1 to m*mxy1+mxy1-1
+   44 flops/particle, 12 loads, 4 stores
+   input: all except ncl, ihole, irc, output: ppart, ncl, ihole, ek, irc
+   equations used are:
+   vx(t+dt/2) = vx(t-dt/2) + (q/m)*fx(x(t),y(t))*dt,
+   vy(t+dt/2) = vy(t-dt/2) + (q/m)*fy(x(t),y(t))*dt,
+   where q/m is charge/mass, and
+   x(t+dt) = x(t) + vx(t+dt/2)*dt, y(t+dt) = y(t) + vy(t+dt/2)*dt
+   fx(x(t),y(t)) and fy(x(t),y(t)) are approximated by interpolation from
+   the nearest grid points:
+   fx(x,y) = (1-dy)*((1-dx)*fx(n,m)+dx*fx(n+1,m)) + dy*((1-dx)*fx(n,m+1)
+      + dx*fx(n+1,m+1))
+   fy(x,y) = (1-dy)*((1-dx)*fy(n,m)+dx*fy(n+1,m)) + dy*((1-dx)*fy(n,m+1)
+      + dx*fy(n+1,m+1))
+   where n,m = leftmost grid points and dx = x-n, dy = y-m
+   ppart[l][m][n][0] = position x of particle n in tile m of species l
+   ppart[l][m][n][1] = position y of particle n in tile m of species l
+   ppart[l][m][n][2] = velocity vx of particle n in tile m of species l
+   ppart[l][m][n][3] = velocity vy of particle n in tile m of species l
+   fxy[k][j][0] = x component of force/charge at grid (j,k)
+   fxy[k][j][1] = y component of force/charge at grid (j,k)
+   that is, convolution of electric field over particle shape
+   kpic[l][k] = number of particles in tile k of species l
+   ncl[l][k][i] = number of particles going to destination i, tile k
+   ihole[l][k][:][0] = location of hole in array left by departing
+   particle
+   ihole[l][k][:][1] = destination of particle leaving hole
+   ihole[l][k][0][0] = ih, number of holes left (error, if negative)
+   qbm[l] = particle charge/mass of species l
+   dt = time interval between successive calculations
+   kinetic energy/mass at time t of species l is also calculated, using
+   ek[l] = .125*sum((vx(t+dt/2)+vx(t-dt/2))**2+(vy(t+dt/2)+vy(t-dt/2))**2)
+   idimp = size of phase space = 4
+   nppmx = maximum number of particles in tile
+   nx/ny = system length in x/y direction
+   mx/my = number of grids in sorting cell in x/y
+   nxv = second dimension of field arrays, must be >= nx+1
+   nyv = third dimension of field arrays, must be >= ny+1
+   mx1 = (system length in x direction - 1)/mx + 1
+   mxy1 = mx1*my1, where my1 = (system length in y direction - 1)/my + 1
+   ntmax = size of hole array for particles leaving tiles
+   nsp = number of species
+   irc = maximum overflow, returned only if error occurs, when irc > 0
+local data                                                            */
+   int noff, moff, npoff, npp, nn0, mm0, kk;
+   int i, j, k, l, ih, nh, nn, mm, mxv;
+   float qtm, dxp, dyp, amx, amy;
+   float x, y, dx, dy, vx, vy;
+   float anx, any, edgelx, edgely, edgerx, edgery;
+   float *sfxy;
+   double sum1;
+   double *sum2;
+   mxv = mx + 1;
+   anx = (float) nx;
+   any = (float) ny;
+   sum2 = (double *) malloc(nsp*sizeof(double));
+   for (l = 0; l < nsp; l++) {
+      sum2[l] = 0.0;
+   }
+/* loop over tiles */
+#pragma omp parallel \
+private(i,j,k,l,kk,noff,moff,npp,npoff,nn,mm,nn0,mm0,ih,nh,x,y,dxp,dyp, \
+amx,amy,dx,dy,vx,vy,qtm,edgelx,edgely,edgerx,edgery,sum1,sfxy)
+   {
+/* allocate local fields for each thread */
+   sfxy = (float *) malloc(2*mxv*(my+1)*sizeof(float));
+#pragma omp for
+   for (k = 0; k < mxy1; k++) {
+      noff = k/mx1;
+      moff = my*noff;
+      noff = mx*(k - mx1*noff);
+      nn0 = nx - noff;
+      nn0 = mx < nn0 ? mx : nn0;
+      mm0 = ny - moff;
+      mm0 = my < mm0 ? my : mm0;
+      edgelx = noff;
+      edgerx = noff + nn0;
+      edgely = moff;
+      edgery = moff + mm0;
+/* load local fields from global array */
+      for (j = 0; j < mm0+1; j++) {
+         for (i = 0; i < nn0+1; i++) {
+            sfxy[2*(i+mxv*j)] = fxy[2*(i+noff+nxv*(j+moff))];
+            sfxy[1+2*(i+mxv*j)] = fxy[1+2*(i+noff+nxv*(j+moff))];
+         }
+      }
+/* loop over species */
+      for (l = 0; l < nsp; l++) {
+         kk = k + mxy1*l;
+         npp = kpic[kk];
+         npoff = nppmx*kk;
+         qtm = qbm[l]*dt;
+         ih = 0;
+         nh = 0;
+/* clear counters */
+         for (j = 0; j < 8; j++) {
+            ncl[j+8*kk] = 0;
+         }
+         sum1 = 0.0;
+/* loop over particles in tile */
+         for (j = 0; j < npp; j++) {
+/* find interpolation weights */
+            x = ppart[idimp*(j+npoff)];
+            y = ppart[1+idimp*(j+npoff)];
+            nn = x;
+            mm = y;
+            dxp = x - (float) nn;
+            dyp = y - (float) mm;
+            nn = 2*(nn - noff) + 2*mxv*(mm - moff);
+            amx = 1.0f - dxp;
+            amy = 1.0f - dyp;
+/* find acceleration */
+            dx = amx*sfxy[nn];
+            dy = amx*sfxy[nn+1];
+            dx = amy*(dxp*sfxy[nn+2] + dx);
+            dy = amy*(dxp*sfxy[nn+3] + dy);
+            nn += 2*mxv;
+            vx = amx*sfxy[nn];
+            vy = amx*sfxy[nn+1];
+            dx += dyp*(dxp*sfxy[nn+2] + vx);
+            dy += dyp*(dxp*sfxy[nn+3] + vy);
+/* new velocity */
+            vx = ppart[2+idimp*(j+npoff)];
+            vy = ppart[3+idimp*(j+npoff)];
+            dx = vx + qtm*dx;
+            dy = vy + qtm*dy;
+/* average kinetic energy */
+            vx += dx;
+            vy += dy;
+            sum1 += (vx*vx + vy*vy);
+            ppart[2+idimp*(j+npoff)] = dx;
+            ppart[3+idimp*(j+npoff)] = dy;
+/* new position */
+            dx = x + dx*dt;
+            dy = y + dy*dt;
+/* find particles going out of bounds */
+            mm = 0;
+/* count how many particles are going in each direction in ncl   */
+/* save their address and destination in ihole                   */
+/* use periodic boundary conditions and check for roundoff error */
+/* mm = direction particle is going                              */
+            if (dx >= edgerx) {
+               if (dx >= anx)
+                  dx -= anx;
+               mm = 2;
+            }
+            else if (dx < edgelx) {
+               if (dx < 0.0f) {
+                  dx += anx;
+                  if (dx < anx)
+                     mm = 1;
+                  else
+                     dx = 0.0;
+               }
+               else {
+                  mm = 1;
+               }
+            }
+            if (dy >= edgery) {
+               if (dy >= any)
+                  dy -= any;
+               mm += 6;
+            }
+            else if (dy < edgely) {
+               if (dy < 0.0) {
+                  dy += any;
+                  if (dy < any)
+                     mm += 3;
+                  else
+                     dy = 0.0;
+               }
+               else {
+                  mm += 3;
+               }
+            }
+/* set new position */
+            ppart[idimp*(j+npoff)] = dx;
+            ppart[1+idimp*(j+npoff)] = dy;
+/* increment counters */
+            if (mm > 0) {
+               ncl[mm+8*kk-1] += 1;
+               ih += 1;
+               if (ih <= ntmax) {
+                  ihole[2*(ih+(ntmax+1)*kk)] = j + 1;
+                  ihole[1+2*(ih+(ntmax+1)*kk)] = mm;
+               }
+               else {
+                  nh = 1;
+               }
+            }
+         }
+/* add kinetic energy of species */
+#pragma omp atomic
+         sum2[l] += sum1;
+/* set error and end of file flag */
+/* ihole overflow */
+         if (nh > 0) {
+            *irc = ih;
+            ih = -ih;
+         }
+         ihole[2*(ntmax+1)*kk] = ih;
+      }
+   }
+   free(sfxy);
+   }
+/* normalize kinetic energy */
+   for (l = 0; l < nsp; l++) {
+      ek[l] += 0.125f*sum2[l];
+   }
+   free(sum2);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cgppost2lm(float ppart[], float q[], int kpic[], float qm[],
+                int nppmx, int idimp, int mx, int my, int nxv, int nyv,
+                int mx1, int mxy1, int nsp) {
+/* for 2d code, this subroutine calculates particle charge density
+   of nsp species using first-order linear interpolation, periodic
+   boundaries
+   OpenMP version using guard cells
+   data deposited in tiles, all species of a tile are deposited into
+   one local accumulator, which is added once to the global array
+   particles stored segmented array, with species m in tiles
+   m*mxy1 to m*mxy1+mxy1-1
+   17 flops/particle, 6 loads, 4 stores
+   input: all, output: q
+   charge density is approximated by values at the nearest grid points
+   q(n,m)=qm*(1.-dx)*(1.-dy)
+   q(n+1,m)=qm*dx*(1.-dy)
+   q(n,m+1)=qm*(1.-dx)*dy
+   q(n+1,m+1)=qm*dx*dy
+   where n,m = leftmost grid points and dx = x-n, dy = y-m
+   ppart[l][m][n][0] = position x of particle n in tile m of species l
+   ppart[l][m][n][1] = position y of particle n in tile m of species l
+   q[k][j] = charge density at grid point j,k
+   kpic[l][k] = number of particles in tile k of species l
+   qm[l] = charge on particle of species l, in units of e
+   nppmx = maximum number of particles in tile
+   idimp = size of phase space = 4
+   mx/my = number of grids in sorting cell in x/y
+   nxv = first dimension of charge array, must be >= nx+1
+   nyv = second dimension of charge array, must be >= ny+1
+   mx1 = (system length in x direction - 1)/mx + 1
+   mxy1 = mx1*my1, where my1 = (system length in y direction - 1)/my + 1
+   nsp = number of species
+local data                                                            */
+   int noff, moff, npoff, npp, mxv, kk;
+   int i, j, k, l, nn, mm;
+   float x, y, dxp, dyp, amx, amy, qml;
+   float *sq;
+   mxv = mx + 1;
+/* loop over tiles */
+#pragma omp parallel \
+private(i,j,k,l,kk,noff,moff,npp,npoff,nn,mm,x,y,dxp,dyp,amx,amy,qml,sq)
+   {
+/* allocate local accumulator for each thread */
+   sq = (float *) malloc(mxv*(my+1)*sizeof(float));
+#pragma omp for
+   for (k = 0; k < mxy1; k++) {
+      noff = k/mx1;
+      moff = my*noff;
+      noff = mx*(k - mx1*noff);
+/* zero out local accumulator */
+      for (j = 0; j < mxv*(my+1); j++) {
+         sq[j] = 0.0f;
+      }
+/* loop over species */
+      for (l = 0; l < nsp; l++) {
+         kk = k + mxy1*l;
+         npp = kpic[kk];
+         npoff = nppmx*kk;
+         qml = qm[l];
+/* loop over particles in tile */
+         for (j = 0; j < npp; j++) {
+/* find interpolation weights */
+            x = ppart[idimp*(j+npoff)];
+            y = ppart[1+idimp*(j+npoff)];
+            nn = x;
+            mm = y;
+            dxp = qml*(x - (float) nn);
+            dyp = y - (float) mm;
+            nn = nn - noff + mxv*(mm - moff);
+            amx = qml - dxp;
+            amy = 1.0f - dyp;
+/* deposit charge within tile to local accumulator */
+            x = sq[nn] + amx*amy;
+            y = sq[nn+1] + dxp*amy;
+            sq[nn] = x;
+            sq[nn+1] = y;
+            nn += mxv;
+            x = sq[nn] + amx*dyp;
+            y = sq[nn+1] + dxp*dyp;
+            sq[nn] = x;
+            sq[nn+1] = y;
+         }
+      }
+/* deposit charge to interior points in global array */
+      nn = nxv - noff;
+      mm = nyv - moff;
+      nn = mx < nn ? mx : nn;
+      mm = my < mm ? my : mm;
+      for (j = 1; j < mm; j++) {
+         for (i = 1; i < nn; i++) {
+            q[i+noff+nxv*(j+moff)] += sq[i+mxv*j];
+         }
+      }
+/* deposit charge to edge points in global array */
+      mm = nyv - moff;
+      mm = my+1 < mm ? my+1 : mm;
+      for (i = 1; i < nn; i++) {
+#pragma omp atomic
+         q[i+noff+nxv*moff] += sq[i];
+         if (mm > my) {
+#pragma omp atomic
+            q[i+noff+nxv*(mm+moff-1)] += sq[i+mxv*(mm-1)];
+         }
+      }
+      nn = nxv - noff;
+      nn = mx+1 < nn ? mx+1 : nn;
+      for (j = 0; j < mm; j++) {
+#pragma omp atomic
+         q[noff+nxv*(j+moff)] += sq[mxv*j];
+         if (nn > mx) {
+#pragma omp atomic
+            q[nn+noff-1+nxv*(j+moff)] += sq[nn-1+mxv*j];
+         }
+      }
+   }
+   free(sq);
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cpporderf2lm(float ppart[], float ppbuff[], int kpic[], int ncl[],
+                  int ihole[], int idimp, int nppmx, int mx1, int my1,
+                  int npbmx, int ntmax, int nsp, int *irc) {
+/* this subroutine sorts particles of nsp species by x,y grid in tiles
+   of mx, my
+   linear interpolation, with periodic boundary conditions
+   tiles are assumed to be arranged in 2D linear memory, with species m
+   in tiles m*mxy1 to m*mxy1+mxy1-1
+   the algorithm has 2 steps.  first, a prefix scan of ncl is performed
+   and departing particles are buffered in ppbuff in direction order.
+   then we copy the incoming particles from other tiles into ppart.
+   both steps handle all species of a tile, and run in one parallel
+   region.
+   it assumes that the number, location, and destination of particles
+   leaving a tile have been previously stored in ncl and ihole by the
+   cgppushf2lm procedure.
+   input: all except ppbuff, irc
+   output: ppart, ppbuff, kpic, ncl, irc
+   ppart[l][k][n][0] = position x of particle n in tile k of species l
+   ppart[l][k][n][1] = position y of particle n in tile k of species l
+   ppbuff[l][k][n][i] = i co-ordinate of particle n in tile k of
+   species l
+   kpic[l][k] = number of particles in tile k of species l
+   ncl[l][k][i] = number of particles going to destination i, tile k
+   ihole[l][k][:][0] = location of hole in array left by departing
+   particle
+   ihole[l][k][:][1] = direction destination of particle leaving hole
+   all for tile k of species l
+   ihole[l][k][0][0] = ih, number of holes left (error, if negative)
+   idimp = size of phase space = 4
+   nppmx = maximum number of particles in tile
+   mx1 = (system length in x direction - 1)/mx + 1
+   my1 = (system length in y direction - 1)/my + 1
+   npbmx = size of buffer array ppbuff
+   ntmax = size of hole array for particles leaving tiles
+   nsp = number of species
+   irc = maximum overflow, returned only if error occurs, when irc > 0
+local data                                                            */
+   int mxy1, npp, ncoff, lk, lks;
+   int i, j, k, l, ii, kx, ky, ih, nh, ist, isum;
+   int ip, j1, j2, kxl, kxr, kk, kl, kr;
+   int ks[8];
+   mxy1 = mx1*my1;
+#pragma omp parallel \
+private(i,j,k,l,lk,lks,ii,kk,npp,kx,ky,kl,kr,kxl,kxr,ih,nh,ncoff,ist, \
+isum,j1,j2,ip,ks)
+   {
+/* buffer particles that are leaving tile: update ppbuff, ncl */
+/* loop over tiles */
+#pragma omp for
+   for (k = 0; k < mxy1; k++) {
+/* loop over species */
+      for (l = 0; l < nsp; l++) {
+         lk = k + mxy1*l;
+/* find address offset for ordered ppbuff array */
+         isum = 0;
+         for (j = 0; j < 8; j++) {
+            ist = ncl[j+8*lk];
+            ncl[j+8*lk] = isum;
+            isum += ist;
+         }
+         nh = ihole[2*(ntmax+1)*lk];
+         ip = 0;
+/* loop over particles leaving tile */
+         for (j = 0; j < nh; j++) {
+/* buffer particles that are leaving tile, in direction order */
+            j1 = ihole[2*(j+1+(ntmax+1)*lk)] - 1;
+            ist = ihole[1+2*(j+1+(ntmax+1)*lk)];
+            ii = ncl[ist+8*lk-1];
+            if (ii < npbmx) {
+               for (i = 0; i < idimp; i++) {
+                  ppbuff[i+idimp*(ii+npbmx*lk)]
+                  = ppart[i+idimp*(j1+nppmx*lk)];
+               }
+            }
+            else {
+               ip = 1;
+            }
+            ncl[ist+8*lk-1] = ii + 1;
+         }
+/* set error */
+         if (ip > 0)
+            *irc = ncl[7+8*lk];
+      }
+   }
+/* ppbuff overflow, read after barrier at end of loop */
+   if (*irc==0) {
+/* copy incoming particles from buffer into ppart: update ppart, kpic */
+/* loop over tiles */
+#pragma omp for
+   for (k = 0; k < mxy1; k++) {
+      ky = k/mx1;
+/* loop over tiles in y, assume periodic boundary conditions */
+      kk = ky*mx1;
+/* find tile above */
+      kl = ky - 1;
+      if (kl < 0)
+         kl += my1;
+      kl = kl*mx1;
+/* find tile below */
+      kr = ky + 1;
+      if (kr >= my1)
+          kr -= my1;
+      kr = kr*mx1;
+/* loop over tiles in x, assume periodic boundary conditions */
+      kx = k - ky*mx1;
+      kxl = kx - 1;
+      if (kxl < 0)
+         kxl += mx1;
+      kxr = kx + 1;
+      if (kxr >= mx1)
+         kxr -= mx1;
+/* find tile number for different directions */
+      ks[0] = kxr + kk;
+      ks[1] = kxl + kk;
+      ks[2] = kx + kr;
+      ks[3] = kxr + kr;
+      ks[4] = kxl + kr;
+      ks[5] = kx + kl;
+      ks[6] = kxr + kl;
+      ks[7] = kxl + kl;
+/* loop over species */
+      for (l = 0; l < nsp; l++) {
+         lk = k + mxy1*l;
+         npp = kpic[lk];
+/* loop over directions */
+         nh = ihole[2*(ntmax+1)*lk];
+         ncoff = 0;
+         ih = 0;
+         ist = 0;
+         j1 = 0;
+         for (ii = 0; ii < 8; ii++) {
+            lks = ks[ii] + mxy1*l;
+            if (ii > 0)
+               ncoff = ncl[ii-1+8*lks];
+/* ip = number of particles coming from direction ii */
+            ip = ncl[ii+8*lks] - ncoff;
+            for (j = 0; j < ip; j++) {
+               ih += 1;
+/* insert incoming particles into holes */
+               if (ih <= nh) {
+                  j1 = ihole[2*(ih+(ntmax+1)*lk)] - 1;
+               }
+/* place overflow at end of array */
+               else {
+                  j1 = npp;
+                  npp += 1;
+               }
+               if (j1 < nppmx) {
+                  for (i = 0; i < idimp; i++) {
+                     ppart[i+idimp*(j1+nppmx*lk)]
+                     = ppbuff[i+idimp*(j+ncoff+npbmx*lks)];
+                  }
+               }
+               else {
+                  ist = 1;
+               }
+            }
+         }
+/* set error */
+         if (ist > 0)
+            *irc = j1+1;
+/* fill up remaining holes in particle array with particles from bottom */
+         if (ih < nh) {
+            ip = nh - ih;
+            for (j = 0; j < ip; j++) {
+               j1 = npp - j - 1;
+               j2 = ihole[2*(nh-j+(ntmax+1)*lk)] - 1;
+               if (j1 > j2) {
+/* move particle only if it is below current hole */
+                  for (i = 0; i < idimp; i++) {
+                     ppart[i+idimp*(j2+nppmx*lk)]
+                     = ppart[i+idimp*(j1+nppmx*lk)];
+                  }
+               }
+            }
+            npp -= ip;
+         }
+         kpic[lk] = npp;
+      }
+   }
+   }
+   }
+   return;
+}
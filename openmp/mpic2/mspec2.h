@@ -0,0 +1,15 @@
+/* header file for mspec2.c */
+
+void cgppushf2lm(float ppart[], float fxy[], int kpic[], int ncl[],
+                 int ihole[], float qbm[], float dt, float ek[],
+                 int idimp, int nppmx, int nx, int ny, int mx, int my,
+                 int nxv, int nyv, int mx1, int mxy1, int ntmax, int nsp,
+                 int *irc);
+
+void cgppost2lm(float ppart[], float q[], int kpic[], float qm[],
+                int nppmx, int idimp, int mx, int my, int nxv, int nyv,
+                int mx1, int mxy1, int nsp);
+
+void cpporderf2lm(float ppart[], float ppbuff[], int kpic[], int ncl[],
+                  int ihole[], int idimp, int nppmx, int mx1, int my1,
+                  int npbmx, int ntmax, int nsp, int *irc);
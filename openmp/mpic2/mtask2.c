@@ -0,0 +1,433 @@
+/* OpenMP task graph library for 2D OpenMP PIC codes */
+/* written for the skeleton PIC codes */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <complex.h>
+#include <omp.h>
+#include "mpush2.h"
+#include "mtask2.h"
+
+/* NTASK = number of kinds of tasks for each row of tiles */
+#define NTASK                 4
+
+static FILE *tunit = NULL;
+
+/*--------------------------------------------------------------------*/
+static void cppbuff2t(float ppart[], float ppbuff[], int ncl[],
+                      int ihole[], int idimp, int nppmx, int mx1,
+                      int mxy1, int npbmx, int ntmax, int nsp, int ky,
+                      int *irc) {
+/* this subroutine performs the first step of cpporderf2lm for the tiles
+   in row ky: a prefix scan of ncl is performed and departing particles
+   are buffered in ppbuff in direction order, for all species
+local data                                                            */
+   int i, j, k, l, lk, ii, ist, isum, nh, ip, j1;
+   for (k = mx1*ky; k < mx1*(ky+1); k++) {
+      for (l = 0; l < nsp; l++) {
+         lk = k + mxy1*l;
+/* find address offset for ordered ppbuff array */
+         isum = 0;
+         for (j = 0; j < 8; j++) {
+            ist = ncl[j+8*lk];
+            ncl[j+8*lk] = isum;
+            isum += ist;
+         }
+         nh = ihole[2*(ntmax+1)*lk];
+         ip = 0;
+/* loop over particles leaving tile */
+         for (j = 0; j < nh; j++) {
+/* buffer particles that are leaving tile, in direction order */
+            j1 = ihole[2*(j+1+(ntmax+1)*lk)] - 1;
+            ist = ihole[1+2*(j+1+(ntmax+1)*lk)];
+            ii = ncl[ist+8*lk-1];
+            if (ii < npbmx) {
+               for (i = 0; i < idimp; i++) {
+                  ppbuff[i+idimp*(ii+npbmx*lk)]
+                  = ppart[i+idimp*(j1+nppmx*lk)];
+               }
+            }
+            else {
+               ip = 1;
+            }
+            ncl[ist+8*lk-1] = ii + 1;
+         }
+/* set error */
+         if (ip > 0)
+            *irc = ncl[7+8*lk];
+      }
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+static void cppfill2t(float ppart[], float ppbuff[], int kpic[],
+                      int ncl[], int ihole[], int idimp, int nppmx,
+                      int mx1, int my1, int npbmx, int ntmax, int nsp,
+                      int ky, int *irc) {
+/* this subroutine performs the second step of cpporderf2lm for the
+   tiles in row ky: incoming particles are copied from the buffers of
+   the neighboring tiles into ppart, for all species.  the first step
+   must have been done for rows ky-1, ky and ky+1
+local data                                                            */
+   int mxy1, npp, ncoff, lk, lks;
+   int i, j, k, l, ii, kx, ih, nh, ist, ip, j1, j2, kxl, kxr, kk, kl, kr;
+   int ks[8];
+   mxy1 = mx1*my1;
+/* loop over tiles in y, assume periodic boundary conditions */
+   kk = ky*mx1;
+/* find tile above */
+   kl = ky - 1;
+   if (kl < 0)
+      kl += my1;
+   kl = kl*mx1;
+/* find tile below */
+   kr = ky + 1;
+   if (kr >= my1)
+       kr -= my1;
+   kr = kr*mx1;
+   for (kx = 0; kx < mx1; kx++) {
+      k = kx + kk;
+/* loop over tiles in x, assume periodic boundary conditions */
+      kxl = kx - 1;
+      if (kxl < 0)
+         kxl += mx1;
+      kxr = kx + 1;
+      if (kxr >= mx1)
+         kxr -= mx1;
+/* find tile number for different directions */
+      ks[0] = kxr + kk;
+      ks[1] = kxl + kk;
+      ks[2] = kx + kr;
+      ks[3] = kxr + kr;
+      ks[4] = kxl + kr;
+      ks[5] = kx + kl;
+      ks[6] = kxr + kl;
+      ks[7] = kxl + kl;
+/* loop over species */
+      for (l = 0; l < nsp; l++) {
+         lk = k + mxy1*l;
+         npp = kpic[lk];
+/* loop over directions */
+         nh = ihole[2*(ntmax+1)*lk];
+         ncoff = 0;
+         ih = 0;
+         ist = 0;
+         j1 = 0;
+         for (ii = 0; ii < 8; ii++) {
+            lks = ks[ii] + mxy1*l;
+            if (ii > 0)
+               ncoff = ncl[ii-1+8*lks];
+/* ip = number of particles coming from direction ii */
+            ip = ncl[ii+8*lks] - ncoff;
+            for (j = 0; j < ip; j++) {
+               ih += 1;
+/* insert incoming particles into holes */
+               if (ih <= nh) {
+                  j1 = ihole[2*(ih+(ntmax+1)*lk)] - 1;
+               }
+/* place overflow at end of array */
+               else {
+                  j1 = npp;
+                  npp += 1;
+               }
+               if (j1 < nppmx) {
+                  for (i = 0; i < idimp; i++) {
+                     ppart[i+idimp*(j1+nppmx*lk)]
+                     = ppbuff[i+idimp*(j+ncoff+npbmx*lks)];
+                  }
+               }
+               else {
+                  ist = 1;
+               }
+            }
+         }
+/* set error */
+         if (ist > 0)
+            *irc = j1+1;
+/* fill up remaining holes in particle array with particles from bottom */
+         if (ih < nh) {
+            ip = nh - ih;
+            for (j = 0; j < ip; j++) {
+               j1 = npp - j - 1;
+               j2 = ihole[2*(nh-j+(ntmax+1)*lk)] - 1;
+               if (j1 > j2) {
+/* move particle only if it is below current hole */
+                  for (i = 0; i < idimp; i++) {
+                     ppart[i+idimp*(j2+nppmx*lk)]
+                     = ppart[i+idimp*(j1+nppmx*lk)];
+                  }
+               }
+            }
+            npp -= ip;
+         }
+         kpic[lk] = npp;
+      }
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+static void cgpost2t(float ppart[], float q[], int kpic[], float qm[],
+                     int nppmx, int idimp, int mx, int my, int nxv,
+                     int nyv, int mx1, int mxy1, int nsp, int ky) {
+/* this subroutine deposits the charge of all species for the tiles in
+   row ky, as in cgppost2lm.  grid points shared with other tiles are
+   added with atomic updates
+local data                                                            */
+   int noff, moff, npoff, npp, mxv, kk;
+   int i, j, k, l, nn, mm;
+   float x, y, dxp, dyp, amx, amy, qml;
+   float *sq;
+   mxv = mx + 1;
+   sq = (float *) malloc(mxv*(my+1)*sizeof(float));
+   moff = my*ky;
+   for (k = mx1*ky; k < mx1*(ky+1); k++) {
+      noff = mx*(k - mx1*ky);
+/* zero out local accumulator */
+      for (j = 0; j < mxv*(my+1); j++) {
+         sq[j] = 0.0f;
+      }
+/* loop over species */
+      for (l = 0; l < nsp; l++) {
+         kk = k + mxy1*l;
+         npp = kpic[kk];
+         npoff = nppmx*kk;
+         qml = qm[l];
+/* loop over particles in tile */
+         for (j = 0; j < npp; j++) {
+/* find interpolation weights */
+            x = ppart[idimp*(j+npoff)];
+            y = ppart[1+idimp*(j+npoff)];
+            nn = x;
+            mm = y;
+            dxp = qml*(x - (float) nn);
+            dyp = y - (float) mm;
+            nn = nn - noff + mxv*(mm - moff);
+            amx = qml - dxp;
+            amy = 1.0f - dyp;
+/* deposit charge within tile to local accumulator */
+            x = sq[nn] + amx*amy;
+            y = sq[nn+1] + dxp*amy;
+            sq[nn] = x;
+            sq[nn+1] = y;
+            nn += mxv;
+            x = sq[nn] + amx*dyp;
+            y = sq[nn+1] + dxp*dyp;
+            sq[nn] = x;
+            sq[nn+1] = y;
+         }
+      }
+/* deposit charge to interior points in global array */
+      nn = nxv - noff;
+      mm = nyv - moff;
+      nn = mx < nn ? mx : nn;
+      mm = my < mm ? my : mm;
+      for (j = 1; j < mm; j++) {
+         for (i = 1; i < nn; i++) {
+            q[i+noff+nxv*(j+moff)] += sq[i+mxv*j];
+         }
+      }
+/* deposit charge to edge points in global array */
+      mm = nyv - moff;
+      mm = my+1 < mm ? my+1 : mm;
+      for (i = 1; i < nn; i++) {
+#pragma omp atomic
+         q[i+noff+nxv*moff] += sq[i];
+         if (mm > my) {
+#pragma omp atomic
+            q[i+noff+nxv*(mm+moff-1)] += sq[i+mxv*(mm-1)];
+         }
+      }
+      nn = nxv - noff;
+      nn = mx+1 < nn ? mx+1 : nn;
+      for (j = 0; j < mm; j++) {
+#pragma omp atomic
+         q[noff+nxv*(j+moff)] += sq[mxv*j];
+         if (nn > mx) {
+#pragma omp atomic
+            q[nn+noff-1+nxv*(j+moff)] += sq[nn-1+mxv*j];
+         }
+      }
+   }
+   free(sq);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+static void caguard2t(float q[], int nx, int ny, int nxe, int kyi,
+                      int kyp) {
+/* this subroutine accumulates the guard cells of caguard2l into the
+   kyp grid rows starting at kyi.  row 0 also receives row ny
+local data                                                            */
+   int j, k;
+   for (k = kyi; k < kyi+kyp; k++) {
+      q[nxe*k] += q[nx+nxe*k];
+      q[nx+nxe*k] = 0.0;
+   }
+   if (kyi==0) {
+      for (j = 0; j < nx; j++) {
+         q[j] += q[j+nxe*ny];
+         q[j+nxe*ny] = 0.0;
+      }
+      q[0] += q[nx+nxe*ny];
+      q[nx+nxe*ny] = 0.0;
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cppordpost2t(float ppart[], float ppbuff[], int kpic[], int ncl[],
+                  int ihole[], float q[], float qm[], int mixup[],
+                  float complex sct[], double trace[], int idimp,
+                  int nppmx, int nx, int ny, int mx, int my, int nxe,
+                  int nye, int mx1, int my1, int npbmx, int ntmax,
+                  int nsp, int indx, int indy, int nxhy, int nxyh,
+                  int *irc) {
+/* this subroutine reorders the particles of all species by tile as in
+   cpporderf2lm, then deposits their charge, adds the guard cells, and
+   performs the x part of the inverse fft of the charge, using a graph
+   of OpenMP tasks for each row of tiles, so that the reorder of some
+   rows overlaps with the deposit and fft of others.  the tasks for
+   tile row ky are:
+   buffer(ky): buffer departing particles, as in the first step of
+   cpporderf2lm
+   fill(ky): copy incoming particles, after buffer(ky-1:ky+1)
+   deposit(ky): deposit charge, after fill(ky)
+   fft(ky): add guard cells and x fft of the grid rows of the tile row,
+   after deposit(ky-1:ky), since deposit(ky-1) adds to the first row.
+   the y part of the fft, cfft2rmxy, is left to the caller.
+   the x fft of each row is performed by cfft2rmxx, whose parallel
+   region runs on the thread of the task.
+   input: all except ppbuff, q, trace, irc
+   output: ppart, ppbuff, kpic, ncl, q, trace, irc
+   q = charge density, in real space with guard cells on input, x
+   transformed on output, as after the x part of cwfft2rmx
+   qm[l] = charge on particle of species l, in units of e
+   mixup/sct = bit reverse and sine/cosine tables for fft
+   trace[ky][i][0] = thread which performed task i of tile row ky
+   trace[ky][i][1:2] = start/end time of task, in seconds, relative to
+   the start of the subroutine, for i = buffer, fill, deposit, fft
+   nxe/nye = dimensions of charge array, must be >= nx+2/ny+1
+   indx/indy = exponent which determines grid points in x/y direction
+   nxhy/nxyh = dimensions of fft tables
+   see cpporderf2lm and cgppost2lm for other arguments
+local data                                                            */
+   int j, ky, kyl, kyr, kyi, kyp, mxy1, nxeh;
+   double tbeg;
+   char *dbuf, *dfill, *ddep;
+   mxy1 = mx1*my1;
+   nxeh = nxe/2;
+   dbuf = (char *) malloc(3*my1*sizeof(char));
+   dfill = &dbuf[my1];
+   ddep = &dbuf[2*my1];
+   tbeg = omp_get_wtime();
+#pragma omp parallel private(j,ky,kyl,kyr,kyi,kyp)
+   {
+/* zero charge density */
+#pragma omp for
+   for (j = 0; j < nxe*nye; j++) {
+      q[j] = 0.0f;
+   }
+/* one thread creates the tasks, all threads execute them */
+/* a task waits only for tasks created before it, so tasks are created */
+/* in the order buffer, fill, deposit, fft                             */
+#pragma omp single
+   {
+   for (ky = 0; ky < my1; ky++) {
+#pragma omp task depend(out:dbuf[ky])
+      {
+      trace[3*(NTASK*ky)] = omp_get_thread_num();
+      trace[1+3*(NTASK*ky)] = omp_get_wtime() - tbeg;
+      cppbuff2t(ppart,ppbuff,ncl,ihole,idimp,nppmx,mx1,mxy1,npbmx,
+                ntmax,nsp,ky,irc);
+      trace[2+3*(NTASK*ky)] = omp_get_wtime() - tbeg;
+      }
+   }
+   for (ky = 0; ky < my1; ky++) {
+      kyl = ky > 0 ? ky - 1 : my1 - 1;
+      kyr = ky < my1-1 ? ky + 1 : 0;
+#pragma omp task depend(in:dbuf[kyl],dbuf[ky],dbuf[kyr]) \
+depend(out:dfill[ky])
+      {
+      trace[3*(1+NTASK*ky)] = omp_get_thread_num();
+      trace[1+3*(1+NTASK*ky)] = omp_get_wtime() - tbeg;
+      if (*irc==0)
+         cppfill2t(ppart,ppbuff,kpic,ncl,ihole,idimp,nppmx,mx1,my1,
+                   npbmx,ntmax,nsp,ky,irc);
+      trace[2+3*(1+NTASK*ky)] = omp_get_wtime() - tbeg;
+      }
+   }
+   for (ky = 0; ky < my1; ky++) {
+#pragma omp task depend(in:dfill[ky]) depend(out:ddep[ky])
+      {
+      trace[3*(2+NTASK*ky)] = omp_get_thread_num();
+      trace[1+3*(2+NTASK*ky)] = omp_get_wtime() - tbeg;
+      if (*irc==0)
+         cgpost2t(ppart,q,kpic,qm,nppmx,idimp,mx,my,nxe,nye,mx1,mxy1,
+                  nsp,ky);
+      trace[2+3*(2+NTASK*ky)] = omp_get_wtime() - tbeg;
+      }
+   }
+   for (ky = 0; ky < my1; ky++) {
+      kyl = ky > 0 ? ky - 1 : my1 - 1;
+      kyi = my*ky;
+      kyp = ny - kyi;
+      kyp = my < kyp ? my : kyp;
+#pragma omp task depend(in:ddep[kyl],ddep[ky])
+      {
+      trace[3*(3+NTASK*ky)] = omp_get_thread_num();
+      trace[1+3*(3+NTASK*ky)] = omp_get_wtime() - tbeg;
+      caguard2t(q,nx,ny,nxe,kyi,kyp);
+      cfft2rmxx((float complex *)q,-1,mixup,sct,indx,indy,kyi+1,kyp,
+                nxeh,nye,nxhy,nxyh);
+      trace[2+3*(3+NTASK*ky)] = omp_get_wtime() - tbeg;
+      }
+   }
+   }
+   }
+   free(dbuf);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+int ctraceopen(char *name) {
+/* this function opens the task trace file name and writes its header
+   returns 1 if the file cannot be opened
+local data                                                            */
+   tunit = fopen(name,"w");
+   if (tunit==NULL)
+      return 1;
+   fprintf(tunit,"step,task,row,thread,start,end\n");
+   return 0;
+}
+
+/*--------------------------------------------------------------------*/
+void ctracewrite(double trace[], int ntime, int my1) {
+/* this subroutine writes the task timelines of cppordpost2t for time
+   step ntime to the task trace file, one line for each task, with
+   times in microseconds
+local data                                                            */
+   int i, ky;
+   static char *tname[NTASK] = {"buffer","fill","deposit","fft"};
+   if (tunit==NULL)
+      return;
+   for (ky = 0; ky < my1; ky++) {
+      for (i = 0; i < NTASK; i++) {
+         fprintf(tunit,"%d,%s,%d,%d,%.3f,%.3f\n",ntime,tname[i],ky,
+                 (int) trace[3*(i+NTASK*ky)],
+                 1.0e6*trace[1+3*(i+NTASK*ky)],
+                 1.0e6*trace[2+3*(i+NTASK*ky)]);
+      }
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void ctraceclose() {
+/* this subroutine closes the task trace file */
+   if (tunit != NULL)
+      fclose(tunit);
+   tunit = NULL;
+   return;
+}
@@ -0,0 +1,15 @@
+/* header file for mtask2.c */
+
+void cppordpost2t(float ppart[], float ppbuff[], int kpic[], int ncl[],
+                  int ihole[], float q[], float qm[], int mixup[],
+                  float complex sct[], double trace[], int idimp,
+                  int nppmx, int nx, int ny, int mx, int my, int nxe,
+                  int nye, int mx1, int my1, int npbmx, int ntmax,
+                  int nsp, int indx, int indy, int nxhy, int nxyh,
+                  int *irc);
+
+int ctraceopen(char *name);
+
+void ctracewrite(double trace[], int ntime, int my1);
+
+void ctraceclose();
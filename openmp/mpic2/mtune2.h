@@ -0,0 +1,12 @@
+/* header file for mtune2.c */
+
+int ccachesize();
+
+double cmtime2(float part[], float qm, float qbm, float dt, int idimp,
+               int np, int nx, int ny, int mx, int my, int nxe, int nye,
+               float xtras, int kdepo, int ntry);
+
+void cmtune2(float part[], float qm, float qbm, float dt, int idimp,
+             int np, int nx, int ny, int nxe, int nye, float xtras,
+             int kdepo, int ntry, int *mx, int *my, double *tbest,
+             double *tdef);
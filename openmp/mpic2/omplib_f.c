@@ -7,6 +7,8 @@ void setnthsize_(int *nth);
 
 int getnthsize_();
 
+void affin_omp_(int *kaff);
+
 /* Interfaces to C */
 
 void cinit_omp(int nth) {
@@ -23,3 +25,7 @@ int cgetnthsize() {
    return getnthsize_();
 }
 
+void caffin_omp(int kaff) {
+   affin_omp_(&kaff);
+   return;
+}
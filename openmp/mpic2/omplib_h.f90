@@ -23,5 +23,12 @@
          integer GETNTHSIZE
          end function
       end interface
+!
+      interface
+         subroutine AFFIN_OMP(kaff)
+         implicit none
+         integer :: kaff
+         end subroutine
+      end interface
 !
       end module
\ No newline at end of file
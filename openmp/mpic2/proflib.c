@@ -0,0 +1,466 @@
+/* hierarchical profiling library */
+/* written for the skeleton PIC codes */
+
+#ifdef __linux__
+#define _GNU_SOURCE
+#endif
+#define _POSIX_C_SOURCE 200112L
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+#include "proflib.h"
+
+/* MAXREG = maximum number of regions */
+/* MAXDEPTH = maximum nesting depth of regions */
+/* NCNTR = number of hardware counters = (cycles,cache misses,           */
+/* instructions)                                                          */
+/* NDATA = number of values per region = (time,calls,counters)           */
+#define MAXREG                64
+#define MAXDEPTH              16
+#define NCNTR                 3
+#define NDATA                 (2+NCNTR)
+
+/* region table, shared by all threads */
+/* rname = region names, iparent = parent region, -1 for top level */
+static char rname[MAXREG][32];
+static int iparent[MAXREG];
+static int nreg = 0;
+
+/* per thread data */
+/* tacc = accumulated (time,calls,counters) for each region */
+/* tstep = the same, for the current time step */
+/* istack = stack of active regions, with start time and counters */
+/* nover = number of regions entered beyond MAXDEPTH, not timed */
+typedef struct {
+   double tacc[MAXREG][NDATA];
+   double tstep[MAXREG][NDATA];
+   int istack[MAXDEPTH];
+   double tbeg[MAXDEPTH][1+NCNTR];
+   int nstack;
+   int nover;
+   int nfd;
+   int ifd;
+} cprofthread;
+
+static cprofthread *thrd = NULL;
+static int nthreads = 0;
+static int kcntr = 0;
+static int iproc = 0;
+static int kfmt = 0;
+static FILE *unit = NULL;
+
+/*--------------------------------------------------------------------*/
+static double cprofclock() {
+/* return monotonic time in seconds */
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC,&ts);
+   return (double) ts.tv_sec + 1.0e-9*(double) ts.tv_nsec;
+}
+
+/*--------------------------------------------------------------------*/
+static int cprofthid() {
+/* return thread number of caller */
+#ifdef _OPENMP
+   return omp_get_thread_num();
+#else
+   return 0;
+#endif
+}
+
+/*--------------------------------------------------------------------*/
+static void cprofcopen(cprofthread *th) {
+/* open hardware counters for calling thread as one group, led by the
+   cycle counter.  th->nfd = number of counters opened, 0 if unavailable
+local data                                                            */
+#ifdef __linux__
+   int i, fd;
+   struct perf_event_attr pe;
+   unsigned long long config[NCNTR] = {PERF_COUNT_HW_CPU_CYCLES,
+                                       PERF_COUNT_HW_CACHE_MISSES,
+                                       PERF_COUNT_HW_INSTRUCTIONS};
+   th->ifd = -1;
+   th->nfd = 0;
+   for (i = 0; i < NCNTR; i++) {
+      memset(&pe,0,sizeof(pe));
+      pe.type = PERF_TYPE_HARDWARE;
+      pe.size = sizeof(pe);
+      pe.config = config[i];
+      pe.read_format = PERF_FORMAT_GROUP;
+      pe.exclude_kernel = 1;
+      pe.exclude_hv = 1;
+      fd = syscall(__NR_perf_event_open,&pe,0,-1,th->ifd,0);
+      if (fd < 0) {
+         if (th->ifd >= 0)
+            close(th->ifd);
+         th->ifd = -1;
+         th->nfd = 0;
+         return;
+      }
+      if (i==0)
+         th->ifd = fd;
+      th->nfd += 1;
+   }
+#else
+   th->ifd = -1;
+   th->nfd = 0;
+#endif
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+static void cprofcread(cprofthread *th, double cntr[]) {
+/* read hardware counters for calling thread into cntr */
+   int i;
+#ifdef __linux__
+   unsigned long long buf[1+NCNTR];
+   if (th->nfd > 0) {
+      if (read(th->ifd,buf,sizeof(buf)) > 0) {
+         for (i = 0; i < NCNTR; i++) {
+            cntr[i] = (double) buf[1+i];
+         }
+         return;
+      }
+   }
+#endif
+   for (i = 0; i < NCNTR; i++) {
+      cntr[i] = 0.0;
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+int cprofinit(int nth, int kperf, int idproc) {
+/* initialize profiling library
+   nth = maximum number of threads which will enter regions,
+   if nth < 1, the maximum number of OpenMP threads is used
+   kperf = (0,1) = (no,yes) read hardware counters (cycles, cache
+   misses, instructions) with perf_event_open on Linux
+   idproc = processor id, written to the per step output
+   returns 1 if hardware counters were requested but are not available,
+   2 if out of memory, 0 otherwise
+local data                                                            */
+   int i;
+   if (nth < 1) {
+#ifdef _OPENMP
+      nth = omp_get_max_threads();
+#else
+      nth = 1;
+#endif
+   }
+   thrd = (cprofthread *) calloc(nth,sizeof(cprofthread));
+   if (thrd==NULL)
+      return 2;
+   nthreads = nth;
+   nreg = 0;
+   iproc = idproc;
+   kcntr = 0;
+/* nfd = -1 means counters have not been opened for thread */
+   for (i = 0; i < nth; i++) {
+      thrd[i].ifd = -1;
+      thrd[i].nfd = -1;
+   }
+   if (kperf) {
+/* counters are opened per thread on first use, check availability */
+      cprofcopen(&thrd[0]);
+      if (thrd[0].nfd==0)
+         return 1;
+      kcntr = 1;
+   }
+   return 0;
+}
+
+/*--------------------------------------------------------------------*/
+void cprofbeg(const char *name) {
+/* begin region name, nested inside the current region of the calling
+   thread.  regions with the same name and parent are accumulated
+   together.  name should be at most 31 characters.  regions nested
+   deeper than MAXDEPTH are counted but not timed, so that the matching
+   calls to cprofend leave the enclosing regions unchanged
+local data                                                            */
+   int i, k, id, ip, ir;
+   cprofthread *th;
+   id = cprofthid();
+   if ((thrd==NULL) || (id >= nthreads))
+      return;
+   th = &thrd[id];
+   if (th->nstack >= MAXDEPTH) {
+      th->nover += 1;
+      return;
+   }
+   if ((kcntr) && (th->nfd < 0))
+      cprofcopen(th);
+   ip = th->nstack > 0 ? th->istack[th->nstack-1] : -1;
+/* outermost region of a worker thread is nested inside the current */
+/* region of the master thread, or inside the parent of the master   */
+/* region of the same name, if the master has already entered it     */
+   if ((th->nstack==0) && (id > 0) && (thrd[0].nstack > 0)) {
+      k = thrd[0].nstack;
+      ip = thrd[0].istack[k-1];
+      for (i = k-1; i >= 0; i--) {
+         ir = thrd[0].istack[i];
+         if ((ir >= 0) && (!strncmp(rname[ir],name,31))) {
+            ip = iparent[ir];
+            break;
+         }
+      }
+   }
+/* find region, or add new region, in the same critical section, */
+/* since another thread may be adding a region                     */
+   ir = -1;
+#ifdef _OPENMP
+#pragma omp critical (cprof)
+#endif
+   {
+      for (i = 0; i < nreg; i++) {
+         if ((iparent[i]==ip) && (!strncmp(rname[i],name,31))) {
+            ir = i;
+            break;
+         }
+      }
+      if ((ir < 0) && (nreg < MAXREG)) {
+         strncpy(rname[nreg],name,31);
+         rname[nreg][31] = '\0';
+         iparent[nreg] = ip;
+         ir = nreg;
+         nreg += 1;
+      }
+   }
+/* region table is full, time is charged to parent */
+   if (ir < 0)
+      ir = ip;
+   th->istack[th->nstack] = ir;
+   cprofcread(th,&th->tbeg[th->nstack][1]);
+   th->tbeg[th->nstack][0] = cprofclock();
+   th->nstack += 1;
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+double cprofend() {
+/* end current region of calling thread
+   returns elapsed time of region in seconds
+local data                                                            */
+   int i, id, ir;
+   double tend, dt;
+   double cntr[NCNTR];
+   cprofthread *th;
+   tend = cprofclock();
+   id = cprofthid();
+   if ((thrd==NULL) || (id >= nthreads))
+      return 0.0;
+   th = &thrd[id];
+/* end of a region which was not timed */
+   if (th->nover > 0) {
+      th->nover -= 1;
+      return 0.0;
+   }
+   if (th->nstack <= 0)
+      return 0.0;
+   cprofcread(th,cntr);
+   th->nstack -= 1;
+   ir = th->istack[th->nstack];
+   dt = tend - th->tbeg[th->nstack][0];
+   if (ir < 0)
+      return dt;
+   th->tacc[ir][0] += dt;
+   th->tacc[ir][1] += 1.0;
+   th->tstep[ir][0] += dt;
+   th->tstep[ir][1] += 1.0;
+   for (i = 0; i < NCNTR; i++) {
+      th->tacc[ir][2+i] += cntr[i] - th->tbeg[th->nstack][1+i];
+      th->tstep[ir][2+i] += cntr[i] - th->tbeg[th->nstack][1+i];
+   }
+   return dt;
+}
+
+/*--------------------------------------------------------------------*/
+static void cprofpath(int ir, char path[], int npath) {
+/* write full name of region ir, parent/child, into path */
+   int n;
+   if (ir < 0) {
+      path[0] = '\0';
+      return;
+   }
+   cprofpath(iparent[ir],path,npath);
+   n = strlen(path);
+   if ((n > 0) && (n < (npath-1))) {
+      path[n] = '/';
+      n += 1;
+   }
+   strncpy(&path[n],rname[ir],npath-n-1);
+   path[npath-1] = '\0';
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+int cprofopen(const char *fname, int kform) {
+/* open file for per time step output
+   fname = file name, for MPI each processor should use its own file
+   kform = (1,2) = (CSV,JSON lines) format
+   returns 1 if file cannot be opened, 0 otherwise                    */
+   if (unit != NULL)
+      fclose(unit);
+   unit = fopen(fname,"w");
+   if (unit==NULL)
+      return 1;
+   kfmt = kform;
+   if (kfmt==1) {
+      fprintf(unit,"proc,step,thread,region,calls,time,cycles,");
+      fprintf(unit,"cache_misses,instructions\n");
+   }
+   return 0;
+}
+
+/*--------------------------------------------------------------------*/
+void cprofstep(int ntime) {
+/* end time step ntime: write per region data for the step, if an
+   output file is open, and clear the step data
+   should be called outside of parallel regions
+local data                                                            */
+   int i, j, k, n;
+   char path[256];
+   cprofthread *th;
+   if (thrd==NULL)
+      return;
+   if ((unit != NULL) && (kfmt==2))
+      fprintf(unit,"{\"proc\":%d,\"step\":%d,\"regions\":[",iproc,ntime);
+   n = 0;
+   for (k = 0; k < nthreads; k++) {
+      th = &thrd[k];
+      for (i = 0; i < nreg; i++) {
+         if (th->tstep[i][1]==0.0)
+            continue;
+         if (unit != NULL) {
+            cprofpath(i,path,256);
+            if (kfmt==1) {
+               fprintf(unit,"%d,%d,%d,%s,%.0f,%.9e",iproc,ntime,k,path,
+                       th->tstep[i][1],th->tstep[i][0]);
+               for (j = 0; j < NCNTR; j++) {
+                  fprintf(unit,",%.0f",th->tstep[i][2+j]);
+               }
+               fprintf(unit,"\n");
+            }
+            else if (kfmt==2) {
+               fprintf(unit,"%s{\"name\":\"%s\",\"thread\":%d,",
+                       n > 0 ? "," : "",path,k);
+               fprintf(unit,"\"calls\":%.0f,\"time\":%.9e",
+                       th->tstep[i][1],th->tstep[i][0]);
+               if (kcntr) {
+                  fprintf(unit,",\"cycles\":%.0f,\"cache_misses\":%.0f",
+                          th->tstep[i][2],th->tstep[i][3]);
+                  fprintf(unit,",\"instructions\":%.0f",th->tstep[i][4]);
+               }
+               fprintf(unit,"}");
+            }
+            n += 1;
+         }
+         for (j = 0; j < NDATA; j++) {
+            th->tstep[i][j] = 0.0;
+         }
+      }
+   }
+   if ((unit != NULL) && (kfmt==2))
+      fprintf(unit,"]}\n");
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+int cprofget(double tdata[], int ndata) {
+/* copy accumulated region data, summed over threads, into tdata
+   tdata[k][0] = time in seconds for region k
+   tdata[k][1] = number of calls
+   tdata[k][2:4] = cycles, cache misses, instructions
+   ndata = size of tdata, must be >= 5*MAXREG
+   returns number of regions
+   for MPI, tdata can then be summed over processors, provided all
+   processors entered the same regions in the same order
+local data                                                            */
+   int i, j, k, nr;
+   nr = nreg;
+   if (ndata < NDATA*nr)
+      nr = ndata/NDATA;
+   for (i = 0; i < NDATA*nr; i++) {
+      tdata[i] = 0.0;
+   }
+   if (thrd==NULL)
+      return 0;
+   for (k = 0; k < nthreads; k++) {
+      for (i = 0; i < nr; i++) {
+         for (j = 0; j < NDATA; j++) {
+            tdata[j+NDATA*i] += thrd[k].tacc[i][j];
+         }
+      }
+   }
+   return nr;
+}
+
+/*--------------------------------------------------------------------*/
+static void cprofpnode(int ip, int ilev, double tdata[], double tmax[],
+                       int nproc, double tpar) {
+/* print regions with parent ip, indented by nesting level ilev */
+   int i;
+   double tavg, pct;
+   for (i = 0; i < nreg; i++) {
+      if (iparent[i] != ip)
+         continue;
+      tavg = tdata[NDATA*i]/(double) nproc;
+      pct = tpar > 0.0 ? 100.0*tavg/tpar : 100.0;
+      printf("%*s%-*s %10.0f %12.6f %12.6f %6.1f%%",2*ilev,"",
+             24-2*ilev,rname[i],tdata[1+NDATA*i],tavg,tmax[NDATA*i],pct);
+      if (kcntr) {
+         printf(" %12.4e %12.4e %12.4e",tdata[2+NDATA*i],
+                tdata[3+NDATA*i],tdata[4+NDATA*i]);
+      }
+      printf("\n");
+      if (ilev < (MAXDEPTH-1))
+         cprofpnode(i,ilev+1,tdata,tmax,nproc,tavg);
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cprofprint(double tdata[], double tmax[], int nproc) {
+/* print hierarchical summary of regions.  times of regions entered by
+   more than one thread are summed over threads
+   tdata = region data from cprofget, summed over nproc processors
+   tmax = region data from cprofget, maximum over processors
+   nproc = number of processors                                       */
+   printf("Profile: region, calls, average time, maximum time, ");
+   printf("%% of parent\n");
+   if (kcntr)
+      printf("         cycles, cache misses, instructions\n");
+   cprofpnode(-1,0,tdata,tmax,nproc,0.0);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cprofexit() {
+/* close output file and hardware counters */
+   int i;
+   if (unit != NULL) {
+      fclose(unit);
+      unit = NULL;
+   }
+   if (thrd != NULL) {
+      for (i = 0; i < nthreads; i++) {
+#ifdef __linux__
+         if (thrd[i].ifd >= 0)
+            close(thrd[i].ifd);
+#endif
+      }
+      free(thrd);
+      thrd = NULL;
+   }
+   nthreads = 0;
+   nreg = 0;
+   return;
+}
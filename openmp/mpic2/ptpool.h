@@ -0,0 +1,12 @@
+/* header file for ptpool.c */
+
+void cinit_ptp(int nth, int kaff, int *irc);
+
+int cgetnth_ptp();
+
+void cptpfor(void (*proc)(void *arg, int ith, int nb, int ne),
+             void *arg, int n);
+
+void cptpbarrier(int ith);
+
+void cend_ptp();
@@ -0,0 +1,172 @@
+/*---------------------------------------------------------------------*/
+/* FFT benchmark for 3D OpenMP PIC codes */
+/* compares the cache blocked ffts in mfft3.c with those in mpush3.c */
+#include <stdlib.h>
+#include <stdio.h>
+#include <complex.h>
+#include <math.h>
+#include <sys/time.h>
+#include "mpush3.h"
+#include "omplib.h"
+#include "cfglib.h"
+#include "mfft3.h"
+
+void dtimer(double *time, struct timeval *itime, int icntrl);
+
+/*--------------------------------------------------------------------*/
+static void cfillrand(float f[], int ncomp, int nx, int ny, int nz,
+                      int nxe, int nye, int nze) {
+/* this subroutine sets ncomp components of f to the same random data
+   each time it is called, with zero in the guard cells
+local data                                                            */
+   int j, k, l, n;
+   n = ncomp*nxe*nye*nze;
+   for (j = 0; j < n; j++) {
+      f[j] = 0.0;
+   }
+   srand(1);
+   for (l = 0; l < nz; l++) {
+      for (k = 0; k < ny; k++) {
+         n = ncomp*nxe*(k + nye*l);
+         for (j = 0; j < ncomp*nx; j++) {
+            f[j+n] = (float) rand()/(float) RAND_MAX - 0.5;
+         }
+      }
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+static float cmaxdiff(float f[], float g[], int n) {
+/* this function returns the maximum absolute difference between f and
+   g, relative to the maximum absolute value of f
+local data                                                            */
+   int j;
+   float fmax = 0.0, dmax = 0.0;
+   for (j = 0; j < n; j++) {
+      fmax = fabsf(f[j]) > fmax ? fabsf(f[j]) : fmax;
+      dmax = fabsf(f[j]-g[j]) > dmax ? fabsf(f[j]-g[j]) : dmax;
+   }
+   if (fmax > 0.0)
+      dmax = dmax/fmax;
+   return dmax;
+}
+
+int main(int argc, char *argv[]) {
+/* indmin/indmax = smallest/largest exponent of grid sizes measured, */
+/* the grid is nx = ny = nz = 2**ind                                 */
+   int indmin = 6, indmax = 9;
+/* nblok = number of rows or columns transformed together */
+   int nblok = 16;
+/* ntry = number of forward and inverse transforms timed */
+   int ntry = 2;
+/* nvp = number of shared memory nodes  (0=default) */
+   int nvp = 0;
+   int ind, indx, indy, indz, nx, ny, nz, nxh, nxe, nye, nze, nxeh;
+   int nxyzh, nxhyz, j, n, l, irc;
+   double dtime, tf[4];
+   float err[2];
+   float *f = NULL, *f1 = NULL;
+   int *mixup = NULL;
+   float complex *sct = NULL;
+   struct timeval itime;
+
+/* replace parameters with values from command line, for example: */
+/* cfftbench3 indmin=6 indmax=8 nblok=8                           */
+   irc = ccfgread(argc,argv,1);
+   ccfgint("indmin",&indmin); ccfgint("indmax",&indmax);
+   ccfgint("nblok",&nblok); ccfgint("ntry",&ntry);
+   ccfgint("nvp",&nvp);
+   irc += ccfgend();
+   if ((irc != 0) || (nblok < 1) || (ntry < 1) || (indmin < 2)) {
+      printf("invalid run time parameters\n");
+      exit(1);
+   }
+   cinit_omp(nvp);
+
+   printf("times are msec for one inverse and one forward transform\n");
+   printf("%5s %9s %9s %7s %9s %9s %9s %7s %9s\n","grid","scalar",
+          "blocked","speedup","error","vector","blocked","speedup",
+          "error");
+   for (ind = indmin; ind <= indmax; ind++) {
+      indx = ind; indy = ind; indz = ind;
+      nx = 1L<<indx; ny = 1L<<indy; nz = 1L<<indz; nxh = nx/2;
+      nxe = nx + 2; nye = ny + 1; nze = nz + 1; nxeh = nxe/2;
+      nxyzh = (nx > ny ? nx : ny); nxyzh = (nxyzh > nz ? nxyzh : nz)/2;
+      nxhyz = nxh > ny ? nxh : ny; nxhyz = nxhyz > nz ? nxhyz : nz;
+      n = 3*nxe*nye*nze;
+      f = (float *) malloc(n*sizeof(float));
+      f1 = (float *) malloc(n*sizeof(float));
+      mixup = (int *) malloc(nxhyz*sizeof(int));
+      sct = (float complex *) malloc(nxyzh*sizeof(float complex));
+      if ((f==NULL) || (f1==NULL)) {
+         printf("grid %d x %d x %d is too large\n",nx,ny,nz);
+         exit(1);
+      }
+      cwfft3rinit(mixup,sct,indx,indy,indz,nxhyz,nxyzh);
+/* l = (0,1) = (scalar,vector) transform */
+      for (l = 0; l < 2; l++) {
+/* check blocked transform against existing one */
+         cfillrand(f,2*l+1,nx,ny,nz,nxe,nye,nze);
+         cfillrand(f1,2*l+1,nx,ny,nz,nxe,nye,nze);
+         if (l==0) {
+            cwfft3rmx((float complex *)f,-1,mixup,sct,indx,indy,indz,
+                      nxeh,nye,nze,nxhyz,nxyzh);
+            cwfft3rmxb((float complex *)f1,-1,mixup,sct,indx,indy,indz,
+                       nxeh,nye,nze,nxhyz,nxyzh,nblok);
+         }
+         else {
+            cwfft3rm3((float complex *)f,-1,mixup,sct,indx,indy,indz,
+                      nxeh,nye,nze,nxhyz,nxyzh);
+            cwfft3rm3b((float complex *)f1,-1,mixup,sct,indx,indy,indz,
+                       nxeh,nye,nze,nxhyz,nxyzh,nblok);
+         }
+         err[l] = cmaxdiff(f,f1,(2*l+1)*nxe*nye*nze);
+/* time existing transform */
+         dtimer(&dtime,&itime,-1);
+         for (j = 0; j < ntry; j++) {
+            if (l==0) {
+               cwfft3rmx((float complex *)f,1,mixup,sct,indx,indy,indz,
+                         nxeh,nye,nze,nxhyz,nxyzh);
+               cwfft3rmx((float complex *)f,-1,mixup,sct,indx,indy,indz,
+                         nxeh,nye,nze,nxhyz,nxyzh);
+            }
+            else {
+               cwfft3rm3((float complex *)f,1,mixup,sct,indx,indy,indz,
+                         nxeh,nye,nze,nxhyz,nxyzh);
+               cwfft3rm3((float complex *)f,-1,mixup,sct,indx,indy,indz,
+                         nxeh,nye,nze,nxhyz,nxyzh);
+            }
+         }
+         dtimer(&dtime,&itime,1);
+         tf[2*l] = 1.0e+3*dtime/(double) ntry;
+/* time blocked transform */
+         dtimer(&dtime,&itime,-1);
+         for (j = 0; j < ntry; j++) {
+            if (l==0) {
+               cwfft3rmxb((float complex *)f1,1,mixup,sct,indx,indy,
+                          indz,nxeh,nye,nze,nxhyz,nxyzh,nblok);
+               cwfft3rmxb((float complex *)f1,-1,mixup,sct,indx,indy,
+                          indz,nxeh,nye,nze,nxhyz,nxyzh,nblok);
+            }
+            else {
+               cwfft3rm3b((float complex *)f1,1,mixup,sct,indx,indy,
+                          indz,nxeh,nye,nze,nxhyz,nxyzh,nblok);
+               cwfft3rm3b((float complex *)f1,-1,mixup,sct,indx,indy,
+                          indz,nxeh,nye,nze,nxhyz,nxyzh,nblok);
+            }
+         }
+         dtimer(&dtime,&itime,1);
+         tf[2*l+1] = 1.0e+3*dtime/(double) ntry;
+      }
+      printf("%5d %9.3f %9.3f %7.2f %9.2e %9.3f %9.3f %7.2f %9.2e\n",
+             nx,tf[0],tf[1],tf[0]/tf[1],err[0],tf[2],tf[3],tf[2]/tf[3],
+             err[1]);
+      free(f);
+      free(f1);
+      free(mixup);
+      free(sct);
+   }
+
+   return 0;
+}
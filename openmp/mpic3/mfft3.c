@@ -0,0 +1,609 @@
+/* cache blocked real to complex fft library for 3D OpenMP PIC codes */
+/* written for the skeleton PIC codes */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <complex.h>
+#include "mpush3.h"
+#include "mfft3.h"
+
+/* NTRB = number of elements in a row copied at a time in a transpose */
+#define NTRB                  64
+
+/*--------------------------------------------------------------------*/
+static void cfftpnl(float gr[], float gi[], int isign, int mixup[],
+                    float complex sct[], int indn, int nxhyz, int nxyz,
+                    int nb, int nbd) {
+/* this subroutine performs nb complex fast fourier transforms of length
+   n = 2**indn stored in a panel, with the element index slow and the
+   transform index fast, so that each butterfly is applied to nb unit
+   stride elements at once.  the panel is stored as separate real and
+   imaginary parts so that the butterflies do not need complex
+   arithmetic
+   gr/gi[k][j] = real/imaginary part of element k of transform j
+   isign = (-1,1) = (inverse,forward) transform
+   mixup = array of bit reversed addresses
+   sct = sine/cosine table
+   nxhyz/nxyz = maximum of (nx/2,ny,nz)/(nx,ny,nz), used to set up
+   tables
+   nb = number of transforms
+   nbd = second dimension of gr/gi >= nb
+local data                                                            */
+   int n, nh, nrb, nr, ns, ns2, km, kmr, i, j, k, l, j1, j2, k1, k2;
+   float wr, wi, tr, ti;
+   n = 1L<<indn;
+   nh = n/2;
+   nrb = nxhyz/n;
+   nr = nxyz/n;
+/* bit-reverse array elements */
+   for (k = 0; k < n; k++) {
+      k1 = (mixup[k] - 1)/nrb;
+      if (k < k1) {
+         j1 = nbd*k;
+         j2 = nbd*k1;
+         for (i = 0; i < nb; i++) {
+            tr = gr[i+j2];
+            ti = gi[i+j2];
+            gr[i+j2] = gr[i+j1];
+            gi[i+j2] = gi[i+j1];
+            gr[i+j1] = tr;
+            gi[i+j1] = ti;
+         }
+      }
+   }
+/* then transform */
+   ns = 1;
+   for (l = 0; l < indn; l++) {
+      ns2 = ns + ns;
+      km = nh/ns;
+      kmr = km*nr;
+      for (k = 0; k < km; k++) {
+         k1 = ns2*k;
+         k2 = k1 + ns;
+         for (j = 0; j < ns; j++) {
+            j1 = nbd*(j + k1);
+            j2 = nbd*(j + k2);
+            wr = crealf(sct[kmr*j]);
+            wi = cimagf(sct[kmr*j]);
+            if (isign > 0)
+               wi = -wi;
+            for (i = 0; i < nb; i++) {
+               tr = wr*gr[i+j2] - wi*gi[i+j2];
+               ti = wr*gi[i+j2] + wi*gr[i+j2];
+               gr[i+j2] = gr[i+j1] - tr;
+               gi[i+j2] = gi[i+j1] - ti;
+               gr[i+j1] += tr;
+               gi[i+j1] += ti;
+            }
+         }
+      }
+      ns = ns2;
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+static void cfftcols(float complex f[], int isign, int mixup[],
+                     float complex sct[], int indn, int ncol, int nlin,
+                     int ldl, int ldk, int nxhyz, int nxyz, int nblok) {
+/* this subroutine performs complex fast fourier transforms of length
+   n = 2**indn along the index of f with stride ldk.  there are ncol
+   adjacent transforms in each of nlin lines, where line m starts at
+   f[ldl*m].  blocks of nblok adjacent transforms are copied into a
+   panel private to each thread, transformed with cfftpnl, and copied
+   back, so that the strided accesses touch whole cache lines
+   isign = (-1,1) = (inverse,forward) transform
+   nxhyz/nxyz = maximum of (nx/2,ny,nz)/(nx,ny,nz), used to set up
+   tables
+   nblok = number of transforms in a block
+local data                                                            */
+   int n, nbk, nt, m, i, k, i0, nb, joff, koff, kk;
+   float *fp, *gr, *gi;
+   n = 1L<<indn;
+   nbk = (ncol - 1)/nblok + 1;
+   nt = nbk*nlin;
+   fp = (float *) f;
+#pragma omp parallel private(m,i,k,i0,nb,joff,koff,kk,gr,gi)
+   {
+      gr = (float *) malloc(2*nblok*n*sizeof(float));
+      gi = &gr[nblok*n];
+#pragma omp for
+      for (m = 0; m < nt; m++) {
+         i0 = nblok*(m%nbk);
+         nb = ncol - i0;
+         nb = nb < nblok ? nb : nblok;
+         joff = ldl*(m/nbk) + i0;
+/* copy block of transforms into panel */
+         for (k = 0; k < n; k++) {
+            koff = 2*(joff + ldk*k);
+            kk = nblok*k;
+            for (i = 0; i < nb; i++) {
+               gr[i+kk] = fp[2*i+koff];
+               gi[i+kk] = fp[2*i+1+koff];
+            }
+         }
+         cfftpnl(gr,gi,isign,mixup,sct,indn,nxhyz,nxyz,nb,nblok);
+/* copy panel back */
+         for (k = 0; k < n; k++) {
+            koff = 2*(joff + ldk*k);
+            kk = nblok*k;
+            for (i = 0; i < nb; i++) {
+               fp[2*i+koff] = gr[i+kk];
+               fp[2*i+1+koff] = gi[i+kk];
+            }
+         }
+      }
+      free(gr);
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+static void cfftrows(float complex f[], int isign, int mixup[],
+                     float complex sct[], int indx, int nrow, int nyr,
+                     int ldy, int ldz, int nxhyz, int nxyz, float ani,
+                     int nblok) {
+/* this subroutine performs the x part of real to complex fast fourier
+   transforms of nrow rows of f, where row m starts at
+   f[ldy*(m%nyr)+ldz*(m/nyr)].  blocks of nblok rows are transposed
+   into a panel private to each thread, so that the butterflies and the
+   unscrambling of the coefficients are applied to nblok rows at once,
+   then transposed back
+   isign = (-1,1) = (inverse,forward) transform
+   indx = exponent which determines length in x direction
+   nyr = number of rows in a plane
+   ldy/ldz = distance between rows/planes
+   nxhyz/nxyz = maximum of (nx/2,ny,nz)/(nx,ny,nz), used to set up
+   tables
+   ani = normalization of inverse transform
+   nblok = number of rows in a block
+local data                                                            */
+   int nx, nxh, nxhh, nbk, kmr, m, i, j, j0, jt, i0, nb, joff, j1, j2;
+   float an, t3r, t3i, ar, ai, br, bi, t1r, t1i, t2r, t2i;
+   float *fp, *gr, *gi;
+   nx = 1L<<indx;
+   nxh = nx/2;
+   nxhh = nx/4;
+   nbk = (nrow - 1)/nblok + 1;
+   kmr = nxyz/nx;
+   fp = (float *) f;
+#pragma omp parallel \
+private(m,i,j,j0,jt,i0,nb,joff,j1,j2,an,t3r,t3i,ar,ai,br,bi,t1r,t1i, \
+t2r,t2i,gr,gi)
+   {
+      gr = (float *) malloc(2*nblok*nxh*sizeof(float));
+      gi = &gr[nblok*nxh];
+#pragma omp for
+      for (m = 0; m < nbk; m++) {
+         i0 = nblok*m;
+         nb = nrow - i0;
+         nb = nb < nblok ? nb : nblok;
+/* transpose block of rows into panel, NTRB elements at a time */
+         for (j0 = 0; j0 < nxh; j0 += NTRB) {
+            jt = j0 + NTRB < nxh ? j0 + NTRB : nxh;
+            for (i = 0; i < nb; i++) {
+               joff = 2*(ldy*((i + i0)%nyr) + ldz*((i + i0)/nyr));
+               for (j = j0; j < jt; j++) {
+                  gr[i+nblok*j] = fp[2*j+joff];
+                  gi[i+nblok*j] = fp[2*j+1+joff];
+               }
+            }
+         }
+/* scramble coefficients */
+         if (isign > 0) {
+            for (j = 1; j < nxhh; j++) {
+               t3r = cimagf(sct[kmr*j]);
+               t3i = crealf(sct[kmr*j]);
+               j1 = nblok*j;
+               j2 = nblok*(nxh - j);
+               for (i = 0; i < nb; i++) {
+                  ar = gr[i+j1];
+                  ai = gi[i+j1];
+                  br = gr[i+j2];
+                  bi = -gi[i+j2];
+                  t1r = ar + br;
+                  t1i = ai + bi;
+                  ar -= br;
+                  ai -= bi;
+                  t2r = ar*t3r - ai*t3i;
+                  t2i = ar*t3i + ai*t3r;
+                  gr[i+j1] = t1r + t2r;
+                  gi[i+j1] = t1i + t2i;
+                  gr[i+j2] = t1r - t2r;
+                  gi[i+j2] = t2i - t1i;
+               }
+            }
+            j1 = nblok*nxhh;
+            for (i = 0; i < nb; i++) {
+               gr[i+j1] = 2.0f*gr[i+j1];
+               gi[i+j1] = -2.0f*gi[i+j1];
+               ar = gr[i];
+               ai = gi[i];
+               gr[i] = ar + ai;
+               gi[i] = ar - ai;
+            }
+         }
+/* transform in x */
+         cfftpnl(gr,gi,isign,mixup,sct,indx-1,nxhyz,nxyz,nb,nblok);
+/* unscramble coefficients and normalize */
+         if (isign < 0) {
+            for (j = 1; j < nxhh; j++) {
+               t3r = cimagf(sct[kmr*j]);
+               t3i = -crealf(sct[kmr*j]);
+               j1 = nblok*j;
+               j2 = nblok*(nxh - j);
+               for (i = 0; i < nb; i++) {
+                  ar = gr[i+j1];
+                  ai = gi[i+j1];
+                  br = gr[i+j2];
+                  bi = -gi[i+j2];
+                  t1r = ar + br;
+                  t1i = ai + bi;
+                  ar -= br;
+                  ai -= bi;
+                  t2r = ar*t3r - ai*t3i;
+                  t2i = ar*t3i + ai*t3r;
+                  gr[i+j1] = ani*(t1r + t2r);
+                  gi[i+j1] = ani*(t1i + t2i);
+                  gr[i+j2] = ani*(t1r - t2r);
+                  gi[i+j2] = ani*(t2i - t1i);
+               }
+            }
+            an = 2.0*ani;
+            j1 = nblok*nxhh;
+            for (i = 0; i < nb; i++) {
+               gr[i+j1] = an*gr[i+j1];
+               gi[i+j1] = -an*gi[i+j1];
+               ar = gr[i];
+               ai = gi[i];
+               gr[i] = an*(ar + ai);
+               gi[i] = an*(ar - ai);
+            }
+         }
+/* transpose panel back */
+         for (j0 = 0; j0 < nxh; j0 += NTRB) {
+            jt = j0 + NTRB < nxh ? j0 + NTRB : nxh;
+            for (i = 0; i < nb; i++) {
+               joff = 2*(ldy*((i + i0)%nyr) + ldz*((i + i0)/nyr));
+               for (j = j0; j < jt; j++) {
+                  fp[2*j+joff] = gr[i+nblok*j];
+                  fp[2*j+1+joff] = gi[i+nblok*j];
+               }
+            }
+         }
+      }
+      free(gr);
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cfft3rmxyb(float complex f[], int isign, int mixup[],
+                float complex sct[], int indx, int indy, int indz,
+                int nzi, int nzp, int nxhd, int nyd, int nzd,
+                int nxhyzd, int nxyzhd, int nblok) {
+/* this subroutine performs the x-y part of a three dimensional real to
+   complex fast fourier transform and its inverse, for a subset of z,
+   as in cfft3rmxy.  the x transforms of blocks of nblok rows are
+   performed in a private panel, as are the y transforms of blocks of
+   nblok columns of each plane, so that each butterfly is applied to
+   nblok transforms at once with unit stride.  results are the same as
+   cfft3rmxy
+   nblok = number of rows or columns in a block
+local data                                                            */
+   int indx1, ndx1yz, nx, nxh, ny, nyh, nz, nxyz, nxhyz, nzt, nxhyd;
+   int k, n, nn, k1, koff;
+   float ani;
+   float complex t1;
+   if (isign==0)
+      return;
+   indx1 = indx - 1;
+   ndx1yz = indx1 > indy ? indx1 : indy;
+   ndx1yz = ndx1yz > indz ? ndx1yz : indz;
+   nx = 1L<<indx;
+   nxh = nx/2;
+   ny = 1L<<indy;
+   nyh = ny/2;
+   nz = 1L<<indz;
+   nxyz = nx > ny ? nx : ny;
+   nxyz = nxyz > nz ? nxyz : nz;
+   nxhyz = 1L<<ndx1yz;
+   nzt = nzi + nzp - 1;
+   nxhyd = nxhd*nyd;
+   nn = nxhyd*(nzi - 1);
+   if (isign > 0)
+      goto L40;
+/* inverse fourier transform */
+   ani = 0.5/(((float) nx)*((float) ny)*((float) nz));
+/* transform in x */
+   cfftrows(&f[nn],isign,mixup,sct,indx,ny*nzp,ny,nxhd,nxhyd,nxhyz,
+            nxyz,ani,nblok);
+/* then transform in y */
+   cfftcols(&f[nn],isign,mixup,sct,indy,nxh,nzp,nxhyd,nxhd,nxhyz,nxyz,
+            nblok);
+/* unscramble modes kx = 0, nx/2 */
+   for (n = nzi-1; n < nzt; n++) {
+      nn = nxhyd*n;
+      for (k = 1; k < nyh; k++) {
+         koff = nxhd*k;
+         k1 = nxhd*ny - koff + nn;
+         koff += nn;
+         t1 = f[k1];
+         f[k1] = 0.5*(cimagf(f[koff] + t1)
+                  + crealf(f[koff] - t1)*_Complex_I);
+         f[koff] = 0.5*(crealf(f[koff] + t1)
+                    + cimagf(f[koff] - t1)*_Complex_I);
+      }
+   }
+   return;
+/* forward fourier transform */
+/* scramble modes kx = 0, nx/2 */
+L40: for (n = nzi-1; n < nzt; n++) {
+      nn = nxhyd*n;
+      for (k = 1; k < nyh; k++) {
+         koff = nxhd*k;
+         k1 = nxhd*ny - koff + nn;
+         koff += nn;
+         t1 = cimagf(f[k1]) + crealf(f[k1])*_Complex_I;
+         f[k1] = conjf(f[koff] - t1);
+         f[koff] += t1;
+      }
+   }
+   nn = nxhyd*(nzi - 1);
+/* transform in y */
+   cfftcols(&f[nn],isign,mixup,sct,indy,nxh,nzp,nxhyd,nxhd,nxhyz,nxyz,
+            nblok);
+/* then transform in x */
+   cfftrows(&f[nn],isign,mixup,sct,indx,ny*nzp,ny,nxhd,nxhyd,nxhyz,
+            nxyz,1.0,nblok);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cfft3rmxzb(float complex f[], int isign, int mixup[],
+                float complex sct[], int indx, int indy, int indz,
+                int nyi, int nyp, int nxhd, int nyd, int nzd,
+                int nxhyzd, int nxyzhd, int nblok) {
+/* this subroutine performs the z part of a three dimensional real to
+   complex fast fourier transform and its inverse, for a subset of y,
+   as in cfft3rmxz.  blocks of nblok columns of each row are copied
+   into a private panel, so that each butterfly is applied to nblok
+   columns at once with unit stride, then copied back.  results are the
+   same as cfft3rmxz
+   nblok = number of columns in a block
+local data                                                            */
+   int indx1, ndx1yz, nx, nxh, ny, nyh, nz, nzh, nxyz, nxhyz, nyt;
+   int nxhyd, n, ll, l1, i0, i1;
+   float complex t1;
+   if (isign==0)
+      return;
+   indx1 = indx - 1;
+   ndx1yz = indx1 > indy ? indx1 : indy;
+   ndx1yz = ndx1yz > indz ? ndx1yz : indz;
+   nx = 1L<<indx;
+   nxh = nx/2;
+   ny = 1L<<indy;
+   nyh = ny/2;
+   nz = 1L<<indz;
+   nzh = nz/2;
+   nxyz = nx > ny ? nx : ny;
+   nxyz = nxyz > nz ? nxyz : nz;
+   nxhyz = 1L<<ndx1yz;
+   nyt = nyi + nyp - 1;
+   nxhyd = nxhd*nyd;
+   if (isign > 0)
+      goto L40;
+/* inverse fourier transform */
+/* transform in z */
+   cfftcols(&f[nxhd*(nyi-1)],isign,mixup,sct,indz,nxh,nyp,nxhd,nxhyd,
+            nxhyz,nxyz,nblok);
+/* unscramble modes kx = 0, nx/2 */
+   for (n = 1; n < nzh; n++) {
+      ll = nxhyd*n;
+      l1 = nxhyd*nz - ll;
+      if (nyi==1) {
+         t1 = f[l1];
+         f[l1] = 0.5*(cimagf(f[ll] + t1)
+                    + crealf(f[ll] - t1)*_Complex_I);
+         f[ll] = 0.5*(crealf(f[ll] + t1)
+                    + cimagf(f[ll] - t1)*_Complex_I);
+      }
+      if ((nyi <= (nyh+1)) && (nyt >= (nyh+1))) {
+         i1 = nxhd*nyh;
+         i0 = i1 + ll;
+         i1 += l1;
+         t1 = f[i1];
+         f[i1] = 0.5*(cimagf(f[i0] + t1)
+                  +   crealf(f[i0] - t1)*_Complex_I);
+         f[i0] = 0.5*(crealf(f[i0] + t1)
+                    + cimagf(f[i0] - t1)*_Complex_I);
+      }
+   }
+   return;
+/* forward fourier transform */
+/* scramble modes kx = 0, nx/2 */
+L40: for (n = 1; n < nzh; n++) {
+      ll = nxhyd*n;
+      l1 = nxhyd*nz - ll;
+      if (nyi==1) {
+         t1 = cimagf(f[l1]) + crealf(f[l1])*_Complex_I;
+         f[l1] = conjf(f[ll] - t1);
+         f[ll] += t1;
+      }
+      if ((nyi <= (nyh+1)) && (nyt >= (nyh+1))) {
+         i1 = nxhd*nyh;
+         i0 = i1 + ll;
+         i1 += l1;
+         t1 = cimagf(f[i1]) + crealf(f[i1])*_Complex_I;
+         f[i1] = conjf(f[i0] - t1);
+         f[i0] += t1;
+      }
+   }
+/* transform in z */
+   cfftcols(&f[nxhd*(nyi-1)],isign,mixup,sct,indz,nxh,nyp,nxhd,nxhyd,
+            nxhyz,nxyz,nblok);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cfft3rm3zb(float complex f[], int isign, int mixup[],
+                float complex sct[], int indx, int indy, int indz,
+                int nyi, int nyp, int nxhd, int nyd, int nzd,
+                int nxhyzd, int nxyzhd, int nblok) {
+/* this subroutine performs the z part of 3 three dimensional real to
+   complex fast fourier transforms and their inverses, for a subset of
+   y, as in cfft3rm3z.  all components of blocks of nblok/3 columns of
+   each row are copied into a private panel, so that each butterfly is
+   applied to nblok transforms at once with unit stride, then copied
+   back.  results are the same as cfft3rm3z
+   nblok = number of transforms in a block
+local data                                                            */
+   int indx1, ndx1yz, nx, nxh, ny, nyh, nz, nzh, nxyz, nxhyz, nyt;
+   int nxhd3, nxhyd, n, jj, ll, l1, i0, i1;
+   float complex t1;
+   if (isign==0)
+      return;
+   indx1 = indx - 1;
+   ndx1yz = indx1 > indy ? indx1 : indy;
+   ndx1yz = ndx1yz > indz ? ndx1yz : indz;
+   nx = 1L<<indx;
+   nxh = nx/2;
+   ny = 1L<<indy;
+   nyh = ny/2;
+   nz = 1L<<indz;
+   nzh = nz/2;
+   nxyz = nx > ny ? nx : ny;
+   nxyz = nxyz > nz ? nxyz : nz;
+   nxhyz = 1L<<ndx1yz;
+   nyt = nyi + nyp - 1;
+   nxhd3 = 3*nxhd;
+   nxhyd = nxhd3*nyd;
+   if (isign > 0)
+      goto L40;
+/* inverse fourier transform */
+/* transform in z */
+   cfftcols(&f[nxhd3*(nyi-1)],isign,mixup,sct,indz,3*nxh,nyp,nxhd3,
+            nxhyd,nxhyz,nxyz,nblok);
+/* unscramble modes kx = 0, nx/2 */
+   for (n = 1; n < nzh; n++) {
+      ll = nxhyd*n;
+      l1 = nxhyd*nz - ll;
+      if (nyi==1) {
+         for (jj = 0; jj < 3; jj++) {
+            t1 = f[jj+l1];
+            f[jj+l1] = 0.5*(cimagf(f[jj+ll] + t1)
+                          + crealf(f[jj+ll] - t1)*_Complex_I);
+            f[jj+ll] = 0.5*(crealf(f[jj+ll] + t1)
+                          + cimagf(f[jj+ll] - t1)*_Complex_I);
+         }
+      }
+      if ((nyi <= (nyh+1)) && (nyt >= (nyh+1))) {
+         for (jj = 0; jj < 3; jj++) {
+            i1 = nxhd3*nyh;
+            i0 = i1 + ll;
+            i1 += l1;
+            t1 = f[jj+i1];
+            f[jj+i1] = 0.5*(cimagf(f[jj+i0] + t1)
+                        +   crealf(f[jj+i0] - t1)*_Complex_I);
+            f[jj+i0] = 0.5*(crealf(f[jj+i0] + t1)
+                          + cimagf(f[jj+i0] - t1)*_Complex_I);
+         }
+      }
+   }
+   return;
+/* forward fourier transform */
+/* scramble modes kx = 0, nx/2 */
+L40: for (n = 1; n < nzh; n++) {
+      ll = nxhyd*n;
+      l1 = nxhyd*nz - ll;
+      if (nyi==1) {
+         for (jj = 0; jj < 3; jj++) {
+            t1 = cimagf(f[jj+l1]) + crealf(f[jj+l1])*_Complex_I;
+            f[jj+l1] = conjf(f[jj+ll] - t1);
+            f[jj+ll] += t1;
+         }
+      }
+      if ((nyi <= (nyh+1)) && (nyt >= (nyh+1))) {
+         for (jj = 0; jj < 3; jj++) {
+            i1 = nxhd3*nyh;
+            i0 = i1 + ll;
+            i1 += l1;
+            t1 = cimagf(f[jj+i1]) + crealf(f[jj+i1])*_Complex_I;
+            f[jj+i1] = conjf(f[jj+i0] - t1);
+            f[jj+i0] += t1;
+         }
+      }
+   }
+/* transform in z */
+   cfftcols(&f[nxhd3*(nyi-1)],isign,mixup,sct,indz,3*nxh,nyp,nxhd3,
+            nxhyd,nxhyz,nxyz,nblok);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cwfft3rmxb(float complex f[], int isign, int mixup[],
+                float complex sct[], int indx, int indy, int indz,
+                int nxhd, int nyd, int nzd, int nxhyzd, int nxyzhd,
+                int nblok) {
+/* wrapper function for real to complex fft, with packed data */
+/* cache blocked version of cwfft3rmx */
+/* local data */
+   int ny, nz;
+   static int nyi = 1, nzi = 1;
+/* calculate range of indices */
+   ny = 1L<<indy;
+   nz = 1L<<indz;
+/* inverse fourier transform */
+   if (isign < 0) {
+/* perform xy fft */
+      cfft3rmxyb(f,isign,mixup,sct,indx,indy,indz,nzi,nz,nxhd,nyd,nzd,
+                 nxhyzd,nxyzhd,nblok);
+/* perform z fft */
+      cfft3rmxzb(f,isign,mixup,sct,indx,indy,indz,nyi,ny,nxhd,nyd,nzd,
+                 nxhyzd,nxyzhd,nblok);
+   }
+/* forward fourier transform */
+   else if (isign > 0) {
+/* perform z fft */
+      cfft3rmxzb(f,isign,mixup,sct,indx,indy,indz,nyi,ny,nxhd,nyd,nzd,
+                 nxhyzd,nxyzhd,nblok);
+/* perform xy fft */
+      cfft3rmxyb(f,isign,mixup,sct,indx,indy,indz,nzi,nz,nxhd,nyd,nzd,
+                 nxhyzd,nxyzhd,nblok);
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cwfft3rm3b(float complex f[], int isign, int mixup[],
+                float complex sct[], int indx, int indy, int indz,
+                int nxhd, int nyd, int nzd, int nxhyzd, int nxyzhd,
+                int nblok) {
+/* wrapper function for 3 3d real to complex ffts, with packed data */
+/* cache blocked version of cwfft3rm3, the x-y part is not blocked */
+/* local data */
+   int ny, nz;
+   static int nyi = 1, nzi = 1;
+/* calculate range of indices */
+   ny = 1L<<indy;
+   nz = 1L<<indz;
+/* inverse fourier transform */
+   if (isign < 0) {
+/* perform xy fft */
+      cfft3rm3xy(f,isign,mixup,sct,indx,indy,indz,nzi,nz,nxhd,nyd,nzd,
+                 nxhyzd,nxyzhd);
+/* perform z fft */
+      cfft3rm3zb(f,isign,mixup,sct,indx,indy,indz,nyi,ny,nxhd,nyd,nzd,
+                 nxhyzd,nxyzhd,nblok);
+   }
+/* forward fourier transform */
+   else if (isign > 0) {
+/* perform z fft */
+      cfft3rm3zb(f,isign,mixup,sct,indx,indy,indz,nyi,ny,nxhd,nyd,nzd,
+                 nxhyzd,nxyzhd,nblok);
+/* perform xy fft */
+      cfft3rm3xy(f,isign,mixup,sct,indx,indy,indz,nzi,nz,nxhd,nyd,nzd,
+                 nxhyzd,nxyzhd);
+   }
+   return;
+}
@@ -0,0 +1,26 @@
+/* header file for mfft3.c */
+
+void cfft3rmxyb(float complex f[], int isign, int mixup[],
+                float complex sct[], int indx, int indy, int indz,
+                int nzi, int nzp, int nxhd, int nyd, int nzd,
+                int nxhyzd, int nxyzhd, int nblok);
+
+void cfft3rmxzb(float complex f[], int isign, int mixup[],
+                float complex sct[], int indx, int indy, int indz,
+                int nyi, int nyp, int nxhd, int nyd, int nzd,
+                int nxhyzd, int nxyzhd, int nblok);
+
+void cfft3rm3zb(float complex f[], int isign, int mixup[],
+                float complex sct[], int indx, int indy, int indz,
+                int nyi, int nyp, int nxhd, int nyd, int nzd,
+                int nxhyzd, int nxyzhd, int nblok);
+
+void cwfft3rmxb(float complex f[], int isign, int mixup[],
+                float complex sct[], int indx, int indy, int indz,
+                int nxhd, int nyd, int nzd, int nxhyzd, int nxyzhd,
+                int nblok);
+
+void cwfft3rm3b(float complex f[], int isign, int mixup[],
+                float complex sct[], int indx, int indy, int indz,
+                int nxhd, int nyd, int nzd, int nxhyzd, int nxyzhd,
+                int nblok);
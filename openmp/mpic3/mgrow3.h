@@ -0,0 +1,13 @@
+/* header file for mgrow3.c */
+
+int cgrowsize(int nold, int nneed, int nmin, float xtras, int kgrow);
+
+void *cgrowtile(void *a, int nold, int nnew, int ntile, int nsize);
+
+void cppneed3l(int kpic[], int ncl[], int mx1, int my1, int mz1,
+               int *nhmax, int *nppmax);
+
+void cppholes3l(float ppart[], int kpic[], int ncl[], int ihole[],
+                int idimp, int nppmx, int nx, int ny, int nz, int mx,
+                int my, int mz, int mx1, int my1, int mxyz1, int ntmax,
+                int *irc);
@@ -0,0 +1,208 @@
+/* NUMA placement library for 3D OpenMP PIC codes */
+/* written for the skeleton PIC codes */
+
+#ifdef __linux__
+#define _GNU_SOURCE
+#include <sched.h>
+#endif
+#include <stdlib.h>
+#include <stdio.h>
+#include <omp.h>
+#include "mnuma3.h"
+
+/* NSOCK = maximum number of sockets reported */
+#define NSOCK                 16
+
+/*--------------------------------------------------------------------*/
+int csocket(int cpu) {
+/* this function returns the socket (physical package) of processor cpu,
+   or 0 if it cannot be determined
+local data                                                            */
+   int ns;
+   char name[80];
+   FILE *unit;
+   ns = 0;
+   if (cpu < 0)
+      return ns;
+   sprintf(name,"/sys/devices/system/cpu/cpu%d/topology/%s",cpu,
+           "physical_package_id");
+   unit = fopen(name,"r");
+   if (unit==NULL)
+      return ns;
+   if (fscanf(unit,"%d",&ns) != 1)
+      ns = 0;
+   fclose(unit);
+   if ((ns < 0) || (ns >= NSOCK))
+      ns = 0;
+   return ns;
+}
+
+/*--------------------------------------------------------------------*/
+void cfirsttouch3l(float ppart[], float ppbuff[], int ihole[], int idimp,
+                   int nppmx, int npbmx, int ntmax, int mxyz1) {
+/* this subroutine zeroes the tiled particle arrays, with each tile
+   written by the thread which processes it in the push, deposit and
+   reorder procedures, so that with first touch placement its memory is
+   on the socket of that thread.  the tile procedures divide the tiles
+   with the default static schedule, which is used here explicitly.
+   must be called after allocation, before the arrays are first used
+   ppart[k][n][i] = particle co-ordinate i of particle n in tile k
+   ppbuff[k][n][i] = buffer co-ordinate i of particle n in tile k
+   ihole[k][:][2] = location and destination of departing particles
+   idimp = size of phase space = 6
+   nppmx = maximum number of particles in tile
+   npbmx = size of buffer array ppbuff
+   ntmax = size of hole array for particles leaving tiles
+   mxyz1 = number of tiles
+local data                                                            */
+   int j, k;
+#pragma omp parallel for schedule(static) private(j,k)
+   for (k = 0; k < mxyz1; k++) {
+      for (j = 0; j < idimp*nppmx; j++) {
+         ppart[j+idimp*nppmx*k] = 0.0f;
+      }
+      for (j = 0; j < idimp*npbmx; j++) {
+         ppbuff[j+idimp*npbmx*k] = 0.0f;
+      }
+      for (j = 0; j < 2*(ntmax+1); j++) {
+         ihole[j+2*(ntmax+1)*k] = 0;
+      }
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cfirsttouch3f(float q[], float fxyz[], int ndim, int mx, int my,
+                   int mz, int nxe, int nye, int nze, int mx1, int my1,
+                   int mxyz1) {
+/* this subroutine zeroes the charge and force arrays, with the grid
+   points of each tile written by the thread which processes the tile,
+   as in cfirsttouch3l.  the guard cells beyond the last tile in x, y
+   and z are written by the thread of the last tile.  since whole pages
+   are placed, planes shared by tiles of different threads are placed on
+   one of them
+   q[l][k][j] = charge density at grid point j,k,l
+   fxyz[l][k][j][i] = component i of force/charge at grid (j,k,l)
+   ndim = number of components of fxyz = 3
+   mx/my/mz = number of grids in sorting cell in x/y/z
+   nxe/nye/nze = dimensions of field arrays, must be >= nx+1/ny+1/nz+1
+   mx1 = (system length in x direction - 1)/mx + 1
+   my1 = (system length in y direction - 1)/my + 1
+   mxyz1 = mx1*my1*mz1,
+   where mz1 = (system length in z direction - 1)/mz + 1
+local data                                                            */
+   int i, j, k, l, mxy1, mz1, noff, moff, loff, nn, mm, ll;
+   mxy1 = mx1*my1;
+   mz1 = mxyz1/mxy1;
+#pragma omp parallel for schedule(static) \
+private(i,j,k,l,noff,moff,loff,nn,mm,ll)
+   for (l = 0; l < mxyz1; l++) {
+      loff = l/mxy1;
+      k = l - mxy1*loff;
+      ll = loff==(mz1-1) ? nze : mz*loff + mz;
+      ll = ll < nze ? ll : nze;
+      loff = mz*loff;
+      noff = k/mx1;
+      moff = my*noff;
+      mm = noff==(my1-1) ? nye : moff + my;
+      mm = mm < nye ? mm : nye;
+      noff = mx*(k - mx1*noff);
+      nn = (noff + mx) >= mx*mx1 ? nxe : noff + mx;
+      nn = nn < nxe ? nn : nxe;
+      for (k = loff; k < ll; k++) {
+         for (j = moff; j < mm; j++) {
+            for (i = noff; i < nn; i++) {
+               q[i+nxe*(j+nye*k)] = 0.0f;
+            }
+            for (i = ndim*noff; i < ndim*nn; i++) {
+               fxyz[i+ndim*nxe*(j+nye*k)] = 0.0f;
+            }
+         }
+      }
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cnumabw3(float ppart[], int kpic[], int idimp, int nppmx,
+              int mxyz1, int ntry) {
+/* this subroutine measures and prints the memory bandwidth of each
+   socket for the tiled particle array, with the access pattern of the
+   push: each thread reads and writes all co-ordinates of the particles
+   in its tiles, ntry times.  the socket of each thread is found from
+   the processor it runs on, so threads should be pinned.  ppart is
+   multiplied by one and so is not changed
+   ppart[k][n][i] = particle co-ordinate i of particle n in tile k
+   kpic[k] = number of particles in tile k
+   idimp = size of phase space = 6
+   nppmx = maximum number of particles in tile
+   mxyz1 = number of tiles
+   ntry = number of passes timed
+local data                                                            */
+   int i, j, k, n, it, ns, nsmax;
+   int nthr[NSOCK];
+   float one;
+   double tbeg, tpass, bytes, bw;
+   double tsock[NSOCK], bsock[NSOCK], tmax[NSOCK];
+   volatile float vone = 1.0f;
+   one = vone;
+   for (i = 0; i < NSOCK; i++) {
+      nthr[i] = 0;
+      tsock[i] = 0.0;
+      bsock[i] = 0.0;
+      tmax[i] = 0.0;
+   }
+   nsmax = 0;
+   tbeg = 0.0;
+#pragma omp parallel private(i,j,k,n,it,ns,tpass,bytes)
+   {
+   ns = 0;
+#ifdef __linux__
+   ns = csocket(sched_getcpu());
+#endif
+   bytes = 0.0;
+/* first pass is not timed */
+   for (n = 0; n <= ntry; n++) {
+#pragma omp barrier
+#pragma omp master
+      tbeg = omp_get_wtime();
+#pragma omp barrier
+#pragma omp for schedule(static) nowait
+      for (k = 0; k < mxyz1; k++) {
+         it = idimp*kpic[k];
+         for (j = 0; j < it; j++) {
+            ppart[j+idimp*nppmx*k] *= one;
+         }
+         if (n > 0)
+            bytes += 2.0*sizeof(float)*(double) it;
+      }
+      tpass = omp_get_wtime() - tbeg;
+/* the last thread of a socket to finish determines its time */
+#pragma omp critical
+      tmax[ns] = tpass > tmax[ns] ? tpass : tmax[ns];
+#pragma omp barrier
+#pragma omp master
+      {
+      for (i = 0; i < NSOCK; i++) {
+         if (n > 0)
+            tsock[i] += tmax[i];
+         tmax[i] = 0.0;
+      }
+      }
+   }
+#pragma omp critical
+   {
+   nthr[ns] += 1;
+   bsock[ns] += bytes;
+   nsmax = ns > nsmax ? ns : nsmax;
+   }
+   }
+   printf("particle array bandwidth of each socket:\n");
+   for (i = 0; i <= nsmax; i++) {
+      if (nthr[i]==0)
+         continue;
+      bw = tsock[i] > 0.0 ? 1.0e-9*bsock[i]/tsock[i] : 0.0;
+      printf("socket %d: %d thread(s), %f GB/sec\n",i,nthr[i],bw);
+   }
+   return;
+}
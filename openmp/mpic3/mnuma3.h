@@ -0,0 +1,13 @@
+/* header file for mnuma3.c */
+
+int csocket(int cpu);
+
+void cfirsttouch3l(float ppart[], float ppbuff[], int ihole[], int idimp,
+                   int nppmx, int npbmx, int ntmax, int mxyz1);
+
+void cfirsttouch3f(float q[], float fxyz[], int ndim, int mx, int my,
+                   int mz, int nxe, int nye, int nze, int mx1, int my1,
+                   int mxyz1);
+
+void cnumabw3(float ppart[], int kpic[], int idimp, int nppmx,
+              int mxyz1, int ntry);
@@ -7,6 +7,12 @@
 #include <sys/time.h>
 #include "mpush3.h"
 #include "omplib.h"
+#include "cfglib.h"
+#include "mgrow3.h"
+#include "mtune3.h"
+#include "mnuma3.h"
+#include "mtask3.h"
+#include "mfft3.h"
 
 void dtimer(double *time, struct timeval *itime, int icntrl);
 
@@ -35,8 +41,30 @@ int main(int argc, char *argv[]) {
    float wke = 0.0, we = 0.0, wt = 0.0;
 /* mx/my/mz = number of grids in x/y/z in sorting tiles */
    int mx = 8, my = 8, mz = 8;
+/* ktune = (0,1) = (no,yes) replace mx, my, mz with the fastest tile */
+/* size, found by timing a few steps at startup                     */
+   int ktune = 0;
 /* xtras = fraction of extra particles needed for particle management */
    float xtras = 0.2;
+/* kdepo = (0,1) = deposit tile edges with (atomic updates,colored */
+/* tile schedule)                                                  */
+   int kdepo = 0;
+/* kgrow = (0,1,2) = on particle buffer overflow (stop with error,grow */
+/* buffers,grow and shrink buffers)                                     */
+   int kgrow = 1;
+/* kaff = (0,1,2) = (do not pin threads,pin threads to consecutive */
+/* processors,spread threads evenly over processors)               */
+/* knuma = (0,1) = (no,yes) first touch tiled particle and field arrays */
+/* by the thread which processes each tile                             */
+/* kbw = (0,1) = (no,yes) print particle array bandwidth of each socket */
+   int kaff = 0, knuma = 0, kbw = 0;
+/* ktask = (0,1,2) = (run the phases of a step one after another,overlap */
+/* reorder with deposit and fft of the charge using OpenMP tasks,same   */
+/* and write task timelines to file trace.csv)                          */
+   int ktask = 0;
+/* kfft = (0,1) = (standard,cache blocked) real to complex ffts */
+/* nbfft = number of rows or columns transformed together in a block */
+   int kfft = 0, nbfft = 16;
 /* declare scalars for standard code */
    int j;
    int np, nx, ny, nz, nxh, nyh, nzh, nxe, nye, nze, nxeh;
@@ -47,6 +75,13 @@ int main(int argc, char *argv[]) {
 /* declare scalars for OpenMP code */
    int nppmx, nppmx0, ntmax, npbmx, irc;
    int nvp;
+/* nppmin/ntmin/npbmin = initial sizes of particle buffers */
+/* nh/npp = buffer sizes needed to reorder particles */
+/* ngrow/nshrink = number of times buffers were enlarged/reduced */
+   int nppmin, ntmin, npbmin, nh, npp, n, ngrow = 0, nshrink = 0;
+/* ltask = (0,1) = charge for this step (is not,is) already deposited and */
+/* x-y transformed by the task graph                                      */
+   int ltask = 0;
 
 /* declare arrays for standard code: */
 /* part = particle arrays */
@@ -72,12 +107,16 @@ int main(int argc, char *argv[]) {
    int *ncl = NULL;
 /* ihole = location/destination of each particle departing tile */
    int *ihole = NULL;
+/* trace = thread and start/end times of each task in task graph */
+   double *trace = NULL;
 
 /* declare and initialize timing data */
    float time;
    struct timeval itime;
    float tdpost = 0.0, tguard = 0.0, tfft = 0.0, tfield = 0.0;
-   float tpush = 0.0, tsort = 0.0;
+   float tpush = 0.0, tsort = 0.0, ttask = 0.0;
+/* tbest/tdef = time per particle per step with best/default tiles */
+   double tbest, tdef;
    double dtime;
 
    irc = 0;
@@ -85,8 +124,34 @@ int main(int argc, char *argv[]) {
    nvp = 0;
 /* printf("enter number of nodes:\n"); */
 /* scanf("%i",&nvp);                   */
+/* replace parameters with values from input decks or command line, */
+/* for example: cmpic3 indx=6 npx=192 npy=192 npz=192               */
+   irc = ccfgread(argc,argv,1);
+   ccfgint("indx",&indx); ccfgint("indy",&indy); ccfgint("indz",&indz);
+   ccfgint("npx",&npx); ccfgint("npy",&npy); ccfgint("npz",&npz);
+   ccfgflt("tend",&tend); ccfgflt("dt",&dt); ccfgflt("vtx",&vtx);
+   ccfgflt("vty",&vty); ccfgflt("vtz",&vtz); ccfgflt("vx0",&vx0);
+   ccfgflt("vy0",&vy0); ccfgflt("vz0",&vz0); ccfgint("mx",&mx);
+   ccfgint("my",&my); ccfgint("mz",&mz); ccfgflt("xtras",&xtras);
+   ccfgint("nvp",&nvp); ccfgint("kdepo",&kdepo);
+   ccfgint("kgrow",&kgrow); ccfgint("ktune",&ktune);
+   ccfgint("kaff",&kaff); ccfgint("knuma",&knuma); ccfgint("kbw",&kbw);
+   ccfgint("ktask",&ktask); ccfgint("kfft",&kfft);
+   ccfgint("nbfft",&nbfft);
+   irc += ccfgend();
+   if (irc != 0) {
+      printf("invalid run time parameters\n");
+      exit(1);
+   }
+   if (nbfft < 1) {
+      printf("invalid fft block size, nbfft=%d\n",nbfft);
+      exit(1);
+   }
 /* initialize for shared memory parallel processing */
    cinit_omp(nvp);
+/* pin threads to processors and report them */
+   if (kaff > 0)
+      caffin_omp(kaff);
 
 /* initialize scalars for standard code */
 /* np = total number of particles in simulation */
@@ -124,6 +189,20 @@ int main(int argc, char *argv[]) {
    cdistr3(part,vtx,vty,vtz,vx0,vy0,vz0,npx,npy,npz,idimp,np,nx,ny,nz,
            ipbc);
 
+/* choose tile size by timing deposit, push and reorder: */
+/* updates mx, my, mz                                    */
+   if (ktune==1) {
+      cmtune3(part,qme,qbme,dt,idimp,np,nx,ny,nz,nxe,nye,nze,xtras,
+              kdepo,3,&mx,&my,&mz,&tbest,&tdef);
+      printf("tile size chosen: mx,my,mz = %d,%d,%d\n",mx,my,mz);
+      if ((tdef > 0.0) && (tbest > 0.0))
+         printf("speedup over default tile size = %f\n",tdef/tbest);
+      mx1 = (nx - 1)/mx + 1; my1 = (ny - 1)/my + 1;
+      mz1 = (nz - 1)/mz + 1; mxyz1 = mx1*my1*mz1;
+      free(kpic);
+      kpic = (int *) malloc(mxyz1*sizeof(int));
+   }
+
 /* find number of particles in each of mx, my, mz tiles: */
 /* updates kpic, nppmx */
    cdblkp3l(part,kpic,&nppmx,idimp,np,mx,my,mz,mx1,my1,mxyz1,&irc);
@@ -139,6 +218,13 @@ int main(int argc, char *argv[]) {
    ppbuff = (float *) malloc(idimp*npbmx*mxyz1*sizeof(float));
    ncl = (int *) malloc(26*mxyz1*sizeof(int));
    ihole = (int *) malloc(2*(ntmax+1)*mxyz1*sizeof(int));
+   trace = (double *) malloc(12*mz1*sizeof(double));
+   nppmin = nppmx0; ntmin = ntmax; npbmin = npbmx;
+/* place memory of each tile on socket of thread which processes it */
+   if (knuma==1) {
+      cfirsttouch3l(ppart,ppbuff,ihole,idimp,nppmx0,npbmx,ntmax,mxyz1);
+      cfirsttouch3f(qe,fxyze,ndim,mx,my,mz,nxe,nye,nze,mx1,my1,mxyz1);
+   }
 /* copy ordered particle data for OpenMP: updates ppart and kpic */
    cppmovin3l(part,ppart,kpic,nppmx0,idimp,np,mx,my,mz,mx1,my1,mxyz1,
               &irc);
@@ -153,6 +239,13 @@ int main(int argc, char *argv[]) {
       printf("%d,cppcheck3l error: irc=%d\n",ntime,irc);
       exit(1);
    }
+/* measure bandwidth of each socket for tiled particle array */
+   if (kbw==1)
+      cnumabw3(ppart,kpic,idimp,nppmx0,mxyz1,5);
+   if (ktask==2) {
+      if (ctraceopen("trace.csv")==1)
+         printf("cannot open task trace file trace.csv\n");
+   }
 
 /* * * * start main iteration loop * * * */
  
@@ -161,28 +254,50 @@ L500: if (nloop <= ntime)
 /*    printf("ntime = %i\n",ntime); */
  
 /* deposit charge with OpenMP: updates qe */
-      dtimer(&dtime,&itime,-1);
-      for (j = 0; j < nxe*nye*nze; j++) {
-         qe[j] = 0.0;
-      }
-      cgppost3l(ppart,qe,kpic,qme,nppmx0,idimp,mx,my,mz,nxe,nye,nze,mx1,
-                my1,mxyz1);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tdpost += time;
+/* skipped if the task graph of the previous step deposited it */
+      if (ltask==0) {
+         dtimer(&dtime,&itime,-1);
+         for (j = 0; j < nxe*nye*nze; j++) {
+            qe[j] = 0.0;
+         }
+         if (kdepo==1)
+            cgppost3lc(ppart,qe,kpic,qme,nppmx0,idimp,mx,my,mz,nxe,nye,
+                       nze,mx1,my1,mxyz1);
+         else
+            cgppost3l(ppart,qe,kpic,qme,nppmx0,idimp,mx,my,mz,nxe,nye,
+                      nze,mx1,my1,mxyz1);
+         dtimer(&dtime,&itime,1);
+         time = (float) dtime;
+         tdpost += time;
 
 /* add guard cells with OpenMP: updates qe */
-      dtimer(&dtime,&itime,-1);
-      caguard3l(qe,nx,ny,nz,nxe,nye,nze);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tguard += time;
+         dtimer(&dtime,&itime,-1);
+         caguard3l(qe,nx,ny,nz,nxe,nye,nze);
+         dtimer(&dtime,&itime,1);
+         time = (float) dtime;
+         tguard += time;
+      }
 
 /* transform charge to fourier space with OpenMP: updates qe */
       dtimer(&dtime,&itime,-1);
       isign = -1;
-      cwfft3rmx((float complex *)qe,isign,mixup,sct,indx,indy,indz,nxeh,
-                nye,nze,nxhyz,nxyzh);
+      if (ltask==0) {
+         if (kfft==0)
+            cwfft3rmx((float complex *)qe,isign,mixup,sct,indx,indy,
+                      indz,nxeh,nye,nze,nxhyz,nxyzh);
+         else
+            cwfft3rmxb((float complex *)qe,isign,mixup,sct,indx,indy,
+                       indz,nxeh,nye,nze,nxhyz,nxyzh,nbfft);
+      }
+/* only the z part is left after the task graph */
+      else {
+         if (kfft==0)
+            cfft3rmxz((float complex *)qe,isign,mixup,sct,indx,indy,
+                      indz,1,ny,nxeh,nye,nze,nxhyz,nxyzh);
+         else
+            cfft3rmxzb((float complex *)qe,isign,mixup,sct,indx,indy,
+                       indz,1,ny,nxeh,nye,nze,nxhyz,nxyzh,nbfft);
+      }
       dtimer(&dtime,&itime,1);
       time = (float) dtime;
       tfft += time;
@@ -200,8 +315,12 @@ L500: if (nloop <= ntime)
 /* transform force to real space with OpenMP: updates fxyze */
       dtimer(&dtime,&itime,-1);
       isign = 1;
-      cwfft3rm3((float complex *)fxyze,isign,mixup,sct,indx,indy,indz,
-                nxeh,nye,nze,nxhyz,nxyzh);
+      if (kfft==0)
+         cwfft3rm3((float complex *)fxyze,isign,mixup,sct,indx,indy,
+                   indz,nxeh,nye,nze,nxhyz,nxyzh);
+      else
+         cwfft3rm3b((float complex *)fxyze,isign,mixup,sct,indx,indy,
+                    indz,nxeh,nye,nze,nxhyz,nxyzh,nbfft);
       dtimer(&dtime,&itime,1);
       time = (float) dtime;
       tfft += time;
@@ -226,22 +345,93 @@ L500: if (nloop <= ntime)
       dtimer(&dtime,&itime,1);
       time = (float) dtime;
       tpush += time;
+
+/* reorder particles by tile with OpenMP: */
+      dtimer(&dtime,&itime,-1);
+      if ((irc != 0) && (kgrow > 0)) {
+/* enlarge ihole and find departing particles again */
+         cppneed3l(kpic,ncl,mx1,my1,mz1,&nh,&npp);
+         ntmax = cgrowsize(ntmax,nh,ntmin,xtras,1);
+         free(ihole);
+         ihole = (int *) malloc(2*(ntmax+1)*mxyz1*sizeof(int));
+         irc = 0;
+         if (ihole==NULL)
+            irc = -1;
+         else
+            cppholes3l(ppart,kpic,ncl,ihole,idimp,nppmx0,nx,ny,nz,mx,my,
+                       mz,mx1,my1,mxyz1,ntmax,&irc);
+         ngrow += 1;
+      }
       if (irc != 0) {
          printf("cgppushf3l error: irc=%d\n",irc);
          exit(1);
       }
-
-/* reorder particles by tile with OpenMP: */
-      dtimer(&dtime,&itime,-1);
+/* check particle buffer sizes, enlarge or reduce them if needed */
+      if (kgrow > 0) {
+         cppneed3l(kpic,ncl,mx1,my1,mz1,&nh,&npp);
+         n = cgrowsize(npbmx,nh,npbmin,xtras,kgrow);
+         if (n != npbmx) {
+            if (n > npbmx) ngrow += 1; else nshrink += 1;
+            npbmx = n;
+            free(ppbuff);
+            ppbuff = (float *) malloc(idimp*npbmx*mxyz1*sizeof(float));
+            if (ppbuff==NULL)
+               irc = -1;
+         }
+         n = cgrowsize(nppmx0,npp,nppmin,xtras,kgrow);
+         if ((n != nppmx0) && (irc==0)) {
+            if (n > nppmx0) ngrow += 1; else nshrink += 1;
+            ppart = (float *) cgrowtile(ppart,nppmx0,n,mxyz1,
+                                        idimp*sizeof(float));
+            nppmx0 = n;
+            if (ppart==NULL)
+               irc = -1;
+         }
+/* ihole holds the holes found by the push, so it is only reduced here */
+         n = cgrowsize(ntmax,nh,ntmin,xtras,kgrow);
+         if ((n < ntmax) && (irc==0)) {
+            nshrink += 1;
+            ihole = (int *) cgrowtile(ihole,ntmax+1,n+1,mxyz1,
+                                      2*sizeof(int));
+            ntmax = n;
+            if (ihole==NULL)
+               irc = -1;
+         }
+         if (irc != 0) {
+            printf("particle buffer allocation error: irc=%d\n",irc);
+            exit(1);
+         }
+      }
 /* updates ppart, ppbuff, kpic, ncl, ihole, and irc */
 /*    cpporder3l(ppart,ppbuff,kpic,ncl,ihole,idimp,nppmx0,nx,ny,nz, */
 /*               mx,my,mz,mx1,my1,mz1,npbmx,ntmax,&irc);            */
+/* reorder particles, then deposit charge and start its fft for the next */
+/* step with a graph of OpenMP tasks: updates ppart, ppbuff, kpic, ncl, */
+/* qe, and irc                                                           */
+      ltask = 0;
+      if ((ktask > 0) && (ntime+1 < nloop)) {
+         dtimer(&dtime,&itime,1);
+         time = (float) dtime;
+         tsort += time;
+         dtimer(&dtime,&itime,-1);
+         cppordpost3t(ppart,ppbuff,kpic,ncl,ihole,qe,qme,mixup,sct,trace,
+                      idimp,nppmx0,nx,ny,nz,mx,my,mz,nxe,nye,nze,mx1,my1,
+                      mz1,npbmx,ntmax,indx,indy,indz,nxhyz,nxyzh,&irc);
+         dtimer(&dtime,&itime,1);
+         time = (float) dtime;
+         ttask += time;
+         if (ktask==2)
+            ctracewrite(trace,ntime,mz1);
+         ltask = 1;
+      }
 /* updates ppart, ppbuff, kpic, ncl, and irc */
-      cpporderf3l(ppart,ppbuff,kpic,ncl,ihole,idimp,nppmx0,mx1,my1,
-                  mz1,npbmx,ntmax,&irc);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tsort += time;
+      else {
+         cpporderf3l(ppart,ppbuff,kpic,ncl,ihole,idimp,nppmx0,mx1,my1,
+                     mz1,npbmx,ntmax,&irc);
+         dtimer(&dtime,&itime,1);
+         time = (float) dtime;
+         tsort += time;
+      }
       if (irc != 0) {
          printf("cpporderf3l error: ntmax, irc=%d,%d\n",ntmax,irc);
          exit(1);
@@ -258,6 +448,11 @@ L2000:
 /* * * * end main iteration loop * * * */
 
    printf("ntime = %i\n",ntime);
+   if ((ngrow + nshrink) > 0) {
+      printf("particle buffers enlarged/reduced = %d,%d\n",ngrow,nshrink);
+      printf("final nppmx0, npbmx, ntmax = %d,%d,%d\n",nppmx0,npbmx,
+             ntmax);
+   }
    printf("Final Field, Kinetic and Total Energies:\n");
    printf("%e %e %e\n",we,wke,wke+we);
 
@@ -268,9 +463,11 @@ L2000:
    printf("fft time = %f\n",tfft);
    printf("push time = %f\n",tpush);
    printf("sort time = %f\n",tsort);
+   if (ktask > 0)
+      printf("task graph time = %f\n",ttask);
    tfield += tguard + tfft;
    printf("total solver time = %f\n",tfield);
-   time = tdpost + tpush + tsort;
+   time = tdpost + tpush + tsort + ttask;
    printf("total particle time = %f\n",time);
    wt = time + tfield;
    printf("total time = %f\n",wt);
@@ -280,8 +477,12 @@ L2000:
    printf("Push Time (nsec) = %f\n",tpush*wt);
    printf("Deposit Time (nsec) = %f\n",tdpost*wt);
    printf("Sort Time (nsec) = %f\n",tsort*wt);
+   if (ktask > 0)
+      printf("Task Graph Time (nsec) = %f\n",ttask*wt);
    printf("Total Particle Time (nsec) = %f\n",time*wt);
    printf("\n");
+   if (ktask==2)
+      ctraceclose();
 
    return 0;
 }
@@ -433,19 +433,13 @@ void cgppush3l(float ppart[], float fxyz[], int kpic[], float qbm,
    ipbc = particle boundary condition = (0,1,2,3) =
    (none,3d periodic,3d reflecting,mixed 2d reflecting/1d periodic)
 local data                                                            */
-#define MXV             17
-#define MYV             17
-#define MZV             17
    int mxy1, noff, moff, loff, npoff, npp;
    int i, j, k, l, nn, mm, ll, mxv, myv, mxyv, nxyv;
    float qtm, edgelx, edgely, edgelz, edgerx, edgery, edgerz;
    float x, y, z, dxp, dyp, dzp, amx, amy, amz, dx1, dx, dy, dz;
    float vx, vy, vz;
-   float sfxyz[3*MXV*MYV*MZV];
-/* float sfxyz[3*(mx+1)*(my+1)*(mz+1)]; */
+   float *sfxyz;
    double sum1, sum2;
-/* mxv = MXV; */
-/* myv = MYV; */
    mxv = mx+1;
    myv = my+1;
    mxyv = mxv*myv;
@@ -474,14 +468,15 @@ local data                                                            */
       edgerx = (float) (nx-1);
       edgery = (float) (ny-1);
    }
-/* error if local array is too small                */
-/* if ((mx >= MXV) || (my >= MYV) || (mz >= MZV))   */
-/*    return;                                       */
 /* loop over tiles */
-#pragma omp parallel for \
+#pragma omp parallel \
 private(i,j,k,l,noff,moff,loff,npp,npoff,nn,mm,ll,x,y,z,dxp,dyp,dzp, \
 amx,amy,amz,dx1,dx,dy,dz,vx,vy,vz,sum1,sfxyz) \
 reduction(+:sum2)
+   {
+/* allocate local fields for each thread */
+   sfxyz = (float *) malloc(3*mxyv*(mz+1)*sizeof(float));
+#pragma omp for
    for (l = 0; l < mxyz1; l++) {
       loff = l/mxy1;
       k = l - mxy1*loff;
@@ -596,12 +591,11 @@ reduction(+:sum2)
       }
       sum2 += sum1;
    }
+   free(sfxyz);
+   }
 /* normalize kinetic energy */
    *ek += 0.125f*sum2;
    return;
-#undef MXV
-#undef MYV
-#undef MZV
 }
 
 /*--------------------------------------------------------------------*/
@@ -677,19 +671,13 @@ void cgppushf3l(float ppart[], float fxyz[], int kpic[], int ncl[],
    irc = maximum overflow, returned only if error occurs, when irc > 0
    optimized version
 local data                                                            */
-#define MXV             17
-#define MYV             17
-#define MZV             17
    int mxy1, noff, moff, loff, npoff, npp;
    int i, j, k, l, ih, nh, nn, mm, ll, mxv, myv, mxyv, nxyv;
    float anx, any, anz, edgelx, edgely, edgelz, edgerx, edgery, edgerz;
    float qtm, x, y, z, dxp, dyp, dzp, amx, amy, amz, dx1, dx, dy, dz;
    float vx, vy, vz;
-   float sfxyz[3*MXV*MYV*MZV];
-/* float sfxyz[3*(mx+1)*(my+1)*(mz+1)]; */
+   float *sfxyz;
    double sum1, sum2;
-/* mxv = MXV; */
-/* myv = MYV; */
    mxv = mx+1;
    myv = my+1;
    mxyv = mxv*myv;
@@ -700,15 +688,16 @@ local data                                                            */
    any = (float) ny;
    anz = (float) nz;
    sum2 = 0.0;
-/* error if local array is too small                */
-/* if ((mx >= MXV) || (my >= MYV) || (mz >= MZV))   */
-/*    return;                                       */
 /* loop over tiles */
-#pragma omp parallel for \
+#pragma omp parallel \
 private(i,j,k,l,noff,moff,loff,npp,npoff,nn,mm,ll,ih,nh,x,y,z,dxp,dyp, \
 dzp,amx,amy,amz,dx1,dx,dy,dz,vx,vy,vz,edgelx,edgely,edgelz,edgerx, \
 edgery,edgerz,sum1,sfxyz) \
 reduction(+:sum2)
+   {
+/* allocate local fields for each thread */
+   sfxyz = (float *) malloc(3*mxyv*(mz+1)*sizeof(float));
+#pragma omp for
    for (l = 0; l < mxyz1; l++) {
       loff = l/mxy1;
       k = l - mxy1*loff;
@@ -890,12 +879,11 @@ reduction(+:sum2)
       }
       ihole[2*(ntmax+1)*l] = ih;
    }
+   free(sfxyz);
+   }
 /* normalize kinetic energy */
    *ek += 0.125f*sum2;
    return;
-#undef MXV
-#undef MYV
-#undef MZV
 }
 
 /*--------------------------------------------------------------------*/
@@ -936,27 +924,22 @@ void cgppost3l(float ppart[], float q[], int kpic[], float qm,
    mxyz1 = mx1*my1*mz1,
    where mz1 = (system length in z direction - 1)/mz + 1
 local data                                                            */
-#define MXV             17
-#define MYV             17
-#define MZV             17
    int mxy1, noff, moff, loff, npoff, npp;
    int i, j, k, l, nn, mm, ll, nm, lm, mxv, myv, mxyv, nxyv;
    float x, y, z, dxp, dyp, dzp, amx, amy, amz, dx1;
-   float sq[MXV*MYV*MZV];
-/* float sq[(mx+1)*(my+1)*(mz+1)]; */
-/* mxv = MXV; */
-/* myv = MYV; */
+   float *sq;
    mxv = mx+1;
    myv = my+1;
    mxyv = mxv*myv;
    nxyv = nxv*nyv;
    mxy1 = mx1*my1;
-/* error if local array is too small                */
-/* if ((mx >= MXV) || (my >= MYV) || (mz >= MZV))   */
-/*    return;                                       */
-#pragma omp parallel for \
+#pragma omp parallel \
 private(i,j,k,l,noff,moff,loff,npp,npoff,nn,mm,ll,nm,lm,x,y,z,dxp,dyp, \
 dzp,amx,amy,amz,dx1,sq)
+   {
+/* allocate local accumulator for each thread */
+   sq = (float *) malloc(mxyv*(mz+1)*sizeof(float));
+#pragma omp for
    for (l = 0; l < mxyz1; l++) {
       loff = l/mxy1;
       k = l - mxy1*loff;
@@ -1086,10 +1069,161 @@ dzp,amx,amy,amz,dx1,sq)
          }
       }
    }
+   free(sq);
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cgppost3lc(float ppart[], float q[], int kpic[], float qm,
+                int nppmx, int idimp, int mx, int my, int mz, int nxv,
+                int nyv, int nzv, int mx1, int my1, int mxyz1) {
+/* for 3d code, this subroutine calculates particle charge density
+   using first-order linear interpolation, periodic boundaries
+   OpenMP version using guard cells, without atomic updates
+   data deposited in tiles
+   particles stored segmented array
+   33 flops/particle, 11 loads, 8 stores
+   input: all, output: q
+   charge density is approximated by values at the nearest grid points
+   q(n,m,l)=qm*(1.-dx)*(1.-dy)*(1.-dz)
+   q(n+1,m,l)=qm*dx*(1.-dy)*(1.-dz)
+   q(n,m+1,l)=qm*(1.-dx)*dy*(1.-dz)
+   q(n+1,m+1,l)=qm*dx*dy*(1.-dz)
+   q(n,m,l+1)=qm*(1.-dx)*(1.-dy)*dz
+   q(n+1,m,l+1)=qm*dx*(1.-dy)*dz
+   q(n,m+1,l+1)=qm*(1.-dx)*dy*dz
+   q(n+1,m+1,l+1)=qm*dx*dy*dz
+   where n,m,l = leftmost grid points and dx = x-n, dy = y-m, dz = z-l
+   tiles are processed in 8 passes, one for each color of a 2x2x2
+   checkerboard, (even,odd) tile in x by (even,odd) tile in y by
+   (even,odd) tile in z.  tiles of the same color share no grid points,
+   so each tile adds all of its local accumulator to q without atomic
+   updates, and the result is the same bit for bit for any number of
+   threads
+   ppart[m][n][0] = position x of particle n in tile m
+   ppart[m][n][1] = position y of particle n in tile m
+   ppart[m][n][2] = position z of particle n in tile m
+   q[l][k][j] = charge density at grid point j,k,l
+   kpic = number of particles per tile
+   qm = charge on particle, in units of e
+   nppmx = maximum number of particles in tile
+   idimp = size of phase space = 6
+   mx/my/mz = number of grids in sorting cell in x/y/z
+   nxv = first dimension of charge array, must be >= nx+1
+   nyv = second dimension of charge array, must be >= ny+1
+   nzv = third dimension of charge array, must be >= nz+1
+   mx1 = (system length in x direction - 1)/mx + 1
+   my1 = (system length in y direction - 1)/my + 1
+   mxyz1 = mx1*my1*mz1,
+   where mz1 = (system length in z direction - 1)/mz + 1
+local data                                                            */
+   int mxy1, mz1, noff, moff, loff, npoff, npp;
+   int i, j, k, l, n, nn, mm, ll, mxv, myv, mxyv, nxyv;
+   int ic, kx, ky, kz, ncx, ncy, ncz;
+   float x, y, z, dxp, dyp, dzp, amx, amy, amz, dx1;
+   float *sq;
+   mxv = mx+1;
+   myv = my+1;
+   mxyv = mxv*myv;
+   nxyv = nxv*nyv;
+   mxy1 = mx1*my1;
+   mz1 = mxyz1/mxy1;
+#pragma omp parallel \
+private(i,j,k,l,n,ic,kx,ky,kz,ncx,ncy,ncz,noff,moff,loff,npp,npoff,nn, \
+mm,ll,x,y,z,dxp,dyp,dzp,amx,amy,amz,dx1,sq)
+   {
+/* allocate local accumulator for each thread */
+   sq = (float *) malloc(mxyv*(mz+1)*sizeof(float));
+/* loop over colors */
+   for (ic = 0; ic < 8; ic++) {
+      kx = ic%2;
+      ky = (ic/2)%2;
+      kz = ic/4;
+      ncx = (mx1 - kx + 1)/2;
+      ncy = (my1 - ky + 1)/2;
+      ncz = (mz1 - kz + 1)/2;
+/* loop over tiles of one color */
+#pragma omp for
+      for (n = 0; n < ncx*ncy*ncz; n++) {
+         l = n/(ncx*ncy);
+         k = n - ncx*ncy*l;
+         j = k/ncx;
+         l = (2*l + kz)*mxy1 + (2*j + ky)*mx1 + 2*(k - ncx*j) + kx;
+         loff = l/mxy1;
+         k = l - mxy1*loff;
+         loff = mz*loff;
+         noff = k/mx1;
+         moff = my*noff;
+         noff = mx*(k - mx1*noff);
+         npp = kpic[l];
+         npoff = nppmx*l;
+/* zero out local accumulator */
+         for (j = 0; j < mxyv*(mz+1); j++) {
+            sq[j] = 0.0f;
+         }
+/* loop over particles in tile */
+         for (j = 0; j < npp; j++) {
+/* find interpolation weights */
+            x = ppart[idimp*(j+npoff)];
+            y = ppart[1+idimp*(j+npoff)];
+            z = ppart[2+idimp*(j+npoff)];
+            nn = x;
+            mm = y;
+            ll = z;
+            dxp = qm*(x - (float) nn);
+            dyp = y - (float) mm;
+            dzp = z - (float) ll;
+            nn = nn - noff + mxv*(mm - moff) + mxyv*(ll - loff);
+            amx = qm - dxp;
+            amy = 1.0f - dyp;
+            dx1 = dxp*dyp;
+            dyp = amx*dyp;
+            amx = amx*amy;
+            amz = 1.0f - dzp;
+            amy = dxp*amy;
+/* deposit charge within tile to local accumulator */
+            x = sq[nn] + amx*amz;
+            y = sq[nn+1] + amy*amz;
+            sq[nn] = x;
+            sq[nn+1] = y;
+            mm = nn + mxv;
+            x = sq[mm] + dyp*amz;
+            y = sq[mm+1] + dx1*amz;
+            sq[mm] = x;
+            sq[mm+1] = y;
+            nn += mxyv;
+            x = sq[nn] + amx*dzp;
+            y = sq[nn+1] + amy*dzp;
+            sq[nn] = x;
+            sq[nn+1] = y;
+            mm = nn + mxv;
+            x = sq[mm] + dyp*dzp;
+            y = sq[mm+1] + dx1*dzp;
+            sq[mm] = x;
+            sq[mm+1] = y;
+         }
+/* deposit charge to interior and edge points in global array */
+         nn = nxv - noff;
+         nn = mx+1 < nn ? mx+1 : nn;
+         mm = nyv - moff;
+         mm = my+1 < mm ? my+1 : mm;
+         ll = nzv - loff;
+         ll = mz+1 < ll ? mz+1 : ll;
+         for (k = 0; k < ll; k++) {
+            for (j = 0; j < mm; j++) {
+               for (i = 0; i < nn; i++) {
+                  q[i+noff+nxv*(j+moff)+nxyv*(k+loff)]
+                  += sq[i+mxv*j+mxyv*k];
+               }
+            }
+         }
+      }
+/* implicit barrier ends each color */
+   }
+   free(sq);
+   }
    return;
-#undef MXV
-#undef MYV
-#undef MZV
 }
 
 /*--------------------------------------------------------------------*/
@@ -3344,6 +3478,16 @@ void cgppost3l_(float *ppart, float *q, int *kpic, float *qm,
    return;
 }
 
+/*--------------------------------------------------------------------*/
+void cgppost3lc_(float *ppart, float *q, int *kpic, float *qm,
+                 int *nppmx, int *idimp, int *mx, int *my, int *mz,
+                 int *nxv, int *nyv, int *nzv, int *mx1, int *my1,
+                 int *mxyz1) {
+   cgppost3lc(ppart,q,kpic,*qm,*nppmx,*idimp,*mx,*my,*mz,*nxv,*nyv,
+              *nzv,*mx1,*my1,*mxyz1);
+   return;
+}
+
 /*--------------------------------------------------------------------*/
 void cpporder3l_(float *ppart, float *ppbuff, int *kpic, int *ncl,
                  int *ihole, int *idimp, int *nppmx, int *nx, int *ny,
@@ -375,8 +375,8 @@ c local data
       real x, y, z, dxp, dyp, dzp, amx, amy, amz, dx1, dx, dy, dz
       real vx, vy, vz
       real sfxyz
-      dimension sfxyz(3,MXV,MYV,MZV)
-c     dimension sfxyz(3,mx+1,my+1,mz+1)
+c     dimension sfxyz(3,MXV,MYV,MZV)
+      dimension sfxyz(3,mx+1,my+1,mz+1)
       double precision sum1, sum2
       mxy1 = mx1*my1
       qtm = qbm*dt
@@ -611,8 +611,8 @@ c local data
       real qtm, x, y, z, dxp, dyp, dzp, amx, amy, amz, dx1, dx, dy, dz
       real vx, vy, vz
       real sfxyz
-      dimension sfxyz(3,MXV,MYV,MZV)
-c     dimension sfxyz(3,mx+1,my+1,mz+1)
+c     dimension sfxyz(3,MXV,MYV,MZV)
+      dimension sfxyz(3,mx+1,my+1,mz+1)
       double precision sum1, sum2
       mxy1 = mx1*my1
       qtm = qbm*dt
@@ -989,6 +989,160 @@ c deposit charge to edge points in global array
 !$OMP END PARALLEL DO
       return
       end
+c-----------------------------------------------------------------------
+      subroutine GPPOST3LC(ppart,q,kpic,qm,nppmx,idimp,mx,my,mz,nxv,nyv,
+     1nzv,mx1,my1,mxyz1)
+c for 3d code, this subroutine calculates particle charge density
+c using first-order linear interpolation, periodic boundaries
+c OpenMP version using guard cells, without atomic updates
+c data deposited in tiles
+c particles stored segmented array
+c 33 flops/particle, 11 loads, 8 stores
+c input: all, output: q
+c charge density is approximated by values at the nearest grid points
+c q(n,m,l)=qm*(1.-dx)*(1.-dy)*(1.-dz)
+c q(n+1,m,l)=qm*dx*(1.-dy)*(1.-dz)
+c q(n,m+1,l)=qm*(1.-dx)*dy*(1.-dz)
+c q(n+1,m+1,l)=qm*dx*dy*(1.-dz)
+c q(n,m,l+1)=qm*(1.-dx)*(1.-dy)*dz
+c q(n+1,m,l+1)=qm*dx*(1.-dy)*dz
+c q(n,m+1,l+1)=qm*(1.-dx)*dy*dz
+c q(n+1,m+1,l+1)=qm*dx*dy*dz
+c where n,m,l = leftmost grid points and dx = x-n, dy = y-m, dz = z-l
+c tiles are processed in 8 passes, one for each color of a 2x2x2
+c checkerboard, (odd,even) tile in x by (odd,even) tile in y by
+c (odd,even) tile in z.  tiles of the same color share no grid points,
+c so each tile adds all of its local accumulator to q without atomic
+c updates, and the result is the same bit for bit for any number of
+c threads
+c ppart(1,n,m) = position x of particle n in tile m
+c ppart(2,n,m) = position y of particle n in tile m
+c ppart(3,n,m) = position z of particle n in tile m
+c q(j,k,l) = charge density at grid point j,k,l
+c kpic = number of particles per tile
+c qm = charge on particle, in units of e
+c nppmx = maximum number of particles in tile
+c idimp = size of phase space = 6
+c mx/my/mz = number of grids in sorting cell in x/y/z
+c nxv = first dimension of charge array, must be >= nx+1
+c nyv = second dimension of charge array, must be >= ny+1
+c nzv = third dimension of charge array, must be >= nz+1
+c mx1 = (system length in x direction - 1)/mx + 1
+c my1 = (system length in y direction - 1)/my + 1
+c mxyz1 = mx1*my1*mz1,
+c where mz1 = (system length in z direction - 1)/mz + 1
+      implicit none
+      integer nppmx, idimp, mx, my, mz, nxv, nyv, nzv, mx1, my1, mxyz1
+      real qm
+      real ppart, q
+      integer kpic
+      dimension ppart(idimp,nppmx,mxyz1), q(nxv,nyv,nzv)
+      dimension kpic(mxyz1)
+c local data
+      integer MXV, MYV, MZV
+      parameter(MXV=17,MYV=17,MZV=17)
+      integer mxy1, mz1, noff, moff, loff, npp
+      integer i, j, k, l, n, nn, mm, ll
+      integer ic, kx, ky, kz, ncx, ncy, ncz
+      real x, y, z, dxp, dyp, dzp, amx, amy, amz, dx1
+      real sq
+c     dimension sq(MXV,MYV,MZV)
+      dimension sq(mx+1,my+1,mz+1)
+      mxy1 = mx1*my1
+      mz1 = mxyz1/mxy1
+c error if local array is too small
+c     if ((mx.ge.MXV).or.(my.ge.MYV).or.(mz.ge.MZV)) return
+!$OMP PARALLEL
+!$OMP& PRIVATE(i,j,k,l,n,ic,kx,ky,kz,ncx,ncy,ncz,noff,moff,loff,npp,nn,
+!$OMP& mm,ll,x,y,z,dxp,dyp,dzp,amx,amy,amz,dx1,sq)
+c loop over colors
+      do 90 ic = 1, 8
+      kx = mod(ic-1,2)
+      ky = mod((ic-1)/2,2)
+      kz = (ic - 1)/4
+      ncx = (mx1 - kx + 1)/2
+      ncy = (my1 - ky + 1)/2
+      ncz = (mz1 - kz + 1)/2
+c loop over tiles of one color
+!$OMP DO
+      do 80 n = 1, ncx*ncy*ncz
+      l = (n - 1)/(ncx*ncy)
+      k = n - ncx*ncy*l - 1
+      j = k/ncx
+      l = (2*l + kz)*mxy1 + (2*j + ky)*mx1 + 2*(k - ncx*j) + kx + 1
+      loff = (l - 1)/mxy1
+      k = l - mxy1*loff
+      loff = mz*loff
+      noff = (k - 1)/mx1
+      moff = my*noff
+      noff = mx*(k - mx1*noff - 1)
+      npp = kpic(l)
+c zero out local accumulator
+      do 30 k = 1, mz+1
+      do 20 j = 1, my+1
+      do 10 i = 1, mx+1
+      sq(i,j,k) = 0.0
+   10 continue
+   20 continue
+   30 continue
+c loop over particles in tile
+      do 40 j = 1, npp
+c find interpolation weights
+      x = ppart(1,j,l)
+      y = ppart(2,j,l)
+      z = ppart(3,j,l)
+      nn = x
+      mm = y
+      ll = z
+      dxp = qm*(x - real(nn))
+      dyp = y - real(mm)
+      dzp = z - real(ll)
+      nn = nn - noff + 1
+      mm = mm - moff + 1
+      ll = ll - loff + 1
+      amx = qm - dxp
+      amy = 1.0 - dyp
+      dx1 = dxp*dyp
+      dyp = amx*dyp
+      amx = amx*amy
+      amz = 1.0 - dzp
+      amy = dxp*amy
+c deposit charge within tile to local accumulator
+      x = sq(nn,mm,ll) + amx*amz
+      y = sq(nn+1,mm,ll) + amy*amz
+      sq(nn,mm,ll) = x
+      sq(nn+1,mm,ll) = y
+      x = sq(nn,mm+1,ll) + dyp*amz
+      y = sq(nn+1,mm+1,ll) + dx1*amz
+      sq(nn,mm+1,ll) = x
+      sq(nn+1,mm+1,ll) = y
+      x = sq(nn,mm,ll+1) + amx*dzp
+      y = sq(nn+1,mm,ll+1) + amy*dzp
+      sq(nn,mm,ll+1) = x
+      sq(nn+1,mm,ll+1) = y
+      x = sq(nn,mm+1,ll+1) + dyp*dzp
+      y = sq(nn+1,mm+1,ll+1) + dx1*dzp
+      sq(nn,mm+1,ll+1) = x
+      sq(nn+1,mm+1,ll+1) = y
+   40 continue
+c deposit charge to interior and edge points in global array
+      nn = min(mx+1,nxv-noff)
+      mm = min(my+1,nyv-moff)
+      ll = min(mz+1,nzv-loff)
+      do 70 k = 1, ll
+      do 60 j = 1, mm
+      do 50 i = 1, nn
+      q(i+noff,j+moff,k+loff) = q(i+noff,j+moff,k+loff) + sq(i,j,k)
+   50 continue
+   60 continue
+   70 continue
+   80 continue
+!$OMP END DO
+c implicit barrier ends each color
+   90 continue
+!$OMP END PARALLEL
+      return
+      end
 c-----------------------------------------------------------------------
       subroutine PPORDER3L(ppart,ppbuff,kpic,ncl,ihole,idimp,nppmx,nx,ny
      1,nz,mx,my,mz,mx1,my1,mz1,npbmx,ntmax,irc)
@@ -33,6 +33,10 @@ void cgppost3l(float ppart[], float q[], int kpic[], float qm,
                int nppmx, int idimp, int mx, int my, int mz, int nxv,
                int nyv, int nzv, int mx1, int my1, int mxyz1);
 
+void cgppost3lc(float ppart[], float q[], int kpic[], float qm,
+                int nppmx, int idimp, int mx, int my, int mz, int nxv,
+                int nyv, int nzv, int mx1, int my1, int mxyz1);
+
 void cpporder3l(float ppart[], float ppbuff[], int kpic[], int ncl[],
                 int ihole[], int idimp, int nppmx, int nx, int ny,
                 int nz, int mx, int my, int mz, int mx1, int my1,
@@ -40,6 +40,11 @@ void gppost3l_(float *ppart, float *q, int *kpic, float *qm, int *nppmx,
                int *idimp, int *mx, int *my, int *mz, int *nxv,
                int *nyv, int *nzv, int *mx1, int *my1, int *mxyz1);
 
+void gppost3lc_(float *ppart, float *q, int *kpic, float *qm,
+                int *nppmx, int *idimp, int *mx, int *my, int *mz,
+                int *nxv, int *nyv, int *nzv, int *mx1, int *my1,
+                int *mxyz1);
+
 void pporder3l_(float *ppart, float *ppbuff, int *kpic, int *ncl,
                 int *ihole, int *idimp, int *nppmx, int *nx, int *ny,
                 int *nz, int *mx, int *my, int *mz, int *mx1, int *my1,
@@ -167,6 +172,15 @@ void cgppost3l(float ppart[], float q[], int kpic[], float qm,
    return;
 }
 
+/*--------------------------------------------------------------------*/
+void cgppost3lc(float ppart[], float q[], int kpic[], float qm,
+                int nppmx, int idimp, int mx, int my, int mz, int nxv,
+                int nyv, int nzv, int mx1, int my1, int mxyz1) {
+   gppost3lc_(ppart,q,kpic,&qm,&nppmx,&idimp,&mx,&my,&mz,&nxv,&nyv,
+              &nzv,&mx1,&my1,&mxyz1);
+   return;
+}
+
 /*--------------------------------------------------------------------*/
 void cpporder3l(float ppart[], float ppbuff[], int kpic[], int ncl[],
                 int ihole[], int idimp, int nppmx, int nx, int ny,
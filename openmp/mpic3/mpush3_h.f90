@@ -93,6 +93,19 @@
          integer, dimension(mxyz1), intent(in) :: kpic
          end subroutine
       end interface
+!
+      interface
+         subroutine GPPOST3LC(ppart,q,kpic,qm,nppmx,idimp,mx,my,mz,nxv, &
+     &nyv,nzv,mx1,my1,mxyz1)
+         implicit none
+         integer, intent(in) :: nppmx, idimp, mx, my, mz, nxv, nyv, nzv
+         integer, intent(in) :: mx1, my1, mxyz1
+         real, intent(in) :: qm
+         real, dimension(idimp,nppmx,mxyz1), intent(in) :: ppart
+         real, dimension(nxv,nyv,nzv), intent(inout) :: q
+         integer, dimension(mxyz1), intent(in) :: kpic
+         end subroutine
+      end interface
 !
       interface
          subroutine PPORDER3L(ppart,ppbuff,kpic,ncl,ihole,idimp,nppmx,nx&
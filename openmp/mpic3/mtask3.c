@@ -0,0 +1,542 @@
+/* OpenMP task graph library for 3D OpenMP PIC codes */
+/* written for the skeleton PIC codes */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <complex.h>
+#include <omp.h>
+#include "mpush3.h"
+#include "mtask3.h"
+
+/* NTASK = number of kinds of tasks for each plane of tiles */
+#define NTASK                 4
+
+static FILE *tunit = NULL;
+
+/*--------------------------------------------------------------------*/
+static void cppbuff3t(float ppart[], float ppbuff[], int ncl[],
+                      int ihole[], int idimp, int nppmx, int mxy1,
+                      int npbmx, int ntmax, int kz, int *irc) {
+/* this subroutine performs the first step of cpporderf3l for the tiles
+   in plane kz: a prefix scan of ncl is performed and departing
+   particles are buffered in ppbuff in direction order
+local data                                                            */
+   int i, j, l, ii, ist, isum, nh, ip, j1;
+   for (l = mxy1*kz; l < mxy1*(kz+1); l++) {
+/* find address offset for ordered ppbuff array */
+      isum = 0;
+      for (j = 0; j < 26; j++) {
+         ist = ncl[j+26*l];
+         ncl[j+26*l] = isum;
+         isum += ist;
+      }
+      nh = ihole[2*(ntmax+1)*l];
+      ip = 0;
+/* loop over particles leaving tile */
+      for (j = 0; j < nh; j++) {
+/* buffer particles that are leaving tile, in direction order */
+         j1 = ihole[2*(j+1+(ntmax+1)*l)] - 1;
+         ist = ihole[1+2*(j+1+(ntmax+1)*l)];
+         ii = ncl[ist+26*l-1];
+         if (ii < npbmx) {
+            for (i = 0; i < idimp; i++) {
+               ppbuff[i+idimp*(ii+npbmx*l)]
+               = ppart[i+idimp*(j1+nppmx*l)];
+            }
+         }
+         else {
+            ip = 1;
+         }
+         ncl[ist+26*l-1] = ii + 1;
+      }
+/* set error */
+      if (ip > 0)
+         *irc = ncl[25+26*l];
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+static void cppfill3t(float ppart[], float ppbuff[], int kpic[],
+                      int ncl[], int ihole[], int idimp, int nppmx,
+                      int mx1, int my1, int mz1, int npbmx, int ntmax,
+                      int kz, int *irc) {
+/* this subroutine performs the second step of cpporderf3l for the
+   tiles in plane kz: incoming particles are copied from the buffers of
+   the neighboring tiles into ppart.  the first step must have been
+   done for planes kz-1, kz and kz+1
+local data                                                            */
+   int mxy1, npp, ncoff;
+   int i, j, k, l, ii, kx, ky, ih, nh, ist, ll;
+   int ip, j1, j2, kxl, kxr, kk, kl, kr, lk, lr;
+   int ks[26];
+   mxy1 = mx1*my1;
+   for (l = mxy1*kz; l < mxy1*(kz+1); l++) {
+      npp = kpic[l];
+      k = l - mxy1*kz;
+/* loop over tiles in z, assume periodic boundary conditions */
+      lk = kz*mxy1;
+/* find tile behind */
+      ll = kz - 1;
+      if (ll < 0)
+         ll += mz1;
+      ll = ll*mxy1;
+/* find tile in front */
+      lr = kz + 1;
+      if (lr >= mz1)
+         lr -= mz1;
+      lr = lr*mxy1;
+      ky = k/mx1;
+/* loop over tiles in y, assume periodic boundary conditions */
+      kk = ky*mx1;
+/* find tile above */
+      kl = ky - 1;
+      if (kl < 0)
+         kl += my1;
+      kl = kl*mx1;
+/* find tile below */
+      kr = ky + 1;
+      if (kr >= my1)
+         kr -= my1;
+      kr = kr*mx1;
+/* loop over tiles in x, assume periodic boundary conditions */
+      kx = k - ky*mx1;
+      kxl = kx - 1;
+      if (kxl < 0)
+         kxl += mx1;
+      kxr = kx + 1;
+      if (kxr >= mx1)
+         kxr -= mx1;
+/* find tile number for different directions */
+      ks[0] = kxr + kk + lk;
+      ks[1] = kxl + kk + lk;
+      ks[2] = kx + kr + lk;
+      ks[3] = kxr + kr + lk;
+      ks[4] = kxl + kr + lk;
+      ks[5] = kx + kl + lk;
+      ks[6] = kxr + kl + lk;
+      ks[7] = kxl + kl + lk;
+      ks[8] = kx + kk + lr;
+      ks[9] = kxr + kk + lr;
+      ks[10] = kxl + kk + lr;
+      ks[11] = kx + kr + lr;
+      ks[12] = kxr + kr + lr;
+      ks[13] = kxl + kr + lr;
+      ks[14] = kx + kl + lr;
+      ks[15] = kxr + kl + lr;
+      ks[16] = kxl + kl + lr;
+      ks[17] = kx + kk + ll;
+      ks[18] = kxr + kk + ll;
+      ks[19] = kxl + kk + ll;
+      ks[20] = kx + kr + ll;
+      ks[21] = kxr + kr + ll;
+      ks[22] = kxl + kr + ll;
+      ks[23] = kx + kl + ll;
+      ks[24] = kxr + kl + ll;
+      ks[25] = kxl + kl + ll;
+/* loop over directions */
+      nh = ihole[2*(ntmax+1)*l];
+      ncoff = 0;
+      ih = 0;
+      ist = 0;
+      j1 = 0;
+      for (ii = 0; ii < 26; ii++) {
+         if (ii > 0)
+            ncoff = ncl[ii-1+26*ks[ii]];
+/* ip = number of particles coming from direction ii */
+         ip = ncl[ii+26*ks[ii]] - ncoff;
+         for (j = 0; j < ip; j++) {
+            ih += 1;
+/* insert incoming particles into holes */
+            if (ih <= nh) {
+               j1 = ihole[2*(ih+(ntmax+1)*l)] - 1;
+            }
+/* place overflow at end of array */
+            else {
+               j1 = npp;
+               npp += 1;
+            }
+            if (j1 < nppmx) {
+               for (i = 0; i < idimp; i++) {
+                  ppart[i+idimp*(j1+nppmx*l)]
+                  = ppbuff[i+idimp*(j+ncoff+npbmx*ks[ii])];
+               }
+            }
+            else {
+               ist = 1;
+            }
+         }
+      }
+/* set error */
+      if (ist > 0)
+         *irc = j1+1;
+/* fill up remaining holes in particle array with particles from bottom */
+      if (ih < nh) {
+         ip = nh - ih;
+         for (j = 0; j < ip; j++) {
+            j1 = npp - j - 1;
+            j2 = ihole[2*(nh-j+(ntmax+1)*l)] - 1;
+            if (j1 > j2) {
+/* move particle only if it is below current hole */
+               for (i = 0; i < idimp; i++) {
+                  ppart[i+idimp*(j2+nppmx*l)]
+                  = ppart[i+idimp*(j1+nppmx*l)];
+               }
+            }
+         }
+         npp -= ip;
+      }
+      kpic[l] = npp;
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+static void cgpost3t(float ppart[], float q[], int kpic[], float qm,
+                     int nppmx, int idimp, int mx, int my, int mz,
+                     int nxv, int nyv, int nzv, int mx1, int my1,
+                     int kz) {
+/* this subroutine deposits the charge for the tiles in plane kz, as in
+   cgppost3l.  grid points shared with other tiles are added with
+   atomic updates
+local data                                                            */
+   int mxy1, noff, moff, loff, npoff, npp;
+   int i, j, k, l, nn, mm, ll, nm, lm, mxv, myv, mxyv, nxyv;
+   float x, y, z, dxp, dyp, dzp, amx, amy, amz, dx1;
+   float *sq;
+   mxv = mx+1;
+   myv = my+1;
+   mxyv = mxv*myv;
+   nxyv = nxv*nyv;
+   mxy1 = mx1*my1;
+   sq = (float *) malloc(mxyv*(mz+1)*sizeof(float));
+   for (l = mxy1*kz; l < mxy1*(kz+1); l++) {
+      loff = l/mxy1;
+      k = l - mxy1*loff;
+      loff = mz*loff;
+      noff = k/mx1;
+      moff = my*noff;
+      noff = mx*(k - mx1*noff);
+      npp = kpic[l];
+      npoff = nppmx*l;
+/* zero out local accumulator */
+      for (j = 0; j < mxyv*(mz+1); j++) {
+         sq[j] = 0.0f;
+      }
+/* loop over particles in tile */
+      for (j = 0; j < npp; j++) {
+/* find interpolation weights */
+         x = ppart[idimp*(j+npoff)];
+         y = ppart[1+idimp*(j+npoff)];
+         z = ppart[2+idimp*(j+npoff)];
+         nn = x;
+         mm = y;
+         ll = z;
+         dxp = qm*(x - (float) nn);
+         dyp = y - (float) mm;
+         dzp = z - (float) ll;
+         nn = nn - noff + mxv*(mm - moff) + mxyv*(ll - loff);
+         amx = qm - dxp;
+         amy = 1.0f - dyp;
+         dx1 = dxp*dyp;
+         dyp = amx*dyp;
+         amx = amx*amy;
+         amz = 1.0f - dzp;
+         amy = dxp*amy;
+/* deposit charge within tile to local accumulator */
+         x = sq[nn] + amx*amz;
+         y = sq[nn+1] + amy*amz;
+         sq[nn] = x;
+         sq[nn+1] = y;
+         mm = nn + mxv;
+         x = sq[mm] + dyp*amz;
+         y = sq[mm+1] + dx1*amz;
+         sq[mm] = x;
+         sq[mm+1] = y;
+         nn += mxyv;
+         x = sq[nn] + amx*dzp;
+         y = sq[nn+1] + amy*dzp;
+         sq[nn] = x;
+         sq[nn+1] = y;
+         mm = nn + mxv;
+         x = sq[mm] + dyp*dzp;
+         y = sq[mm+1] + dx1*dzp;
+         sq[mm] = x;
+         sq[mm+1] = y;
+      }
+/* deposit charge to interior points in global array */
+      nn = nxv - noff;
+      nn = mx < nn ? mx : nn;
+      mm = nyv - moff;
+      mm = my < mm ? my : mm;
+      ll = nzv - loff;
+      ll = mz < ll ? mz : ll;
+      for (k = 1; k < ll; k++) {
+         for (j = 1; j < mm; j++) {
+            for (i = 1; i < nn; i++) {
+               q[i+noff+nxv*(j+moff)+nxyv*(k+loff)]
+               += sq[i+mxv*j+mxyv*k];
+            }
+         }
+      }
+/* deposit charge to edge points in global array */
+      lm = nzv - loff;
+      lm = mz+1 < lm ? mz+1 : lm;
+      for (j = 1; j < mm; j++) {
+         for (i = 1; i < nn; i++) {
+#pragma omp atomic
+            q[i+noff+nxv*(j+moff)+nxyv*loff] += sq[i+mxv*j];
+            if (lm > mz) {
+#pragma omp atomic
+               q[i+noff+nxv*(j+moff)+nxyv*(lm+loff-1)]
+               += sq[i+mxv*j+mxyv*(lm-1)];
+            }
+         }
+      }
+      nm = nxv - noff;
+      nm = mx+1 < nm ? mx+1 : nm;
+      mm = nyv - moff;
+      mm = my+1 < mm ? my+1 : mm;
+      for (k = 0; k < ll; k++) {
+         for (i = 1; i < nn; i++) {
+#pragma omp atomic
+            q[i+noff+nxv*moff+nxyv*(k+loff)] += sq[i+mxyv*k];
+            if (mm > my) {
+#pragma omp atomic
+               q[i+noff+nxv*(mm+moff-1)+nxyv*(k+loff)]
+               += sq[i+mxv*(mm-1)+mxyv*k];
+            }
+         }
+         for (j = 0; j < mm; j++) {
+#pragma omp atomic
+            q[noff+nxv*(j+moff)+nxyv*(k+loff)] += sq[mxv*j+mxyv*k];
+            if (nm > mx) {
+#pragma omp atomic
+               q[nm+noff-1+nxv*(j+moff)+nxyv*(k+loff)]
+               += sq[nm-1+mxv*j+mxyv*k];
+            }
+         }
+      }
+      if (lm > mz) {
+         for (i = 1; i < nn; i++) {
+#pragma omp atomic
+            q[i+noff+nxv*moff+nxyv*(lm+loff-1)] += sq[i+mxyv*(lm-1)];
+            if (mm > my) {
+#pragma omp atomic
+               q[i+noff+nxv*(mm+moff-1)+nxyv*(lm+loff-1)]
+               += sq[i+mxv*(mm-1)+mxyv*(lm-1)];
+            }
+         }
+         for (j = 0; j < mm; j++) {
+#pragma omp atomic
+            q[noff+nxv*(j+moff)+nxyv*(lm+loff-1)]
+            += sq[mxv*j+mxyv*(lm-1)];
+            if (nm > mx) {
+#pragma omp atomic
+               q[nm+noff-1+nxv*(j+moff)+nxyv*(lm+loff-1)]
+               += sq[nm-1+mxv*j+mxyv*(lm-1)];
+            }
+         }
+      }
+   }
+   free(sq);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+static void caguard3t(float q[], int nx, int ny, int nz, int nxe,
+                      int nye, int kzi, int kzp) {
+/* this subroutine accumulates the guard cells of caguard3l into the
+   kzp grid planes starting at kzi.  plane 0 also receives plane nz
+local data                                                            */
+   int j, k, l, nxye, ll;
+   nxye = nxe*nye;
+   for (l = kzi; l < kzi+kzp; l++) {
+      ll = nxye*l;
+      for (k = 0; k < ny; k++) {
+         q[nxe*k+ll] += q[nx+nxe*k+ll];
+         q[nx+nxe*k+ll] = 0.0;
+      }
+      for (j = 0; j < nx; j++) {
+         q[j+ll] += q[j+nxe*ny+ll];
+         q[j+nxe*ny+ll] = 0.0;
+      }
+      q[ll] += q[nx+nxe*ny+ll];
+      q[nx+nxe*ny+ll] = 0.0;
+   }
+   if (kzi==0) {
+      for (k = 0; k < ny; k++) {
+         for (j = 0; j < nx; j++) {
+            q[j+nxe*k] += q[j+nxe*k+nxye*nz];
+            q[j+nxe*k+nxye*nz] = 0.0;
+         }
+         q[nxe*k] += q[nx+nxe*k+nxye*nz];
+         q[nx+nxe*k+nxye*nz] = 0.0;
+      }
+      for (j = 0; j < nx; j++) {
+         q[j] += q[j+nxe*ny+nxye*nz];
+         q[j+nxe*ny+nxye*nz] = 0.0;
+      }
+      q[0] += q[nx+nxe*ny+nxye*nz];
+      q[nx+nxe*ny+nxye*nz] = 0.0;
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cppordpost3t(float ppart[], float ppbuff[], int kpic[], int ncl[],
+                  int ihole[], float q[], float qm, int mixup[],
+                  float complex sct[], double trace[], int idimp,
+                  int nppmx, int nx, int ny, int nz, int mx, int my,
+                  int mz, int nxe, int nye, int nze, int mx1, int my1,
+                  int mz1, int npbmx, int ntmax, int indx, int indy,
+                  int indz, int nxhyz, int nxyzh, int *irc) {
+/* this subroutine reorders the particles by tile as in cpporderf3l,
+   then deposits their charge, adds the guard cells, and performs the
+   x-y part of the inverse fft of the charge, using a graph of OpenMP
+   tasks for each plane of tiles in z, so that the reorder of some
+   planes overlaps with the deposit and fft of others.  the tasks for
+   tile plane kz are:
+   buffer(kz): buffer departing particles, as in the first step of
+   cpporderf3l
+   fill(kz): copy incoming particles, after buffer(kz-1:kz+1)
+   deposit(kz): deposit charge, after fill(kz)
+   fft(kz): add guard cells and x-y fft of the grid planes of the tile
+   plane, after deposit(kz-1:kz), since deposit(kz-1) adds to the first
+   plane.
+   the z part of the fft, cfft3rmxz, is left to the caller.
+   the x-y fft of each plane is performed by cfft3rmxy, whose parallel
+   region runs on the thread of the task.
+   input: all except ppbuff, q, trace, irc
+   output: ppart, ppbuff, kpic, ncl, q, trace, irc
+   q = charge density, in real space with guard cells on input, x-y
+   transformed on output, as after the x-y part of cwfft3rmx
+   qm = charge on particle, in units of e
+   mixup/sct = bit reverse and sine/cosine tables for fft
+   trace[kz][i][0] = thread which performed task i of tile plane kz
+   trace[kz][i][1:2] = start/end time of task, in seconds, relative to
+   the start of the subroutine, for i = buffer, fill, deposit, fft
+   nxe/nye/nze = dimensions of charge array, must be >= nx+2/ny+1/nz+1
+   indx/indy/indz = exponent which determines grid points in x/y/z
+   direction
+   nxhyz/nxyzh = dimensions of fft tables
+   see cpporderf3l and cgppost3l for other arguments
+local data                                                            */
+   int j, kz, kzl, kzr, kzi, kzp, mxy1, nxeh;
+   double tbeg;
+   char *dbuf, *dfill, *ddep;
+   mxy1 = mx1*my1;
+   nxeh = nxe/2;
+   dbuf = (char *) malloc(3*mz1*sizeof(char));
+   dfill = &dbuf[mz1];
+   ddep = &dbuf[2*mz1];
+   tbeg = omp_get_wtime();
+#pragma omp parallel private(j,kz,kzl,kzr,kzi,kzp)
+   {
+/* zero charge density */
+#pragma omp for
+   for (j = 0; j < nxe*nye*nze; j++) {
+      q[j] = 0.0f;
+   }
+/* one thread creates the tasks, all threads execute them */
+/* a task waits only for tasks created before it, so tasks are created */
+/* in the order buffer, fill, deposit, fft                             */
+#pragma omp single
+   {
+   for (kz = 0; kz < mz1; kz++) {
+#pragma omp task depend(out:dbuf[kz])
+      {
+      trace[3*(NTASK*kz)] = omp_get_thread_num();
+      trace[1+3*(NTASK*kz)] = omp_get_wtime() - tbeg;
+      cppbuff3t(ppart,ppbuff,ncl,ihole,idimp,nppmx,mxy1,npbmx,ntmax,kz,
+                irc);
+      trace[2+3*(NTASK*kz)] = omp_get_wtime() - tbeg;
+      }
+   }
+   for (kz = 0; kz < mz1; kz++) {
+      kzl = kz > 0 ? kz - 1 : mz1 - 1;
+      kzr = kz < mz1-1 ? kz + 1 : 0;
+#pragma omp task depend(in:dbuf[kzl],dbuf[kz],dbuf[kzr]) \
+depend(out:dfill[kz])
+      {
+      trace[3*(1+NTASK*kz)] = omp_get_thread_num();
+      trace[1+3*(1+NTASK*kz)] = omp_get_wtime() - tbeg;
+      if (*irc==0)
+         cppfill3t(ppart,ppbuff,kpic,ncl,ihole,idimp,nppmx,mx1,my1,mz1,
+                   npbmx,ntmax,kz,irc);
+      trace[2+3*(1+NTASK*kz)] = omp_get_wtime() - tbeg;
+      }
+   }
+   for (kz = 0; kz < mz1; kz++) {
+#pragma omp task depend(in:dfill[kz]) depend(out:ddep[kz])
+      {
+      trace[3*(2+NTASK*kz)] = omp_get_thread_num();
+      trace[1+3*(2+NTASK*kz)] = omp_get_wtime() - tbeg;
+      if (*irc==0)
+         cgpost3t(ppart,q,kpic,qm,nppmx,idimp,mx,my,mz,nxe,nye,nze,mx1,
+                  my1,kz);
+      trace[2+3*(2+NTASK*kz)] = omp_get_wtime() - tbeg;
+      }
+   }
+   for (kz = 0; kz < mz1; kz++) {
+      kzl = kz > 0 ? kz - 1 : mz1 - 1;
+      kzi = mz*kz;
+      kzp = nz - kzi;
+      kzp = mz < kzp ? mz : kzp;
+#pragma omp task depend(in:ddep[kzl],ddep[kz])
+      {
+      trace[3*(3+NTASK*kz)] = omp_get_thread_num();
+      trace[1+3*(3+NTASK*kz)] = omp_get_wtime() - tbeg;
+      caguard3t(q,nx,ny,nz,nxe,nye,kzi,kzp);
+      cfft3rmxy((float complex *)q,-1,mixup,sct,indx,indy,indz,kzi+1,
+                kzp,nxeh,nye,nze,nxhyz,nxyzh);
+      trace[2+3*(3+NTASK*kz)] = omp_get_wtime() - tbeg;
+      }
+   }
+   }
+   }
+   free(dbuf);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+int ctraceopen(char *name) {
+/* this function opens the task trace file name and writes its header
+   returns 1 if the file cannot be opened
+local data                                                            */
+   tunit = fopen(name,"w");
+   if (tunit==NULL)
+      return 1;
+   fprintf(tunit,"step,task,plane,thread,start,end\n");
+   return 0;
+}
+
+/*--------------------------------------------------------------------*/
+void ctracewrite(double trace[], int ntime, int mz1) {
+/* this subroutine writes the task timelines of cppordpost3t for time
+   step ntime to the task trace file, one line for each task, with
+   times in microseconds
+local data                                                            */
+   int i, kz;
+   static char *tname[NTASK] = {"buffer","fill","deposit","fft"};
+   if (tunit==NULL)
+      return;
+   for (kz = 0; kz < mz1; kz++) {
+      for (i = 0; i < NTASK; i++) {
+         fprintf(tunit,"%d,%s,%d,%d,%.3f,%.3f\n",ntime,tname[i],kz,
+                 (int) trace[3*(i+NTASK*kz)],
+                 1.0e6*trace[1+3*(i+NTASK*kz)],
+                 1.0e6*trace[2+3*(i+NTASK*kz)]);
+      }
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void ctraceclose() {
+/* this subroutine closes the task trace file */
+   if (tunit != NULL)
+      fclose(tunit);
+   tunit = NULL;
+   return;
+}
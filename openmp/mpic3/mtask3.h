@@ -0,0 +1,15 @@
+/* header file for mtask3.c */
+
+void cppordpost3t(float ppart[], float ppbuff[], int kpic[], int ncl[],
+                  int ihole[], float q[], float qm, int mixup[],
+                  float complex sct[], double trace[], int idimp,
+                  int nppmx, int nx, int ny, int nz, int mx, int my,
+                  int mz, int nxe, int nye, int nze, int mx1, int my1,
+                  int mz1, int npbmx, int ntmax, int indx, int indy,
+                  int indz, int nxhyz, int nxyzh, int *irc);
+
+int ctraceopen(char *name);
+
+void ctracewrite(double trace[], int ntime, int mz1);
+
+void ctraceclose();
@@ -0,0 +1,189 @@
+/* tile size autotuner for 3D OpenMP PIC codes */
+/* written for the skeleton PIC codes */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <complex.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include "mpush3.h"
+#include "mtune3.h"
+
+/* NTILE = number of candidate tile sizes */
+#define NTILE                 7
+
+/*--------------------------------------------------------------------*/
+static double ctunetime() {
+/* this function returns the wall clock time in seconds
+local data                                                            */
+   struct timeval tv;
+   gettimeofday(&tv,NULL);
+   return (double) tv.tv_sec + 1.0e-6*(double) tv.tv_usec;
+}
+
+/*--------------------------------------------------------------------*/
+int ccachesize() {
+/* this function returns the size of the level 2 data cache in bytes,
+   or 262144 if it cannot be determined
+local data                                                            */
+   long n = 0;
+#ifdef _SC_LEVEL2_CACHE_SIZE
+   n = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+   if (n <= 0)
+      n = 262144;
+   return (int) n;
+}
+
+/*--------------------------------------------------------------------*/
+double cmtime3(float part[], float qm, float qbm, float dt, int idimp,
+               int np, int nx, int ny, int nz, int mx, int my, int mz,
+               int nxe, int nye, int nze, float xtras, int kdepo,
+               int ntry) {
+/* this function returns the time per particle per step for deposit,
+   push and reorder with tiles of size mx, my, mz.
+   the particles in part are copied into tiled arrays, and ntry steps
+   are timed after one step to warm up the caches.  the force is zero,
+   so particles move with their initial velocity.  part is not changed
+   returns a negative value if the particle buffers overflow
+   part[n][i] = position i of particle n
+   qm = charge on particle, in units of e
+   qbm = particle charge/mass
+   dt = time interval between successive calculations
+   idimp = size of phase space = 6
+   np = number of particles
+   nx/ny/nz = system length in x/y/z direction
+   mx/my/mz = number of grids in sorting cell in x/y/z
+   nxe/nye/nze = dimensions of field arrays, must be >= nx+1/ny+1/nz+1
+   xtras = fraction of extra particles needed for particle management
+   kdepo = (0,1) = deposit tile edges with (atomic updates,colored tile
+   schedule)
+   ntry = number of steps timed
+local data                                                            */
+   int mx1, my1, mz1, mxyz1, nppmx, nppmx0, ntmax, npbmx, irc, j, n;
+   int *kpic, *ncl, *ihole;
+   float wke;
+   float *q, *fxyz, *ppart, *ppbuff;
+   double time;
+   mx1 = (nx - 1)/mx + 1;
+   my1 = (ny - 1)/my + 1;
+   mz1 = (nz - 1)/mz + 1;
+   mxyz1 = mx1*my1*mz1;
+   irc = 0;
+   kpic = (int *) malloc(mxyz1*sizeof(int));
+   cdblkp3l(part,kpic,&nppmx,idimp,np,mx,my,mz,mx1,my1,mxyz1,&irc);
+   nppmx0 = (1.0 + xtras)*nppmx;
+   ntmax = xtras*nppmx;
+   npbmx = xtras*nppmx;
+   q = (float *) malloc(nxe*nye*nze*sizeof(float));
+   fxyz = (float *) malloc(3*nxe*nye*nze*sizeof(float));
+   ppart = (float *) malloc(idimp*nppmx0*mxyz1*sizeof(float));
+   ppbuff = (float *) malloc(idimp*npbmx*mxyz1*sizeof(float));
+   ncl = (int *) malloc(26*mxyz1*sizeof(int));
+   ihole = (int *) malloc(2*(ntmax+1)*mxyz1*sizeof(int));
+   for (j = 0; j < 3*nxe*nye*nze; j++) {
+      fxyz[j] = 0.0f;
+   }
+   if (irc==0)
+      cppmovin3l(part,ppart,kpic,nppmx0,idimp,np,mx,my,mz,mx1,my1,mxyz1,
+                 &irc);
+   time = 0.0;
+/* first step is not timed */
+   for (n = 0; n <= ntry; n++) {
+      if (irc != 0)
+         break;
+      if (n==1)
+         time = ctunetime();
+      for (j = 0; j < nxe*nye*nze; j++) {
+         q[j] = 0.0f;
+      }
+      if (kdepo==1)
+         cgppost3lc(ppart,q,kpic,qm,nppmx0,idimp,mx,my,mz,nxe,nye,nze,
+                    mx1,my1,mxyz1);
+      else
+         cgppost3l(ppart,q,kpic,qm,nppmx0,idimp,mx,my,mz,nxe,nye,nze,
+                   mx1,my1,mxyz1);
+      wke = 0.0f;
+      cgppushf3l(ppart,fxyz,kpic,ncl,ihole,qbm,dt,&wke,idimp,nppmx0,nx,
+                 ny,nz,mx,my,mz,nxe,nye,nze,mx1,my1,mxyz1,ntmax,&irc);
+      if (irc==0)
+         cpporderf3l(ppart,ppbuff,kpic,ncl,ihole,idimp,nppmx0,mx1,my1,
+                     mz1,npbmx,ntmax,&irc);
+   }
+   time = ctunetime() - time;
+   free(ihole);
+   free(ncl);
+   free(ppbuff);
+   free(ppart);
+   free(fxyz);
+   free(q);
+   free(kpic);
+   if (irc != 0)
+      return -1.0;
+   return time/((double) np*(double) ntry);
+}
+
+/*--------------------------------------------------------------------*/
+void cmtune3(float part[], float qm, float qbm, float dt, int idimp,
+             int np, int nx, int ny, int nz, int nxe, int nye, int nze,
+             float xtras, int kdepo, int ntry, int *mx, int *my,
+             int *mz, double *tbest, double *tdef) {
+/* this subroutine chooses the tile size mx, my, mz which gives the
+   shortest time for deposit, push and reorder.  the default tile size
+   is tried first, followed by a list of cubic tiles and tiles twice as
+   long in x, with sides from 4 to 32 grids.  candidates larger than
+   the grid, or whose local field array does not fit in half of the
+   level 2 cache, are not tried.
+   each tile size is timed with cmtime3, and the times are printed
+   input: all except tbest, tdef, output: mx, my, mz, tbest, tdef
+   mx/my/mz = on input, default tile size, on output, best tile size
+   tbest = time per particle per step for best tile size, in seconds
+   tdef = time per particle per step for default tile size, in seconds
+   both times are negative if the particle buffers overflowed
+   see cmtime3 for other arguments
+local data                                                            */
+   int kx[NTILE+1] = {0,4,8,8,16,16,32,32};
+   int ky[NTILE+1] = {0,4,4,8,8,16,16,32};
+   int kz[NTILE+1] = {0,4,4,8,8,16,16,32};
+   int i, ibest, nsize, ncache;
+   double time;
+   ncache = ccachesize();
+   printf("tile size autotuner: L2 cache = %d KB\n",ncache/1024);
+   kx[0] = *mx;
+   ky[0] = *my;
+   kz[0] = *mz;
+   ibest = 0;
+   *tbest = -1.0;
+   *tdef = -1.0;
+   for (i = 0; i <= NTILE; i++) {
+      if (i > 0) {
+         if ((kx[i]==kx[0]) && (ky[i]==ky[0]) && (kz[i]==kz[0]))
+            continue;
+         if ((kx[i] > nx) || (ky[i] > ny) || (kz[i] > nz))
+            continue;
+/* size in bytes of local field array for one tile */
+         nsize = 12*(kx[i] + 1)*(ky[i] + 1)*(kz[i] + 1);
+         if (2*nsize > ncache)
+            continue;
+      }
+      time = cmtime3(part,qm,qbm,dt,idimp,np,nx,ny,nz,kx[i],ky[i],kz[i],
+                     nxe,nye,nze,xtras,kdepo,ntry);
+      if (time < 0.0) {
+         printf("mx,my,mz = %d,%d,%d: particle buffer overflow\n",kx[i],
+                ky[i],kz[i]);
+         continue;
+      }
+      printf("mx,my,mz = %d,%d,%d: time/particle/step = %f nsec\n",
+             kx[i],ky[i],kz[i],1.0e9*time);
+      if (i==0)
+         *tdef = time;
+      if ((*tbest < 0.0) || (time < *tbest)) {
+         *tbest = time;
+         ibest = i;
+      }
+   }
+   *mx = kx[ibest];
+   *my = ky[ibest];
+   *mz = kz[ibest];
+   return;
+}
@@ -0,0 +1,13 @@
+/* header file for mtune3.c */
+
+int ccachesize();
+
+double cmtime3(float part[], float qm, float qbm, float dt, int idimp,
+               int np, int nx, int ny, int nz, int mx, int my, int mz,
+               int nxe, int nye, int nze, float xtras, int kdepo,
+               int ntry);
+
+void cmtune3(float part[], float qm, float qbm, float dt, int idimp,
+             int np, int nx, int ny, int nz, int nxe, int nye, int nze,
+             float xtras, int kdepo, int ntry, int *mx, int *my,
+             int *mz, double *tbest, double *tdef);
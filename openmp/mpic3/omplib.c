@@ -1,6 +1,10 @@
 /*  OpenMP utility library */
 /* written by Viktor K. Decyk, UCLA */
 
+#ifdef __linux__
+#define _GNU_SOURCE
+#include <sched.h>
+#endif
 #include <stdlib.h>
 #include <stdio.h>
 #include <omp.h>
@@ -23,6 +27,74 @@ void cinit_omp(int nth) {
       nthreads = nth;
    omp_set_num_threads(nthreads);
    printf("using %i thread(s)\n",nthreads);
+#if _OPENMP >= 201511
+/* report binding policy set by OMP_PROC_BIND and OMP_PLACES */
+   printf("thread binding = %i, number of places = %i\n",
+          (int) omp_get_proc_bind(),omp_get_num_places());
+#endif
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void caffin_omp(int kaff) {
+/* pin threads to processors and report the processor of each thread
+   kaff = (0,1,2) = (do not pin,pin threads to consecutive processors,
+   spread threads evenly over the processors)
+   processors are taken from the affinity mask of the process, in
+   increasing order.  OpenMP reuses the same threads in later parallel
+   regions with the same number of threads, so they stay pinned.
+   pinning is only available on linux
+local data                                                            */
+#ifdef __linux__
+   int i, n, ncpu, nth;
+   int *kcpu, *lcpu;
+   cpu_set_t mask;
+   CPU_ZERO(&mask);
+   sched_getaffinity(0,sizeof(mask),&mask);
+   ncpu = CPU_COUNT(&mask);
+   lcpu = (int *) malloc(ncpu*sizeof(int));
+   kcpu = (int *) malloc(nthreads*sizeof(int));
+   n = 0;
+   for (i = 0; i < CPU_SETSIZE; i++) {
+      if ((n < ncpu) && CPU_ISSET(i,&mask)) {
+         lcpu[n] = i;
+         n += 1;
+      }
+   }
+   for (i = 0; i < nthreads; i++) {
+      kcpu[i] = -1;
+   }
+#pragma omp parallel private(i,n,nth,mask)
+   {
+   i = omp_get_thread_num();
+   nth = omp_get_num_threads();
+   if ((kaff > 0) && (ncpu > 0)) {
+      n = kaff==1 ? i%ncpu : ((long) i*ncpu/nth)%ncpu;
+      CPU_ZERO(&mask);
+      CPU_SET(lcpu[n],&mask);
+/* pid 0 is the calling thread */
+      sched_setaffinity(0,sizeof(mask),&mask);
+   }
+   if (i < nthreads)
+      kcpu[i] = sched_getcpu();
+   }
+   if (kaff==1)
+      printf("threads pinned to consecutive processors\n");
+   else if (kaff==2)
+      printf("threads pinned evenly over processors\n");
+   printf("processor of each thread:");
+   for (i = 0; i < nthreads; i++) {
+      if ((i%16)==0)
+         printf("\n");
+      printf(" %i",kcpu[i]);
+   }
+   printf("\n");
+   free(kcpu);
+   free(lcpu);
+#else
+   if (kaff > 0)
+      printf("thread pinning is not available\n");
+#endif
    return;
 }
 
@@ -56,3 +128,8 @@ void csetnthsize_(int *nth) {
 int cgetnthsize_() {
    return cgetnthsize();
 }
+
+void caffin_omp_(int *kaff) {
+   caffin_omp(*kaff);
+   return;
+}
@@ -47,3 +47,35 @@ c common block for parallel processing
       GETNTHSIZE = nthreads
       return
       end
+c-----------------------------------------------------------------------
+      subroutine AFFIN_OMP(kaff)
+c report the place of each thread
+c kaff = (0,1,2) = (do not pin,pin threads to consecutive processors,
+c spread threads evenly over the processors)
+c threads cannot be pinned from Fortran, so if kaff > 0, a message
+c is printed instead: use OMP_PROC_BIND and OMP_PLACES
+      implicit none
+      integer kaff
+c get definition of OpenMP functions
+      include 'omp_lib.h'
+c common block for parallel processing
+      integer nthreads
+      common /omdata/ nthreads
+c local data
+      integer i
+      integer kplace
+      dimension kplace(nthreads)
+      if (kaff.gt.0) then
+         write (*,*) 'thread pinning not available, use OMP_PROC_BIND'
+      endif
+      do 10 i = 1, nthreads
+      kplace(i) = -1
+   10 continue
+!$OMP PARALLEL PRIVATE(i)
+      i = omp_get_thread_num() + 1
+      if (i.le.nthreads) kplace(i) = omp_get_place_num()
+!$OMP END PARALLEL
+      write (*,*) 'place of each thread:'
+      write (*,'(16i5)') (kplace(i),i=1,nthreads)
+      return
+      end
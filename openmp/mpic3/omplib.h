@@ -5,3 +5,5 @@ void cinit_omp(int nth);
 void csetnthsize(int nth);
 
 int cgetnthsize();
+
+void caffin_omp(int kaff);
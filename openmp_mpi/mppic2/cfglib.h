@@ -0,0 +1,9 @@
+/* C header file for cfglib.h */
+
+int ccfgread(int argc, char *argv[], int kprint);
+
+int ccfgint(const char *name, int *ival);
+
+int ccfgflt(const char *name, float *fval);
+
+int ccfgend();
@@ -0,0 +1,275 @@
+/* particle buffer growth library for 2D MPI/OpenMP PIC codes */
+/* written for the skeleton PIC codes */
+
+#include <stdlib.h>
+#include <string.h>
+#include "mpgrow2.h"
+
+/*--------------------------------------------------------------------*/
+int cgrowsize(int nold, int nneed, int nmin, float xtras, int kgrow) {
+/* this function returns a new size for a particle buffer of size nold
+   which needs to hold nneed entries.
+   if nneed > nold, the buffer grows by at least half its size, so that
+   the number of reallocations grows only logarithmically.
+   if kgrow = 2 and less than a quarter of the buffer is needed, it
+   shrinks to (1+xtras)*nneed, but not below nmin.
+   otherwise nold is returned
+   nmin = initial size of buffer
+   xtras = fraction of extra entries kept after shrinking
+   kgrow = (1,2) = (grow only,grow and shrink)
+local data                                                            */
+   int n;
+   if (nneed > nold) {
+      n = nold + nold/2;
+      return nneed > n ? nneed : n;
+   }
+   if ((kgrow==2) && (4*nneed < nold)) {
+      n = (1.0 + xtras)*nneed;
+      return n > nmin ? n : nmin;
+   }
+   return nold;
+}
+
+/*--------------------------------------------------------------------*/
+void *cgrowtile(void *a, int nold, int nnew, int ntile, int nsize) {
+/* this function copies a tiled array a[ntile][nold] with elements of
+   nsize bytes into a newly allocated array b[ntile][nnew], and frees a.
+   the first min(nold,nnew) elements of each tile are copied.
+   returns b, or NULL if there is not enough memory, in which case a is
+   not freed
+local data                                                            */
+   int k, n;
+   char *b;
+   b = (char *) malloc((size_t) nnew*ntile*nsize);
+   if (b==NULL)
+      return NULL;
+   n = nold < nnew ? nold : nnew;
+   for (k = 0; k < ntile; k++) {
+      memcpy(b+(size_t) nnew*nsize*k,(char *) a+(size_t) nold*nsize*k,
+             (size_t) n*nsize);
+   }
+   free(a);
+   return b;
+}
+
+/*--------------------------------------------------------------------*/
+void cppneed2la(int ncl[], int mx1, int myp1, int *nhmax,
+                int *nbmax) {
+/* this subroutine finds the buffer sizes needed by cppporderf2la to
+   buffer particles leaving tiles and processors, from the number of
+   particles leaving each tile in each direction, as found by
+   cppgppushf2l or cppholes2l.  it must be called before cppporderf2la
+   for distributed data, with 1d domain decomposition in y.
+   tiles are assumed to be arranged in 2D linear memory
+   input: ncl, mx1, myp1, output: nhmax, nbmax
+   ncl[k][i] = number of particles going to destination i, tile k
+   mx1 = (system length in x direction - 1)/mx + 1
+   myp1 = (partition length in y direction - 1)/my + 1
+   nhmax = maximum number of particles leaving any tile, the size
+   needed for ppbuff and ihole
+   nbmax = maximum number of particles leaving through the lower or
+   upper processor boundary, the size needed for sbufl and sbufr
+local data                                                            */
+   int mxyp1, j, k, kk, nh, nn, nl, nr;
+   mxyp1 = mx1*myp1;
+   nh = 0;
+   for (k = 0; k < mxyp1; k++) {
+      nn = 0;
+      for (j = 0; j < 8; j++) {
+         nn += ncl[j+8*k];
+      }
+      nh = nn > nh ? nn : nh;
+   }
+/* directions 3-5 go to lower processor, directions 6-8 to upper */
+   kk = mx1*(myp1 - 1);
+   nl = 0;
+   nr = 0;
+   for (k = 0; k < mx1; k++) {
+      for (j = 2; j < 5; j++) {
+         nl += ncl[j+8*k];
+         nr += ncl[j+3+8*(k+kk)];
+      }
+   }
+   *nhmax = nh;
+   *nbmax = nl > nr ? nl : nr;
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cppneed2lb(int kpic[], int ncl[], int ihole[], int mcll[],
+                int mclr[], int mx1, int myp1, int ntmax,
+                int *nppmax) {
+/* this subroutine finds the size of ppart needed by cppporder2lb to
+   insert incoming particles, from the particle number offsets found by
+   cppporderf2la and received by cpppmove2.  it must be called after
+   cpppmove2 and before cppporder2lb
+   for distributed data, with 1d domain decomposition in y.
+   tiles are assumed to be arranged in 2D linear memory
+   input: all, output: nppmax
+   kpic[k] = number of particles in tile k
+   ncl[k][i] = number offset of particles going to destination i,
+   tile k, as found by cppporderf2la
+   ihole[k][0][0] = ih, number of holes left in tile k
+   mcll = number offset being received from lower processor
+   mclr = number offset being received from upper processor
+   mx1 = (system length in x direction - 1)/mx + 1
+   myp1 = (partition length in y direction - 1)/my + 1
+   ntmax = size of hole array for particles leaving tiles
+   nppmax = maximum number of particles held by any tile after particles
+   are reordered, the size needed for ppart
+local data                                                            */
+   int mxyp1, k, ii, kx, ky, kk, kl, kr, kxl, kxr, nn, mm, ncoff, nh;
+   int npp, nppp;
+   int ks[8];
+   mxyp1 = mx1*myp1;
+   npp = 0;
+   for (k = 0; k < mxyp1; k++) {
+      ky = k/mx1;
+      kk = ky*mx1;
+      kl = (ky - 1)*mx1;
+      kr = (ky + 1)*mx1;
+      kx = k - ky*mx1;
+      kxl = kx - 1;
+      if (kxl < 0)
+         kxl += mx1;
+      kxr = kx + 1;
+      if (kxr >= mx1)
+         kxr -= mx1;
+/* find tile number for different directions, as in cppporder2lb */
+      ks[0] = kxr + kk;
+      ks[1] = kxl + kk;
+      ks[2] = kx + kr;
+      ks[3] = kxr + kr;
+      ks[4] = kxl + kr;
+      ks[5] = kx + kl;
+      ks[6] = kxr + kl;
+      ks[7] = kxl + kl;
+      nn = 0;
+      mm = 0;
+      if (ky==0) {
+         if (kx > 0)
+            nn = mcll[2+3*(kx-1)];
+      }
+      if (ky==(myp1-1)) {
+         if (kx > 0)
+            mm = mclr[2+3*(kx-1)];
+      }
+/* count particles coming from each direction */
+      ncoff = 0;
+      nppp = 0;
+      for (ii = 0; ii < 8; ii++) {
+         if (ks[ii] < 0) {
+            if (ii > 5)
+               nn = mcll[ii-6+3*(ks[ii]+mx1)];
+            nppp += mcll[ii-5+3*(ks[ii]+mx1)] - nn;
+         }
+         else if (ks[ii] >= mxyp1) {
+            if (ii > 2)
+               mm = mclr[ii-3+3*(ks[ii]-mxyp1)];
+            nppp += mclr[ii-2+3*(ks[ii]-mxyp1)] - mm;
+         }
+         else {
+            if (ii > 0)
+               ncoff = ncl[ii-1+8*ks[ii]];
+            nppp += ncl[ii+8*ks[ii]] - ncoff;
+         }
+      }
+/* holes are filled first, the rest is added at the end of the tile */
+      nh = ihole[2*(ntmax+1)*k];
+      nppp = kpic[k] + (nppp > nh ? nppp - nh : 0);
+      npp = nppp > npp ? nppp : npp;
+   }
+   *nppmax = npp;
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cppholes2l(float ppart[], int kpic[], int ncl[], int ihole[],
+                int noff, int nyp, int idimp, int nppmx, int nx,
+                int mx, int my, int mx1, int mxyp1, int ntmax,
+                int *irc) {
+/* this subroutine finds particles which have left their tile after a
+   push with cppgppushf2l, and stores their number in each direction,
+   location, and destination in ncl and ihole, as cppgppushf2l does.
+   it is used to recover when ihole overflowed in cppgppushf2l, after
+   ihole has been enlarged.  particle positions have already been
+   wrapped by periodic boundary conditions, so the direction in which
+   a particle left is taken from the sign of its velocity.
+   for distributed data, with 1d domain decomposition in y.
+   input: all except ncl, ihole, irc, output: ncl, ihole, irc
+   ppart[k][n][0] = position x of particle n in partition in tile k
+   ppart[k][n][1] = position y of particle n in partition in tile k
+   ppart[k][n][2] = velocity vx of particle n in partition in tile k
+   ppart[k][n][3] = velocity vy of particle n in partition in tile k
+   kpic[k] = number of particles in tile k
+   ncl[k][i] = number of particles going to destination i, tile k
+   ihole[k][:][0] = location of hole in array left by departing particle
+   ihole[k][:][1] = direction destination of particle leaving hole
+   all for tile k
+   ihole[k][0][0] = ih, number of holes left (error, if negative)
+   noff = lowermost global gridpoint in particle partition.
+   nyp = number of primary (complete) gridpoints in particle partition
+   idimp = size of phase space = 4
+   nppmx = maximum number of particles in tile
+   nx = system length in x direction
+   mx/my = number of grids in sorting cell in x/y
+   mx1 = (system length in x direction - 1)/mx + 1
+   mxyp1 = mx1*myp1, where myp1=(partition length in y direction-1)/my+1
+   ntmax = size of hole array for particles leaving tiles
+   irc = maximum overflow, returned only if error occurs, when irc > 0
+local data                                                            */
+   int noffp, moffp, nppp, npoff, nn, mm, ih, nh, ist, j, k;
+   float edgelx, edgely, edgerx, edgery, dx, dy;
+#pragma omp parallel for \
+private(j,k,noffp,moffp,nppp,npoff,nn,mm,ih,nh,ist,dx,dy,edgelx, \
+edgely,edgerx,edgery)
+   for (k = 0; k < mxyp1; k++) {
+      noffp = k/mx1;
+      moffp = my*noffp;
+      noffp = mx*(k - mx1*noffp);
+      nppp = kpic[k];
+      npoff = nppmx*k;
+      nn = nx - noffp;
+      nn = mx < nn ? mx : nn;
+      mm = nyp - moffp;
+      mm = my < mm ? my : mm;
+      edgelx = noffp;
+      edgerx = noffp + nn;
+      edgely = noff + moffp;
+      edgery = noff + moffp + mm;
+      ih = 0;
+      nh = 0;
+      for (j = 0; j < 8; j++) {
+         ncl[j+8*k] = 0;
+      }
+/* loop over particles in tile */
+      for (j = 0; j < nppp; j++) {
+         dx = ppart[idimp*(j+npoff)];
+         dy = ppart[1+idimp*(j+npoff)];
+/* ist = direction particle is going */
+         ist = 0;
+         if ((dx < edgelx) || (dx >= edgerx))
+            ist = ppart[2+idimp*(j+npoff)] > 0.0f ? 2 : 1;
+         if ((dy < edgely) || (dy >= edgery))
+            ist += ppart[3+idimp*(j+npoff)] > 0.0f ? 6 : 3;
+         if (ist > 0) {
+            ncl[ist+8*k-1] += 1;
+            ih += 1;
+            if (ih <= ntmax) {
+               ihole[2*(ih+(ntmax+1)*k)] = j + 1;
+               ihole[1+2*(ih+(ntmax+1)*k)] = ist;
+            }
+            else {
+               nh = 1;
+            }
+         }
+      }
+/* set error */
+      if (nh > 0) {
+         *irc = ih;
+         ih = -ih;
+      }
+      ihole[2*(ntmax+1)*k] = ih;
+   }
+   return;
+}
@@ -0,0 +1,17 @@
+/* header file for mpgrow2.c */
+
+int cgrowsize(int nold, int nneed, int nmin, float xtras, int kgrow);
+
+void *cgrowtile(void *a, int nold, int nnew, int ntile, int nsize);
+
+void cppneed2la(int ncl[], int mx1, int myp1, int *nhmax,
+                int *nbmax);
+
+void cppneed2lb(int kpic[], int ncl[], int ihole[], int mcll[],
+                int mclr[], int mx1, int myp1, int ntmax,
+                int *nppmax);
+
+void cppholes2l(float ppart[], int kpic[], int ncl[], int ihole[],
+                int noff, int nyp, int idimp, int nppmx, int nx,
+                int mx, int my, int mx1, int mxyp1, int ntmax,
+                int *irc);
@@ -4,12 +4,12 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <complex.h>
-#include <sys/time.h>
 #include "mppush2.h"
 #include "mpplib2.h"
 #include "omplib.h"
-
-void dtimer(double *time, struct timeval *itime, int icntrl);
+#include "mpgrow2.h"
+#include "proflib.h"
+#include "cfglib.h"
 
 int main(int argc, char *argv[]) {
 /* indx/indy = exponent which determines grid points in x/y direction: */
@@ -39,6 +39,22 @@ int main(int argc, char *argv[]) {
    int mx = 16, my = 16;
 /* fraction of extra particles needed for particle management */
    float xtras = 0.2;
+/* kgrow = (0,1,2) = on particle buffer overflow (stop with error,grow */
+/* buffers,grow and shrink buffers)                                     */
+   int kgrow = 1;
+/* kovlp = (0,1) = (no,yes) push interior tiles while guard cells in y */
+/* are exchanged, and add guard cells in x while guard cells in y are  */
+/* summed                                                              */
+   int kovlp = 0;
+/* kshm = (0,1) = (no,yes) allocate charge, field and particle send */
+/* buffers in MPI-3 shared memory windows, so that nearby processors */
+/* on the same node read them directly instead of using messages    */
+   int kshm = 0;
+/* kprof = (0,1,2,3) = print (no profile,profile summary,summary and   */
+/* per step CSV files prof.n.csv,summary and per step JSON files       */
+/* prof.n.json), where n = processor id                                */
+/* kperf = (0,1) = (no,yes) read hardware counters in profile          */
+   int kprof = 0, kperf = 0;
 /* declare scalars for standard code */
    int j;
    int nx, ny, nxh, nyh, nxe, nye, nxeh, nnxe, nxyh, nxhy;
@@ -50,10 +66,18 @@ int main(int argc, char *argv[]) {
    int ntpose = 1;
    int nvp, idproc, kstrt, npmax, kxp, kyp, nypmx, nypmn;
    int nyp, noff, npp, nps, myp1, mxyp1;
+/* mxyi = number of interior tiles, which do not use guard cells in y */
+/* moffb = offset in y of the last row of tiles                       */
+   int mxyi, moffb;
 
 /* declare scalars for OpenMP code */
    int nppmx, nppmx0, nbmaxp, ntmaxp, npbmx, irc;
    int nvpp;
+/* nppmin/ntmin/npbmin/nbmin = initial sizes of particle buffers */
+/* nh/nb/nn = buffer sizes needed to reorder particles */
+/* ngrow/nshrink = number of times buffers were enlarged/reduced */
+   int nppmin, ntmin, npbmin, nbmin, nh, nb, nn, n;
+   int ngrow = 0, nshrink = 0;
 
 /* declare arrays for standard code */
 /* part = particle array */
@@ -73,6 +97,7 @@ int main(int argc, char *argv[]) {
 /* sct = sine/cosine table for FFT */
    float complex *sct = NULL;
    double wtot[4], work[4];
+   int ibflg[4], iwork[4];
 
 /* declare arrays for MPI code */
 /* bs/br = complex send/receive buffers for data transpose */
@@ -99,17 +124,42 @@ int main(int argc, char *argv[]) {
 
 /* declare and initialize timing data */
    float time;
-   struct timeval itime;
    float tdpost = 0.0, tguard = 0.0, ttp = 0.0, tfield = 0.0;
    float tpush = 0.0, tsort = 0.0, tmov = 0.0;
    float tfft[2] = {0.0,0.0};
-   double dtime;
+/* tgwait = time waiting for guard cells in y from remote processor */
+   float tgwait = 0.0;
+/* tprof/tpmax = profile data for each region, summed/maximum over */
+/* processors, tpscr = scratch array, dimension 5*64              */
+   double tprof[320], tpmax[320], tpscr[320];
+   char fprof[32];
 
    irc = 0;
 /* nvpp = number of shared memory nodes  (0=default) */
    nvpp = 0;
-/* printf("enter number of nodes:\n"); */
-/* scanf("%i",&nvpp);                   */
+
+/* nvp = number of distributed memory nodes */
+/* initialize for distributed memory parallel processing */
+   cppinit2(&idproc,&nvp,argc,argv);
+   kstrt = idproc + 1;
+/* replace parameters with values from input decks or command line, */
+/* for example: cmppic2 indx=10 npx=1024 npy=1024                   */
+   ierr = ccfgread(argc,argv,kstrt==1);
+   ccfgint("indx",&indx); ccfgint("indy",&indy); ccfgint("npx",&npx);
+   ccfgint("npy",&npy); ccfgflt("tend",&tend); ccfgflt("dt",&dt);
+   ccfgflt("vtx",&vtx); ccfgflt("vty",&vty); ccfgflt("vx0",&vx0);
+   ccfgflt("vy0",&vy0); ccfgint("mx",&mx); ccfgint("my",&my);
+   ccfgflt("xtras",&xtras); ccfgint("kgrow",&kgrow);
+   ccfgint("nvpp",&nvpp); ccfgint("kovlp",&kovlp);
+   ccfgint("kshm",&kshm);
+   ccfgint("kprof",&kprof); ccfgint("kperf",&kperf);
+   ierr += ccfgend();
+   if (ierr != 0) {
+      if (kstrt==1)
+         printf("invalid run time parameters\n");
+      goto L3000;
+   }
+
 /* initialize for shared memory parallel processing */
    cinit_omp(nvpp);
 
@@ -129,10 +179,6 @@ int main(int argc, char *argv[]) {
    qbme = qme;
    affp = (double) nx*(double) ny/np;
 
-/* nvp = number of distributed memory nodes */
-/* initialize for distributed memory parallel processing */
-   cppinit2(&idproc,&nvp,argc,argv);
-   kstrt = idproc + 1;
 /* check if too many processors */
    if (nvp > ny) {
       if (kstrt==1) {
@@ -166,11 +212,23 @@ int main(int argc, char *argv[]) {
    npmax = (np/nvp)*1.25;
 /* myp1 = number of tiles in y direction */
    myp1 = (nyp - 1)/my + 1; mxyp1 = mx1*myp1;
+   mxyi = mx1*(myp1 - 1); moffb = my*(myp1 - 1);
 
 /* allocate and initialize data for standard code */
    part = (float *) malloc(idimp*npmax*sizeof(float));
-   qe = (float *) malloc(nxe*nypmx*sizeof(float));
-   fxye = (float *) malloc(ndim*nxe*nypmx*sizeof(float));
+   if (kshm==1) {
+      qe = cppshalloc(nxe*nypmx,0);
+      fxye = cppshalloc(ndim*nxe*nypmx,0);
+      if ((qe==NULL) || (fxye==NULL)) {
+         printf("%d,shared memory allocation error\n",kstrt);
+         cppabort();
+         exit(1);
+      }
+   }
+   else {
+      qe = (float *) malloc(nxe*nypmx*sizeof(float));
+      fxye = (float *) malloc(ndim*nxe*nypmx*sizeof(float));
+   }
    qt = (float complex *) malloc(nye*kxp*sizeof(float complex));
    fxyt = (float complex *) malloc(ndim*nye*kxp*sizeof(float complex));
    ffc = (float complex *) malloc(nyh*kxp*sizeof(float complex));
@@ -214,8 +272,15 @@ int main(int argc, char *argv[]) {
    ntmaxp = xtras*nppmx;
    npbmx = xtras*nppmx;
    nbmaxp = 0.25*mx1*npbmx;
-   sbufl = (float *) malloc(idimp*nbmaxp*sizeof(float));
-   sbufr = (float *) malloc(idimp*nbmaxp*sizeof(float));
+/* shared send buffers also hold the particle number offsets */
+   if (kshm==1) {
+      sbufl = cppshalloc(idimp*nbmaxp,3*mx1);
+      sbufr = cppshalloc(idimp*nbmaxp,3*mx1);
+   }
+   else {
+      sbufl = (float *) malloc(idimp*nbmaxp*sizeof(float));
+      sbufr = (float *) malloc(idimp*nbmaxp*sizeof(float));
+   }
    rbufl = (float *) malloc(idimp*nbmaxp*sizeof(float));
    rbufr = (float *) malloc(idimp*nbmaxp*sizeof(float));
    ppart = (float *) malloc(idimp*nppmx0*mxyp1*sizeof(float));
@@ -226,6 +291,7 @@ int main(int argc, char *argv[]) {
    nclr = (int *) malloc(3*mxyp1*sizeof(int));
    mcll = (int *) malloc(3*mxyp1*sizeof(int));
    mclr = (int *) malloc(3*mxyp1*sizeof(int));
+   nppmin = nppmx0; ntmin = ntmaxp; npbmin = npbmx; nbmin = nbmaxp;
 
 /* copy ordered particle data for OpenMP */
    cpppmovin2l(part,ppart,kpic,npp,noff,nppmx0,idimp,npmax,mx,my,mx1,
@@ -243,94 +309,207 @@ int main(int argc, char *argv[]) {
       exit(1);
    }
 
+/* initialize profiler */
+   if (cprofinit(0,kperf,idproc)==1) {
+      if (kstrt==1)
+         printf("hardware counters not available\n");
+   }
+   if (kprof==2) {
+      sprintf(fprof,"prof.%d.csv",idproc);
+      cprofopen(fprof,1);
+   }
+   else if (kprof==3) {
+      sprintf(fprof,"prof.%d.json",idproc);
+      cprofopen(fprof,2);
+   }
+
 /* * * * start main iteration loop * * * */
 
 L500: if (nloop <= ntime)
          goto L2000;
 /*    if (kstrt==1) printf("ntime = %i\n",ntime); */
+      cprofbeg("step");
 
 /* deposit charge with OpenMP: updates qe */
-      dtimer(&dtime,&itime,-1);
+      cprofbeg("deposit");
       for (j = 0; j < nxe*nypmx; j++) {
          qe[j] = 0.0;
       }
       cppgppost2l(ppart,qe,kpic,noff,qme,idimp,nppmx0,mx,my,nxe,nypmx,
                   mx1,mxyp1);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tdpost += time;
+      tdpost += cprofend();
 
 /* add guard cells with OpenMP: updates qe */
-      dtimer(&dtime,&itime,-1);
-      cppaguard2xl(qe,nyp,nx,nxe,nypmx);
-      cppnaguard2l(qe,scr,nyp,nx,kstrt,nvp,nxe,nypmx);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tguard += time;
+      cprofbeg("guard");
+      if (kovlp==1) {
+/* send guard cells in y first, then add the remaining guard cells in */
+/* x while they are in flight                                         */
+         cppaguard2xl(&qe[nxe*nyp],0,nx,nxe,nypmx);
+         cppnaguard2la(qe,scr,nyp,nx,kstrt,nvp,nxe,nypmx);
+         cppaguard2xl(qe,nyp-1,nx,nxe,nypmx);
+         cprofbeg("gwait");
+         cppnaguard2lb(qe,scr,nyp,nx,kstrt,nvp,nxe,nypmx);
+         tgwait += cprofend();
+      }
+      else {
+         cppaguard2xl(qe,nyp,nx,nxe,nypmx);
+         cprofbeg("gwait");
+         cppnaguard2l(qe,scr,nyp,nx,kstrt,nvp,nxe,nypmx);
+         tgwait += cprofend();
+      }
+      tguard += cprofend();
 
 /* transform charge to fourier space with OpenMP: updates qt */
 /* modifies qe */
-      dtimer(&dtime,&itime,-1);
+      cprofbeg("fft");
       isign = -1;
       cwppfft2rm((float complex *)qe,qt,bs,br,isign,ntpose,mixup,sct,
                  &ttp,indx,indy,kstrt,nvp,nxeh,nye,kxp,kyp,nypmx,nxhy,
                  nxyh);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tfft[0] += time;
+      tfft[0] += cprofend();
       tfft[1] += ttp;
 
 /* calculate force/charge in fourier space with OpenMP: updates fxyt, we */
-      dtimer(&dtime,&itime,-1);
+      cprofbeg("field");
       isign = -1;
       cmppois22(qt,fxyt,isign,ffc,ax,ay,affp,&we,nx,ny,kstrt,nye,kxp,
                 nyh);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tfield += time;
+      tfield += cprofend();
 
 /* transform force to real space with OpenMP: updates fxye */
 /* modifies fxyt */
-      dtimer(&dtime,&itime,-1);
+      cprofbeg("fft");
       isign = 1;
       cwppfft2rm2((float complex *)fxye,fxyt,bs,br,isign,ntpose,mixup,
                   sct,&ttp,indx,indy,kstrt,nvp,nxeh,nye,kxp,kyp,nypmx,
                   nxhy,nxyh);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tfft[0] += time;
+      tfft[0] += cprofend();
       tfft[1] += ttp;
 
 /* copy guard cells with OpenMP: updates fxye */
-      dtimer(&dtime,&itime,-1);
-      cppncguard2l(fxye,nyp,kstrt,nvp,nnxe,nypmx);
-      cppcguard2xl(fxye,nyp,nx,ndim,nxe,nypmx);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tguard += time;
+      cprofbeg("guard");
+      if (kovlp==1) {
+/* replicate in x first, so that the row sent in y is complete */
+         cppcguard2xl(fxye,nyp,nx,ndim,nxe,nypmx);
+         cppncguard2la(fxye,nyp,kstrt,nvp,nnxe,nypmx);
+      }
+      else {
+         cprofbeg("gwait");
+         cppncguard2l(fxye,nyp,kstrt,nvp,nnxe,nypmx);
+         tgwait += cprofend();
+         cppcguard2xl(fxye,nyp,nx,ndim,nxe,nypmx);
+      }
+      tguard += cprofend();
 
 /* push particles with OpenMP: */
-      dtimer(&dtime,&itime,-1);
+      cprofbeg("push");
       wke = 0.0;
 /* updates ppart and wke */
 /*    cppgppush2l(ppart,fxye,kpic,noff,nyp,qbme,dt,&wke,nx,ny,mx,my, */
 /*                idimp,nppmx0,nxe,nypmx,mx1,mxyp1,ipbc);            */
 /* updates ppart, wke, ncl, iholep, irc */
-      cppgppushf2l(ppart,fxye,kpic,ncl,iholep,noff,nyp,qbme,dt,&wke,nx,
-                   ny,mx,my,idimp,nppmx0,nxe,nypmx,mx1,mxyp1,ntmaxp,
-                   &irc);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tpush += time;
+      if (kovlp==1) {
+/* push interior tiles while the guard cells in y are in flight */
+         cppgppushf2l(ppart,fxye,kpic,ncl,iholep,noff,nyp,qbme,dt,&wke,
+                      nx,ny,mx,my,idimp,nppmx0,nxe,nypmx,mx1,mxyi,
+                      ntmaxp,&irc);
+         tpush += cprofend();
+         cprofbeg("guard");
+         cprofbeg("gwait");
+         cppncguard2lb(fxye,nyp,kstrt,nvp,nnxe,nypmx);
+         tgwait += cprofend();
+         tguard += cprofend();
+/* push last row of tiles, as a partition starting at noff + moffb */
+         cprofbeg("push");
+         cppgppushf2l(&ppart[idimp*nppmx0*mxyi],&fxye[nnxe*moffb],
+                      &kpic[mxyi],&ncl[8*mxyi],
+                      &iholep[2*(ntmaxp+1)*mxyi],noff+moffb,nyp-moffb,
+                      qbme,dt,&wke,nx,ny,mx,my,idimp,nppmx0,nxe,nypmx,
+                      mx1,mx1,ntmaxp,&irc);
+      }
+      else {
+         cppgppushf2l(ppart,fxye,kpic,ncl,iholep,noff,nyp,qbme,dt,&wke,
+                      nx,ny,mx,my,idimp,nppmx0,nxe,nypmx,mx1,mxyp1,
+                      ntmaxp,&irc);
+      }
+      tpush += cprofend();
+
+/* reorder particles by tile with OpenMP */
+/* first part of particle reorder on x and y cell with mx, my tiles: */
+      cprofbeg("sort");
+      if ((irc != 0) && (kgrow > 0)) {
+/* enlarge iholep and find departing particles again */
+         cppneed2la(ncl,mx1,myp1,&nh,&nb);
+         ntmaxp = cgrowsize(ntmaxp,nh,ntmin,xtras,1);
+         free(iholep);
+         iholep = (int *) malloc(2*(ntmaxp+1)*mxyp1*sizeof(int));
+         irc = 0;
+         if (iholep==NULL)
+            irc = -1;
+         else
+            cppholes2l(ppart,kpic,ncl,iholep,noff,nyp,idimp,nppmx0,nx,
+                       mx,my,mx1,mxyp1,ntmaxp,&irc);
+         ngrow += 1;
+      }
       if (irc != 0) { 
          printf("%d,cppgppushf2l error: irc=%d\n",kstrt,irc);
          cppabort();
          exit(1);
       }
-
-/* reorder particles by tile with OpenMP */
-/* first part of particle reorder on x and y cell with mx, my tiles: */
-      dtimer(&dtime,&itime,-1);
+/* check particle buffer sizes, enlarge or reduce them if needed */
+/* sbufl, sbufr, rbufl, and rbufr must hold the largest number of */
+/* particles sent by any processor                                */
+      if (kgrow > 0) {
+         cppneed2la(ncl,mx1,myp1,&nh,&nb);
+         ibflg[0] = nb;
+         cppimax(ibflg,iwork,1);
+         n = cgrowsize(nbmaxp,ibflg[0],nbmin,xtras,kgrow);
+         if (n != nbmaxp) {
+            if (n > nbmaxp) ngrow += 1; else nshrink += 1;
+            nbmaxp = n;
+            if (kshm==1) {
+               cppshfree(sbufl); cppshfree(sbufr);
+               sbufl = cppshalloc(idimp*nbmaxp,3*mx1);
+               sbufr = cppshalloc(idimp*nbmaxp,3*mx1);
+            }
+            else {
+               free(sbufl); free(sbufr);
+               sbufl = (float *) malloc(idimp*nbmaxp*sizeof(float));
+               sbufr = (float *) malloc(idimp*nbmaxp*sizeof(float));
+            }
+            free(rbufl); free(rbufr);
+            rbufl = (float *) malloc(idimp*nbmaxp*sizeof(float));
+            rbufr = (float *) malloc(idimp*nbmaxp*sizeof(float));
+            if ((sbufl==NULL) || (sbufr==NULL) || (rbufl==NULL)
+                || (rbufr==NULL))
+               irc = -1;
+         }
+         n = cgrowsize(npbmx,nh,npbmin,xtras,kgrow);
+         if ((n != npbmx) && (irc==0)) {
+            if (n > npbmx) ngrow += 1; else nshrink += 1;
+            npbmx = n;
+            free(ppbuff);
+            ppbuff = (float *) malloc(idimp*npbmx*mxyp1*sizeof(float));
+            if (ppbuff==NULL)
+               irc = -1;
+         }
+/* iholep holds the holes found by the push, so it is only reduced */
+         n = cgrowsize(ntmaxp,nh,ntmin,xtras,kgrow);
+         if ((n < ntmaxp) && (irc==0)) {
+            nshrink += 1;
+            iholep = (int *) cgrowtile(iholep,ntmaxp+1,n+1,mxyp1,
+                                       2*sizeof(int));
+            ntmaxp = n;
+            if (iholep==NULL)
+               irc = -1;
+         }
+         if (irc != 0) {
+            printf("%d,particle buffer allocation error: irc=%d\n",
+                   kstrt,irc);
+            cppabort();
+            exit(1);
+         }
+      }
 /* updates ppart, ppbuff, sbufl, sbufr, ncl, iholep, ncll, nclr, irc */
 /*    cppporder2la(ppart,ppbuff,sbufl,sbufr,kpic,ncl,iholep,ncll,nclr, */
 /*                 noff,nyp,idimp,nppmx0,nx,ny,mx,my,mx1,myp1,npbmx,   */
@@ -338,9 +517,7 @@ L500: if (nloop <= ntime)
 /* updates: ppart, ppbuff, sbufl, sbufr, ncl, ncll, nclr, irc */
       cppporderf2la(ppart,ppbuff,sbufl,sbufr,ncl,iholep,ncll,nclr,
                     idimp,nppmx0,mx1,myp1,npbmx,ntmaxp,nbmaxp,&irc);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tsort += time;
+      tsort += cprofend();
       if (irc != 0) {
          printf("%d,cppporderf2la error:ntmaxp,irc=%d,%d\n",kstrt,
                 ntmaxp,irc);
@@ -349,20 +526,33 @@ L500: if (nloop <= ntime)
       }
 /* move particles into appropriate spatial regions: */
 /* updates rbufr, rbufl, mcll, mclr */
-      dtimer(&dtime,&itime,-1);
+      cprofbeg("move");
       cpppmove2(sbufr,sbufl,rbufr,rbufl,ncll,nclr,mcll,mclr,kstrt,nvp,
                 idimp,nbmaxp,mx1);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tmov += time;
+      tmov += cprofend();
 /* second part of particle reorder on x and y cell with mx, my tiles: */
 /* updates ppart, kpic */
-      dtimer(&dtime,&itime,-1);
+      cprofbeg("sort");
+/* check size of ppart, enlarge or reduce it if needed */
+      if (kgrow > 0) {
+         cppneed2lb(kpic,ncl,iholep,mcll,mclr,mx1,myp1,ntmaxp,&nn);
+         n = cgrowsize(nppmx0,nn,nppmin,xtras,kgrow);
+         if (n != nppmx0) {
+            if (n > nppmx0) ngrow += 1; else nshrink += 1;
+            ppart = (float *) cgrowtile(ppart,nppmx0,n,mxyp1,
+                                        idimp*sizeof(float));
+            nppmx0 = n;
+            if (ppart==NULL) {
+               printf("%d,particle buffer allocation error: nppmx0=%d\n",
+                      kstrt,nppmx0);
+               cppabort();
+               exit(1);
+            }
+         }
+      }
       cppporder2lb(ppart,ppbuff,rbufl,rbufr,kpic,ncl,iholep,mcll,mclr,
                    idimp,nppmx0,mx1,myp1,npbmx,ntmaxp,nbmaxp,&irc);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tsort += time;
+      tsort += cprofend();
       if (irc != 0) {
          printf("%d,cppporder2lb error:nppmx0,irc=%d,%d\n",kstrt,nppmx0,
                 irc);
@@ -384,21 +574,42 @@ L500: if (nloop <= ntime)
             printf("%e %e %e\n",we,wke,wke+we);
          }
       }
+      cprofend();
+      cprofstep(ntime);
       ntime += 1;
       goto L500;
 L2000:
 
 /* * * * end main iteration loop * * * */
  
+/* maximum number of buffer resizes on any processor */
+   ibflg[0] = ngrow;
+   ibflg[1] = nshrink;
+   ibflg[2] = nppmx0;
+   ibflg[3] = nbmaxp;
+   cppimax(ibflg,iwork,4);
+/* time per step waiting for guard cells, average and maximum over */
+/* processors                                                      */
+   wtot[0] = nloop > 0 ? 1.0e+06*tgwait/(double) nloop : 0.0;
+   wtot[1] = wtot[0];
+   cppdsum(wtot,work,1);
+   cppdmax(&wtot[1],work,1);
    if (kstrt==1) {
       printf("ntime = %i\n",ntime);
       printf("MPI nodes nvp = %i\n",nvp);
+      if ((ibflg[0] + ibflg[1]) > 0) {
+         printf("max particle buffers enlarged/reduced = %d,%d\n",
+                ibflg[0],ibflg[1]);
+         printf("max final nppmx0, nbmaxp = %d,%d\n",ibflg[2],ibflg[3]);
+      }
       printf("Final Field, Kinetic and Total Energies:\n");
       printf("%e %e %e\n",we,wke,wke+we);
 
       printf("\n");
       printf("deposit time = %f\n",tdpost);
       printf("guard time = %f\n",tguard);
+      printf("guard wait time per step (usec), average and maximum = ");
+      printf("%f,%f\n",wtot[0]/(double) nvp,wtot[1]);
       printf("solver time = %f\n",tfield);
       printf("fft and transpose time = %f,%f\n",tfft[0],tfft[1]);
       printf("push time = %f\n",tpush);
@@ -420,7 +631,27 @@ L2000:
       printf("Total Particle Time (nsec) = %f\n",time*wt);
    }
 
+/* print profile, summed and maximum over processors */
+   if (kprof > 0) {
+      cprofget(tprof,320);
+      for (j = 0; j < 320; j++) {
+         tpmax[j] = tprof[j];
+      }
+      cppdsum(tprof,tpscr,320);
+      cppdmax(tpmax,tpscr,320);
+      if (kstrt==1) {
+         printf("\n");
+         cprofprint(tprof,tpmax,nvp);
+      }
+   }
+/* shared memory windows are freed by all processors together */
+   if (kshm==1) {
+      cppshfree(sbufr); cppshfree(sbufl);
+      cppshfree(fxye); cppshfree(qe);
+   }
+
 L3000:
+   cprofexit();
    cppexit();
    return 0;
 }
@@ -19,6 +19,13 @@
    cppnacguard2lL adds guard cells in y for vector array, linear
                   interpolation, and distributed data with non-uniform
                   partition.
+   cppncguard2la/cppncguard2lb begin/end copying data to guard cells,
+                               so that work can be done while the
+                               messages are in flight.
+   cppnaguard2la/cppnaguard2lb begin/end adding guard cells for scalar
+                               array.
+   cppnacguard2la/cppnacguard2lb begin/end adding guard cells for vector
+                                 array.
    cpptpose performs a transpose of a complex scalar array, distributed
             in y, to a complex scalar array, distributed in x.
    cppntpose performs a transpose of an n component complex vector array,
@@ -26,6 +33,13 @@
             distributed in x.
    cpppmove2 moves particles into appropriate spatial regions for tiled
              distributed data.
+   cppshalloc allocates an array in memory shared with the other
+              processors on the same node.
+   cppshfree frees an array allocated by cppshalloc.
+   when the arrays passed to the guard cell procedures and cpppmove2
+   were allocated by cppshalloc, data from a nearby processor on the
+   same node is read directly from its array, instead of being sent
+   in a message.
    written by viktor k. decyk, ucla
    copyright 1995, regents of the university of california
    update: february 26, 2018                                         */
@@ -54,6 +68,32 @@ static MPI_Op msum, mmax;
 
 static FILE *unit2 = NULL;
 
+/* mgsid = requests of the guard cell exchange in progress, started by */
+/* one of the procedures cppn*guard2la and completed by the matching   */
+/* cppn*guard2lb.  only one such exchange may be in progress at a time */
+static MPI_Request mgsid[2] = {MPI_REQUEST_NULL,MPI_REQUEST_NULL};
+
+/* MAXSHW = maximum number of shared memory windows */
+#define MAXSHW                  8
+/* shared memory windows made by cppshalloc
+   lnode = communicator of the processors on the same node
+   nshw = number of windows
+   mshw = window for each array
+   pshb = start of the segment of this processor, each segment begins
+   with a header of nshh bytes, followed by the array
+   nshs = size of the segment of this processor in bytes
+   pshn = start of the segment of the lower/upper processor, NULL if it
+   is on another node
+   nshx = number of extra integers in header, after the offset and
+   length of the data being sent                                     */
+static MPI_Comm lnode = MPI_COMM_NULL;
+static int nshw = 0;
+static MPI_Win mshw[MAXSHW];
+static char *pshb[MAXSHW];
+static char *pshn[MAXSHW][2];
+static MPI_Aint nshs[MAXSHW];
+static int nshh[MAXSHW], nshx[MAXSHW];
+
 float vresult(float prec) {
    float vresult;
    vresult = prec;
@@ -265,6 +305,180 @@ local data */
    return;
 }
 
+/*--------------------------------------------------------------------*/
+float *cppshalloc(int nsize, int nhx) {
+/* this function allocates an array of nsize reals in a shared memory
+   window of the processors on the same node, and returns its address,
+   or NULL if it cannot be allocated.  nhx integers are reserved in the
+   header of each segment, for cpppmove2 nhx >= 3*mx1.
+   it must be called by all processors with the same arguments
+local data */
+   int ierr, ks, kn[3], kl[2], j, nh, ir;
+   MPI_Aint nsz;
+   MPI_Group mworld, mnode;
+   MPI_Info minfo;
+   char *base;
+   if (nshw >= MAXSHW)
+      return NULL;
+/* make communicator of processors on same node */
+   if (lnode==MPI_COMM_NULL) {
+      ierr = MPI_Comm_split_type(lgrp,MPI_COMM_TYPE_SHARED,0,
+                                 MPI_INFO_NULL,&lnode);
+      if (ierr)
+         return NULL;
+   }
+/* header holds offset, length and nhx extra integers, in cache lines */
+   nh = sizeof(int)*(nhx + 2);
+   nh = 64*((nh - 1)/64 + 1);
+   nsz = (MPI_Aint) nh + (MPI_Aint) nsize*sizeof(float);
+/* segments need not be contiguous, so each can be near its processor */
+   MPI_Info_create(&minfo);
+   MPI_Info_set(minfo,"alloc_shared_noncontig","true");
+   ierr = MPI_Win_allocate_shared(nsz,1,minfo,lnode,&base,&mshw[nshw]);
+   MPI_Info_free(&minfo);
+   if (ierr)
+      return NULL;
+   ierr = MPI_Win_lock_all(MPI_MODE_NOCHECK,mshw[nshw]);
+   pshb[nshw] = base;
+   nshs[nshw] = nsz;
+   nshh[nshw] = nh;
+   nshx[nshw] = nhx;
+   ((int *) base)[0] = 0;
+   ((int *) base)[1] = 0;
+/* find segments of lower and upper processors, if on same node */
+   ierr = MPI_Comm_rank(lgrp,&ks);
+   kn[0] = ks - 1;
+   if (kn[0] < 0)
+      kn[0] += nproc;
+   kn[1] = ks + 1;
+   if (kn[1] >= nproc)
+      kn[1] -= nproc;
+   MPI_Comm_group(lgrp,&mworld);
+   MPI_Comm_group(lnode,&mnode);
+   MPI_Group_translate_ranks(mworld,2,kn,mnode,kl);
+   MPI_Group_free(&mworld);
+   MPI_Group_free(&mnode);
+   for (j = 0; j < 2; j++) {
+      pshn[nshw][j] = NULL;
+      if (kl[j] != MPI_UNDEFINED) {
+         MPI_Win_shared_query(mshw[nshw],kl[j],&nsz,&ir,&base);
+         pshn[nshw][j] = base;
+      }
+   }
+   nshw += 1;
+   return (float *) (pshb[nshw-1] + nh);
+}
+
+/*--------------------------------------------------------------------*/
+void cppshfree(float f[]) {
+/* this subroutine frees an array allocated by cppshalloc.
+   it must be called by all processors
+local data */
+   int j, w;
+   w = -1;
+   for (j = 0; j < nshw; j++) {
+      if ((char *) f==(pshb[j] + nshh[j]))
+         w = j;
+   }
+   if (w < 0)
+      return;
+   MPI_Win_unlock_all(mshw[w]);
+   MPI_Win_free(&mshw[w]);
+   for (j = w; j < (nshw-1); j++) {
+      mshw[j] = mshw[j+1];
+      pshb[j] = pshb[j+1];
+      pshn[j][0] = pshn[j+1][0];
+      pshn[j][1] = pshn[j+1][1];
+      nshs[j] = nshs[j+1];
+      nshh[j] = nshh[j+1];
+      nshx[j] = nshx[j+1];
+   }
+   nshw -= 1;
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+static int cpshwin(float f[]) {
+/* this function returns the number of the shared memory window which
+   contains f, or -1 if f was not allocated by cppshalloc
+local data */
+   int j;
+   for (j = 0; j < nshw; j++) {
+      if (((char *) f >= pshb[j]) && ((char *) f < (pshb[j] + nshs[j])))
+         return j;
+   }
+   return -1;
+}
+
+/*--------------------------------------------------------------------*/
+static void cpshput(int w, float fs[], int ns, int nx[], int nhx) {
+/* this subroutine records in the header of window w that ns reals
+   starting at fs are to be read by a nearby processor, together with
+   nhx extra integers nx
+local data */
+   int j;
+   int *ih;
+   ih = (int *) pshb[w];
+   ih[0] = (int) (fs - (float *) (pshb[w] + nshh[w]));
+   ih[1] = ns;
+   for (j = 0; j < nhx; j++) {
+      ih[j+2] = nx[j];
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+static float *cpshget(int w, int kd, int *ns, int **nx) {
+/* this function returns the address of the data recorded by cpshput
+   in window w by the lower (kd=0) or upper (kd=1) processor, and its
+   length ns and extra integers nx
+local data */
+   int *ih;
+   ih = (int *) pshn[w][kd];
+   *ns = ih[1];
+   if (nx != NULL)
+      *nx = &ih[2];
+   return (float *) (pshn[w][kd] + nshh[w]) + ih[0];
+}
+
+/*--------------------------------------------------------------------*/
+static void cpshbar() {
+/* this subroutine synchronizes the processors on the same node, so
+   that data written to shared memory windows before the call can be
+   read by the other processors after it
+local data */
+   int j;
+   for (j = 0; j < nshw; j++) {
+      MPI_Win_sync(mshw[j]);
+   }
+   MPI_Barrier(lnode);
+   for (j = 0; j < nshw; j++) {
+      MPI_Win_sync(mshw[j]);
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+static void cpshend(int w, int kd, float fr[]) {
+/* this subroutine completes an exchange through shared memory window
+   w: after all processors on the node have recorded their data with
+   cpshput, the data of the lower (kd=0) or upper (kd=1) processor is
+   copied to fr, if it is on the same node.  the second barrier keeps
+   the data from being changed until it has been read
+local data */
+   int j, ns;
+   float *fs;
+   cpshbar();
+   if (pshn[w][kd] != NULL) {
+      fs = cpshget(w,kd,&ns,NULL);
+      for (j = 0; j < ns; j++) {
+         fr[j] = fs[j];
+      }
+   }
+   cpshbar();
+   return;
+}
+
 /*--------------------------------------------------------------------*/
 void cppncguard2l(float f[], int nyp, int kstrt, int nvp, int nxv,
                   int nypmx) {
@@ -280,9 +494,9 @@ void cppncguard2l(float f[], int nyp, int kstrt, int nvp, int nxv,
    nypmx = maximum size of field partition, including guard cell.
    linear interpolation, for distributed data
 local data */
-   int j, ks, moff, kl, kr, ierr;
-   MPI_Request msid;
-   MPI_Status istatus;
+   int j, ks, moff, kl, kr, ierr, w;
+   MPI_Request msid[2];
+   MPI_Status istatus[2];
 /* special case for one processor */
    if (nvp==1) {
       for (j = 0; j < nxv; j++) {
@@ -299,10 +513,21 @@ local data */
    kl = ks - 1;
    if (kl < 0)
       kl = kl + nvp;
+/* w = shared memory window containing f, -1 if none */
+   w = cpshwin(f);
+   msid[0] = MPI_REQUEST_NULL;
+   msid[1] = MPI_REQUEST_NULL;
 /* this segment is used for mpi computers */
-   ierr = MPI_Irecv(&f[nxv*nyp],nxv,mreal,kr,moff,lgrp,&msid);
-   ierr = MPI_Send(f,nxv,mreal,kl,moff,lgrp);
-   ierr = MPI_Wait(&msid,&istatus);
+   if ((w < 0) || (pshn[w][1]==NULL))
+      ierr = MPI_Irecv(&f[nxv*nyp],nxv,mreal,kr,moff,lgrp,&msid[0]);
+   if ((w < 0) || (pshn[w][0]==NULL))
+      ierr = MPI_Isend(f,nxv,mreal,kl,moff,lgrp,&msid[1]);
+/* this segment is used for processors on the same node */
+   if (w >= 0) {
+      cpshput(w,f,nxv,NULL,0);
+      cpshend(w,1,&f[nxv*nyp]);
+   }
+   ierr = MPI_Waitall(2,msid,istatus);
    return;
 }
 
@@ -323,9 +548,9 @@ void cppnaguard2l(float f[], float scr[], int nyp, int nx, int kstrt,
    nypmx = maximum size of field partition, including guard cells.
    linear interpolation, for distributed data
 local data */
-   int j, nx1, ks, moff, kl, kr, ierr;
-   MPI_Request msid;
-   MPI_Status istatus;
+   int j, nx1, ks, moff, kl, kr, ierr, w;
+   MPI_Request msid[2];
+   MPI_Status istatus[2];
    nx1 = nx + 1;
 /* special case for one processor */
    if (nvp==1) {
@@ -344,10 +569,21 @@ local data */
    kl = ks - 1;
    if (kl < 0)
       kl = kl + nvp;
+/* w = shared memory window containing f, -1 if none */
+   w = cpshwin(f);
+   msid[0] = MPI_REQUEST_NULL;
+   msid[1] = MPI_REQUEST_NULL;
 /* this segment is used for mpi computers */
-   ierr = MPI_Irecv(scr,nxv,mreal,kl,moff,lgrp,&msid);
-   ierr = MPI_Send(&f[nxv*nyp],nxv,mreal,kr,moff,lgrp);
-   ierr = MPI_Wait(&msid,&istatus);
+   if ((w < 0) || (pshn[w][0]==NULL))
+      ierr = MPI_Irecv(scr,nxv,mreal,kl,moff,lgrp,&msid[0]);
+   if ((w < 0) || (pshn[w][1]==NULL))
+      ierr = MPI_Isend(&f[nxv*nyp],nxv,mreal,kr,moff,lgrp,&msid[1]);
+/* this segment is used for processors on the same node */
+   if (w >= 0) {
+      cpshput(w,&f[nxv*nyp],nxv,NULL,0);
+      cpshend(w,0,scr);
+   }
+   ierr = MPI_Waitall(2,msid,istatus);
 /* add up the guard cells */
    for (j = 0; j < nx1; j++) {
       f[j] += scr[j];
@@ -374,10 +610,10 @@ void cppnacguard2l(float f[], float scr[], int nyp, int nx, int ndim,
    nypmx = maximum size of field partition, including guard cells.
    linear interpolation, for distributed data
 local data */
-   int j, n, nx1, ks, moff, kl, kr, ierr;
+   int j, n, nx1, ks, moff, kl, kr, ierr, w;
    int nnxv;
-   MPI_Request msid;
-   MPI_Status istatus;
+   MPI_Request msid[2];
+   MPI_Status istatus[2];
    nx1 = nx + 1;
 /* special case for one processor */
    if (nvp==1) {
@@ -399,10 +635,281 @@ local data */
    kl = ks - 1;
    if (kl < 0)
       kl = kl + nvp;
+/* w = shared memory window containing f, -1 if none */
+   w = cpshwin(f);
+   msid[0] = MPI_REQUEST_NULL;
+   msid[1] = MPI_REQUEST_NULL;
 /* this segment is used for mpi computers */
-   ierr = MPI_Irecv(scr,nnxv,mreal,kl,moff,lgrp,&msid);
-   ierr = MPI_Send(&f[nnxv*nyp],nnxv,mreal,kr,moff,lgrp);
-   ierr = MPI_Wait(&msid,&istatus);
+   if ((w < 0) || (pshn[w][0]==NULL))
+      ierr = MPI_Irecv(scr,nnxv,mreal,kl,moff,lgrp,&msid[0]);
+   if ((w < 0) || (pshn[w][1]==NULL))
+      ierr = MPI_Isend(&f[nnxv*nyp],nnxv,mreal,kr,moff,lgrp,&msid[1]);
+/* this segment is used for processors on the same node */
+   if (w >= 0) {
+      cpshput(w,&f[nnxv*nyp],nnxv,NULL,0);
+      cpshend(w,0,scr);
+   }
+   ierr = MPI_Waitall(2,msid,istatus);
+/* add up the guard cells */
+   for (j = 0; j < nx1; j++) {
+      for (n = 0; n < ndim; n++) {
+         f[n+ndim*j] += scr[n+ndim*j];
+         f[n+ndim*(j+nxv*nyp)] = 0.0;
+      }
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cppncguard2la(float f[], int nyp, int kstrt, int nvp, int nxv,
+                   int nypmx) {
+/* this subroutine begins copying data to guard cells in non-uniform
+   partitions, the exchange is completed by cppncguard2lb.
+   between the two calls, f may be read, but not written, except for
+   the guard cells f[nyp][j], which may be neither read nor written.
+   f[k][j] = real data for grid j,k in particle partition.
+   the grid is non-uniform and includes one extra guard cell.
+   nyp = number of primary gridpoints in field partition
+   it is assumed the nyp > 0.
+   kstrt = starting data block number
+   nvp = number of real or virtual processors
+   nxv = first dimension of f, must be >= nx
+   nypmx = maximum size of field partition, including guard cell.
+   linear interpolation, for distributed data
+local data */
+   int ks, moff, kl, kr, ierr, w;
+/* special case for one processor */
+   if (nvp==1)
+      return;
+   ks = kstrt - 1;
+   moff = nypmx*nvp + 2;
+/* copy guard cells */
+   kr = ks + 1;
+   if (kr >= nvp)
+      kr = kr - nvp;
+   kl = ks - 1;
+   if (kl < 0)
+      kl = kl + nvp;
+/* w = shared memory window containing f, -1 if none */
+   w = cpshwin(f);
+/* this segment is used for mpi computers */
+   if ((w < 0) || (pshn[w][1]==NULL))
+      ierr = MPI_Irecv(&f[nxv*nyp],nxv,mreal,kr,moff,lgrp,&mgsid[0]);
+   if ((w < 0) || (pshn[w][0]==NULL))
+      ierr = MPI_Isend(f,nxv,mreal,kl,moff,lgrp,&mgsid[1]);
+/* processors on the same node read f in cppncguard2lb */
+   if (w >= 0)
+      cpshput(w,f,nxv,NULL,0);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cppncguard2lb(float f[], int nyp, int kstrt, int nvp, int nxv,
+                   int nypmx) {
+/* this subroutine completes copying data to guard cells in non-uniform
+   partitions, begun by cppncguard2la with the same arguments
+   f[k][j] = real data for grid j,k in particle partition.
+   output: f
+   nyp = number of primary gridpoints in field partition
+   kstrt = starting data block number
+   nvp = number of real or virtual processors
+   nxv = first dimension of f, must be >= nx
+   nypmx = maximum size of field partition, including guard cell.
+   linear interpolation, for distributed data
+local data */
+   int j, ierr, w;
+   MPI_Status istatus[2];
+/* special case for one processor */
+   if (nvp==1) {
+      for (j = 0; j < nxv; j++) {
+        f[j+nxv*nyp] = f[j];
+      }
+      return;
+   }
+/* this segment is used for processors on the same node */
+   w = cpshwin(f);
+   if (w >= 0)
+      cpshend(w,1,&f[nxv*nyp]);
+/* this segment is used for mpi computers */
+   ierr = MPI_Waitall(2,mgsid,istatus);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cppnaguard2la(float f[], float scr[], int nyp, int nx, int kstrt,
+                   int nvp, int nxv, int nypmx) {
+/* this subroutine begins adding data from guard cells in non-uniform
+   partitions, the sum is completed by cppnaguard2lb.
+   between the two calls, f may be read and written, except for the
+   guard cells f[nyp][j], which may be read but not written.  scr may
+   be neither read nor written.
+   f[k][j] = real data for grid j,k in particle partition.
+   the grid is non-uniform and includes one extra guard cell.
+   scr[j] = scratch array for particle partition
+   nyp = number of primary gridpoints in particle partition
+   it is assumed the nyp > 0.
+   kstrt = starting data block number
+   nvp = number of real or virtual processors
+   nx = system length in x direction
+   nxv = first dimension of f, must be >= nx
+   nypmx = maximum size of field partition, including guard cells.
+   linear interpolation, for distributed data
+local data */
+   int ks, moff, kl, kr, ierr, w;
+/* special case for one processor */
+   if (nvp==1)
+      return;
+   ks = kstrt - 1;
+   moff = nypmx*nvp + 1;
+/* add guard cells */
+   kr = ks + 1;
+   if (kr >= nvp)
+      kr = kr - nvp;
+   kl = ks - 1;
+   if (kl < 0)
+      kl = kl + nvp;
+/* w = shared memory window containing f, -1 if none */
+   w = cpshwin(f);
+/* this segment is used for mpi computers */
+   if ((w < 0) || (pshn[w][0]==NULL))
+      ierr = MPI_Irecv(scr,nxv,mreal,kl,moff,lgrp,&mgsid[0]);
+   if ((w < 0) || (pshn[w][1]==NULL))
+      ierr = MPI_Isend(&f[nxv*nyp],nxv,mreal,kr,moff,lgrp,&mgsid[1]);
+/* processors on the same node read f in cppnaguard2lb */
+   if (w >= 0)
+      cpshput(w,&f[nxv*nyp],nxv,NULL,0);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cppnaguard2lb(float f[], float scr[], int nyp, int nx, int kstrt,
+                   int nvp, int nxv, int nypmx) {
+/* this subroutine completes adding data from guard cells in
+   non-uniform partitions, begun by cppnaguard2la with the same
+   arguments
+   f[k][j] = real data for grid j,k in particle partition.
+   output: f, scr
+   scr[j] = scratch array for particle partition
+   nyp = number of primary gridpoints in particle partition
+   kstrt = starting data block number
+   nvp = number of real or virtual processors
+   nx = system length in x direction
+   nxv = first dimension of f, must be >= nx
+   nypmx = maximum size of field partition, including guard cells.
+   linear interpolation, for distributed data
+local data */
+   int j, nx1, ierr, w;
+   MPI_Status istatus[2];
+   nx1 = nx + 1;
+/* special case for one processor */
+   if (nvp==1) {
+      for (j = 0; j < nx1; j++) {
+         f[j] += f[j+nxv*nyp];
+         f[j+nxv*nyp] = 0.0;
+      }
+      return;
+   }
+/* this segment is used for processors on the same node */
+   w = cpshwin(f);
+   if (w >= 0)
+      cpshend(w,0,scr);
+/* this segment is used for mpi computers */
+   ierr = MPI_Waitall(2,mgsid,istatus);
+/* add up the guard cells */
+   for (j = 0; j < nx1; j++) {
+      f[j] += scr[j];
+      f[j+nxv*nyp] = 0.0;
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cppnacguard2la(float f[], float scr[], int nyp, int nx, int ndim,
+                    int kstrt, int nvp, int nxv, int nypmx) {
+/* this subroutine begins adding data from guard cells in non-uniform
+   partitions, the sum is completed by cppnacguard2lb.
+   between the two calls, f may be read and written, except for the
+   guard cells f[nyp][j][:], which may be read but not written.  scr
+   may be neither read nor written.
+   f[k][j][ndim] = real data for grid j,k in particle partition.
+   the grid is non-uniform and includes one extra guard cell.
+   scr[j][ndim] = scratch array for particle partition
+   nyp = number of primary gridpoints in particle partition
+   it is assumed the nyp > 0.
+   kstrt = starting data block number
+   nvp = number of real or virtual processors
+   nx = system length in x direction
+   ndim = leading dimension of array f
+   nxv = first dimension of f, must be >= nx
+   nypmx = maximum size of field partition, including guard cells.
+   linear interpolation, for distributed data
+local data */
+   int ks, moff, kl, kr, ierr, w;
+   int nnxv;
+/* special case for one processor */
+   if (nvp==1)
+      return;
+   ks = kstrt - 1;
+   moff = nypmx*nvp + 1;
+   nnxv = ndim*nxv;
+/* add guard cells */
+   kr = ks + 1;
+   if (kr >= nvp)
+      kr = kr - nvp;
+   kl = ks - 1;
+   if (kl < 0)
+      kl = kl + nvp;
+/* w = shared memory window containing f, -1 if none */
+   w = cpshwin(f);
+/* this segment is used for mpi computers */
+   if ((w < 0) || (pshn[w][0]==NULL))
+      ierr = MPI_Irecv(scr,nnxv,mreal,kl,moff,lgrp,&mgsid[0]);
+   if ((w < 0) || (pshn[w][1]==NULL))
+      ierr = MPI_Isend(&f[nnxv*nyp],nnxv,mreal,kr,moff,lgrp,
+                       &mgsid[1]);
+/* processors on the same node read f in cppnacguard2lb */
+   if (w >= 0)
+      cpshput(w,&f[nnxv*nyp],nnxv,NULL,0);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cppnacguard2lb(float f[], float scr[], int nyp, int nx, int ndim,
+                    int kstrt, int nvp, int nxv, int nypmx) {
+/* this subroutine completes adding data from guard cells in
+   non-uniform partitions, begun by cppnacguard2la with the same
+   arguments
+   f[k][j][ndim] = real data for grid j,k in particle partition.
+   output: f, scr
+   scr[j][ndim] = scratch array for particle partition
+   nyp = number of primary gridpoints in particle partition
+   kstrt = starting data block number
+   nvp = number of real or virtual processors
+   nx = system length in x direction
+   ndim = leading dimension of array f
+   nxv = first dimension of f, must be >= nx
+   nypmx = maximum size of field partition, including guard cells.
+   linear interpolation, for distributed data
+local data */
+   int j, n, nx1, ierr, w;
+   MPI_Status istatus[2];
+   nx1 = nx + 1;
+/* special case for one processor */
+   if (nvp==1) {
+      for (j = 0; j < nx1; j++) {
+         for (n = 0; n < ndim; n++) {
+            f[n+ndim*j] += f[n+ndim*(j+nxv*nyp)];
+            f[n+ndim*(j+nxv*nyp)] = 0.0;
+         }
+      }
+      return;
+   }
+/* this segment is used for processors on the same node */
+   w = cpshwin(f);
+   if (w >= 0)
+      cpshend(w,0,scr);
+/* this segment is used for mpi computers */
+   ierr = MPI_Waitall(2,mgsid,istatus);
 /* add up the guard cells */
    for (j = 0; j < nx1; j++) {
       for (n = 0; n < ndim; n++) {
@@ -634,11 +1141,14 @@ void cpppmove2(float sbufr[], float sbufl[], float rbufr[],
    nbmax =  size of buffers for passing particles between processors
    mx1 = (system length in x direction - 1)/mx + 1
 local data */
-   int ierr, ks, kl, kr, i, j, jsl, jsr;
+   int ierr, ks, kl, kr, i, j, jsl, jsr, ws, wl, ns;
    int nbsize, ncsize;
    int itg[4] = {3,4,5,6};
+   int *nx;
+   float *fs;
+   char *pl, *pr;
    MPI_Request msid[8];
-   MPI_Status istatus;
+   MPI_Status istatus[8];
    ks = kstrt - 1;
    nbsize = idimp*nbmax;
    ncsize = 3*mx1;
@@ -675,29 +1185,71 @@ local data */
       kl = ks - 1;
       if (kl < 0)
          kl += nvp;
+/* ws/wl = shared memory windows containing sbufr/sbufl, -1 if none */
+/* pl/pr = segments of lower/upper processor, NULL if on another node */
+      ws = cpshwin(sbufr);
+      wl = cpshwin(sbufl);
+      pl = NULL;
+      pr = NULL;
+      if ((ws >= 0) && (wl >= 0) && (nshx[ws] >= ncsize)
+         && (nshx[wl] >= ncsize)) {
+         pl = pshn[ws][0];
+         pr = pshn[wl][1];
+      }
+      else {
+         ws = -1;
+      }
+      for (i = 0; i < 8; i++) {
+         msid[i] = MPI_REQUEST_NULL;
+      }
 /* post receives */
-      ierr = MPI_Irecv(mcll,ncsize,mint,kl,itg[0],lgrp,&msid[0]);
-      ierr = MPI_Irecv(mclr,ncsize,mint,kr,itg[1],lgrp,&msid[1]);
-      ierr = MPI_Irecv(rbufl,nbsize,mreal,kl,itg[2],lgrp,&msid[2]);
-      ierr = MPI_Irecv(rbufr,nbsize,mreal,kr,itg[3],lgrp,&msid[3]);
-/* send particle number offsets */
-      ierr = MPI_Isend(nclr,ncsize,mint,kr,itg[0],lgrp,&msid[4]);
-      ierr = MPI_Isend(ncll,ncsize,mint,kl,itg[1],lgrp,&msid[5]);
-      ierr = MPI_Wait(&msid[0],&istatus);
-      ierr = MPI_Wait(&msid[1],&istatus);
-/* send particles */
+      if (pl==NULL) {
+         ierr = MPI_Irecv(mcll,ncsize,mint,kl,itg[0],lgrp,&msid[0]);
+         ierr = MPI_Irecv(rbufl,nbsize,mreal,kl,itg[2],lgrp,&msid[2]);
+      }
+      if (pr==NULL) {
+         ierr = MPI_Irecv(mclr,ncsize,mint,kr,itg[1],lgrp,&msid[1]);
+         ierr = MPI_Irecv(rbufr,nbsize,mreal,kr,itg[3],lgrp,&msid[3]);
+      }
+/* send particle number offsets and particles */
       jsr = idimp*nclr[3*mx1-1];
-      ierr = MPI_Isend(sbufr,jsr,mreal,kr,itg[2],lgrp,&msid[6]);
       jsl = idimp*ncll[3*mx1-1];
-      ierr = MPI_Isend(sbufl,jsl,mreal,kl,itg[3],lgrp,&msid[7]);
-      ierr = MPI_Wait(&msid[2],&istatus);
-      ierr = MPI_Wait(&msid[3],&istatus);
-   }
-/* make sure sbufr, sbufl, ncll, and nclr have been sent */
-   if (nvp != 1) {
-      for (i = 0; i < 4; i++) {
-         ierr = MPI_Wait(&msid[i+4],&istatus);
+      if (pr==NULL) {
+         ierr = MPI_Isend(nclr,ncsize,mint,kr,itg[0],lgrp,&msid[4]);
+         ierr = MPI_Isend(sbufr,jsr,mreal,kr,itg[2],lgrp,&msid[6]);
       }
+      if (pl==NULL) {
+         ierr = MPI_Isend(ncll,ncsize,mint,kl,itg[1],lgrp,&msid[5]);
+         ierr = MPI_Isend(sbufl,jsl,mreal,kl,itg[3],lgrp,&msid[7]);
+      }
+/* this segment is used for processors on the same node: */
+/* read particles and offsets directly from send buffers */
+      if (ws >= 0) {
+         cpshput(ws,sbufr,jsr,nclr,ncsize);
+         cpshput(wl,sbufl,jsl,ncll,ncsize);
+         cpshbar();
+         if (pl != NULL) {
+            fs = cpshget(ws,0,&ns,&nx);
+            for (j = 0; j < ncsize; j++) {
+               mcll[j] = nx[j];
+            }
+            for (j = 0; j < ns; j++) {
+               rbufl[j] = fs[j];
+            }
+         }
+         if (pr != NULL) {
+            fs = cpshget(wl,1,&ns,&nx);
+            for (j = 0; j < ncsize; j++) {
+               mclr[j] = nx[j];
+            }
+            for (j = 0; j < ns; j++) {
+               rbufr[j] = fs[j];
+            }
+         }
+         cpshbar();
+      }
+/* make sure sbufr, sbufl, ncll, and nclr have been sent */
+      ierr = MPI_Waitall(8,msid,istatus);
    }
    return;
 }
@@ -771,6 +1323,48 @@ void cppnacguard2l_(float *f, float *scr, int *nyp, int *nx, int *ndim,
    return;
 }
 
+/*--------------------------------------------------------------------*/
+void cppncguard2la_(float *f, int *nyp, int *kstrt, int *nvp, int *nxv,
+                    int *nypmx) {
+   cppncguard2la(f,*nyp,*kstrt,*nvp,*nxv,*nypmx);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cppncguard2lb_(float *f, int *nyp, int *kstrt, int *nvp, int *nxv,
+                    int *nypmx) {
+   cppncguard2lb(f,*nyp,*kstrt,*nvp,*nxv,*nypmx);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cppnaguard2la_(float *f, float *scr, int *nyp, int *nx, int *kstrt,
+                    int *nvp, int *nxv, int *nypmx) {
+   cppnaguard2la(f,scr,*nyp,*nx,*kstrt,*nvp,*nxv,*nypmx);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cppnaguard2lb_(float *f, float *scr, int *nyp, int *nx, int *kstrt,
+                    int *nvp, int *nxv, int *nypmx) {
+   cppnaguard2lb(f,scr,*nyp,*nx,*kstrt,*nvp,*nxv,*nypmx);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cppnacguard2la_(float *f, float *scr, int *nyp, int *nx, int *ndim,
+                     int *kstrt, int *nvp, int *nxv, int *nypmx) {
+   cppnacguard2la(f,scr,*nyp,*nx,*ndim,*kstrt,*nvp,*nxv,*nypmx);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cppnacguard2lb_(float *f, float *scr, int *nyp, int *nx, int *ndim,
+                     int *kstrt, int *nvp, int *nxv, int *nypmx) {
+   cppnacguard2lb(f,scr,*nyp,*nx,*ndim,*kstrt,*nvp,*nxv,*nypmx);
+   return;
+}
+
 /*--------------------------------------------------------------------*/
 void cpptpose_(float complex *f, float complex *g, float complex *s,
                float complex *t, int *nx, int *ny, int *kxp, int *kyp,
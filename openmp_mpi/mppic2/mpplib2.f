@@ -19,6 +19,13 @@ c             partition.
 c PPNACGUARD2L adds guard cells in y for vector array, linear
 c              interpolation, and distributed data with non-uniform
 c              partition.
+c PPNCGUARD2LA/PPNCGUARD2LB begin/end copying data to guard cells, so
+c                          that work can be done while the messages
+c                          are in flight.
+c PPNAGUARD2LA/PPNAGUARD2LB begin/end adding guard cells for scalar
+c                          array.
+c PPNACGUARD2LA/PPNACGUARD2LB begin/end adding guard cells for vector
+c                            array.
 c PPTPOSE performs a transpose of a complex scalar array, distributed
 c         in y, to a complex scalar array, distributed in x.
 c PPNTPOSE performs a transpose of an n component complex vector array,
@@ -499,6 +506,297 @@ c add up the guard cells
    40 continue
       return
       end
+c-----------------------------------------------------------------------
+      subroutine PPNCGUARD2LA(f,nyp,kstrt,nvp,nxv,nypmx)
+c this subroutine begins copying data to guard cells in non-uniform
+c partitions, the exchange is completed by PPNCGUARD2LB.
+c between the two calls, f may be read, but not written, except for
+c the guard cells f(j,nyp+1), which may be neither read nor written.
+c f(j,k) = real data for grid j,k in particle partition.
+c the grid is non-uniform and includes one extra guard cell.
+c nyp = number of primary gridpoints in field partition
+c it is assumed the nyp > 0.
+c kstrt = starting data block number
+c nvp = number of real or virtual processors
+c nxv = first dimension of f, must be >= nx
+c nypmx = maximum size of field partition, including guard cell.
+c linear interpolation, for distributed data
+      implicit none
+      integer nyp, kstrt, nvp, nxv, nypmx
+      real f
+      dimension f(nxv,nypmx)
+c common block for parallel processing
+      integer nproc, lgrp, mreal, mint, mcplx, mdouble, lworld
+c lgrp = current communicator
+c mreal = default datatype for reals
+      common /PPARMS/ nproc, lgrp, mreal, mint, mcplx, mdouble, lworld
+c common block for guard cell exchange in progress
+c msidg = requests of exchange
+      integer msidg
+      dimension msidg(2)
+      common /PPGUARD/ msidg
+      save /PPGUARD/
+c local data
+      integer ks, moff, kl, kr, ierr
+c special case for one processor
+      if (nvp.eq.1) return
+      ks = kstrt - 1
+      moff = nypmx*nvp + 2
+c copy to guard cells
+      kr = ks + 1
+      if (kr.ge.nvp) kr = kr - nvp
+      kl = ks - 1
+      if (kl.lt.0)  kl = kl + nvp
+      ks = nyp + 1
+c this segment is used for mpi computers
+      call MPI_IRECV(f(1,ks),nxv,mreal,kr,moff,lgrp,msidg(1),ierr)
+      call MPI_ISEND(f,nxv,mreal,kl,moff,lgrp,msidg(2),ierr)
+      return
+      end
+c-----------------------------------------------------------------------
+      subroutine PPNCGUARD2LB(f,nyp,kstrt,nvp,nxv,nypmx)
+c this subroutine completes copying data to guard cells in non-uniform
+c partitions, begun by PPNCGUARD2LA with the same arguments
+c f(j,k) = real data for grid j,k in particle partition.
+c output: f
+c nyp = number of primary gridpoints in field partition
+c kstrt = starting data block number
+c nvp = number of real or virtual processors
+c nxv = first dimension of f, must be >= nx
+c nypmx = maximum size of field partition, including guard cell.
+c linear interpolation, for distributed data
+      implicit none
+      integer nyp, kstrt, nvp, nxv, nypmx
+      real f
+      dimension f(nxv,nypmx)
+c lstat = length of status array
+      integer lstat
+      parameter(lstat=10)
+c common block for guard cell exchange in progress
+c msidg = requests of exchange
+      integer msidg
+      dimension msidg(2)
+      common /PPGUARD/ msidg
+      save /PPGUARD/
+c local data
+      integer j, istatus, ierr
+      dimension istatus(lstat,2)
+c special case for one processor
+      if (nvp.eq.1) then
+         do 10 j = 1, nxv
+         f(j,nyp+1) = f(j,1)
+   10    continue
+         return
+      endif
+c this segment is used for mpi computers
+      call MPI_WAITALL(2,msidg,istatus,ierr)
+      return
+      end
+c-----------------------------------------------------------------------
+      subroutine PPNAGUARD2LA(f,scr,nyp,nx,kstrt,nvp,nxv,nypmx)
+c this subroutine begins adding data from guard cells in non-uniform
+c partitions, the sum is completed by PPNAGUARD2LB.
+c between the two calls, f may be read and written, except for the
+c guard cells f(j,nyp+1), which may be read but not written.  scr may
+c be neither read nor written.
+c f(j,k) = real data for grid j,k in particle partition.
+c the grid is non-uniform and includes one extra guard cell.
+c scr(j) = scratch array for particle partition
+c nyp = number of primary gridpoints in particle partition
+c it is assumed the nyp > 0.
+c kstrt = starting data block number
+c nvp = number of real or virtual processors
+c nx = system length in x direction
+c nxv = first dimension of f, must be >= nx
+c nypmx = maximum size of field partition, including guard cells.
+c linear interpolation, for distributed data
+      implicit none
+      integer nyp, kstrt, nvp, nx, nxv, nypmx
+      real f, scr
+      dimension f(nxv,nypmx), scr(nxv)
+c common block for parallel processing
+      integer nproc, lgrp, mreal, mint, mcplx, mdouble, lworld
+c lgrp = current communicator
+c mreal = default datatype for reals
+      common /PPARMS/ nproc, lgrp, mreal, mint, mcplx, mdouble, lworld
+c common block for guard cell exchange in progress
+c msidg = requests of exchange
+      integer msidg
+      dimension msidg(2)
+      common /PPGUARD/ msidg
+      save /PPGUARD/
+c local data
+      integer ks, moff, kl, kr, ierr
+c special case for one processor
+      if (nvp.eq.1) return
+      ks = kstrt - 1
+      moff = nypmx*nvp + 1
+c add guard cells
+      kr = ks + 1
+      if (kr.ge.nvp) kr = kr - nvp
+      kl = ks - 1
+      if (kl.lt.0) kl = kl + nvp
+      ks = nyp + 1
+c this segment is used for mpi computers
+      call MPI_IRECV(scr,nxv,mreal,kl,moff,lgrp,msidg(1),ierr)
+      call MPI_ISEND(f(1,ks),nxv,mreal,kr,moff,lgrp,msidg(2),ierr)
+      return
+      end
+c-----------------------------------------------------------------------
+      subroutine PPNAGUARD2LB(f,scr,nyp,nx,kstrt,nvp,nxv,nypmx)
+c this subroutine completes adding data from guard cells in
+c non-uniform partitions, begun by PPNAGUARD2LA with the same
+c arguments
+c f(j,k) = real data for grid j,k in particle partition.
+c output: f, scr
+c scr(j) = scratch array for particle partition
+c nyp = number of primary gridpoints in particle partition
+c kstrt = starting data block number
+c nvp = number of real or virtual processors
+c nx = system length in x direction
+c nxv = first dimension of f, must be >= nx
+c nypmx = maximum size of field partition, including guard cells.
+c linear interpolation, for distributed data
+      implicit none
+      integer nyp, kstrt, nvp, nx, nxv, nypmx
+      real f, scr
+      dimension f(nxv,nypmx), scr(nxv)
+c lstat = length of status array
+      integer lstat
+      parameter(lstat=10)
+c common block for guard cell exchange in progress
+c msidg = requests of exchange
+      integer msidg
+      dimension msidg(2)
+      common /PPGUARD/ msidg
+      save /PPGUARD/
+c local data
+      integer j, nx1, istatus, ierr
+      dimension istatus(lstat,2)
+      nx1 = nx + 1
+c special case for one processor
+      if (nvp.eq.1) then
+         do 10 j = 1, nx1
+         f(j,1) = f(j,1) + f(j,nyp+1)
+         f(j,nyp+1) = 0.
+   10    continue
+         return
+      endif
+c this segment is used for mpi computers
+      call MPI_WAITALL(2,msidg,istatus,ierr)
+c add up the guard cells
+      do 20 j = 1, nx1
+      f(j,1) = f(j,1) + scr(j)
+      f(j,nyp+1) = 0.0
+   20 continue
+      return
+      end
+c-----------------------------------------------------------------------
+      subroutine PPNACGUARD2LA(f,scr,nyp,nx,ndim,kstrt,nvp,nxv,nypmx)
+c this subroutine begins adding data from guard cells in non-uniform
+c partitions, the sum is completed by PPNACGUARD2LB.
+c between the two calls, f may be read and written, except for the
+c guard cells f(:,j,nyp+1), which may be read but not written.  scr
+c may be neither read nor written.
+c f(ndim,j,k) = real data for grid j,k in particle partition.
+c the grid is non-uniform and includes one extra guard cell.
+c scr(ndim,j) = scratch array for particle partition
+c nyp = number of primary gridpoints in particle partition
+c it is assumed the nyp > 0.
+c kstrt = starting data block number
+c nvp = number of real or virtual processors
+c nx = system length in x direction
+c ndim = leading dimension of array f
+c nxv = first dimension of f, must be >= nx
+c nypmx = maximum size of field partition, including guard cells.
+c linear interpolation, for distributed data
+      implicit none
+      integer nyp, kstrt, nvp, nx, ndim, nxv, nypmx
+      real f, scr
+      dimension f(ndim,nxv,nypmx), scr(ndim,nxv)
+c common block for parallel processing
+      integer nproc, lgrp, mreal, mint, mcplx, mdouble, lworld
+c lgrp = current communicator
+c mreal = default datatype for reals
+      common /PPARMS/ nproc, lgrp, mreal, mint, mcplx, mdouble, lworld
+c common block for guard cell exchange in progress
+c msidg = requests of exchange
+      integer msidg
+      dimension msidg(2)
+      common /PPGUARD/ msidg
+      save /PPGUARD/
+c local data
+      integer ks, moff, kl, kr, nnxv, ierr
+c special case for one processor
+      if (nvp.eq.1) return
+      ks = kstrt - 1
+      moff = nypmx*nvp + 1
+      nnxv = ndim*nxv
+c add guard cells
+      kr = ks + 1
+      if (kr.ge.nvp) kr = kr - nvp
+      kl = ks - 1
+      if (kl.lt.0) kl = kl + nvp
+      ks = nyp + 1
+c this segment is used for mpi computers
+      call MPI_IRECV(scr,nnxv,mreal,kl,moff,lgrp,msidg(1),ierr)
+      call MPI_ISEND(f(1,1,ks),nnxv,mreal,kr,moff,lgrp,msidg(2),ierr)
+      return
+      end
+c-----------------------------------------------------------------------
+      subroutine PPNACGUARD2LB(f,scr,nyp,nx,ndim,kstrt,nvp,nxv,nypmx)
+c this subroutine completes adding data from guard cells in
+c non-uniform partitions, begun by PPNACGUARD2LA with the same
+c arguments
+c f(ndim,j,k) = real data for grid j,k in particle partition.
+c output: f, scr
+c scr(ndim,j) = scratch array for particle partition
+c nyp = number of primary gridpoints in particle partition
+c kstrt = starting data block number
+c nvp = number of real or virtual processors
+c nx = system length in x direction
+c ndim = leading dimension of array f
+c nxv = first dimension of f, must be >= nx
+c nypmx = maximum size of field partition, including guard cells.
+c linear interpolation, for distributed data
+      implicit none
+      integer nyp, kstrt, nvp, nx, ndim, nxv, nypmx
+      real f, scr
+      dimension f(ndim,nxv,nypmx), scr(ndim,nxv)
+c lstat = length of status array
+      integer lstat
+      parameter(lstat=10)
+c common block for guard cell exchange in progress
+c msidg = requests of exchange
+      integer msidg
+      dimension msidg(2)
+      common /PPGUARD/ msidg
+      save /PPGUARD/
+c local data
+      integer j, n, nx1, istatus, ierr
+      dimension istatus(lstat,2)
+      nx1 = nx + 1
+c special case for one processor
+      if (nvp.eq.1) then
+         do 20 j = 1, nx1
+         do 10 n = 1, ndim
+         f(n,j,1) = f(n,j,1) + f(n,j,nyp+1)
+         f(n,j,nyp+1) = 0.0
+   10    continue
+   20    continue
+         return
+      endif
+c this segment is used for mpi computers
+      call MPI_WAITALL(2,msidg,istatus,ierr)
+c add up the guard cells
+      do 40 j = 1, nx1
+      do 30 n = 1, ndim
+      f(n,j,1) = f(n,j,1) + scr(n,j)
+      f(n,j,nyp+1) = 0.0
+   30    continue
+   40 continue
+      return
+      end
 c-----------------------------------------------------------------------
       subroutine PPTPOSE(f,g,s,t,nx,ny,kxp,kyp,kstrt,nvp,nxv,nyv,kxpd,  
      1kypd)
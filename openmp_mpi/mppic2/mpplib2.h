@@ -25,6 +25,24 @@ void cppnaguard2l(float f[], float scr[], int nyp, int nx, int kstrt,
 void cppnacguard2l(float f[], float scr[], int nyp, int nx, int ndim,
                    int kstrt, int nvp, int nxv, int nypmx);
 
+void cppncguard2la(float f[], int nyp, int kstrt, int nvp, int nxv,
+                   int nypmx);
+
+void cppncguard2lb(float f[], int nyp, int kstrt, int nvp, int nxv,
+                   int nypmx);
+
+void cppnaguard2la(float f[], float scr[], int nyp, int nx, int kstrt,
+                   int nvp, int nxv, int nypmx);
+
+void cppnaguard2lb(float f[], float scr[], int nyp, int nx, int kstrt,
+                   int nvp, int nxv, int nypmx);
+
+void cppnacguard2la(float f[], float scr[], int nyp, int nx, int ndim,
+                    int kstrt, int nvp, int nxv, int nypmx);
+
+void cppnacguard2lb(float f[], float scr[], int nyp, int nx, int ndim,
+                    int kstrt, int nvp, int nxv, int nypmx);
+
 void cpptpose(float complex f[], float complex g[], float complex s[],
               float complex t[], int nx, int ny, int kxp, int kyp,
               int kstrt, int nvp, int nxv, int nyv, int kxpd, int kypd);
@@ -38,3 +56,7 @@ void cpppmove2(float sbufr[], float sbufl[], float rbufr[],
                float rbufl[], int ncll[], int nclr[], int mcll[],
                int mclr[], int kstrt, int nvp, int idimp, int nbmax,
                int mx1);
+
+float *cppshalloc(int nsize, int nhx);
+
+void cppshfree(float f[]);
@@ -1,6 +1,7 @@
 /* Basic parallel PIC library for MPI communications with OpenMP */
 /* Wrappers for calling the Fortran routines from a C main program */
 
+#include <stdlib.h>
 #include <complex.h>
 
 void ppinit2_(int *idproc, int *nvp, int *argc, char *argv[]);
@@ -28,6 +29,24 @@ void ppnaguard2l_(float *f, float *scr, int *nyp, int *nx, int *kstrt,
 void ppnacguard2l_(float *f, float *scr, int *nyp, int *nx, int *ndim,
                    int *kstrt, int *nvp, int *nxv, int *nypmx);
 
+void ppncguard2la_(float *f, int *nyp, int *kstrt, int *nvp, int *nxv,
+                   int *nypmx);
+
+void ppncguard2lb_(float *f, int *nyp, int *kstrt, int *nvp, int *nxv,
+                   int *nypmx);
+
+void ppnaguard2la_(float *f, float *scr, int *nyp, int *nx, int *kstrt,
+                   int *nvp, int *nxv, int *nypmx);
+
+void ppnaguard2lb_(float *f, float *scr, int *nyp, int *nx, int *kstrt,
+                   int *nvp, int *nxv, int *nypmx);
+
+void ppnacguard2la_(float *f, float *scr, int *nyp, int *nx, int *ndim,
+                    int *kstrt, int *nvp, int *nxv, int *nypmx);
+
+void ppnacguard2lb_(float *f, float *scr, int *nyp, int *nx, int *ndim,
+                    int *kstrt, int *nvp, int *nxv, int *nypmx);
+
 void pptpose_(float complex *f, float complex *g, float complex *s,
               float complex *t, int *nx, int *ny, int *kxp, int *kyp,
               int *kstrt, int *nvp, int *nxv, int *nyv, int *kxpd,
@@ -113,6 +132,48 @@ void cppnacguard2l(float f[], float scr[], int nyp, int nx, int ndim,
    return;
 }
 
+/*--------------------------------------------------------------------*/
+void cppncguard2la(float f[], int nyp, int kstrt, int nvp, int nxv,
+                   int nypmx) {
+   ppncguard2la_(f,&nyp,&kstrt,&nvp,&nxv,&nypmx);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cppncguard2lb(float f[], int nyp, int kstrt, int nvp, int nxv,
+                   int nypmx) {
+   ppncguard2lb_(f,&nyp,&kstrt,&nvp,&nxv,&nypmx);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cppnaguard2la(float f[], float scr[], int nyp, int nx, int kstrt,
+                   int nvp, int nxv, int nypmx) {
+   ppnaguard2la_(f,scr,&nyp,&nx,&kstrt,&nvp,&nxv,&nypmx);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cppnaguard2lb(float f[], float scr[], int nyp, int nx, int kstrt,
+                   int nvp, int nxv, int nypmx) {
+   ppnaguard2lb_(f,scr,&nyp,&nx,&kstrt,&nvp,&nxv,&nypmx);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cppnacguard2la(float f[], float scr[], int nyp, int nx, int ndim,
+                    int kstrt, int nvp, int nxv, int nypmx) {
+   ppnacguard2la_(f,scr,&nyp,&nx,&ndim,&kstrt,&nvp,&nxv,&nypmx);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cppnacguard2lb(float f[], float scr[], int nyp, int nx, int ndim,
+                    int kstrt, int nvp, int nxv, int nypmx) {
+   ppnacguard2lb_(f,scr,&nyp,&nx,&ndim,&kstrt,&nvp,&nxv,&nypmx);
+   return;
+}
+
 /*--------------------------------------------------------------------*/
 void cpptpose(float complex f[], float complex g[], float complex s[],
               float complex t[], int nx, int ny, int kxp, int kyp,
@@ -141,3 +202,16 @@ void cpppmove2(float sbufr[], float sbufl[], float rbufr[],
              &idimp,&nbmax,&mx1);
    return;
 }
+
+/*--------------------------------------------------------------------*/
+float *cppshalloc(int nsize, int nhx) {
+/* the Fortran library has no shared memory windows, so the array is */
+/* allocated in the memory of the processor, and messages are used   */
+   return (float *) malloc(nsize*sizeof(float));
+}
+
+/*--------------------------------------------------------------------*/
+void cppshfree(float f[]) {
+   free(f);
+   return;
+}
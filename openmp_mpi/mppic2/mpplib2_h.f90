@@ -88,6 +88,60 @@
          real, dimension(ndim,nxv), intent(inout) :: scr
          end subroutine
       end interface
+!
+      interface
+         subroutine PPNCGUARD2LA(f,nyp,kstrt,nvp,nxv,nypmx)
+         implicit none
+         integer, intent(in) :: nyp, kstrt, nvp, nxv, nypmx
+         real, dimension(nxv,nypmx), intent(inout) :: f
+         end subroutine
+      end interface
+!
+      interface
+         subroutine PPNCGUARD2LB(f,nyp,kstrt,nvp,nxv,nypmx)
+         implicit none
+         integer, intent(in) :: nyp, kstrt, nvp, nxv, nypmx
+         real, dimension(nxv,nypmx), intent(inout) :: f
+         end subroutine
+      end interface
+!
+      interface
+         subroutine PPNAGUARD2LA(f,scr,nyp,nx,kstrt,nvp,nxv,nypmx)
+         implicit none
+         integer, intent(in) :: nyp, kstrt, nvp, nx, nxv, nypmx
+         real, dimension(nxv,nypmx), intent(inout) :: f
+         real, dimension(nxv), intent(inout) :: scr
+         end subroutine
+      end interface
+!
+      interface
+         subroutine PPNAGUARD2LB(f,scr,nyp,nx,kstrt,nvp,nxv,nypmx)
+         implicit none
+         integer, intent(in) :: nyp, kstrt, nvp, nx, nxv, nypmx
+         real, dimension(nxv,nypmx), intent(inout) :: f
+         real, dimension(nxv), intent(inout) :: scr
+         end subroutine
+      end interface
+!
+      interface
+         subroutine PPNACGUARD2LA(f,scr,nyp,nx,ndim,kstrt,nvp,nxv,nypmx&
+     &)
+         implicit none
+         integer, intent(in) :: ndim, nyp, kstrt, nvp, nx, nxv, nypmx
+         real, dimension(ndim,nxv,nypmx), intent(inout) :: f
+         real, dimension(ndim,nxv), intent(inout) :: scr
+         end subroutine
+      end interface
+!
+      interface
+         subroutine PPNACGUARD2LB(f,scr,nyp,nx,ndim,kstrt,nvp,nxv,nypmx&
+     &)
+         implicit none
+         integer, intent(in) :: ndim, nyp, kstrt, nvp, nx, nxv, nypmx
+         real, dimension(ndim,nxv,nypmx), intent(inout) :: f
+         real, dimension(ndim,nxv), intent(inout) :: scr
+         end subroutine
+      end interface
 !
       interface
          subroutine PPTPOSE(f,g,s,t,nx,ny,kxp,kyp,kstrt,nvp,nxv,nyv,kxpd&
@@ -0,0 +1,17 @@
+/* C header file for proflib.h */
+
+int cprofinit(int nth, int kperf, int idproc);
+
+void cprofbeg(const char *name);
+
+double cprofend();
+
+int cprofopen(const char *fname, int kform);
+
+void cprofstep(int ntime);
+
+int cprofget(double tdata[], int ndata);
+
+void cprofprint(double tdata[], double tmax[], int nproc);
+
+void cprofexit();
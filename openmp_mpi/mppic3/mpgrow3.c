@@ -0,0 +1,507 @@
+/* particle buffer growth library for 3D MPI/OpenMP PIC codes */
+/* written for the skeleton PIC codes */
+
+#include <stdlib.h>
+#include <string.h>
+#include "mpgrow3.h"
+
+/*--------------------------------------------------------------------*/
+int cgrowsize(int nold, int nneed, int nmin, float xtras, int kgrow) {
+/* this function returns a new size for a particle buffer of size nold
+   which needs to hold nneed entries.
+   if nneed > nold, the buffer grows by at least half its size, so that
+   the number of reallocations grows only logarithmically.
+   if kgrow = 2 and less than a quarter of the buffer is needed, it
+   shrinks to (1+xtras)*nneed, but not below nmin.
+   otherwise nold is returned
+   nmin = initial size of buffer
+   xtras = fraction of extra entries kept after shrinking
+   kgrow = (1,2) = (grow only,grow and shrink)
+local data                                                            */
+   int n;
+   if (nneed > nold) {
+      n = nold + nold/2;
+      return nneed > n ? nneed : n;
+   }
+   if ((kgrow==2) && (4*nneed < nold)) {
+      n = (1.0 + xtras)*nneed;
+      return n > nmin ? n : nmin;
+   }
+   return nold;
+}
+
+/*--------------------------------------------------------------------*/
+void *cgrowtile(void *a, int nold, int nnew, int ntile, int nsize) {
+/* this function copies a tiled array a[ntile][nold] with elements of
+   nsize bytes into a newly allocated array b[ntile][nnew], and frees a.
+   the first min(nold,nnew) elements of each tile are copied.
+   returns b, or NULL if there is not enough memory, in which case a is
+   not freed
+local data                                                            */
+   int k, n;
+   char *b;
+   b = (char *) malloc((size_t) nnew*ntile*nsize);
+   if (b==NULL)
+      return NULL;
+   n = nold < nnew ? nold : nnew;
+   for (k = 0; k < ntile; k++) {
+      memcpy(b+(size_t) nnew*nsize*k,(char *) a+(size_t) nold*nsize*k,
+             (size_t) n*nsize);
+   }
+   free(a);
+   return b;
+}
+
+/*--------------------------------------------------------------------*/
+void cppneed3la(int ncl[], int mx1, int myp1, int mzp1, int *nhmax,
+                int *nbmax, int *ncmax) {
+/* this subroutine finds the buffer sizes needed by cppporderf32la to
+   buffer particles leaving tiles and processors, from the number of
+   particles leaving each tile in each direction, as found by
+   cppgppushf32l or cppholes3l.  it must be called before cppporderf32la
+   for distributed data, with 2d domain decomposition in y/z.
+   particles leave the processor in two stages, first in y, then in z.
+   particles leaving through a corner in y and z are sent in y, and are
+   then forwarded by cpppmove32 from the corner processors to the end of
+   the receive buffers in y, so that these need nbmax + 2*ncmax entries
+   if nbmax and ncmax are maximized over processors.
+   tiles are assumed to be arranged in 3D linear memory
+   input: ncl, mx1, myp1, mzp1, output: nhmax, nbmax, ncmax
+   ncl[l][i] = number of particles going to destination i, tile l
+   mx1 = (system length in x direction - 1)/mx + 1
+   myp1 = (partition length in y direction - 1)/my + 1
+   mzp1 = (partition length in z direction - 1)/mz + 1
+   nhmax = maximum number of particles leaving any tile, the size
+   needed for ppbuff and ihole
+   nbmax = maximum number of particles leaving through the lower/back or
+   upper/forward processor boundary, in y or in z
+   ncmax = maximum number of particles leaving through any one of the
+   four corners in y and z, from the first or last layer of tiles in z
+local data                                                            */
+   int mxyp1, mxyzp1, i, j, l, ky, kz, nh, nn, nly, nry, nlz, nrz;
+   int nc[4];
+   mxyp1 = mx1*myp1;
+   mxyzp1 = mxyp1*mzp1;
+   nh = 0;
+   nly = 0;
+   nry = 0;
+   nlz = 0;
+   nrz = 0;
+   for (i = 0; i < 4; i++) {
+      nc[i] = 0;
+   }
+   for (l = 0; l < mxyzp1; l++) {
+      kz = l/mxyp1;
+      ky = (l - mxyp1*kz)/mx1;
+      nn = 0;
+      for (j = 0; j < 26; j++) {
+         nn += ncl[j+26*l];
+      }
+      nh = nn > nh ? nn : nh;
+/* directions 3-5, 12-14, 21-23 go to lower processor in y, */
+/* directions 6-8, 15-17, 24-26 to upper processor in y     */
+      for (i = 0; i < 3; i++) {
+         for (j = 2; j < 5; j++) {
+            if (ky==0)
+               nly += ncl[j+9*i+26*l];
+            if (ky==(myp1-1))
+               nry += ncl[j+3+9*i+26*l];
+         }
+      }
+/* directions 9-17 go to back processor in z, */
+/* directions 18-26 to forward processor in z */
+      for (j = 8; j < 17; j++) {
+         if (kz==0)
+            nlz += ncl[j+26*l];
+         if (kz==(mzp1-1))
+            nrz += ncl[j+9+26*l];
+      }
+/* corners, directions 12-14 and 15-17 from the first layer in z, */
+/* and directions 21-23 and 24-26 from the last layer in z         */
+      for (j = 11; j < 14; j++) {
+         if ((ky==0) && (kz==0))
+            nc[0] += ncl[j+26*l];
+         if ((ky==(myp1-1)) && (kz==0))
+            nc[1] += ncl[j+3+26*l];
+         if ((ky==0) && (kz==(mzp1-1)))
+            nc[2] += ncl[j+9+26*l];
+         if ((ky==(myp1-1)) && (kz==(mzp1-1)))
+            nc[3] += ncl[j+12+26*l];
+      }
+   }
+   nn = nly > nry ? nly : nry;
+   nn = nlz > nn ? nlz : nn;
+   nn = nrz > nn ? nrz : nn;
+   *nhmax = nh;
+   *nbmax = nn;
+   nn = 0;
+   for (i = 0; i < 4; i++) {
+      nn = nc[i] > nn ? nc[i] : nn;
+   }
+   *ncmax = nn;
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+static int cppnin3(int mcl[], int ii, int iis, int mm, int noff) {
+/* this function returns the number of particles coming from direction
+   ii which were received from another processor, as cppporder32lb
+   finds it from the number offsets mcl of the group of three directions
+   starting with iis, for the tile at location mm in the boundary layer.
+   noff = number offset of the first direction of the first tile
+local data                                                            */
+   if (ii==iis) {
+      if (mm > 0)
+         noff = mcl[2+3*(mm-1)];
+   }
+   else {
+      noff = mcl[ii-iis-1+3*mm];
+   }
+   return mcl[ii-iis+3*mm] - noff;
+}
+
+/*--------------------------------------------------------------------*/
+void cppneed3lb(int kpic[], int ncl[], int ihole[], int mcll[],
+                int mclr[], int mcls[], int mx1, int myp1, int mzp1,
+                int mxzyp1, int ntmax, int *nppmax) {
+/* this subroutine finds the size of ppart needed by cppporder32lb to
+   insert incoming particles, from the particle number offsets found by
+   cppporderf32la and received by cpppmove32.  it must be called after
+   cpppmove32 and before cppporder32lb
+   for distributed data, with 2d domain decomposition in y/z.
+   tiles are assumed to be arranged in 3D linear memory
+   input: all, output: nppmax
+   kpic[l] = number of particles in tile l
+   ncl[l][i] = number offset of particles going to destination i,
+   tile l, as found by cppporderf32la
+   ihole[l][0][0] = ih, number of holes left in tile l
+   mcll = number offset being received from lower/back processor
+   mclr = number offset being received from upper/forward processor
+   mcls = number offsets received from corner processors
+   mx1 = (system length in x direction - 1)/mx + 1
+   myp1 = (partition length in y direction - 1)/my + 1
+   mzp1 = (partition length in z direction - 1)/mz + 1
+   mxzyp1 = mx1*max(myp1,mzp1)
+   ntmax = size of hole array for particles leaving tiles
+   nppmax = maximum number of particles held by any tile after particles
+   are reordered, the size needed for ppart
+local data                                                            */
+   int mxyp1, mxzp1, mxyzp1, mc, mcs, l, k, ii, kx, ky, kz, kzs;
+   int kk, kl, kr, ll, lk, lr, kxl, kxr, mm, ip, ncoff, nh, npp, nppp;
+   int ks[26];
+   mxyp1 = mx1*myp1;
+   mxzp1 = mx1*mzp1;
+   mxyzp1 = mxyp1*mzp1;
+/* mc = size of one group of offsets in mcll, mclr */
+/* mcs = size of one corner of offsets in mcls     */
+   mc = 3*mxzyp1;
+   mcs = 3*(mx1 + 1);
+   npp = 0;
+   for (l = 0; l < mxyzp1; l++) {
+      kz = l/mxyp1;
+      k = l - mxyp1*kz;
+      kzs = kz*mx1;
+      lk = kz*mxyp1;
+      ll = (kz - 1)*mxyp1;
+      lr = (kz + 1)*mxyp1;
+      ky = k/mx1;
+      kk = ky*mx1;
+      kl = (ky - 1)*mx1;
+      kr = (ky + 1)*mx1;
+      kx = k - ky*mx1;
+      kxl = kx - 1;
+      if (kxl < 0)
+         kxl += mx1;
+      kxr = kx + 1;
+      if (kxr >= mx1)
+         kxr -= mx1;
+/* find tile number for different directions, as in cppporder32lb */
+/* particles from other processors are marked by -(1 + x tile)    */
+      ks[0] = kxr + kk + lk;
+      ks[1] = kxl + kk + lk;
+      if (ky==(myp1-1)) {
+         ks[2] = -1 - kx;
+         ks[3] = -1 - kxr;
+         ks[4] = -1 - kxl;
+      }
+      else {
+         ks[2] = kx + kr + lk;
+         ks[3] = kxr + kr + lk;
+         ks[4] = kxl + kr + lk;
+      }
+      if (ky==0) {
+         ks[5] = -1 - kx;
+         ks[6] = -1 - kxr;
+         ks[7] = -1 - kxl;
+      }
+      else {
+         ks[5] = kx + kl + lk;
+         ks[6] = kxr + kl + lk;
+         ks[7] = kxl + kl + lk;
+      }
+      if (kz==(mzp1-1)) {
+         ks[8] = -1 - kx;
+         ks[9] = -1 - kxr;
+         ks[10] = -1 - kxl;
+      }
+      else {
+         ks[8] = kx + kk + lr;
+         ks[9] = kxr + kk + lr;
+         ks[10] = kxl + kk + lr;
+      }
+      if ((ky==(myp1-1)) || (kz==(mzp1-1))) {
+         ks[11] = -1 - kx;
+         ks[12] = -1 - kxr;
+         ks[13] = -1 - kxl;
+      }
+      else {
+         ks[11] = kx + kr + lr;
+         ks[12] = kxr + kr + lr;
+         ks[13] = kxl + kr + lr;
+      }
+      if ((ky==0) || (kz==(mzp1-1))) {
+         ks[14] = -1 - kx;
+         ks[15] = -1 - kxr;
+         ks[16] = -1 - kxl;
+      }
+      else {
+         ks[14] = kx + kl + lr;
+         ks[15] = kxr + kl + lr;
+         ks[16] = kxl + kl + lr;
+      }
+      if (kz==0) {
+         ks[17] = -1 - kx;
+         ks[18] = -1 - kxr;
+         ks[19] = -1 - kxl;
+      }
+      else {
+         ks[17] = kx + kk + ll;
+         ks[18] = kxr + kk + ll;
+         ks[19] = kxl + kk + ll;
+      }
+      if ((ky==(myp1-1)) || (kz==0)) {
+         ks[20] = -1 - kx;
+         ks[21] = -1 - kxr;
+         ks[22] = -1 - kxl;
+      }
+      else {
+         ks[20] = kx + kr + ll;
+         ks[21] = kxr + kr + ll;
+         ks[22] = kxl + kr + ll;
+      }
+      if ((ky==0) || (kz==0)) {
+         ks[23] = -1 - kx;
+         ks[24] = -1 - kxr;
+         ks[25] = -1 - kxl;
+      }
+      else {
+         ks[23] = kx + kl + ll;
+         ks[24] = kxr + kl + ll;
+         ks[25] = kxl + kl + ll;
+      }
+/* count particles coming from each direction */
+      nppp = 0;
+      for (ii = 0; ii < 26; ii++) {
+         ip = 0;
+/* particles from tiles on this processor */
+         if (ks[ii] >= 0) {
+            ncoff = ii > 0 ? ncl[ii-1+26*ks[ii]] : 0;
+            ip = ncl[ii+26*ks[ii]] - ncoff;
+         }
+/* particles from other processors, ks[ii] = -(1 + x tile) */
+         else {
+            mm = -1 - ks[ii];
+/* top layer */
+            if (ky==0) {
+               if ((ii >= 5) && (ii <= 7)) {
+                  ip = cppnin3(mcll,ii,5,kzs+mm,0);
+               }
+               else if ((ii >= 14) && (ii <= 16)) {
+                  if (kz < (mzp1-1))
+                     ip = cppnin3(&mcll[mc],ii,14,kzs+mx1+mm,
+                                  mcll[2+3*(mxzp1-1)]);
+                  else
+                     ip = cppnin3(mcls,ii,14,mm,mcls[3*mx1]);
+               }
+               else if ((ii >= 23) && (ii <= 25)) {
+                  if (kz > 0)
+                     ip = cppnin3(&mcll[2*mc],ii,23,kzs-mx1+mm,
+                                  mcll[2+3*(mxzp1-1)+mc]);
+                  else
+                     ip = cppnin3(&mcls[mcs],ii,23,mm,
+                                  mcls[3*mx1+mcs]);
+               }
+            }
+/* bottom layer */
+            if (ky==(myp1-1)) {
+               if ((ii >= 2) && (ii <= 4)) {
+                  ip = cppnin3(mclr,ii,2,kzs+mm,0);
+               }
+               else if ((ii >= 11) && (ii <= 13)) {
+                  if (kz < (mzp1-1))
+                     ip = cppnin3(&mclr[mc],ii,11,kzs+mx1+mm,
+                                  mclr[2+3*(mxzp1-1)]);
+                  else
+                     ip = cppnin3(&mcls[2*mcs],ii,11,mm,
+                                  mcls[3*mx1+2*mcs]);
+               }
+               else if ((ii >= 20) && (ii <= 22)) {
+                  if (kz > 0)
+                     ip = cppnin3(&mclr[2*mc],ii,20,kzs-mx1+mm,
+                                  mclr[2+3*(mxzp1-1)+mc]);
+                  else
+                     ip = cppnin3(&mcls[3*mcs],ii,20,mm,
+                                  mcls[3*mx1+3*mcs]);
+               }
+            }
+/* front layer, corners have already been counted */
+            if (kz==0) {
+               if ((ii >= 17) && (ii <= 19)) {
+                  ip = cppnin3(&mcll[3*mc],ii,17,kk+mm,0);
+               }
+               else if ((ii >= 20) && (ii <= 22)) {
+                  if (ky < (myp1-1))
+                     ip = cppnin3(&mcll[4*mc],ii,20,kr+mm,
+                                  mcll[2+3*(mxyp1-1)+3*mc]);
+               }
+               else if ((ii >= 23) && (ii <= 25)) {
+                  if (ky > 0)
+                     ip = cppnin3(&mcll[5*mc],ii,23,kl+mm,
+                                  mcll[2+3*(mxyp1-1)+4*mc]);
+               }
+            }
+/* back layer, corners have already been counted */
+            if (kz==(mzp1-1)) {
+               if ((ii >= 8) && (ii <= 10)) {
+                  ip = cppnin3(&mclr[3*mc],ii,8,kk+mm,0);
+               }
+               else if ((ii >= 11) && (ii <= 13)) {
+                  if (ky < (myp1-1))
+                     ip = cppnin3(&mclr[4*mc],ii,11,kr+mm,
+                                  mclr[2+3*(mxyp1-1)+3*mc]);
+               }
+               else if ((ii >= 14) && (ii <= 16)) {
+                  if (ky > 0)
+                     ip = cppnin3(&mclr[5*mc],ii,14,kl+mm,
+                                  mclr[2+3*(mxyp1-1)+4*mc]);
+               }
+            }
+         }
+         nppp += ip;
+      }
+/* holes are filled first, the rest is added at the end of the tile */
+      nh = ihole[2*(ntmax+1)*l];
+      nppp = kpic[l] + (nppp > nh ? nppp - nh : 0);
+      npp = nppp > npp ? nppp : npp;
+   }
+   *nppmax = npp;
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cppholes3l(float ppart[], int kpic[], int ncl[], int ihole[],
+                int noff[], int nyzp[], int idimp, int nppmx, int nx,
+                int mx, int my, int mz, int mx1, int myp1, int mxyzp1,
+                int ntmax, int *irc) {
+/* this subroutine finds particles which have left their tile after a
+   push with cppgppushf32l, and stores their number in each direction,
+   location, and destination in ncl and ihole, as cppgppushf32l does.
+   it is used to recover when ihole overflowed in cppgppushf32l, after
+   ihole has been enlarged.  particle positions have already been
+   wrapped by periodic boundary conditions, so the direction in which
+   a particle left is taken from the sign of its velocity.
+   for distributed data, with 2d domain decomposition in y/z.
+   input: all except ncl, ihole, irc, output: ncl, ihole, irc
+   ppart[l][n][0] = position x of particle n in partition in tile l
+   ppart[l][n][1] = position y of particle n in partition in tile l
+   ppart[l][n][2] = position z of particle n in partition in tile l
+   ppart[l][n][3] = velocity vx of particle n in partition in tile l
+   ppart[l][n][4] = velocity vy of particle n in partition in tile l
+   ppart[l][n][5] = velocity vz of particle n in partition in tile l
+   kpic[l] = number of particles in tile l
+   ncl[l][i] = number of particles going to destination i, tile l
+   ihole[l][:][0] = location of hole in array left by departing particle
+   ihole[l][:][1] = direction destination of particle leaving hole
+   all for tile l
+   ihole[l][0][0] = ih, number of holes left (error, if negative)
+   noff[0] = lowermost global gridpoint in y in particle partition
+   noff[1] = backmost global gridpoint in z in particle partition
+   nyzp[0:1] = number of primary (complete) gridpoints in y/z
+   idimp = size of phase space = 6
+   nppmx = maximum number of particles in tile
+   nx = system length in x direction
+   mx/my/mz = number of grids in sorting cell in x/y/z
+   mx1 = (system length in x direction - 1)/mx + 1
+   myp1 = (partition length in y direction - 1)/my + 1
+   mxyzp1 = mx1*myp1*mzp1
+   where mzp1 = (partition length in z direction - 1)/mz + 1
+   ntmax = size of hole array for particles leaving tiles
+   irc = maximum overflow, returned only if error occurs, when irc > 0
+local data                                                            */
+   int mxyp1, noffp, moffp, loffp, nppp, npoff, nn, mm, ll, ih, nh;
+   int ist, j, k, l;
+   float edgelx, edgely, edgelz, edgerx, edgery, edgerz, dx, dy, dz;
+   mxyp1 = mx1*myp1;
+#pragma omp parallel for \
+private(j,k,l,noffp,moffp,loffp,nppp,npoff,nn,mm,ll,ih,nh,ist,dx,dy, \
+dz,edgelx,edgely,edgelz,edgerx,edgery,edgerz)
+   for (l = 0; l < mxyzp1; l++) {
+      loffp = l/mxyp1;
+      k = l - mxyp1*loffp;
+      loffp = mz*loffp;
+      noffp = k/mx1;
+      moffp = my*noffp;
+      noffp = mx*(k - mx1*noffp);
+      nppp = kpic[l];
+      npoff = nppmx*l;
+      nn = nx - noffp;
+      nn = mx < nn ? mx : nn;
+      mm = nyzp[0] - moffp;
+      mm = my < mm ? my : mm;
+      ll = nyzp[1] - loffp;
+      ll = mz < ll ? mz : ll;
+      edgelx = noffp;
+      edgerx = noffp + nn;
+      edgely = noff[0] + moffp;
+      edgery = noff[0] + moffp + mm;
+      edgelz = noff[1] + loffp;
+      edgerz = noff[1] + loffp + ll;
+      ih = 0;
+      nh = 0;
+      for (j = 0; j < 26; j++) {
+         ncl[j+26*l] = 0;
+      }
+/* loop over particles in tile */
+      for (j = 0; j < nppp; j++) {
+         dx = ppart[idimp*(j+npoff)];
+         dy = ppart[1+idimp*(j+npoff)];
+         dz = ppart[2+idimp*(j+npoff)];
+/* ist = direction particle is going */
+         ist = 0;
+         if ((dx < edgelx) || (dx >= edgerx))
+            ist = ppart[3+idimp*(j+npoff)] > 0.0f ? 2 : 1;
+         if ((dy < edgely) || (dy >= edgery))
+            ist += ppart[4+idimp*(j+npoff)] > 0.0f ? 6 : 3;
+         if ((dz < edgelz) || (dz >= edgerz))
+            ist += ppart[5+idimp*(j+npoff)] > 0.0f ? 18 : 9;
+         if (ist > 0) {
+            ncl[ist+26*l-1] += 1;
+            ih += 1;
+            if (ih <= ntmax) {
+               ihole[2*(ih+(ntmax+1)*l)] = j + 1;
+               ihole[1+2*(ih+(ntmax+1)*l)] = ist;
+            }
+            else {
+               nh = 1;
+            }
+         }
+      }
+/* set error */
+      if (nh > 0) {
+         *irc = ih;
+         ih = -ih;
+      }
+      ihole[2*(ntmax+1)*l] = ih;
+   }
+   return;
+}
@@ -0,0 +1,17 @@
+/* header file for mpgrow3.c */
+
+int cgrowsize(int nold, int nneed, int nmin, float xtras, int kgrow);
+
+void *cgrowtile(void *a, int nold, int nnew, int ntile, int nsize);
+
+void cppneed3la(int ncl[], int mx1, int myp1, int mzp1, int *nhmax,
+                int *nbmax, int *ncmax);
+
+void cppneed3lb(int kpic[], int ncl[], int ihole[], int mcll[],
+                int mclr[], int mcls[], int mx1, int myp1, int mzp1,
+                int mxzyp1, int ntmax, int *nppmax);
+
+void cppholes3l(float ppart[], int kpic[], int ncl[], int ihole[],
+                int noff[], int nyzp[], int idimp, int nppmx, int nx,
+                int mx, int my, int mz, int mx1, int myp1, int mxyzp1,
+                int ntmax, int *irc);
@@ -8,6 +8,7 @@
 #include "mppush3.h"
 #include "mpplib3.h"
 #include "omplib.h"
+#include "mpgrow3.h"
 
 void dtimer(double *time, struct timeval *itime, int icntrl);
 
@@ -42,6 +43,9 @@ int main(int argc, char *argv[]) {
    int mx = 8, my = 8, mz = 8;
 /* fraction of extra particles needed for particle management */
    float xtras = 0.2;
+/* kgrow = (0,1,2) = on particle buffer overflow (stop with error,grow */
+/* buffers,grow and shrink buffers)                                     */
+   int kgrow = 1;
 /* declare scalars for standard code */
    int j;
    int nx, ny, nz, nxh, nyh, nzh, nxe, nye, nze, nxeh, nnxe;
@@ -58,6 +62,11 @@ int main(int argc, char *argv[]) {
 /* declare scalars for OpenMP code */
    int nppmx, nppmx0, nbmaxp, ntmaxp, npbmx, irc;
    int nvpp;
+/* nppmin/ntmin/npbmin/nbmin = initial sizes of particle buffers */
+/* nh/nb/nc/nn = buffer sizes needed to reorder particles */
+/* ngrow/nshrink = number of times buffers were enlarged/reduced */
+   int nppmin, ntmin, npbmin, nbmin, nh, nb, nc, nn, n;
+   int ngrow = 0, nshrink = 0;
 
 /* declare arrays for standard code: */
 /* part = particle array */
@@ -77,6 +86,7 @@ int main(int argc, char *argv[]) {
 /* sct = sine/cosine table for FFT */
    float complex *sct = NULL;
    double wtot[4], work[4];
+   int ibflg[4], iwork[4];
 
 /* declare arrays for MPI code: */
 /* bs/br = complex send/receive buffers for data transpose */
@@ -269,6 +279,7 @@ int main(int argc, char *argv[]) {
    mcll = (int *) malloc(3*mxzyp1*6*sizeof(int));
    mclr = (int *) malloc(3*mxzyp1*6*sizeof(int));
    mcls = (int *) malloc(3*(mx1+1)*4*sizeof(int));
+   nppmin = nppmx0; ntmin = ntmaxp; npbmin = npbmx; nbmin = nbmaxp;
 
 /* copy ordered particle data for OpenMP */
    cpppmovin3l(part,ppart,kpic,npp,noff,nppmx0,idimp,npmax,mx,my,mz,mx1,
@@ -371,16 +382,78 @@ L500: if (nloop <= ntime)
       dtimer(&dtime,&itime,1);
       time = (float) dtime;
       tpush += time;
-      if (irc != 0) { 
-         printf("%d,cppgppushf32l error: irc=%d\n",kstrt,irc);
-         cppabort();
-         exit(1);
-      }
 
 /* reorder particles by tile with OpenMP */
 /* first part of particle reorder on x, y and z cell */
 /* with mx, my, mz tiles: */
       dtimer(&dtime,&itime,-1);
+      if ((irc != 0) && (kgrow > 0)) {
+/* enlarge iholep and find departing particles again */
+         cppneed3la(ncl,mx1,myp1,mzp1,&nh,&nb,&nc);
+         ntmaxp = cgrowsize(ntmaxp,nh,ntmin,xtras,1);
+         free(iholep);
+         iholep = (int *) malloc(2*(ntmaxp+1)*mxyzp1*sizeof(int));
+         irc = 0;
+         if (iholep==NULL)
+            irc = -1;
+         else
+            cppholes3l(ppart,kpic,ncl,iholep,noff,nyzp,idimp,nppmx0,nx,
+                       mx,my,mz,mx1,myp1,mxyzp1,ntmaxp,&irc);
+         ngrow += 1;
+      }
+      if (irc != 0) { 
+         printf("%d,cppgppushf32l error: irc=%d\n",kstrt,irc);
+         cppabort();
+         exit(1);
+      }
+/* check particle buffer sizes, enlarge or reduce them if needed */
+/* sbufl, sbufr, rbufl, and rbufr must hold the largest number of */
+/* particles sent by any processor in y or z, and the receive     */
+/* buffers in y also the particles forwarded from two corners     */
+      if (kgrow > 0) {
+         cppneed3la(ncl,mx1,myp1,mzp1,&nh,&nb,&nc);
+         ibflg[0] = nb;
+         ibflg[1] = nc;
+         cppimax(ibflg,iwork,2);
+         n = cgrowsize(nbmaxp,ibflg[0]+2*ibflg[1],nbmin,xtras,kgrow);
+         if (n != nbmaxp) {
+            if (n > nbmaxp) ngrow += 1; else nshrink += 1;
+            nbmaxp = n;
+            free(sbufl); free(sbufr); free(rbufl); free(rbufr);
+            sbufl = (float *) malloc(idimp*nbmaxp*2*sizeof(float));
+            sbufr = (float *) malloc(idimp*nbmaxp*2*sizeof(float));
+            rbufl = (float *) malloc(idimp*nbmaxp*2*sizeof(float));
+            rbufr = (float *) malloc(idimp*nbmaxp*2*sizeof(float));
+            if ((sbufl==NULL) || (sbufr==NULL) || (rbufl==NULL)
+                || (rbufr==NULL))
+               irc = -1;
+         }
+         n = cgrowsize(npbmx,nh,npbmin,xtras,kgrow);
+         if ((n != npbmx) && (irc==0)) {
+            if (n > npbmx) ngrow += 1; else nshrink += 1;
+            npbmx = n;
+            free(ppbuff);
+            ppbuff = (float *) malloc(idimp*npbmx*mxyzp1*sizeof(float));
+            if (ppbuff==NULL)
+               irc = -1;
+         }
+/* iholep holds the holes found by the push, so it is only reduced */
+         n = cgrowsize(ntmaxp,nh,ntmin,xtras,kgrow);
+         if ((n < ntmaxp) && (irc==0)) {
+            nshrink += 1;
+            iholep = (int *) cgrowtile(iholep,ntmaxp+1,n+1,mxyzp1,
+                                       2*sizeof(int));
+            ntmaxp = n;
+            if (iholep==NULL)
+               irc = -1;
+         }
+         if (irc != 0) {
+            printf("%d,particle buffer allocation error: irc=%d\n",
+                   kstrt,irc);
+            cppabort();
+            exit(1);
+         }
+      }
 /* updates ppart, ppbuff, sbufl, sbufr, ncl, iholep, ncll, nclr, irc */
 /*    cppporder32la(ppart,ppbuff,sbufl,sbufr,kpic,ncl,iholep,ncll,     */
 /*                  nclr,noff,nyzp,idimp,nppmx0,nx,ny,nz,mx,my,mz,mx1, */
@@ -415,6 +488,24 @@ L500: if (nloop <= ntime)
 /* second part of particle reorder on x and y cell */
 /* with mx, my, mz tiles: updates ppart, kpic */
       dtimer(&dtime,&itime,-1);
+/* check size of ppart, enlarge or reduce it if needed */
+      if (kgrow > 0) {
+         cppneed3lb(kpic,ncl,iholep,mcll,mclr,mcls,mx1,myp1,mzp1,mxzyp1,
+                    ntmaxp,&nn);
+         n = cgrowsize(nppmx0,nn,nppmin,xtras,kgrow);
+         if (n != nppmx0) {
+            if (n > nppmx0) ngrow += 1; else nshrink += 1;
+            ppart = (float *) cgrowtile(ppart,nppmx0,n,mxyzp1,
+                                        idimp*sizeof(float));
+            nppmx0 = n;
+            if (ppart==NULL) {
+               printf("%d,particle buffer allocation error: nppmx0=%d\n",
+                      kstrt,nppmx0);
+               cppabort();
+               exit(1);
+            }
+         }
+      }
       cppporder32lb(ppart,ppbuff,rbufl,rbufr,kpic,ncl,iholep,mcll,mclr,
                     mcls,idimp,nppmx0,mx1,myp1,mzp1,mxzyp1,npbmx,ntmaxp,
                     nbmaxp,&irc);
@@ -448,9 +539,20 @@ L2000:
 
 /* * * * end main iteration loop * * * */
 
+/* maximum number of buffer resizes on any processor */
+   ibflg[0] = ngrow;
+   ibflg[1] = nshrink;
+   ibflg[2] = nppmx0;
+   ibflg[3] = nbmaxp;
+   cppimax(ibflg,iwork,4);
    if (kstrt==1) {
       printf("ntime = %i\n",ntime);
       printf("MPI nodes nvpy, nvpz = %i,%i\n",nvpy,nvpz);
+      if ((ibflg[0] + ibflg[1]) > 0) {
+         printf("max particle buffers enlarged/reduced = %d,%d\n",
+                ibflg[0],ibflg[1]);
+         printf("max final nppmx0, nbmaxp = %d,%d\n",ibflg[2],ibflg[3]);
+      }
       printf("Final Field, Kinetic and Total Energies:\n");
       printf("%e %e %e\n",we,wke,wke+we);
 
@@ -9,6 +9,7 @@
 #include "omplib.h"
 #include "sselib2.h"
 #include "ssempush2.h"
+#include "cfglib.h"
 
 void dtimer(double *time, struct timeval *itime, int icntrl);
 
@@ -91,6 +92,19 @@ int main(int argc, char *argv[]) {
    nvp = 0;
 /* printf("enter number of nodes:\n"); */
 /* scanf("%i",&nvp);                   */
+/* replace parameters with values from input decks or command line, */
+/* for example: cvmpic2 indx=10 npx=1024 npy=1024                   */
+   irc = ccfgread(argc,argv,1);
+   ccfgint("indx",&indx); ccfgint("indy",&indy); ccfgint("npx",&npx);
+   ccfgint("npy",&npy); ccfgflt("tend",&tend); ccfgflt("dt",&dt);
+   ccfgflt("vtx",&vtx); ccfgflt("vty",&vty); ccfgflt("vx0",&vx0);
+   ccfgflt("vy0",&vy0); ccfgint("mx",&mx); ccfgint("my",&my);
+   ccfgflt("xtras",&xtras); ccfgint("kvec",&kvec); ccfgint("nvp",&nvp);
+   irc += ccfgend();
+   if (irc != 0) {
+      printf("invalid run time parameters\n");
+      exit(1);
+   }
 /* initialize for shared memory parallel processing */
    cinit_omp(nvp);
 
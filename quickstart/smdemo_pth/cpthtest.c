@@ -2,6 +2,7 @@
 #include <stdio.h>
 #include <sys/time.h>
 #include "pthlib.h"
+#include "ptpool.h"
 
 void cadd(float a[], float b[], float c[], int nx) {
    int j;
@@ -19,6 +20,8 @@ int main(int argc, char *argv[])
 /* written by Viktor K. Decyk, UCLA */
 /* nx = size of array, nthreads = number of threads */
    int nx = 1048576, nthreads = 1;
+/* nxs = size of array and ntry = number of calls for overhead test */
+   int nxs = 1024, ntry = 1000;
    int j, irc;
    float eps, epsmax;
 /* timing data */
@@ -80,6 +83,38 @@ int main(int argc, char *argv[])
    }
    printf("maximum difference = %e\n",epsmax);
 
+/* Compare overhead per call of tasks started for each call and of */
+/* persistent thread pool, for a small array                        */
+   dtimer(&dtime,&itime,-1);
+   for (j = 0; j < ntry; j++) {
+      ptadd(p_a,p_b,p_c,nxs,&irc);
+   }
+   dtimer(&dtime,&itime,1);
+   if (irc != 0)
+      printf("ptadd error: irc=%i\n",irc);
+   printf("pthreads tasks time per call=%e\n",(float)dtime/ntry);
+   cinit_ptp(0,0,&irc);
+   if (irc != 0) {
+      printf("thread pool initialization error!\n");
+      exit(1);
+   }
+   dtimer(&dtime,&itime,-1);
+   for (j = 0; j < ntry; j++) {
+      ptpadd(p_a,p_b,p_c,nxs);
+   }
+   dtimer(&dtime,&itime,1);
+   printf("thread pool time per call=%e\n",(float)dtime/ntry);
+   epsmax = 0.0;
+   for (j = 0; j < nxs; j++) {
+      eps = a[j] - p_a[j];
+      if (eps < 0.0)
+         eps = -eps;
+      if (eps > epsmax)
+         epsmax = eps;
+   }
+   printf("maximum difference = %e\n",epsmax);
+   cend_ptp();
+
 /* deallocate memory for Pthreads */
    free(p_a);
    free(p_b);
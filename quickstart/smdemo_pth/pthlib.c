@@ -4,6 +4,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include "LnxMP.h"
+#include "ptpool.h"
 #include "pthlib.h"
 
 
@@ -12,6 +13,11 @@
 static int nthreads = 1;
 static int idtask[MAXTHREADS];
 
+/* arguments of vector add for thread pool */
+struct paddargs {
+   float *a, *b, *c;
+};
+
 /*--------------------------------------------------------------------*/
 void padd(float a[], float b[], float c[], int *nx) {
    int j, lx;
@@ -82,6 +88,30 @@ void ptadd(float *a, float *b, float *c, int nx, int *irc) {
    return;
 }
 
+/*--------------------------------------------------------------------*/
+static void ptpaddt(void *arg, int ith, int nb, int ne) {
+/* vector add of elements nb to ne-1, performed by thread ith */
+/* local data */
+   struct paddargs *p;
+   int nxp;
+   p = (struct paddargs *) arg;
+   nxp = ne - nb;
+   padd(&p->a[nb],&p->b[nb],&p->c[nb],&nxp);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void ptpadd(float *a, float *b, float *c, int nx) {
+/* vector add with the persistent thread pool started by cinit_ptp */
+/* local data */
+   struct paddargs args;
+   args.a = a;
+   args.b = b;
+   args.c = c;
+   cptpfor(ptpaddt,&args,nx);
+   return;
+}
+
 /*--------------------------------------------------------------------*/
 void end_pt() {
 /* terminate pthreads library */
@@ -6,4 +6,6 @@ void copy_memptr(float *f, float *p_f, int nsize);
 
 void ptadd(float *a, float *b, float *c, int nx, int *irc);
 
+void ptpadd(float *a, float *b, float *c, int nx);
+
 void end_pt();
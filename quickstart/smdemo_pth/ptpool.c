@@ -0,0 +1,234 @@
+/* persistent thread pool library based on Pthreads */
+/* the worker threads are created once by cinit_ptp and then wait for */
+/* work in a spin loop, so that starting a parallel loop costs about   */
+/* as much as a barrier, rather than the creation of a thread          */
+/* written for the skeleton PIC codes */
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sched.h>
+#include <pthread.h>
+#include "ptpool.h"
+
+/* MAXPTH = maximum number of threads in pool */
+#define MAXPTH                  256
+/* NSPIN = number of spins before an idle worker thread sleeps */
+#define NSPIN                   100000
+
+/* internal common block for pool
+   nthreads = number of threads in pool, including the caller
+   ncpus = number of processors found
+   kaffin = (0,1) = (no,yes) thread i is pinned to processor i mod ncpus
+   ptid = pthread_t records of worker threads
+   pmutex/pcond = mutex and condition variable for sleeping workers
+   jproc/jarg/jn = procedure, argument and loop count of current job
+   jgen = job generation, incremented for each new job
+   jend = (0,1) = (no,yes) workers should exit
+   nsleep = number of workers sleeping on pcond
+   bcount/bsense = arrival count and sense of barrier
+   lsense = local sense of barrier for each thread                 */
+static int nthreads = 1, ncpus = 1, kaffin = 0;
+static pthread_t ptid[MAXPTH];
+static pthread_mutex_t pmutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pcond = PTHREAD_COND_INITIALIZER;
+static void (*jproc)(void *arg, int ith, int nb, int ne) = NULL;
+static void *jarg = NULL;
+static int jn = 0;
+static int jgen = 0, jend = 0, nsleep = 0;
+static int bcount = 0, bsense = 0;
+static int lsense[MAXPTH];
+
+/*--------------------------------------------------------------------*/
+static void cptpin(int ith) {
+/* pin the calling thread to processor ith mod ncpus, where available
+local data                                                            */
+#ifdef __linux__
+   cpu_set_t cset;
+   CPU_ZERO(&cset);
+   CPU_SET(ith%ncpus,&cset);
+   if (pthread_setaffinity_np(pthread_self(),sizeof(cset),&cset))
+      printf("cannot pin thread %d to processor %d\n",ith,ith%ncpus);
+#endif
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+static void cptrun(int ith) {
+/* thread ith performs its block of iterations of the current job.
+   the procedure is called even if the block is empty, so that it can
+   use cptpbarrier
+local data                                                            */
+   int nb, ne;
+   nb = ((long) jn*ith)/nthreads;
+   ne = ((long) jn*(ith + 1))/nthreads;
+   jproc(jarg,ith,nb,ne);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+static void *cptworker(void *arg) {
+/* main loop of worker thread: wait for the next job, spinning first and
+   then sleeping on a condition variable, perform it, and wait at the
+   barrier which ends the job
+local data                                                            */
+   int ith, gen, i;
+   ith = (int) (long) arg;
+   if (kaffin)
+      cptpin(ith);
+   gen = 0;
+   while (1) {
+      i = 0;
+      while (__atomic_load_n(&jgen,__ATOMIC_SEQ_CST)==gen) {
+         if (i < NSPIN) {
+            i += 1;
+            if (nthreads > ncpus)
+               sched_yield();
+            continue;
+         }
+         pthread_mutex_lock(&pmutex);
+         __atomic_add_fetch(&nsleep,1,__ATOMIC_SEQ_CST);
+         while (__atomic_load_n(&jgen,__ATOMIC_SEQ_CST)==gen) {
+            pthread_cond_wait(&pcond,&pmutex);
+         }
+         __atomic_sub_fetch(&nsleep,1,__ATOMIC_SEQ_CST);
+         pthread_mutex_unlock(&pmutex);
+      }
+      gen += 1;
+      if (jend)
+         break;
+      cptrun(ith);
+      cptpbarrier(ith);
+   }
+   return NULL;
+}
+
+/*--------------------------------------------------------------------*/
+static void cptpost() {
+/* start the next job: wake the workers, spinning or sleeping
+local data                                                            */
+   __atomic_add_fetch(&jgen,1,__ATOMIC_SEQ_CST);
+   if (__atomic_load_n(&nsleep,__ATOMIC_SEQ_CST) > 0) {
+      pthread_mutex_lock(&pmutex);
+      pthread_cond_broadcast(&pcond);
+      pthread_mutex_unlock(&pmutex);
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cinit_ptp(int nth, int kaff, int *irc) {
+/* initialize the thread pool
+   nth = number of threads, including the caller, if nth > 0,
+   otherwise the number of processors found
+   kaff = (0,1) = (no,yes) pin thread i to processor i mod ncpus
+   irc = error indicator, modified only if there is an error
+local data                                                            */
+   int i;
+   ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+   if (ncpus < 1)
+      ncpus = 1;
+   printf("number of cpus found = %d\n",ncpus);
+   nthreads = nth > 0 ? nth : ncpus;
+   if (nthreads > MAXPTH)
+      nthreads = MAXPTH;
+   printf("using %d pool thread(s)\n",nthreads);
+   kaffin = kaff;
+   jgen = 0;
+   jend = 0;
+   nsleep = 0;
+   bcount = 0;
+   bsense = 0;
+   for (i = 0; i < nthreads; i++) {
+      lsense[i] = 0;
+   }
+   if (kaffin)
+      cptpin(0);
+/* start worker threads */
+   for (i = 1; i < nthreads; i++) {
+      if (pthread_create(&ptid[i],NULL,cptworker,(void *) (long) i)) {
+         printf("pthread_create error for thread %d\n",i);
+         *irc = 1;
+         jend = 1;
+         cptpost();
+         for (nth = 1; nth < i; nth++) {
+            pthread_join(ptid[nth],NULL);
+         }
+         nthreads = 1;
+         return;
+      }
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+int cgetnth_ptp() {
+/* returns number of threads in pool */
+   return nthreads;
+}
+
+/*--------------------------------------------------------------------*/
+void cptpfor(void (*proc)(void *arg, int ith, int nb, int ne),
+             void *arg, int n) {
+/* performs the loop for (i = 0; i < n; i++) with the pool, and returns
+   after all threads have finished.  thread ith calls
+   proc(arg,ith,nb,ne) once, for its block of iterations nb <= i < ne,
+   which may be empty.  the blocks are contiguous and in thread order.
+   proc may call cptpbarrier(ith) to synchronize all threads in the job.
+   cptpfor must be called by the thread which called cinit_ptp
+local data                                                            */
+   if (nthreads==1) {
+      proc(arg,0,0,n);
+      return;
+   }
+   jproc = proc;
+   jarg = arg;
+   jn = n;
+   cptpost();
+   cptrun(0);
+   cptpbarrier(0);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cptpbarrier(int ith) {
+/* sense reversing spin barrier for all threads of the pool, where ith
+   is the thread number.  each thread flips its local sense, the last
+   thread to arrive resets the count and releases the others by setting
+   the global sense to the local one, so the barrier can be reused at
+   once without a second phase
+local data                                                            */
+   int s;
+   if (nthreads==1)
+      return;
+   s = 1 - lsense[ith];
+   lsense[ith] = s;
+   if (__atomic_add_fetch(&bcount,1,__ATOMIC_ACQ_REL)==nthreads) {
+      __atomic_store_n(&bcount,0,__ATOMIC_RELAXED);
+      __atomic_store_n(&bsense,s,__ATOMIC_RELEASE);
+   }
+   else {
+      while (__atomic_load_n(&bsense,__ATOMIC_ACQUIRE) != s) {
+         if (nthreads > ncpus)
+            sched_yield();
+      }
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cend_ptp() {
+/* stop the worker threads of the pool
+local data                                                            */
+   int i;
+   if (nthreads==1)
+      return;
+   jend = 1;
+   cptpost();
+   for (i = 1; i < nthreads; i++) {
+      pthread_join(ptid[i],NULL);
+   }
+   nthreads = 1;
+   return;
+}
@@ -0,0 +1,241 @@
+/* asynchronous diagnostic writer library */
+/* written for the skeleton PIC codes */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <complex.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "diag2.h"
+
+/* MAGIC = first word of file, the characters "PKD2" */
+/* NHEAD = number of words in file header */
+#define MAGIC                 0x32444b50
+#define NHEAD                 8
+
+/* ring buffer of records, written only by the time loop (producer) at
+   ihead and read only by the writer thread (consumer) at itail.  the
+   indices increase without bound, a record is in slot index%nring.
+   each index is stored only by its owner with release order and read
+   by the other side with acquire order, so no locks are needed */
+static float complex *ring = NULL;
+static int *rtime = NULL;
+static float *rwe = NULL;
+static int nring = 0;
+static int nmode = 0;
+static unsigned long ihead = 0;
+static unsigned long itail = 0;
+static int kdone = 0;
+static int kerr = 0;
+
+static FILE *unit = NULL;
+static pthread_t writer;
+/* nrec = number of records written, twait = time producer waited */
+static int nrec = 0;
+static double twait = 0.0;
+
+/*--------------------------------------------------------------------*/
+static void cdiagnap(long nsec) {
+/* sleep for nsec nanoseconds */
+   struct timespec ts;
+   ts.tv_sec = 0;
+   ts.tv_nsec = nsec;
+   nanosleep(&ts,NULL);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+static double cdiagclock() {
+/* return monotonic time in seconds */
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC,&ts);
+   return (double) ts.tv_sec + 1.0e-9*(double) ts.tv_nsec;
+}
+
+/*--------------------------------------------------------------------*/
+static void *cdiagwrite(void *arg) {
+/* writer thread: copies all records between itail and ihead to the
+   file, then advances itail, until kdone is set and the ring is empty.
+   while the ring is empty the thread sleeps, doubling the sleep from
+   50 microseconds up to 10 milliseconds, so that an idle writer does
+   not take time from the time loop when both share a processor
+local data                                                            */
+   unsigned long it, ih;
+   int i, done;
+   long nap;
+   it = itail;
+   nap = 50000;
+   while (1) {
+      done = __atomic_load_n(&kdone,__ATOMIC_ACQUIRE);
+      ih = __atomic_load_n(&ihead,__ATOMIC_ACQUIRE);
+      if (ih==it) {
+         if (done)
+            break;
+         cdiagnap(nap);
+         nap = nap < 5000000 ? 2*nap : 10000000;
+         continue;
+      }
+      nap = 50000;
+      for ( ; it < ih; it++) {
+         i = it%nring;
+         if (kerr)
+            continue;
+         if ((fwrite(&rtime[i],sizeof(int),1,unit) != 1) ||
+             (fwrite(&rwe[i],sizeof(float),1,unit) != 1) ||
+             (fwrite(&ring[nmode*i],sizeof(float complex),nmode,unit)
+              != nmode))
+            kerr = 1;
+         else
+            nrec += 1;
+      }
+      fflush(unit);
+      __atomic_store_n(&itail,it,__ATOMIC_RELEASE);
+   }
+   return arg;
+}
+
+/*--------------------------------------------------------------------*/
+int cdiagopen2(const char *fname, int nx, int ny, int modesx,
+               int modesy, int modesxd, int modesyd, int nrecs) {
+/* open time series file fname for unpacked fourier modes, and start the
+   background writer thread.  if the file already exists with the same
+   header, new records are appended to it, otherwise it is created.
+   the file header contains NHEAD int words: MAGIC, version = 1, nx, ny,
+   modesx, modesy, modesxd, modesyd, and is followed by one record per
+   diagnostic, containing an int time step, a float energy, and
+   modesxd*modesyd float complex modes, in native byte order.
+   a partial record at the end of an existing file, left by an
+   interrupted run, is removed before appending.
+   nx/ny = system length in x/y direction
+   modesx/modesy = number of modes stored in x/y direction
+   modesxd/modesyd = dimensions of unpacked modes array
+   nrecs = number of records in ring buffer, at least 2
+   returns 1 if the file cannot be opened or written, 2 if an existing
+   file has a different header, 3 if out of memory or the thread cannot
+   be started, 0 otherwise
+local data                                                            */
+   int ihdr[NHEAD], ifile[NHEAD];
+   long lrec, lsize;
+   struct stat st;
+   nmode = modesxd*modesyd;
+   nring = nrecs > 2 ? nrecs : 2;
+   ihdr[0] = MAGIC; ihdr[1] = 1; ihdr[2] = nx; ihdr[3] = ny;
+   ihdr[4] = modesx; ihdr[5] = modesy; ihdr[6] = modesxd;
+   ihdr[7] = modesyd;
+   lrec = sizeof(int) + sizeof(float) + nmode*sizeof(float complex);
+/* check existing file */
+   unit = fopen(fname,"rb");
+   if (unit != NULL) {
+      if (fread(ifile,sizeof(int),NHEAD,unit) != NHEAD) {
+         fclose(unit);
+         return 2;
+      }
+      fclose(unit);
+      if (memcmp(ihdr,ifile,sizeof(ihdr)))
+         return 2;
+/* remove partial record */
+      if (stat(fname,&st))
+         return 1;
+      lsize = (long) st.st_size - sizeof(ihdr);
+      if (lsize%lrec) {
+         if (truncate(fname,sizeof(ihdr)+lrec*(lsize/lrec)))
+            return 1;
+      }
+      unit = fopen(fname,"ab");
+      if (unit==NULL)
+         return 1;
+   }
+/* create new file */
+   else {
+      unit = fopen(fname,"wb");
+      if (unit==NULL)
+         return 1;
+      if (fwrite(ihdr,sizeof(int),NHEAD,unit) != NHEAD) {
+         fclose(unit);
+         unit = NULL;
+         return 1;
+      }
+   }
+   ring = (float complex *) malloc(nring*nmode*sizeof(float complex));
+   rtime = (int *) malloc(nring*sizeof(int));
+   rwe = (float *) malloc(nring*sizeof(float));
+   ihead = 0; itail = 0;
+   kdone = 0; kerr = 0;
+   nrec = 0; twait = 0.0;
+   if ((ring==NULL) || (rtime==NULL) || (rwe==NULL) ||
+       pthread_create(&writer,NULL,cdiagwrite,NULL)) {
+      free(ring); free(rtime); free(rwe);
+      ring = NULL; rtime = NULL; rwe = NULL;
+      fclose(unit);
+      unit = NULL;
+      return 3;
+   }
+   return 0;
+}
+
+/*--------------------------------------------------------------------*/
+float complex *cdiagbuf2() {
+/* return the next free record in the ring buffer, of size
+   modesxd*modesyd, to be filled by the caller, for example by
+   crdmodes2, and then released with cdiagpost2.  if the ring is full
+   the caller waits for the writer thread, and the time waited is
+   accumulated
+local data                                                            */
+   unsigned long it;
+   double tbeg;
+   it = __atomic_load_n(&itail,__ATOMIC_ACQUIRE);
+   if ((ihead - it) >= nring) {
+      tbeg = cdiagclock();
+      do {
+         cdiagnap(50000);
+         it = __atomic_load_n(&itail,__ATOMIC_ACQUIRE);
+      } while ((ihead - it) >= nring);
+      twait += cdiagclock() - tbeg;
+   }
+   return &ring[nmode*(ihead%nring)];
+}
+
+/*--------------------------------------------------------------------*/
+void cdiagpost2(int ntime, float we) {
+/* release the record obtained with cdiagbuf2 to the writer thread
+   ntime = current time step
+   we = field energy, or other scalar to be stored with the record
+local data                                                            */
+   int i;
+   i = ihead%nring;
+   rtime[i] = ntime;
+   rwe[i] = we;
+   __atomic_store_n(&ihead,ihead+1,__ATOMIC_RELEASE);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+int cdiagclose2(int *nrecs, float *tw) {
+/* wait for the writer thread to store all pending records, then close
+   the file and free the ring buffer
+   nrecs = number of records written since cdiagopen2
+   tw = time in seconds the time loop waited for a free record
+   returns 1 if a write error occurred, 0 otherwise
+local data                                                            */
+   int ierr;
+   *nrecs = 0;
+   *tw = 0.0;
+   if (unit==NULL)
+      return 0;
+   __atomic_store_n(&kdone,1,__ATOMIC_RELEASE);
+   pthread_join(writer,NULL);
+   ierr = kerr;
+   if (fclose(unit))
+      ierr = 1;
+   unit = NULL;
+   free(ring); free(rtime); free(rwe);
+   ring = NULL; rtime = NULL; rwe = NULL;
+   *nrecs = nrec;
+   *tw = twait;
+   return ierr;
+}
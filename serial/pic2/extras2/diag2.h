@@ -0,0 +1,10 @@
+/* header file for diag2.c */
+
+int cdiagopen2(const char *fname, int nx, int ny, int modesx,
+               int modesy, int modesxd, int modesyd, int nrecs);
+
+float complex *cdiagbuf2();
+
+void cdiagpost2(int ntime, float we);
+
+int cdiagclose2(int *nrecs, float *tw);
@@ -1,18 +1,28 @@
 /*---------------------------------------------------------------------*/
 /* Skeleton 2D Electrostatic PIC code */
 /* written by Viktor K. Decyk, UCLA */
+#define _POSIX_C_SOURCE 200112L
 #include <stdlib.h>
 #include <stdio.h>
 #include <complex.h>
-#include <sys/time.h>
+#include <math.h>
+#include <sys/resource.h>
 #include "push2.h"
-
-void dtimer(double *time, struct timeval *itime, int icntrl);
+#include "push2x.h"
+#include "proflib.h"
+#include "cfglib.h"
+#include "extras2/field2.h"
+#include "extras2/diag2.h"
 
 int main(int argc, char *argv[]) {
 /* indx/indy = exponent which determines grid points in x/y direction: */
 /* nx = 2**indx, ny = 2**indy */
    int indx =   9, indy =   9;
+/* nxr/nyr = number of grid points in x/y direction for mixed radix fft, */
+/* if nxr > 0, nx = nxr, ny = nyr replace 2**indx, 2**indy,              */
+/* nyr = 0 means nyr = nxr,                                              */
+/* nxr/nyr must be even and contain only factors 2, 3, 5 and 7           */
+   int nxr =   0, nyr =   0;
 /* npx/npy = number of electrons distributed in x/y direction */
    int npx =  3072, npy =   3072;
 /* ndim = number of velocity coordinates = 2 */
@@ -32,147 +42,405 @@ int main(int argc, char *argv[]) {
    int idimp = 4, ipbc = 1, sortime = 50;
 /* wke/we/wt = particle kinetic/electric field/total energy */
    float wke = 0.0, we = 0.0, wt = 0.0;
+/* kpart = (1,2,3) = run (array of structures,structure of arrays, */
+/* compressed) version                                              */
+   int kpart = 1;
+/* ncomp = size of compressed phase space for kpart = 3:    */
+/* (3,4) = (16 bit bfloat16,32 bit float) velocities         */
+   int ncomp = 4;
+/* norder = interpolation order = (1,2,3) = (linear,quadratic,cubic) */
+/* norder > 1 requires kpart = 1                                     */
+   int norder = 1;
+/* ksort = (1,2,3) = sort particles by (y grid with second particle */
+/* array, y grid in place, x,y cell in place), ksort > 1 requires   */
+/* kpart = 1                                                        */
+   int ksort = 1;
+/* kcurve = (0,1,2) = order cells for sorting along (row,Morton,Hilbert) */
+/* curve, kcurve > 0 requires ksort = 1 and kpart = 1                    */
+/* nblok = curve granularity, in cells                                   */
+   int kcurve = 0, nblok = 1;
+/* kfuse = (0,1) = (separate,fused) push and deposit,         */
+/* kfuse = 1 requires kpart = 1 and norder = 1                */
+   int kfuse = 0;
+/* ndiag = number of time steps between potential diagnostics, whose */
+/* low order fourier modes are written to the file potk2.bin by a    */
+/* background thread, ndiag = 0 means no diagnostics                 */
+   int ndiag = 0;
+/* kprof = (0,1,2,3) = print (no profile,profile summary,summary and  */
+/* per step CSV file prof.csv,summary and per step JSON file prof.json) */
+/* kperf = (0,1) = (no,yes) read hardware counters in profile         */
+   int kprof = 0, kperf = 0;
 /* declare scalars for standard code */
-   int j;
-   int np, nx, ny, nxh, nyh, nxe, nye, nxeh, nxyh, nxhy;
-   int ny1, ntime, nloop, isign;
+   int j, irc;
+   int npe, np, nx, ny, nxh, nyh, nxe, nye, nxeh, nxyh, nxhy;
+   int nxv, nyv;
+   int ny1, nxy1, nsort, ntime, nloop, isign;
    float qbme, affp;
+   double mpart, msort;
+/* declare scalars for diagnostics */
+   int modesx, modesy, modesxd, modesyd, nrec;
+   float wd, twait;
 
 /* declare arrays for standard code: */
 /* part, part2 = particle arrays */
    float *part = NULL, *part2 = NULL, *tpart = NULL;
+/* partt, partt2 = transposed (structure of arrays) particle arrays */
+   float *partt = NULL, *partt2 = NULL;
+/* cpart, cpart2 = compressed particle arrays */
+   unsigned int *cpart = NULL, *cpart2 = NULL, *tcpart = NULL;
 /* qe = electron charge density with guard cells */
    float *qe = NULL;
 /* fxye = smoothed electric field with guard cells */
    float *fxye = NULL;
+/* qs/fxys = charge density/smoothed electric field with guard cells */
+/* on both sides, for norder > 1                                     */
+   float *qs = NULL, *fxys = NULL;
 /* ffc = form factor array for poisson solver */
    float complex *ffc = NULL;
 /* mixup = bit reverse table for FFT */
    int *mixup = NULL;
 /* sct = sine/cosine table for FFT */
    float complex *sct = NULL;
-/* npicy = scratch array for reordering particles */
+/* kcell = position of each cell along space filling curve */
+   int *kcell = NULL;
+/* npicy = scratch array for reordering particles, */
+/* dimension nsort = ny1 (ksort=1), 2*ny1 (ksort=2), 2*nxy1 (ksort=3) */
    int *npicy = NULL;
+/* potc = potential in fourier space, for diagnostics */
+   float complex *potc = NULL;
   
 /* declare and initialize timing data */
    float time;
-   struct timeval itime;
    float tdpost = 0.0, tguard = 0.0, tfft = 0.0, tfield = 0.0;
-   float tpush = 0.0, tsort = 0.0;
-   double dtime;
+   float tpush = 0.0, tsort = 0.0, tdiag = 0.0;
+/* tprof = profile data for each region, dimension 5*64 */
+   double tprof[320];
+/* wsum/wsum2 = sum of field energy and its square, for noise estimate */
+   double wsum = 0.0, wsum2 = 0.0;
+
+/* replace parameters with values from input decks or command line, */
+/* for example: cpic2 indx=10 npx=1024 npy=1024                     */
+   irc = ccfgread(argc,argv,1);
+   ccfgint("indx",&indx); ccfgint("indy",&indy); ccfgint("nxr",&nxr);
+   ccfgint("nyr",&nyr); ccfgint("npx",&npx); ccfgint("npy",&npy);
+   ccfgflt("tend",&tend); ccfgflt("dt",&dt); ccfgflt("vtx",&vtx);
+   ccfgflt("vty",&vty); ccfgflt("vx0",&vx0); ccfgflt("vy0",&vy0);
+   ccfgint("sortime",&sortime); ccfgint("kpart",&kpart);
+   ccfgint("ncomp",&ncomp); ccfgint("norder",&norder);
+   ccfgint("ksort",&ksort); ccfgint("kcurve",&kcurve);
+   ccfgint("nblok",&nblok); ccfgint("kfuse",&kfuse);
+   ccfgint("ndiag",&ndiag);
+   ccfgint("kprof",&kprof); ccfgint("kperf",&kperf);
+   irc += ccfgend();
+   if (irc != 0) {
+      printf("invalid run time parameters\n");
+      exit(1);
+   }
 
 /* initialize scalars for standard code */
 /* np = total number of particles in simulation */
 /* nx/ny = number of grid points in x/y direction */
    np = npx*npy; nx = 1L<<indx; ny = 1L<<indy;
+   if ((nxr < 0) || (nyr < 0)) {
+      printf("invalid nxr, nyr = %d,%d\n",nxr,nyr);
+      exit(1);
+   }
+   if (nxr > 0) {
+/* nyr defaults to nxr */
+      if (nyr==0)
+         nyr = nxr;
+      nx = nxr; ny = nyr;
+   }
    nxh = nx/2; nyh = 1 > ny/2 ? 1 : ny/2;
    nxe = nx + 2; nye = ny + 1; nxeh = nxe/2;
    nxyh = (nx > ny ? nx : ny)/2; nxhy = nxh > ny ? nxh : ny;
-   ny1 = ny + 1;
+/* nxv/nyv = dimensions of extended arrays for spline interpolation */
+   nxv = nx + 3; nyv = ny + 3;
+/* mixed radix fft tables hold separate x and y parts */
+   if (nxr > 0) {
+      nxyh = nx + ny; nxhy = nxh + ny;
+   }
+   ny1 = ny + 1; nxy1 = (nx + 1)*ny1;
+   nsort = ny1;
+   if (ksort==2)
+      nsort = 2*ny1;
+   else if (ksort==3)
+      nsort = 2*nxy1;
+   if (kcurve > 0)
+      nsort = nxy1;
 /* nloop = number of time steps in simulation */
 /* ntime = current time step */
    nloop = tend/dt + .0001; ntime = 0;
+/* npe = first dimension of transposed particle arrays, */
+/* padded to a multiple of 16 for 64 byte alignment     */
+   npe = 16*((np - 1)/16 + 1);
    qbme = qme;
    affp = (float) (nx*ny)/(float ) np;
 
 /* allocate data for standard code */
    part = (float *) malloc(idimp*np*sizeof(float));
-   if (sortime > 0)
+   if ((sortime > 0) && (ksort==1) && (kpart==1))
       part2 = (float *) malloc(idimp*np*sizeof(float));
    qe = (float *) malloc(nxe*nye*sizeof(float));
    fxye = (float *) malloc(ndim*nxe*nye*sizeof(float));
    ffc = (float complex *) malloc(nxh*nyh*sizeof(float complex));
    mixup = (int *) malloc(nxhy*sizeof(int));
    sct = (float complex *) malloc(nxyh*sizeof(float complex));
-   npicy = (int *) malloc(ny1*sizeof(int));
+   npicy = (int *) malloc(nsort*sizeof(int));
+   if ((ksort < 1) || (ksort > 3) || ((ksort > 1) && (kpart != 1))) {
+      printf("invalid ksort, kpart = %d,%d\n",ksort,kpart);
+      exit(1);
+   }
+   if ((kfuse < 0) || (kfuse > 1) || ((kfuse==1) && ((kpart != 1) ||
+       (norder != 1)))) {
+      printf("invalid kfuse = %d\n",kfuse);
+      exit(1);
+   }
+   if (kcurve > 0) {
+      if ((kcurve > 2) || (nblok < 1)) {
+         printf("invalid kcurve, nblok = %d,%d\n",kcurve,nblok);
+         exit(1);
+      }
+      if ((ksort != 1) || (kpart != 1)) {
+         printf("kcurve > 0 requires ksort = 1 and kpart = 1: ");
+         printf("kcurve, ksort, kpart = %d,%d,%d\n",kcurve,ksort,kpart);
+         exit(1);
+      }
+      kcell = (int *) malloc(nxy1*sizeof(int));
+      cscurve2(kcell,nx,ny,nblok,kcurve);
+   }
+   if (norder > 1) {
+      if ((kpart != 1) || (norder > 3)) {
+         printf("invalid norder, kpart = %d,%d\n",norder,kpart);
+         exit(1);
+      }
+      qs = (float *) malloc(nxv*nyv*sizeof(float));
+      fxys = (float *) malloc(ndim*nxv*nyv*sizeof(float));
+   }
+   if ((kpart < 1) || (kpart > 3) || ((kpart==3) && ((ncomp < 3) ||
+       (ncomp > 4) || (nx > 65536) || (ny > 65536)))) {
+      printf("invalid kpart, ncomp = %d,%d\n",kpart,ncomp);
+      exit(1);
+   }
+   if (kpart==3) {
+      cpart = (unsigned int *) malloc(ncomp*np*sizeof(unsigned int));
+      if (sortime > 0)
+         cpart2 = (unsigned int *) malloc(ncomp*np*sizeof(unsigned int));
+   }
+   if (kpart==2) {
+      if (posix_memalign((void **)&partt,64,idimp*npe*sizeof(float))) {
+         printf("partt allocation error\n");
+         exit(1);
+      }
+      if (sortime > 0) {
+         if (posix_memalign((void **)&partt2,64,
+                            idimp*npe*sizeof(float))) {
+            printf("partt2 allocation error\n");
+            exit(1);
+         }
+      }
+   }
+/* modesx/modesy = number of modes stored in x/y direction */
+   modesx = nx/4; modesy = ny/4;
+   modesxd = modesx; modesyd = 2*modesy - 1;
+   modesyd = modesyd < ny ? modesyd : ny;
+   if (ndiag > 0) {
+      potc = (float complex *) malloc(nxeh*nye*sizeof(float complex));
+/* open time series file and start background writer */
+      irc = cdiagopen2("potk2.bin",nx,ny,modesx,modesy,modesxd,modesyd,
+                       16);
+      if (irc != 0) {
+         printf("cdiagopen2 error: irc = %d\n",irc);
+         exit(1);
+      }
+   }
 
 /* prepare fft tables */
-   cwfft2rinit(mixup,sct,indx,indy,nxhy,nxyh);
+   if (nxr > 0) {
+      if (cwfft2rminit(mixup,sct,nx,ny,nxhy,nxyh)) {
+         printf("mixed radix fft error: nx, ny = %d,%d\n",nx,ny);
+         exit(1);
+      }
+   }
+   else
+      cwfft2rinit(mixup,sct,indx,indy,nxhy,nxyh);
 /* calculate form factors */
    isign = 0;
    cpois22((float complex *)qe,(float complex *)fxye,isign,ffc,ax,ay,affp,
             &we,nx,ny,nxeh,nye,nxh,nyh);
 /* initialize electrons */
    cdistr2(part,vtx,vty,vx0,vy0,npx,npy,idimp,np,nx,ny,ipbc);
+/* copy electrons to transposed particle array, and release part */
+   if (kpart==2) {
+      cpart2t(part,partt,idimp,np,npe);
+      free(part);
+      part = NULL;
+   }
+/* copy electrons to compressed particle array, and release part */
+   else if (kpart==3) {
+      cpart2c(part,cpart,idimp,ncomp,np,nx,ny);
+      free(part);
+      part = NULL;
+   }
+
+/* initialize profiler */
+   if (cprofinit(1,kperf,0)==1)
+      printf("hardware counters not available\n");
+   if (kprof==2)
+      cprofopen("prof.csv",1);
+   else if (kprof==3)
+      cprofopen("prof.json",2);
 
 /* * * * start main iteration loop * * * */
  
 L500: if (nloop <= ntime)
          goto L2000;
 /*    printf("ntime = %i\n",ntime); */
+      cprofbeg("step");
  
 /* deposit charge with standard procedure: updates qe */
-      dtimer(&dtime,&itime,-1);
-      for (j = 0; j < nxe*nye; j++) {
-         qe[j] = 0.0;
+/* with fused push and deposit, only needed for first time step */
+      cprofbeg("deposit");
+      if ((kfuse==0) || (ntime==0)) {
+         if (norder > 1) {
+            for (j = 0; j < nxv*nyv; j++) {
+               qs[j] = 0.0;
+            }
+            cgpost2s(part,qs,qme,np,idimp,nxv,nyv,norder);
+         }
+         else {
+            for (j = 0; j < nxe*nye; j++) {
+               qe[j] = 0.0;
+            }
+            if (kpart==1)
+               cgpost2l(part,qe,qme,np,idimp,nxe,nye);
+            else if (kpart==2)
+               cgpost2lt(partt,qe,qme,np,npe,idimp,nxe,nye);
+            else if (kpart==3)
+               cgpost2c(cpart,qe,qme,ncomp,np,nxe,nye);
+         }
       }
-      cgpost2l(part,qe,qme,np,idimp,nxe,nye);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tdpost += time;
+      tdpost += cprofend();
 
 /* add guard cells with standard procedure: updates qe */
-      dtimer(&dtime,&itime,-1);
-      caguard2l(qe,nx,ny,nxe,nye);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tguard += time;
+      cprofbeg("guard");
+      if (norder > 1)
+         caguard2s(qs,qe,nx,ny,nxe,nye,nxv,nyv);
+      else
+         caguard2l(qe,nx,ny,nxe,nye);
+      tguard += cprofend();
 
 /* transform charge to fourier space with standard procedure: updates qe */
-      dtimer(&dtime,&itime,-1);
+      cprofbeg("fft");
       isign = -1;
-      cwfft2rx((float complex *)qe,isign,mixup,sct,indx,indy,nxeh,nye,
-               nxhy,nxyh);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tfft += time;
+      if (nxr > 0)
+         cwfft2rmx((float complex *)qe,isign,mixup,sct,nx,ny,nxeh,nye,
+                   nxhy,nxyh);
+      else
+         cwfft2rx((float complex *)qe,isign,mixup,sct,indx,indy,nxeh,nye,
+                  nxhy,nxyh);
+      tfft += cprofend();
+
+/* potential diagnostic, low order modes are unpacked directly into */
+/* the ring buffer of the background writer: updates potc, wd       */
+      if ((ndiag > 0) && (ntime%ndiag==0)) {
+         cprofbeg("diag");
+         cpotp2((float complex *)qe,potc,ffc,&wd,nx,ny,nxeh,nye,nxh,nyh);
+         crdmodes2(potc,cdiagbuf2(),nx,ny,modesx,modesy,nxeh,nye,modesxd,
+                   modesyd);
+         cdiagpost2(ntime,wd);
+         tdiag += cprofend();
+      }
 
 /* calculate force/charge in fourier space with standard procedure: */
 /* updates fxye, we                                                 */
-      dtimer(&dtime,&itime,-1);
+      cprofbeg("field");
       isign = -1;
       cpois22((float complex *)qe,(float complex *)fxye,isign,ffc,ax,ay,
               affp,&we,nx,ny,nxeh,nye,nxh,nyh);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tfield += time;
+      wsum += we;
+      wsum2 += we*we;
+      tfield += cprofend();
 
 /* transform force to real space with standard procedure: updates fxye */
-      dtimer(&dtime,&itime,-1);
+      cprofbeg("fft");
       isign = 1;
-      cwfft2r2((float complex *)fxye,isign,mixup,sct,indx,indy,nxeh,nye,
-               nxhy,nxyh);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tfft += time;
+      if (nxr > 0)
+         cwfft2rm2((float complex *)fxye,isign,mixup,sct,nx,ny,nxeh,nye,
+                   nxhy,nxyh);
+      else
+         cwfft2r2((float complex *)fxye,isign,mixup,sct,indx,indy,nxeh,
+                  nye,nxhy,nxyh);
+      tfft += cprofend();
 
 /* copy guard cells with standard procedure: updates fxye */
-      dtimer(&dtime,&itime,-1);
-      ccguard2l(fxye,nx,ny,nxe,nye);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tguard += time;
+      cprofbeg("guard");
+      if (norder > 1)
+         ccguard2s(fxye,fxys,nx,ny,nxe,nye,nxv,nyv);
+      else
+         ccguard2l(fxye,nx,ny,nxe,nye);
+      tguard += cprofend();
 
 /* push particles with standard procedure: updates part, wke */
       wke = 0.0;
-      dtimer(&dtime,&itime,-1);
-      cgpush2l(part,fxye,qbme,dt,&wke,idimp,np,nx,ny,nxe,nye,ipbc);
-      dtimer(&dtime,&itime,1);
-      time = (float) dtime;
-      tpush += time;
+      cprofbeg("push");
+      if (norder > 1)
+         cgpush2s(part,fxys,qbme,dt,&wke,idimp,np,nx,ny,nxv,nyv,ipbc,
+                  norder);
+/* fused push also deposits charge for next time step: updates qe */
+      else if (kfuse==1) {
+         for (j = 0; j < nxe*nye; j++) {
+            qe[j] = 0.0;
+         }
+         cgpushpost2l(part,fxye,qe,qbme,qme,dt,&wke,idimp,np,nx,ny,nxe,
+                      nye,ipbc);
+      }
+      else if (kpart==1)
+         cgpush2l(part,fxye,qbme,dt,&wke,idimp,np,nx,ny,nxe,nye,ipbc);
+      else if (kpart==2)
+         cgpush2lt(partt,fxye,qbme,dt,&wke,idimp,np,npe,nx,ny,nxe,nye,
+                   ipbc);
+      else if (kpart==3)
+         cgpush2c(cpart,fxye,qbme,dt,&wke,ncomp,np,nx,ny,nxe,nye,ipbc);
+      tpush += cprofend();
 
 /* sort particles by cell for standard procedure */
       if (sortime > 0) {
          if (ntime%sortime==0) {
-            dtimer(&dtime,&itime,-1);
-            cdsortp2yl(part,part2,npicy,idimp,np,ny1);
+            cprofbeg("sort");
+            if (kcurve > 0) {
+               cssortp2l(part,part2,npicy,kcell,idimp,np,nx+1,nxy1);
+/* exchange pointers */
+               tpart = part;
+               part = part2;
+               part2 = tpart;
+            }
+            else if (ksort==2)
+               cisortp2yl(part,npicy,idimp,np,ny1);
+            else if (ksort==3)
+               cisortp2xyl(part,npicy,idimp,np,nx+1,nxy1);
+            else if (kpart==1) {
+               cdsortp2yl(part,part2,npicy,idimp,np,ny1);
+/* exchange pointers */
+               tpart = part;
+               part = part2;
+               part2 = tpart;
+            }
+            else if (kpart==2) {
+               cdsortp2ylt(partt,partt2,npicy,idimp,np,npe,ny1);
 /* exchange pointers */
-            tpart = part;
-            part = part2;
-            part2 = tpart;
-            dtimer(&dtime,&itime,1);
-            time = (float) dtime;
-            tsort += time;
+               tpart = partt;
+               partt = partt2;
+               partt2 = tpart;
+            }
+            else if (kpart==3) {
+               cdsortp2yc(cpart,cpart2,npicy,ncomp,np,ny1);
+/* exchange pointers */
+               tcpart = cpart;
+               cpart = cpart2;
+               cpart2 = tcpart;
+            }
+            tsort += cprofend();
          }
       }
 
@@ -180,15 +448,46 @@ L500: if (nloop <= ntime)
          printf("Initial Field, Kinetic and Total Energies:\n");
          printf("%e %e %e\n",we,wke,wke+we);
       }
+      cprofend();
+      cprofstep(ntime);
       ntime += 1;
       goto L500;
 L2000:
 
 /* * * * end main iteration loop * * * */
 
+/* wait for background writer to store remaining diagnostics */
+   if (ndiag > 0) {
+      cprofbeg("diag");
+      if (cdiagclose2(&nrec,&twait))
+         printf("potk2.bin write error\n");
+      tdiag += cprofend();
+   }
+
+/* copy electrons back to standard particle array */
+   if (kpart==2) {
+      free(partt2);
+      partt2 = NULL;
+      part = (float *) malloc(idimp*np*sizeof(float));
+      cpartt2(partt,part,idimp,np,npe);
+   }
+   else if (kpart==3) {
+      free(cpart2);
+      cpart2 = NULL;
+      part = (float *) malloc(idimp*np*sizeof(float));
+      ccpart2(cpart,part,idimp,ncomp,np);
+   }
+
    printf("ntime = %i\n",ntime);
    printf("Final Field, Kinetic and Total Energies:\n");
    printf("%e %e %e\n",we,wke,wke+we);
+/* field energy fluctuation measures particle noise */
+   wsum = wsum/(double) ntime;
+   wsum2 = wsum2/(double) ntime - wsum*wsum;
+   wsum2 = wsum2 > 0.0 ? sqrt(wsum2) : 0.0;
+   printf("Average and RMS Fluctuation of Field Energy, norder = %d:\n",
+          norder);
+   printf("%e %e\n",wsum,wsum2);
 
    printf("\n");
    printf("deposit time = %f\n",tdpost);
@@ -203,6 +502,10 @@ L2000:
    printf("total particle time = %f\n",time);
    wt = time + tfield;
    printf("total time = %f\n",wt);
+   if (ndiag > 0) {
+      printf("diagnostic time = %f, records = %d, wait time = %f\n",
+             tdiag,nrec,twait);
+   }
    printf("\n");
 
    wt = 1.0e+09/(((float) nloop)*((float) np));
@@ -210,6 +513,34 @@ L2000:
    printf("Deposit Time (nsec) = %f\n",tdpost*wt);
    printf("Sort Time (nsec) = %f\n",tsort*wt);
    printf("Total Particle Time (nsec) = %f\n",time*wt);
+   printf("\n");
+
+/* particle and sort memory used in the main loop, in MBytes: */
+/* part, partt or cpart, and part2, partt2 or cpart2 for sorting */
+   mpart = (double) idimp*(kpart==2 ? npe : np)*sizeof(float);
+   if (kpart==3)
+      mpart = (double) ncomp*np*sizeof(unsigned int);
+   msort = (double) nsort*sizeof(int);
+   if ((sortime > 0) && (ksort==1))
+      msort += mpart;
+   wt = 1.0/(1024.0*1024.0);
+   printf("ksort = %d\n",ksort);
+   printf("Particle Memory (MB) = %f\n",mpart*wt);
+   printf("Sort Memory (MB) = %f\n",msort*wt);
+   {
+      struct rusage usage;
+      if (!getrusage(RUSAGE_SELF,&usage))
+         printf("Maximum Resident Memory (MB) = %f\n",
+                (double) usage.ru_maxrss/1024.0);
+   }
+
+/* print profile */
+   if (kprof > 0) {
+      printf("\n");
+      cprofget(tprof,320);
+      cprofprint(tprof,tprof,1);
+   }
+   cprofexit();
 
    return 0;
 }
@@ -0,0 +1,2277 @@
+/* C Library for Skeleton 2D Electrostatic PIC Code */
+/* procedures with no Fortran77 equivalent in push2.f, linked with */
+/* both push2.c and push2_f.c */
+/* written for the skeleton PIC codes */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <complex.h>
+#include <math.h>
+#include "push2.h"
+#include "push2x.h"
+
+/*--------------------------------------------------------------------*/
+void cgpushpost2l(float part[], float fxy[], float q[], float qbm,
+                  float qm, float dt, float *ek, int idimp, int nop,
+                  int nx, int ny, int nxv, int nyv, int ipbc) {
+/* for 2d code, this subroutine updates particle co-ordinates and
+   velocities using leap-frog scheme in time and first-order linear
+   interpolation in space, with various boundary conditions, and
+   deposits the charge at the new positions, so that each particle is
+   read from memory only once per time step
+   scalar version using guard cells
+   61 flops/particle, 16 loads, 8 stores
+   input: all, output: part, q, ek
+   equations used are:
+   vx(t+dt/2) = vx(t-dt/2) + (q/m)*fx(x(t),y(t))*dt,
+   vy(t+dt/2) = vy(t-dt/2) + (q/m)*fy(x(t),y(t))*dt,
+   where q/m is charge/mass, and
+   x(t+dt) = x(t) + vx(t+dt/2)*dt, y(t+dt) = y(t) + vy(t+dt/2)*dt
+   fx(x(t),y(t)) and fy(x(t),y(t)) are approximated by interpolation from
+   the nearest grid points:
+   fx(x,y) = (1-dy)*((1-dx)*fx(n,m)+dx*fx(n+1,m)) + dy*((1-dx)*fx(n,m+1)
+      + dx*fx(n+1,m+1))
+   fy(x,y) = (1-dy)*((1-dx)*fy(n,m)+dx*fy(n+1,m)) + dy*((1-dx)*fy(n,m+1)
+      + dx*fy(n+1,m+1))
+   where n,m = leftmost grid points and dx = x-n, dy = y-m
+   charge density at time t+dt is approximated by values at the nearest
+   grid points:
+   q(n,m)=qm*(1.-dx)*(1.-dy)
+   q(n+1,m)=qm*dx*(1.-dy)
+   q(n,m+1)=qm*(1.-dx)*dy
+   q(n+1,m+1)=qm*dx*dy
+   where n,m = leftmost grid points and dx = x(t+dt)-n, dy = y(t+dt)-m
+   part[n][0] = position x of particle n
+   part[n][1] = position y of particle n
+   part[n][2] = velocity vx of particle n
+   part[n][3] = velocity vy of particle n
+   fxy[k][j][0] = x component of force/charge at grid (j,k)
+   fxy[k][j][1] = y component of force/charge at grid (j,k)
+   that is, convolution of electric field over particle shape
+   q[k][j] = charge density at grid point j,k
+   qbm = particle charge/mass
+   qm = charge on particle, in units of e
+   dt = time interval between successive calculations
+   kinetic energy/mass at time t is also calculated, using
+   ek = .125*sum((vx(t+dt/2)+vx(t-dt/2))**2+(vy(t+dt/2)+vy(t-dt/2))**2)
+   idimp = size of phase space = 4
+   nop = number of particles
+   nx/ny = system length in x/y direction
+   nxv = first dimension of field arrays, must be >= nx+1
+   nyv = second dimension of field arrays, must be >= ny+1
+   ipbc = particle boundary condition = (0,1,2,3) =
+   (none,2d periodic,2d reflecting,mixed reflecting/periodic)
+local data                                                            */
+   int j, nn, mm, np, mp, nxv2;
+   float qtm, edgelx, edgely, edgerx, edgery, dxp, dyp, amx, amy;
+   float dx, dy, vx, vy;
+   double sum1;
+   nxv2 = 2*nxv;
+   qtm = qbm*dt;
+   sum1 = 0.0;
+/* set boundary values */
+   edgelx = 0.0;
+   edgely = 0.0;
+   edgerx = (float) nx;
+   edgery = (float) ny;
+   if (ipbc==2) {
+      edgelx = 1.0;
+      edgely = 1.0;
+      edgerx = (float) (nx-1);
+      edgery = (float) (ny-1);
+   }
+   else if (ipbc==3) {
+      edgelx = 1.0;
+      edgerx = (float) (nx-1);
+   }
+   for (j = 0; j < nop; j++) {
+/* find interpolation weights */
+      nn = part[idimp*j];
+      mm = part[1+idimp*j];
+      dxp = part[idimp*j] - (float) nn;
+      dyp = part[1+idimp*j] - (float) mm;
+      nn = 2*nn;
+      mm = nxv2*mm;
+      amx = 1.0 - dxp;
+      mp = mm + nxv2;
+      amy = 1.0 - dyp;
+      np = nn + 2;
+/* find acceleration */
+      dx = dyp*(dxp*fxy[np+mp] + amx*fxy[nn+mp])
+         + amy*(dxp*fxy[np+mm] + amx*fxy[nn+mm]);
+      dy = dyp*(dxp*fxy[1+np+mp] + amx*fxy[1+nn+mp])
+         + amy*(dxp*fxy[1+np+mm] + amx*fxy[1+nn+mm]);
+/* new velocity */
+      vx = part[2+idimp*j];
+      vy = part[3+idimp*j];
+      dx = vx + qtm*dx;
+      dy = vy + qtm*dy;
+/* average kinetic energy */
+      vx += dx;
+      vy += dy;
+      sum1 += vx*vx + vy*vy;
+      part[2+idimp*j] = dx;
+      part[3+idimp*j] = dy;
+/* new position */
+      dx = part[idimp*j] + dx*dt;
+      dy = part[1+idimp*j] + dy*dt;
+/* periodic boundary conditions */
+      if (ipbc==1) {
+         if (dx < edgelx) dx += edgerx;
+         if (dx >= edgerx) dx -= edgerx;
+         if (dy < edgely) dy += edgery;
+         if (dy >= edgery) dy -= edgery;
+      }
+/* reflecting boundary conditions */
+      else if (ipbc==2) {
+         if ((dx < edgelx) || (dx >= edgerx)) {
+            dx = part[idimp*j];
+            part[2+idimp*j] = -part[2+idimp*j];
+         }
+         if ((dy < edgely) || (dy >= edgery)) {
+            dy = part[1+idimp*j];
+            part[3+idimp*j] = -part[3+idimp*j];
+         }
+      }
+/* mixed reflecting/periodic boundary conditions */
+      else if (ipbc==3) {
+         if ((dx < edgelx) || (dx >= edgerx)) {
+            dx = part[idimp*j];
+            part[2+idimp*j] = -part[2+idimp*j];
+         }
+         if (dy < edgely) dy += edgery;
+         if (dy >= edgery) dy -= edgery;
+      }
+/* set new position */
+      part[idimp*j] = dx;
+      part[1+idimp*j] = dy;
+/* find interpolation weights at new position */
+      nn = dx;
+      mm = dy;
+      dxp = qm*(dx - (float) nn);
+      dyp = dy - (float) mm;
+      mm = nxv*mm;
+      amx = qm - dxp;
+      mp = mm + nxv;
+      amy = 1.0 - dyp;
+      np = nn + 1;
+/* deposit charge */
+      q[np+mp] += dxp*dyp;
+      q[nn+mp] += amx*dyp;
+      q[np+mm] += dxp*amy;
+      q[nn+mm] += amx*amy;
+   }
+/* normalize kinetic energy */
+   *ek += 0.125*sum1;
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cisortp2yl(float part[], int npic[], int idimp, int nop,
+                int ny1) {
+/* this subroutine sorts particles by y grid in place, using a counting
+   sort where misplaced particles are swapped directly into the next
+   free slot of their grid, so that no second particle array is needed
+   linear interpolation
+   part = particle array, sorted on output
+   part[n][1] = position y of particle n
+   npic = address offsets for reordering particles, dimension 2*ny1
+   npic[k] = next free address, npic[ny1+k] = first address for grid k
+   idimp = size of phase space = 4
+   nop = number of particles
+   ny1 = system length in y direction + 1
+local data                                                            */
+   int i, j, k, m, isum, ist, ip, iend;
+   float at1;
+/* clear counter array */
+   for (k = 0; k < ny1; k++) {
+      npic[k] = 0;
+   }
+/* find how many particles in each grid */
+   for (j = 0; j < nop; j++) {
+      m = part[1+idimp*j];
+      npic[m] += 1;
+   }
+/* find address offset */
+   isum = 0;
+   for (k = 0; k < ny1; k++) {
+      ist = npic[k];
+      npic[k] = isum;
+      npic[ny1+k] = isum;
+      isum += ist;
+   }
+/* move particles at each grid into place, following swaps */
+   for (k = 0; k < ny1; k++) {
+      iend = k < (ny1-1) ? npic[ny1+k+1] : nop;
+      j = npic[k];
+      while (j < iend) {
+         m = part[1+idimp*j];
+         if (m==k) {
+            j += 1;
+            continue;
+         }
+/* swap particle j with first free particle in grid m */
+         ip = npic[m];
+         npic[m] = ip + 1;
+         for (i = 0; i < idimp; i++) {
+            at1 = part[i+idimp*ip];
+            part[i+idimp*ip] = part[i+idimp*j];
+            part[i+idimp*j] = at1;
+         }
+      }
+      npic[k] = iend;
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cisortp2xyl(float part[], int npic[], int idimp, int nop, int nx1,
+                 int nxy1) {
+/* this subroutine sorts particles by x,y grid in place, using a
+   counting sort where misplaced particles are swapped directly into
+   the next free slot of their cell, so that no second particle array is
+   needed.  sorting by cell rather than by y grid keeps the particles
+   which deposit to the same grid points adjacent in memory
+   linear interpolation
+   part = particle array, sorted on output
+   part[n][0] = position x of particle n
+   part[n][1] = position y of particle n
+   npic = address offsets for reordering particles, dimension 2*nxy1
+   npic[k] = next free address, npic[nxy1+k] = first address for cell k
+   idimp = size of phase space = 4
+   nop = number of particles
+   nx1 = system length in x direction + 1
+   nxy1 = nx1*ny1, where ny1 = system length in y direction + 1
+local data                                                            */
+   int i, j, k, n, m, isum, ist, ip, iend;
+   float at1;
+/* clear counter array */
+   for (k = 0; k < nxy1; k++) {
+      npic[k] = 0;
+   }
+/* find how many particles in each cell */
+   for (j = 0; j < nop; j++) {
+      n = part[idimp*j];
+      m = part[1+idimp*j];
+      m = n + nx1*m;
+      npic[m] += 1;
+   }
+/* find address offset */
+   isum = 0;
+   for (k = 0; k < nxy1; k++) {
+      ist = npic[k];
+      npic[k] = isum;
+      npic[nxy1+k] = isum;
+      isum += ist;
+   }
+/* move particles at each cell into place, following swaps */
+   for (k = 0; k < nxy1; k++) {
+      iend = k < (nxy1-1) ? npic[nxy1+k+1] : nop;
+      j = npic[k];
+      while (j < iend) {
+         n = part[idimp*j];
+         m = part[1+idimp*j];
+         m = n + nx1*m;
+         if (m==k) {
+            j += 1;
+            continue;
+         }
+/* swap particle j with first free particle in cell m */
+         ip = npic[m];
+         npic[m] = ip + 1;
+         for (i = 0; i < idimp; i++) {
+            at1 = part[i+idimp*ip];
+            part[i+idimp*ip] = part[i+idimp*j];
+            part[i+idimp*j] = at1;
+         }
+      }
+      npic[k] = iend;
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cscurve(int ix[], int ih, int nbit, int ndim, int kcurve) {
+/* this subroutine finds the coordinates of point ih along a Morton or
+   Hilbert space filling curve, using the transposed representation of
+   J. Skilling, AIP Conf. Proc. 707, 381 (2004)
+   ix = output coordinates of point ih, each in the range 0:2**nbit-1
+   ih = index of point along curve, 0 <= ih < 2**(nbit*ndim)
+   nbit = number of bits per coordinate
+   ndim = number of dimensions
+   kcurve = (1,2) = (Morton,Hilbert) curve
+local data                                                            */
+   int i, j, k, it, ip, iq, nn;
+/* distribute the bits of ih over the coordinates, most significant */
+/* bit first, which is the Morton order                             */
+   for (i = 0; i < ndim; i++) {
+      ix[i] = 0;
+   }
+   k = nbit*ndim;
+   for (j = 0; j < nbit; j++) {
+      for (i = 0; i < ndim; i++) {
+         k -= 1;
+         ix[i] = (ix[i] << 1) | ((ih >> k) & 1);
+      }
+   }
+   if ((kcurve != 2) || (nbit < 1))
+      return;
+/* gray decode */
+   it = ix[ndim-1] >> 1;
+   for (i = ndim-1; i > 0; i--) {
+      ix[i] ^= ix[i-1];
+   }
+   ix[0] ^= it;
+/* undo excess work */
+   nn = 2 << (nbit - 1);
+   for (iq = 2; iq != nn; iq <<= 1) {
+      ip = iq - 1;
+      for (i = ndim-1; i >= 0; i--) {
+/* invert */
+         if (ix[i] & iq) {
+            ix[0] ^= ip;
+         }
+/* exchange */
+         else {
+            it = (ix[0] ^ ix[i]) & ip;
+            ix[0] ^= it;
+            ix[i] ^= it;
+         }
+      }
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cscurve2(int kcell[], int nx, int ny, int nblok, int kcurve) {
+/* this subroutine numbers the cells of a 2d grid along a space filling
+   curve.  the grid is divided into blocks of nblok x nblok cells which
+   are visited in Morton or Hilbert order, and the cells within a block
+   are visited in row order.  guard cells are numbered last
+   kcell[m][n] = position of cell (n,m) along curve
+   nx/ny = system length in x/y direction
+   nblok = curve granularity, in cells
+   kcurve = (0,1,2) = (row,Morton,Hilbert) order
+local data                                                            */
+   int i, j, k, n, m, nx1, ny1, nbx, nby, nbit, ih, nh, isum;
+   int ix[2];
+   nx1 = nx + 1; ny1 = ny + 1;
+   nbx = (nx - 1)/nblok + 1; nby = (ny - 1)/nblok + 1;
+   if (kcurve==0) {
+      nbx = 1; nby = 1; nblok = nx > ny ? nx : ny;
+   }
+/* find number of bits needed for largest block coordinate */
+   nbit = 0;
+   while ((1 << nbit) < (nbx > nby ? nbx : nby)) {
+      nbit += 1;
+   }
+   nh = 1 << (2*nbit);
+/* mark all cells as guard cells */
+   for (k = 0; k < nx1*ny1; k++) {
+      kcell[k] = -1;
+   }
+/* visit blocks along curve, skipping those outside the grid */
+   isum = 0;
+   for (ih = 0; ih < nh; ih++) {
+      cscurve(ix,ih,nbit,2,kcurve);
+      if ((ix[0] >= nbx) || (ix[1] >= nby))
+         continue;
+      for (j = 0; j < nblok; j++) {
+         m = j + nblok*ix[1];
+         if (m >= ny)
+            break;
+         for (i = 0; i < nblok; i++) {
+            n = i + nblok*ix[0];
+            if (n >= nx)
+               break;
+            kcell[n+nx1*m] = isum;
+            isum += 1;
+         }
+      }
+   }
+/* number guard cells */
+   for (k = 0; k < nx1*ny1; k++) {
+      if (kcell[k] < 0) {
+         kcell[k] = isum;
+         isum += 1;
+      }
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cssortp2l(float parta[], float partb[], int npic[], int kcell[],
+               int idimp, int nop, int nx1, int nxy1) {
+/* this subroutine sorts particles by cell, with the cells ordered
+   along a space filling curve
+   linear interpolation
+   parta/partb = input/output particle arrays
+   parta[n][0] = position x of particle n
+   parta[n][1] = position y of particle n
+   npic = address offset for reordering particles
+   kcell = position of each cell along curve, from cscurve2
+   idimp = size of phase space = 4
+   nop = number of particles
+   nx1 = system length in x direction + 1
+   nxy1 = nx1*ny1, where ny1 = system length in y direction + 1
+local data                                                            */
+   int i, j, k, n, m, isum, ist, ip;
+/* clear counter array */
+   for (k = 0; k < nxy1; k++) {
+      npic[k] = 0;
+   }
+/* find how many particles in each cell */
+   for (j = 0; j < nop; j++) {
+      n = parta[idimp*j];
+      m = parta[1+idimp*j];
+      m = kcell[n+nx1*m];
+      npic[m] += 1;
+   }
+/* find address offset */
+   isum = 0;
+   for (k = 0; k < nxy1; k++) {
+      ist = npic[k];
+      npic[k] = isum;
+      isum += ist;
+   }
+/* find addresses of particles at each cell and reorder particles */
+   for (j = 0; j < nop; j++) {
+      n = parta[idimp*j];
+      m = parta[1+idimp*j];
+      m = kcell[n+nx1*m];
+      ip = npic[m];
+      for (i = 0; i < idimp; i++) {
+         partb[i+idimp*ip] = parta[i+idimp*j];
+      }
+      npic[m] = ip + 1;
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cgpush2lt(float part[], float fxy[], float qbm, float dt,
+               float *ek, int idimp, int nop, int npe, int nx, int ny,
+               int nxv, int nyv, int ipbc) {
+/* for 2d code, this subroutine updates particle co-ordinates and
+   velocities using leap-frog scheme in time and first-order linear
+   interpolation in space, with various boundary conditions.
+   scalar version using guard cells
+   44 flops/particle, 12 loads, 4 stores
+   input: all, output: part, ek
+   equations used are:
+   vx(t+dt/2) = vx(t-dt/2) + (q/m)*fx(x(t),y(t))*dt,
+   vy(t+dt/2) = vy(t-dt/2) + (q/m)*fy(x(t),y(t))*dt,
+   where q/m is charge/mass, and
+   x(t+dt) = x(t) + vx(t+dt/2)*dt, y(t+dt) = y(t) + vy(t+dt/2)*dt
+   fx(x(t),y(t)) and fy(x(t),y(t)) are approximated by interpolation from
+   the nearest grid points:
+   fx(x,y) = (1-dy)*((1-dx)*fx(n,m)+dx*fx(n+1,m)) + dy*((1-dx)*fx(n,m+1)
+      + dx*fx(n+1,m+1))
+   fy(x,y) = (1-dy)*((1-dx)*fy(n,m)+dx*fy(n+1,m)) + dy*((1-dx)*fy(n,m+1)
+      + dx*fy(n+1,m+1))
+   where n,m = leftmost grid points and dx = x-n, dy = y-m
+   part[0][n] = position x of particle n
+   part[1][n] = position y of particle n
+   part[2][n] = velocity vx of particle n
+   part[3][n] = velocity vy of particle n
+   fxy[k][j][0] = x component of force/charge at grid (j,k)
+   fxy[k][j][1] = y component of force/charge at grid (j,k)
+   that is, convolution of electric field over particle shape
+   qbm = particle charge/mass
+   dt = time interval between successive calculations
+   kinetic energy/mass at time t is also calculated, using
+   ek = .125*sum((vx(t+dt/2)+vx(t-dt/2))**2+(vy(t+dt/2)+vy(t-dt/2))**2)
+   idimp = size of phase space = 4
+   nop = number of particles
+   npe = first dimension of particle array
+   nx/ny = system length in x/y direction
+   nxv = second dimension of field arrays, must be >= nx+1
+   nyv = third dimension of field arrays, must be >= ny+1
+   ipbc = particle boundary condition = (0,1,2,3) =
+   (none,2d periodic,2d reflecting,mixed reflecting/periodic)
+local data                                                            */
+   int j, nn, mm, nxv2;
+   float qtm, edgelx, edgely, edgerx, edgery, dxp, dyp, amx, amy;
+   float x, y, dx, dy, vx, vy;
+   double sum1;
+   nxv2 = 2*nxv;
+   qtm = qbm*dt;
+   sum1 = 0.0;
+/* set boundary values */
+   edgelx = 0.0f;
+   edgely = 0.0f;
+   edgerx = (float) nx;
+   edgery = (float) ny;
+   if (ipbc==2) {
+      edgelx = 1.0f;
+      edgely = 1.0f;
+      edgerx = (float) (nx-1);
+      edgery = (float) (ny-1);
+   }
+   else if (ipbc==3) {
+      edgelx = 1.0f;
+      edgerx = (float) (nx-1);
+   }
+   for (j = 0; j < nop; j++) {
+/* find interpolation weights */
+      x = part[j];
+      y = part[j+npe];
+      nn = x;
+      mm = y;
+      dxp = x - (float) nn;
+      dyp = y - (float) mm;
+      nn = 2*nn + nxv2*mm;
+      amx = 1.0f - dxp;
+      amy = 1.0f - dyp;
+/* find acceleration */
+      dx = amx*fxy[nn];
+      dy = amx*fxy[nn+1];
+      dx = amy*(dxp*fxy[nn+2] + dx);
+      dy = amy*(dxp*fxy[nn+3] + dy);
+      nn += nxv2;
+      vx = amx*fxy[nn];
+      vy = amx*fxy[nn+1];
+      dx += dyp*(dxp*fxy[nn+2] + vx);
+      dy += dyp*(dxp*fxy[nn+3] + vy);
+/* new velocity */
+      dxp = part[j+2*npe];
+      dyp = part[j+3*npe];
+      vx = dxp + qtm*dx;
+      vy = dyp + qtm*dy;
+/* average kinetic energy */
+      dxp += vx;
+      dyp += vy;
+      sum1 += dxp*dxp + dyp*dyp;
+/* new position */
+      dx = x + vx*dt;
+      dy = y + vy*dt;
+/* periodic boundary conditions */
+      if (ipbc==1) {
+         if (dx < edgelx) dx += edgerx;
+         if (dx >= edgerx) dx -= edgerx;
+         if (dy < edgely) dy += edgery;
+         if (dy >= edgery) dy -= edgery;
+      }
+/* reflecting boundary conditions */
+      else if (ipbc==2) {
+         if ((dx < edgelx) || (dx >= edgerx)) {
+            dx = x;
+            vx = -vx;
+         }
+         if ((dy < edgely) || (dy >= edgery)) {
+            dy = y;
+            vy = -vy;
+         }
+      }
+/* mixed reflecting/periodic boundary conditions */
+      else if (ipbc==3) {
+         if ((dx < edgelx) || (dx >= edgerx)) {
+            dx = x;
+            vx = -vx;
+         }
+         if (dy < edgely) dy += edgery;
+         if (dy >= edgery) dy -= edgery;
+      }
+/* set new position */
+      part[j] = dx;
+      part[j+npe] = dy;
+/* set new velocity */
+      part[j+2*npe] = vx;
+      part[j+3*npe] = vy;
+   }
+/* normalize kinetic energy */
+   *ek += 0.125f*sum1;
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cgpost2lt(float part[], float q[], float qm, int nop, int npe,
+               int idimp, int nxv, int nyv) {
+/* for 2d code, this subroutine calculates particle charge density
+   using first-order linear interpolation, periodic boundaries
+   scalar version using guard cells
+   17 flops/particle, 6 loads, 4 stores
+   input: all, output: q
+   charge density is approximated by values at the nearest grid points
+   q(n,m)=qm*(1.-dx)*(1.-dy)
+   q(n+1,m)=qm*dx*(1.-dy)
+   q(n,m+1)=qm*(1.-dx)*dy
+   q(n+1,m+1)=qm*dx*dy
+   where n,m = leftmost grid points and dx = x-n, dy = y-m
+   part[0][n] = position x of particle n
+   part[1][n] = position y of particle n
+   q[k][j] = charge density at grid point j,k
+   qm = charge on particle, in units of e
+   nop = number of particles
+   npe = first dimension of particle array
+   idimp = size of phase space = 4
+   nxv = first dimension of charge array, must be >= nx+1
+   nyv = second dimension of charge array, must be >= ny+1
+local data                                                            */
+   int j, nn, mm;
+   float x, y, dxp, dyp, amx, amy;
+   for (j = 0; j < nop; j++) {
+/* find interpolation weights */
+      x = part[j];
+      y = part[j+npe];
+      nn = x;
+      mm = y;
+      dxp = qm*(x - (float) nn);
+      dyp = y - (float) mm;
+      nn = nn + nxv*mm;
+      amx = qm - dxp;
+      amy = 1.0f - dyp;
+/* deposit charge */
+      x = q[nn] + amx*amy;
+      y = q[nn+1] + dxp*amy;
+      q[nn] = x;
+      q[nn+1] = y;
+      nn += nxv;
+      x = q[nn] + amx*dyp;
+      y = q[nn+1] + dxp*dyp;
+      q[nn] = x;
+      q[nn+1] = y;
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cdsortp2ylt(float parta[], float partb[], int npic[], int idimp,
+                 int nop, int npe, int ny1) {
+/* this subroutine sorts particles by y grid
+   linear interpolation
+   parta/partb = input/output particle arrays
+   parta[1][n] = position y of particle n
+   npic = address offset for reordering particles
+   idimp = size of phase space = 4
+   nop = number of particles
+   npe = first dimension of particle array
+   ny1 = system length in y direction + 1
+local data                                                            */
+   int i, j, k, m, isum, ist, ip;
+/* clear counter array */
+   for (k = 0; k < ny1; k++) {
+      npic[k] = 0;
+   }
+/* find how many particles in each grid */
+   for (j = 0; j < nop; j++) {
+      m = parta[j+npe];
+      npic[m] += 1;
+   }
+/* find address offset */
+   isum = 0;
+   for (k = 0; k < ny1; k++) {
+      ist = npic[k];
+      npic[k] = isum;
+      isum += ist;
+   }
+/* find addresses of particles at each grid and reorder particles */
+   for (j = 0; j < nop; j++) {
+      m = parta[j+npe];
+      ip = npic[m];
+      npic[m] = ip + 1;
+      for (i = 0; i < idimp; i++) {
+         partb[ip+npe*i] = parta[j+npe*i];
+      }
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cpart2t(float part[], float partt[], int idimp, int nop, int npe) {
+/* this subroutine copies a particle array to a transposed (structure of
+   arrays) particle array, where each co-ordinate is stored contiguously
+   input: all, output: partt
+   part[n][i] = co-ordinate i of particle n
+   partt[i][n] = co-ordinate i of particle n
+   idimp = size of phase space = 4
+   nop = number of particles
+   npe = first dimension of transposed particle array, must be >= nop
+local data                                                            */
+   int i, j;
+   for (i = 0; i < idimp; i++) {
+      for (j = 0; j < nop; j++) {
+         partt[j+npe*i] = part[i+idimp*j];
+      }
+/* zero padding */
+      for (j = nop; j < npe; j++) {
+         partt[j+npe*i] = 0.0;
+      }
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cpartt2(float partt[], float part[], int idimp, int nop, int npe) {
+/* this subroutine copies a transposed (structure of arrays) particle
+   array back to a standard particle array
+   input: all, output: part
+   partt[i][n] = co-ordinate i of particle n
+   part[n][i] = co-ordinate i of particle n
+   idimp = size of phase space = 4
+   nop = number of particles
+   npe = first dimension of transposed particle array, must be >= nop
+local data                                                            */
+   int i, j;
+   for (j = 0; j < nop; j++) {
+      for (i = 0; i < idimp; i++) {
+         part[i+idimp*j] = partt[j+npe*i];
+      }
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cpart2c(float part[], unsigned int cpart[], int idimp, int ncomp,
+             int nop, int nx, int ny) {
+/* this subroutine copies a particle array to a compressed particle
+   array, where the position is stored as an integer cell index plus a
+   16 bit fixed point offset within the cell, and the velocity is stored
+   either as 32 bit or as 16 bit (bfloat16) floating point
+   input: all, output: cpart
+   part[n][0] = position x of particle n
+   part[n][1] = position y of particle n
+   part[n][2] = velocity vx of particle n
+   part[n][3] = velocity vy of particle n
+   cpart[n][0] = cell index of particle n, nn + 65536*mm
+   cpart[n][1] = offset within cell of particle n, dx + 65536*dy,
+   where x = nn + dx/65536, y = mm + dy/65536
+   if ncomp = 4:
+   cpart[n][2] = velocity vx of particle n, as float
+   cpart[n][3] = velocity vy of particle n, as float
+   if ncomp = 3:
+   cpart[n][2] = velocity of particle n, bfloat16(vx) + 65536*bfloat16(vy)
+   idimp = size of phase space = 4
+   ncomp = size of compressed phase space = (3,4)
+   nop = number of particles
+   nx/ny = system length in x/y direction, must be <= 65536
+local data                                                            */
+   int j, nn, mm, ix, iy;
+   unsigned int ivx, ivy;
+   union {float f; unsigned int i;} vx, vy;
+   for (j = 0; j < nop; j++) {
+/* find cell and offset, rounding the offset to nearest */
+      nn = part[idimp*j];
+      mm = part[1+idimp*j];
+      ix = 65536.0f*(part[idimp*j] - (float) nn) + 0.5f;
+      iy = 65536.0f*(part[1+idimp*j] - (float) mm) + 0.5f;
+      if (ix > 65535) {
+         ix -= 65536;
+         nn += 1;
+         if (nn >= nx) nn -= nx;
+      }
+      if (iy > 65535) {
+         iy -= 65536;
+         mm += 1;
+         if (mm >= ny) mm -= ny;
+      }
+      cpart[ncomp*j] = nn + 65536u*mm;
+      cpart[1+ncomp*j] = ix + 65536u*iy;
+/* velocity */
+      vx.f = part[2+idimp*j];
+      vy.f = part[3+idimp*j];
+      if (ncomp==4) {
+         cpart[2+ncomp*j] = vx.i;
+         cpart[3+ncomp*j] = vy.i;
+      }
+/* round to nearest even bfloat16 */
+      else {
+         ivx = (vx.i + 32767 + ((vx.i >> 16) & 1)) >> 16;
+         ivy = (vy.i + 32767 + ((vy.i >> 16) & 1)) >> 16;
+         cpart[2+ncomp*j] = ivx + 65536*ivy;
+      }
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void ccpart2(unsigned int cpart[], float part[], int idimp, int ncomp,
+             int nop) {
+/* this subroutine copies a compressed particle array back to a standard
+   particle array
+   input: all, output: part
+   cpart = compressed particle array, described in cpart2c
+   part[n][0] = position x of particle n
+   part[n][1] = position y of particle n
+   part[n][2] = velocity vx of particle n
+   part[n][3] = velocity vy of particle n
+   idimp = size of phase space = 4
+   ncomp = size of compressed phase space = (3,4)
+   nop = number of particles
+local data                                                            */
+   int j;
+   unsigned int ic, io;
+   union {float f; unsigned int i;} vx, vy;
+   for (j = 0; j < nop; j++) {
+      ic = cpart[ncomp*j];
+      io = cpart[1+ncomp*j];
+      part[idimp*j] = (float) (ic & 65535)
+                    + (1.0f/65536.0f)*(float) (io & 65535);
+      part[1+idimp*j] = (float) (ic >> 16)
+                      + (1.0f/65536.0f)*(float) (io >> 16);
+      if (ncomp==4) {
+         vx.i = cpart[2+ncomp*j];
+         vy.i = cpart[3+ncomp*j];
+      }
+      else {
+         vx.i = cpart[2+ncomp*j] << 16;
+         vy.i = cpart[2+ncomp*j] & 4294901760u;
+      }
+      part[2+idimp*j] = vx.f;
+      part[3+idimp*j] = vy.f;
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cgpush2c(unsigned int cpart[], float fxy[], float qbm, float dt,
+              float *ek, int ncomp, int nop, int nx, int ny, int nxv,
+              int nyv, int ipbc) {
+/* for 2d code, this subroutine updates compressed particle co-ordinates
+   and velocities using leap-frog scheme in time and first-order linear
+   interpolation in space, with various boundary conditions.
+   the position is advanced as a cell index plus an offset within the
+   cell, so its precision does not depend on the distance from the
+   origin.
+   scalar version using guard cells
+   input: all, output: cpart, ek
+   equations used are:
+   vx(t+dt/2) = vx(t-dt/2) + (q/m)*fx(x(t),y(t))*dt,
+   vy(t+dt/2) = vy(t-dt/2) + (q/m)*fy(x(t),y(t))*dt,
+   where q/m is charge/mass, and
+   x(t+dt) = x(t) + vx(t+dt/2)*dt, y(t+dt) = y(t) + vy(t+dt/2)*dt
+   fx(x(t),y(t)) and fy(x(t),y(t)) are approximated by interpolation from
+   the nearest grid points:
+   fx(x,y) = (1-dy)*((1-dx)*fx(n,m)+dx*fx(n+1,m)) + dy*((1-dx)*fx(n,m+1)
+      + dx*fx(n+1,m+1))
+   fy(x,y) = (1-dy)*((1-dx)*fy(n,m)+dx*fy(n+1,m)) + dy*((1-dx)*fy(n,m+1)
+      + dx*fy(n+1,m+1))
+   where n,m = leftmost grid points and dx = x-n, dy = y-m
+   cpart = compressed particle array, described in cpart2c
+   fxy[k][j][0] = x component of force/charge at grid (j,k)
+   fxy[k][j][1] = y component of force/charge at grid (j,k)
+   that is, convolution of electric field over particle shape
+   qbm = particle charge/mass
+   dt = time interval between successive calculations
+   kinetic energy/mass at time t is also calculated, using
+   ek = .125*sum((vx(t+dt/2)+vx(t-dt/2))**2+(vy(t+dt/2)+vy(t-dt/2))**2)
+   ncomp = size of compressed phase space = (3,4)
+   nop = number of particles
+   nx/ny = system length in x/y direction
+   nxv = second dimension of field arrays, must be >= nx+1
+   nyv = third dimension of field arrays, must be >= ny+1
+   ipbc = particle boundary condition = (0,1,2,3) =
+   (none,2d periodic,2d reflecting,mixed reflecting/periodic)
+local data                                                            */
+   int j, nn, mm, np, mp, nxv2, ix, iy, in, im, edgelx, edgely;
+   int edgerx, edgery;
+   unsigned int ic, io;
+   float qtm, dxp, dyp, amx, amy, dx, dy, ox, oy;
+   union {float f; unsigned int i;} vx, vy;
+   double sum1;
+   nxv2 = 2*nxv;
+   qtm = qbm*dt;
+   sum1 = 0.0;
+/* set boundary values, in cells */
+   edgelx = 0;
+   edgely = 0;
+   edgerx = nx;
+   edgery = ny;
+   if (ipbc==2) {
+      edgelx = 1;
+      edgely = 1;
+      edgerx = nx - 1;
+      edgery = ny - 1;
+   }
+   else if (ipbc==3) {
+      edgelx = 1;
+      edgerx = nx - 1;
+   }
+   for (j = 0; j < nop; j++) {
+/* find interpolation weights */
+      ic = cpart[ncomp*j];
+      io = cpart[1+ncomp*j];
+      nn = ic & 65535;
+      mm = ic >> 16;
+      dxp = (1.0f/65536.0f)*(float) (io & 65535);
+      dyp = (1.0f/65536.0f)*(float) (io >> 16);
+      in = nn;
+      im = mm;
+      ox = dxp;
+      oy = dyp;
+      nn = 2*nn;
+      mm = nxv2*mm;
+      amx = 1.0f - dxp;
+      mp = mm + nxv2;
+      amy = 1.0f - dyp;
+      np = nn + 2;
+/* find acceleration */
+      dx = dyp*(dxp*fxy[np+mp] + amx*fxy[nn+mp])
+         + amy*(dxp*fxy[np+mm] + amx*fxy[nn+mm]);
+      dy = dyp*(dxp*fxy[1+np+mp] + amx*fxy[1+nn+mp])
+         + amy*(dxp*fxy[1+np+mm] + amx*fxy[1+nn+mm]);
+/* old velocity */
+      if (ncomp==4) {
+         vx.i = cpart[2+ncomp*j];
+         vy.i = cpart[3+ncomp*j];
+      }
+      else {
+         vx.i = cpart[2+ncomp*j] << 16;
+         vy.i = cpart[2+ncomp*j] & 4294901760u;
+      }
+/* new velocity */
+      dx = vx.f + qtm*dx;
+      dy = vy.f + qtm*dy;
+/* average kinetic energy */
+      vx.f += dx;
+      vy.f += dy;
+      sum1 += vx.f*vx.f + vy.f*vy.f;
+      vx.f = dx;
+      vy.f = dy;
+/* new offset within cell, rounded to nearest */
+      dx = ox + dx*dt;
+      dy = oy + dy*dt;
+      nn = dx;
+      mm = dy;
+      nn -= (float) nn > dx;
+      mm -= (float) mm > dy;
+      ix = 65536.0f*(dx - (float) nn) + 0.5f;
+      iy = 65536.0f*(dy - (float) mm) + 0.5f;
+      if (ix > 65535) {
+         ix -= 65536;
+         nn += 1;
+      }
+      if (iy > 65535) {
+         iy -= 65536;
+         mm += 1;
+      }
+/* new cell */
+      nn += in;
+      mm += im;
+/* periodic boundary conditions */
+      if (ipbc==1) {
+         if (nn < edgelx) nn += edgerx;
+         if (nn >= edgerx) nn -= edgerx;
+         if (mm < edgely) mm += edgery;
+         if (mm >= edgery) mm -= edgery;
+      }
+/* reflecting boundary conditions */
+      else if (ipbc==2) {
+         if ((nn < edgelx) || (nn >= edgerx)) {
+            nn = in;
+            ix = io & 65535;
+            vx.f = -vx.f;
+         }
+         if ((mm < edgely) || (mm >= edgery)) {
+            mm = im;
+            iy = io >> 16;
+            vy.f = -vy.f;
+         }
+      }
+/* mixed reflecting/periodic boundary conditions */
+      else if (ipbc==3) {
+         if ((nn < edgelx) || (nn >= edgerx)) {
+            nn = in;
+            ix = io & 65535;
+            vx.f = -vx.f;
+         }
+         if (mm < edgely) mm += edgery;
+         if (mm >= edgery) mm -= edgery;
+      }
+/* set new position and velocity */
+      cpart[ncomp*j] = nn + 65536u*mm;
+      cpart[1+ncomp*j] = ix + 65536u*iy;
+      if (ncomp==4) {
+         cpart[2+ncomp*j] = vx.i;
+         cpart[3+ncomp*j] = vy.i;
+      }
+/* round to nearest even bfloat16 */
+      else {
+         vx.i = (vx.i + 32767 + ((vx.i >> 16) & 1)) >> 16;
+         vy.i = (vy.i + 32767 + ((vy.i >> 16) & 1)) >> 16;
+         cpart[2+ncomp*j] = vx.i + 65536*vy.i;
+      }
+   }
+/* normalize kinetic energy */
+   *ek += 0.125*sum1;
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cgpost2c(unsigned int cpart[], float q[], float qm, int ncomp,
+              int nop, int nxv, int nyv) {
+/* for 2d code, this subroutine calculates particle charge density
+   from compressed particles using first-order linear interpolation,
+   periodic boundaries
+   scalar version using guard cells
+   input: all, output: q
+   charge density is approximated by values at the nearest grid points
+   q(n,m)=qm*(1.-dx)*(1.-dy)
+   q(n+1,m)=qm*dx*(1.-dy)
+   q(n,m+1)=qm*(1.-dx)*dy
+   q(n+1,m+1)=qm*dx*dy
+   where n,m = leftmost grid points and dx = x-n, dy = y-m
+   cpart = compressed particle array, described in cpart2c
+   q[k][j] = charge density at grid point j,k
+   qm = charge on particle, in units of e
+   ncomp = size of compressed phase space = (3,4)
+   nop = number of particles
+   nxv = first dimension of charge array, must be >= nx+1
+   nyv = second dimension of charge array, must be >= ny+1
+local data                                                            */
+   int j, nn, mm, np, mp;
+   unsigned int ic, io;
+   float dxp, dyp, amx, amy;
+   for (j = 0; j < nop; j++) {
+/* find interpolation weights */
+      ic = cpart[ncomp*j];
+      io = cpart[1+ncomp*j];
+      nn = ic & 65535;
+      mm = ic >> 16;
+      dxp = (qm/65536.0f)*(float) (io & 65535);
+      dyp = (1.0f/65536.0f)*(float) (io >> 16);
+      mm = nxv*mm;
+      amx = qm - dxp;
+      mp = mm + nxv;
+      amy = 1.0f - dyp;
+      np = nn + 1;
+/* deposit charge */
+      q[np+mp] += dxp*dyp;
+      q[nn+mp] += amx*dyp;
+      q[np+mm] += dxp*amy;
+      q[nn+mm] += amx*amy;
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cdsortp2yc(unsigned int cparta[], unsigned int cpartb[], int npic[],
+                int ncomp, int nop, int ny1) {
+/* this subroutine sorts compressed particles by y grid
+   linear interpolation
+   cparta/cpartb = input/output compressed particle arrays
+   cparta[n][0] = cell index of particle n, described in cpart2c
+   npic = address offset for reordering particles
+   ncomp = size of compressed phase space = (3,4)
+   nop = number of particles
+   ny1 = system length in y direction + 1
+local data                                                            */
+   int i, j, k, m, isum, ist, ip;
+/* clear counter array */
+   for (k = 0; k < ny1; k++) {
+      npic[k] = 0;
+   }
+/* find how many particles in each grid */
+   for (j = 0; j < nop; j++) {
+      m = cparta[ncomp*j] >> 16;
+      npic[m] += 1;
+   }
+/* find address offset */
+   isum = 0;
+   for (k = 0; k < ny1; k++) {
+      ist = npic[k];
+      npic[k] = isum;
+      isum += ist;
+   }
+/* find addresses of particles at each grid and reorder particles */
+   for (j = 0; j < nop; j++) {
+      m = cparta[ncomp*j] >> 16;
+      ip = npic[m];
+      for (i = 0; i < ncomp; i++) {
+         cpartb[i+ncomp*ip] = cparta[i+ncomp*j];
+      }
+      npic[m] = ip + 1;
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+int cspline1(float x, float w[], int norder) {
+/* this function calculates the interpolation weights of a particle at
+   position x for a spline shape function of order norder
+   input: x, norder, output: w
+   for norder = 1, linear: n = x, dx = x - n
+   w[0] = 1 - dx, w[1] = dx
+   for norder = 2, quadratic: n = x + 0.5, dx = x - n
+   w[0] = .5*(.5 - dx)**2, w[1] = .75 - dx**2, w[2] = .5*(.5 + dx)**2
+   for norder = 3, cubic: n = x, dx = x - n
+   w[0] = (1 - dx)**3/6, w[1] = (4 - 6*dx**2 + 3*dx**3)/6,
+   w[2] = (1 + 3*dx + 3*dx**2 - 3*dx**3)/6, w[3] = dx**3/6
+   x = position of particle, must be >= 0
+   w = interpolation weights for norder+1 grid points
+   returns leftmost grid point used, n for linear, n-1 otherwise
+local data                                                            */
+   int nn;
+   float dx, dx2, dx3, amx;
+   if (norder==2) {
+      nn = x + 0.5f;
+      dx = x - (float) nn;
+      amx = 0.5f - dx;
+      w[0] = 0.5f*amx*amx;
+      w[1] = 0.75f - dx*dx;
+      amx = 0.5f + dx;
+      w[2] = 0.5f*amx*amx;
+      return nn - 1;
+   }
+   nn = x;
+   dx = x - (float) nn;
+   amx = 1.0f - dx;
+   if (norder==3) {
+      dx2 = dx*dx;
+      dx3 = dx*dx2;
+      w[0] = amx*amx*amx/6.0f;
+      w[1] = (4.0f - 6.0f*dx2 + 3.0f*dx3)/6.0f;
+      w[2] = (1.0f + 3.0f*(dx + dx2 - dx3))/6.0f;
+      w[3] = dx3/6.0f;
+      return nn - 1;
+   }
+   w[0] = amx;
+   w[1] = dx;
+   return nn;
+}
+
+/*--------------------------------------------------------------------*/
+void cgpush2sn(float part[], float fxy[], float qbm, float dt,
+               float *ek, int idimp, int nop, int nx, int ny, int nxv,
+               int nyv, int ipbc, int norder) {
+/* for 2d code, this subroutine updates particle co-ordinates and
+   velocities using leap-frog scheme in time and linear, quadratic or
+   cubic spline interpolation in space, with various boundary conditions.
+   scalar version using guard cells on both sides
+   input: all, output: part, ek
+   equations used are:
+   vx(t+dt/2) = vx(t-dt/2) + (q/m)*fx(x(t),y(t))*dt,
+   vy(t+dt/2) = vy(t-dt/2) + (q/m)*fy(x(t),y(t))*dt,
+   where q/m is charge/mass, and
+   x(t+dt) = x(t) + vx(t+dt/2)*dt, y(t+dt) = y(t) + vy(t+dt/2)*dt
+   fx(x(t),y(t)) and fy(x(t),y(t)) are approximated by interpolation from
+   the nearest norder+1 grid points in each direction:
+   fx(x,y) = sum(wy[m]*wx[n]*fx(n,m)), fy(x,y) = sum(wy[m]*wx[n]*fy(n,m))
+   where wx, wy are the spline weights calculated by cspline1
+   part[n][0] = position x of particle n
+   part[n][1] = position y of particle n
+   part[n][2] = velocity vx of particle n
+   part[n][3] = velocity vy of particle n
+   fxy[k+1][j+1][0] = x component of force/charge at grid (j,k)
+   fxy[k+1][j+1][1] = y component of force/charge at grid (j,k)
+   that is, convolution of electric field over particle shape,
+   with one guard cell on the left and two on the right
+   qbm = particle charge/mass
+   dt = time interval between successive calculations
+   kinetic energy/mass at time t is also calculated, using
+   ek = .125*sum((vx(t+dt/2)+vx(t-dt/2))**2+(vy(t+dt/2)+vy(t-dt/2))**2)
+   idimp = size of phase space = 4
+   nop = number of particles
+   nx/ny = system length in x/y direction
+   nxv = second dimension of field arrays, must be >= nx+3
+   nyv = third dimension of field arrays, must be >= ny+3
+   ipbc = particle boundary condition = (0,1,2,3) =
+   (none,2d periodic,2d reflecting,mixed reflecting/periodic)
+   norder = interpolation order = (1,2,3) = (linear,quadratic,cubic)
+local data                                                            */
+   int j, i, k, nn, mm, np, mp, nxv2, no1;
+   float qtm, edgelx, edgely, edgerx, edgery;
+   float dx, dy, vx, vy;
+   float wx[4], wy[4];
+   double sum1;
+   nxv2 = 2*nxv;
+   no1 = norder + 1;
+   qtm = qbm*dt;
+   sum1 = 0.0;
+/* set boundary values */
+   edgelx = 0.0;
+   edgely = 0.0;
+   edgerx = (float) nx;
+   edgery = (float) ny;
+   if (ipbc==2) {
+      edgelx = 1.0;
+      edgely = 1.0;
+      edgerx = (float) (nx-1);
+      edgery = (float) (ny-1);
+   }
+   else if (ipbc==3) {
+      edgelx = 1.0;
+      edgerx = (float) (nx-1);
+   }
+   for (j = 0; j < nop; j++) {
+/* find interpolation weights */
+      nn = cspline1(part[idimp*j],wx,norder);
+      mm = cspline1(part[1+idimp*j],wy,norder);
+      nn = 2*(nn + 1);
+      mm = nxv2*(mm + 1);
+/* find acceleration */
+      dx = 0.0;
+      dy = 0.0;
+      for (k = 0; k < no1; k++) {
+         mp = mm + nxv2*k;
+         vx = 0.0;
+         vy = 0.0;
+         for (i = 0; i < no1; i++) {
+            np = nn + 2*i + mp;
+            vx += wx[i]*fxy[np];
+            vy += wx[i]*fxy[np+1];
+         }
+         dx += wy[k]*vx;
+         dy += wy[k]*vy;
+      }
+/* new velocity */
+      vx = part[2+idimp*j];
+      vy = part[3+idimp*j];
+      dx = vx + qtm*dx;
+      dy = vy + qtm*dy;
+/* average kinetic energy */
+      vx += dx;
+      vy += dy;
+      sum1 += vx*vx + vy*vy;
+      part[2+idimp*j] = dx;
+      part[3+idimp*j] = dy;
+/* new position */
+      dx = part[idimp*j] + dx*dt;
+      dy = part[1+idimp*j] + dy*dt;
+/* periodic boundary conditions */
+      if (ipbc==1) {
+         if (dx < edgelx) dx += edgerx;
+         if (dx >= edgerx) dx -= edgerx;
+         if (dy < edgely) dy += edgery;
+         if (dy >= edgery) dy -= edgery;
+      }
+/* reflecting boundary conditions */
+      else if (ipbc==2) {
+         if ((dx < edgelx) || (dx >= edgerx)) {
+            dx = part[idimp*j];
+            part[2+idimp*j] = -part[2+idimp*j];
+         }
+         if ((dy < edgely) || (dy >= edgery)) {
+            dy = part[1+idimp*j];
+            part[3+idimp*j] = -part[3+idimp*j];
+         }
+      }
+/* mixed reflecting/periodic boundary conditions */
+      else if (ipbc==3) {
+         if ((dx < edgelx) || (dx >= edgerx)) {
+            dx = part[idimp*j];
+            part[2+idimp*j] = -part[2+idimp*j];
+         }
+         if (dy < edgely) dy += edgery;
+         if (dy >= edgery) dy -= edgery;
+      }
+/* set new position */
+      part[idimp*j] = dx;
+      part[1+idimp*j] = dy;
+   }
+/* normalize kinetic energy */
+   *ek += 0.125*sum1;
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cgpost2sn(float part[], float q[], float qm, int nop, int idimp,
+               int nxv, int nyv, int norder) {
+/* for 2d code, this subroutine calculates particle charge density
+   using linear, quadratic or cubic spline interpolation
+   scalar version using guard cells on both sides
+   input: all, output: q
+   charge density is approximated by values at the nearest norder+1
+   grid points in each direction
+   q(n,m)=qm*wx[n]*wy[m]
+   where wx, wy are the spline weights calculated by cspline1
+   part[n][0] = position x of particle n
+   part[n][1] = position y of particle n
+   q[k+1][j+1] = charge density at grid point j,k,
+   with one guard cell on the left and two on the right
+   qm = charge on particle, in units of e
+   nop = number of particles
+   idimp = size of phase space = 4
+   nxv = first dimension of charge array, must be >= nx+3
+   nyv = second dimension of charge array, must be >= ny+3
+   norder = interpolation order = (1,2,3) = (linear,quadratic,cubic)
+local data                                                            */
+   int j, i, k, nn, mm, mp, no1;
+   float at1;
+   float wx[4], wy[4];
+   no1 = norder + 1;
+   for (j = 0; j < nop; j++) {
+/* find interpolation weights */
+      nn = cspline1(part[idimp*j],wx,norder);
+      mm = cspline1(part[1+idimp*j],wy,norder);
+      nn = nn + 1;
+      mm = nxv*(mm + 1);
+/* deposit charge */
+      for (k = 0; k < no1; k++) {
+         mp = nn + mm + nxv*k;
+         at1 = qm*wy[k];
+         for (i = 0; i < no1; i++) {
+            q[i+mp] += at1*wx[i];
+         }
+      }
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cgpush2s(float part[], float fxy[], float qbm, float dt, float *ek,
+              int idimp, int nop, int nx, int ny, int nxv, int nyv,
+              int ipbc, int norder) {
+/* for 2d code, this subroutine updates particle co-ordinates and
+   velocities using spline interpolation of order norder, by calling
+   cgpush2sn with a constant order, so that a specialized kernel with
+   fixed length interpolation loops is generated for each order
+   norder = interpolation order = (1,2,3) = (linear,quadratic,cubic)
+   other arguments are described in cgpush2sn                        */
+   switch (norder) {
+   case 2:
+      cgpush2sn(part,fxy,qbm,dt,ek,idimp,nop,nx,ny,nxv,nyv,ipbc,2);
+      break;
+   case 3:
+      cgpush2sn(part,fxy,qbm,dt,ek,idimp,nop,nx,ny,nxv,nyv,ipbc,3);
+      break;
+   default:
+      cgpush2sn(part,fxy,qbm,dt,ek,idimp,nop,nx,ny,nxv,nyv,ipbc,1);
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cgpost2s(float part[], float q[], float qm, int nop, int idimp,
+              int nxv, int nyv, int norder) {
+/* for 2d code, this subroutine calculates particle charge density
+   using spline interpolation of order norder, by calling cgpost2sn with
+   a constant order, so that a specialized kernel with fixed length
+   interpolation loops is generated for each order
+   norder = interpolation order = (1,2,3) = (linear,quadratic,cubic)
+   other arguments are described in cgpost2sn                        */
+   switch (norder) {
+   case 2:
+      cgpost2sn(part,q,qm,nop,idimp,nxv,nyv,2);
+      break;
+   case 3:
+      cgpost2sn(part,q,qm,nop,idimp,nxv,nyv,3);
+      break;
+   default:
+      cgpost2sn(part,q,qm,nop,idimp,nxv,nyv,1);
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void ccguard2s(float fxy[], float fxys[], int nx, int ny, int nxe,
+               int nye, int nxv, int nyv) {
+/* copy periodic vector field fxy into extended field fxys with one
+   guard cell on the left and two on the right, for spline interpolation
+   of order up to 3
+   fxy[k][j][0:1] = field at grid (j,k), without guard cells
+   fxys[k+1][j+1][0:1] = field at grid (j,k), with guard cells
+   nx/ny = system length in x/y direction
+   nxe = second dimension of field array fxy, must be >= nx
+   nye = third dimension of field array fxy, must be >= ny
+   nxv = second dimension of field array fxys, must be >= nx+3
+   nyv = third dimension of field array fxys, must be >= ny+3
+local data                                                 */
+   int j, k, jj, kk;
+   for (k = 0; k < ny+3; k++) {
+      kk = k - 1;
+      kk = kk < 0 ? kk + ny : (kk >= ny ? kk - ny : kk);
+      for (j = 0; j < nx+3; j++) {
+         jj = j - 1;
+         jj = jj < 0 ? jj + nx : (jj >= nx ? jj - nx : jj);
+         fxys[2*j+2*nxv*k] = fxy[2*jj+2*nxe*kk];
+         fxys[1+2*j+2*nxv*k] = fxy[1+2*jj+2*nxe*kk];
+      }
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void caguard2s(float qs[], float q[], int nx, int ny, int nxe, int nye,
+               int nxv, int nyv) {
+/* accumulate extended periodic scalar field qs with one guard cell on
+   the left and two on the right into field q without guard cells, for
+   spline interpolation of order up to 3
+   qs[k+1][j+1] = charge density at grid (j,k), with guard cells
+   q[k][j] = charge density at grid (j,k), without guard cells
+   nx/ny = system length in x/y direction
+   nxe = first dimension of field array q, must be >= nx
+   nye = second dimension of field array q, must be >= ny
+   nxv = first dimension of field array qs, must be >= nx+3
+   nyv = second dimension of field array qs, must be >= ny+3
+local data                                                 */
+   int j, k, jj, kk;
+/* copy interior */
+   for (k = 0; k < ny; k++) {
+      for (j = 0; j < nx; j++) {
+         q[j+nxe*k] = qs[j+1+nxv*(k+1)];
+      }
+   }
+/* accumulate guard cells in y */
+   for (j = 0; j < nx+3; j++) {
+      jj = j - 1;
+      jj = jj < 0 ? jj + nx : (jj >= nx ? jj - nx : jj);
+      q[jj+nxe*(ny-1)] += qs[j];
+      q[jj] += qs[j+nxv*(ny+1)];
+      q[jj+nxe] += qs[j+nxv*(ny+2)];
+   }
+/* accumulate guard cells in x */
+   for (k = 1; k < ny+1; k++) {
+      kk = k - 1;
+      q[nx-1+nxe*kk] += qs[nxv*k];
+      q[nxe*kk] += qs[nx+1+nxv*k];
+      q[1+nxe*kk] += qs[nx+2+nxv*k];
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+int cfftmrfac(int factor[], int n, int nfd) {
+/* this function factors the length n of a mixed radix fast fourier
+   transform into radices 4, 2, 3, 5 and 7, in the order used by the
+   butterfly stages of cfftmr1.
+   output: factor
+   factor = array of radices
+   n = length of transform, must be > 0
+   nfd = dimension of factor, 32 is enough for any int n
+   returns number of factors, or -1 if n <= 0, n contains another prime
+   factor or has more than nfd factors
+local data                                                            */
+   int nf, nr, i;
+   int radix[5] = {4,2,3,5,7};
+   if (n <= 0)
+      return -1;
+   nf = 0;
+   nr = n;
+   for (i = 0; i < 5; i++) {
+      while ((nr%radix[i])==0) {
+         if (nf >= nfd)
+            return -1;
+         factor[nf++] = radix[i];
+         nr = nr/radix[i];
+      }
+   }
+   if (nr != 1)
+      return -1;
+   return nf;
+}
+
+/*--------------------------------------------------------------------*/
+void cfftmrinit(int mixup[], int n) {
+/* this subroutine calculates the digit reverse table needed by a one
+   dimensional mixed radix complex fast fourier transform of length n.
+   input: n
+   output: mixup
+   mixup = array of digit reversed addresses, where the cycle leaders
+   of the permutation are stored with a negative sign, so that the
+   permutation can be performed in place by following cycles
+   n = length of transform, must contain only factors 2, 3, 5 and 7
+local data                                                            */
+   int factor[32];
+   int nf, i, j, m, nr, nl;
+   nf = cfftmrfac(factor,n,32);
+/* digit-reverse index table: mixup[j] = 1 + digit reversed j, */
+/* where the first digit of j has the radix of the first stage */
+   for (j = 0; j < n; j++) {
+      nr = j;
+      nl = 0;
+      for (i = 0; i < nf; i++) {
+         m = nr/factor[i];
+         nl = nl*factor[i] + (nr - m*factor[i]);
+         nr = m;
+      }
+      mixup[j] = nl + 1;
+   }
+/* mark cycle leaders: visited entries are temporarily offset by n */
+   for (j = 0; j < n; j++) {
+      if (mixup[j] > n)
+         continue;
+      i = j;
+      do {
+         m = mixup[i];
+         mixup[i] = m + n;
+         i = m - 1;
+      } while (i != j);
+      if ((mixup[j] - n - 1) != j)
+         mixup[j] = -mixup[j];
+   }
+   for (j = 0; j < n; j++) {
+      if (mixup[j] > 0)
+         mixup[j] -= n;
+      else
+         mixup[j] += n;
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cfftmr1(float complex f[], int isign, int mixup[],
+             float complex sct[], int n, int nrs, int is, int nvp,
+             int ivs) {
+/* this subroutine performs a set of nvp one dimensional mixed radix
+   complex fast fourier transforms of length n, in place, using a
+   decimation in time algorithm with radix 4, 2, 3, 5 and 7 butterflies.
+   for isign = (-1,1), input: all, output: f
+   if isign = -1, an unnormalized inverse fourier transform is performed
+   f[m] = sum(f[j]*exp(-sqrt(-1)*2pi*m*j/n))
+   if isign = 1, an unnormalized forward fourier transform is performed
+   f[m] = sum(f[j]*exp(sqrt(-1)*2pi*m*j/n))
+   element j of transform v is stored in f[is*j+ivs*v]
+   mixup = array of digit reversed addresses from cfftmrinit
+   sct = sine/cosine table, where sct[nrs*j] = exp(-sqrt(-1)*2pi*j/n)
+   n = length of transform
+   nrs = stride in sct
+   is = stride between elements of a transform
+   nvp = number of transforms
+   ivs = stride between transforms
+local data                                                            */
+   int factor[32];
+   int nf, i, j, k, l, m, q, r, ns, nsr, km, kmr, nsct, j1, joff, ip;
+   float sn;
+   float complex t1, t2, t3, t4, y[7], z[7], wr[49];
+   if (isign==0)
+      return;
+   nf = cfftmrfac(factor,n,32);
+   nsct = nrs*n;
+   sn = isign < 0 ? -1.0 : 1.0;
+/* digit-reverse array elements by following cycles */
+   for (j = 0; j < n; j++) {
+      if (mixup[j] >= 0)
+         continue;
+      ip = -mixup[j] - 1;
+      for (i = 0; i < nvp; i++) {
+         joff = ivs*i;
+         t1 = f[is*j+joff];
+         k = j;
+         l = ip;
+         while (l != j) {
+            f[is*k+joff] = f[is*l+joff];
+            k = l;
+            l = abs(mixup[l]) - 1;
+         }
+         f[is*k+joff] = t1;
+      }
+   }
+/* butterfly stages */
+   ns = 1;
+   for (l = 0; l < nf; l++) {
+      r = factor[l];
+      nsr = ns*r;
+      km = n/nsr;
+      kmr = km*nrs;
+/* roots of unity for general radix butterfly */
+      if (r > 4) {
+         for (m = 0; m < r; m++) {
+            for (q = 0; q < r; q++) {
+               wr[q+r*m] = sct[nrs*km*ns*((q*m)%r)];
+               if (isign > 0)
+                  wr[q+r*m] = conjf(wr[q+r*m]);
+            }
+         }
+      }
+      for (k = 0; k < km; k++) {
+         for (j = 0; j < ns; j++) {
+            j1 = j + nsr*k;
+            switch (r) {
+/* radix 2 butterfly */
+            case 2:
+               t1 = sct[kmr*j];
+               if (isign > 0)
+                  t1 = conjf(t1);
+               for (i = 0; i < nvp; i++) {
+                  joff = is*j1 + ivs*i;
+                  t2 = t1*f[joff+is*ns];
+                  f[joff+is*ns] = f[joff] - t2;
+                  f[joff] += t2;
+               }
+               break;
+/* radix 4 butterfly */
+            case 4:
+               for (q = 1; q < 4; q++) {
+                  z[q] = sct[(kmr*j*q)%nsct];
+                  if (isign > 0)
+                     z[q] = conjf(z[q]);
+               }
+               for (i = 0; i < nvp; i++) {
+                  joff = is*j1 + ivs*i;
+                  t1 = f[joff] + z[2]*f[joff+2*is*ns];
+                  t2 = f[joff] - z[2]*f[joff+2*is*ns];
+                  t3 = z[1]*f[joff+is*ns] + z[3]*f[joff+3*is*ns];
+                  t4 = z[1]*f[joff+is*ns] - z[3]*f[joff+3*is*ns];
+                  t4 = sn*(cimagf(t4) - crealf(t4)*_Complex_I);
+                  f[joff] = t1 + t3;
+                  f[joff+is*ns] = t2 - t4;
+                  f[joff+2*is*ns] = t1 - t3;
+                  f[joff+3*is*ns] = t2 + t4;
+               }
+               break;
+/* radix 3 butterfly */
+            case 3:
+               for (q = 1; q < 3; q++) {
+                  z[q] = sct[(kmr*j*q)%nsct];
+                  if (isign > 0)
+                     z[q] = conjf(z[q]);
+               }
+               for (i = 0; i < nvp; i++) {
+                  joff = is*j1 + ivs*i;
+                  t2 = z[1]*f[joff+is*ns];
+                  t3 = z[2]*f[joff+2*is*ns];
+                  t1 = t2 + t3;
+                  t4 = 0.866025403784439*sn*(t2 - t3);
+                  t2 = f[joff] - 0.5*t1;
+                  t3 = -cimagf(t4) + crealf(t4)*_Complex_I;
+                  f[joff] += t1;
+                  f[joff+is*ns] = t2 + t3;
+                  f[joff+2*is*ns] = t2 - t3;
+               }
+               break;
+/* general radix 5 or 7 butterfly */
+            default:
+               for (q = 1; q < r; q++) {
+                  z[q] = sct[(kmr*j*q)%nsct];
+                  if (isign > 0)
+                     z[q] = conjf(z[q]);
+               }
+               for (i = 0; i < nvp; i++) {
+                  joff = is*j1 + ivs*i;
+                  y[0] = f[joff];
+                  for (q = 1; q < r; q++) {
+                     y[q] = z[q]*f[joff+is*ns*q];
+                  }
+                  for (m = 0; m < r; m++) {
+                     t1 = y[0];
+                     for (q = 1; q < r; q++) {
+                        t1 += wr[q+r*m]*y[q];
+                     }
+                     f[joff+is*ns*m] = t1;
+                  }
+               }
+               break;
+            }
+         }
+      }
+      ns = nsr;
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+int cwfft2rminit(int mixup[], float complex sct[], int nx, int ny,
+                 int nxhyd, int nxyd) {
+/* this subroutine calculates tables needed by a two dimensional mixed
+   radix real to complex fast fourier transform and its inverse.
+   input: nx, ny, nxhyd, nxyd
+   output: mixup, sct
+   mixup = array of digit reversed addresses, for x in mixup[j],
+   0 <= j < nx/2, and for y in mixup[nx/2+k], 0 <= k < ny
+   sct = sine/cosine table, for the angles 2*j*pi/nx in sct[j],
+   0 <= j < nx, and for the angles 2*k*pi/ny in sct[nx+k], 0 <= k < ny
+   nx/ny = system length in x/y direction, must be positive, even and
+   contain only factors 2, 3, 5 and 7
+   nxhyd = dimension of mixup, must be >= nx/2 + ny
+   nxyd = dimension of sct, must be >= nx + ny
+   returns 0 if tables were calculated, otherwise 1
+local data                                                            */
+   int factor[32];
+   int nxh, j, k;
+   float dnx, dny, arg;
+   nxh = nx/2;
+   if ((nx <= 0) || (ny <= 0))
+      return 1;
+   if ((nx != 2*nxh) || (ny != 2*(ny/2)))
+      return 1;
+   if ((nxh + ny) > nxhyd)
+      return 1;
+   if ((nx + ny) > nxyd)
+      return 1;
+   if ((cfftmrfac(factor,nxh,32) < 0) || (cfftmrfac(factor,ny,32) < 0))
+      return 1;
+/* digit-reverse index tables */
+   cfftmrinit(mixup,nxh);
+   cfftmrinit(&mixup[nxh],ny);
+/* sine/cosine tables for the angles 2*j*pi/nx and 2*k*pi/ny */
+   dnx = 6.28318530717959/(float) nx;
+   for (j = 0; j < nx; j++) {
+      arg = dnx*(float) j;
+      sct[j] = cosf(arg) - sinf(arg)*_Complex_I;
+   }
+   dny = 6.28318530717959/(float) ny;
+   for (k = 0; k < ny; k++) {
+      arg = dny*(float) k;
+      sct[nx+k] = cosf(arg) - sinf(arg)*_Complex_I;
+   }
+   return 0;
+}
+
+/*--------------------------------------------------------------------*/
+void cfft2rmxx(float complex f[], int isign, int mixup[],
+               float complex sct[], int nx, int ny, int nyi, int nyp,
+               int nxhd, int nyd, int nxhyd, int nxyd) {
+/* this subroutine performs the x part of a two dimensional mixed radix
+   real to complex fast fourier transform and its inverse, for a subset
+   of y, using complex arithmetic.
+   for isign = (-1,1), input: all, output: f
+   nx/ny = system length in x/y direction, must be even and contain
+   only factors 2, 3, 5 and 7
+   if isign = -1, an inverse fourier transform is performed
+   f[m][n] = (1/nx*ny)*sum(f[k][j]*
+         exp(-sqrt(-1)*2pi*n*j/nx)*exp(-sqrt(-1)*2pi*m*k/ny))
+   if isign = 1, a forward fourier transform is performed
+   f[k][j] = sum(f[m][n]*exp(sqrt(-1)*2pi*n*j/nx)*exp(sqrt(-1)*2pi*m*k/ny))
+   mixup = array of digit reversed addresses, from cwfft2rminit
+   sct = sine/cosine table, from cwfft2rminit
+   nyi = initial y index used
+   nyp = number of y indices used
+   nxhd = first dimension of f >= nx/2
+   nyd = second dimension of f >= ny
+   nxhyd = dimension of mixup >= nx/2 + ny
+   nxyd = dimension of sct >= nx + ny
+   fourier coefficients are stored as follows:
+   f[k][j] = mode j,k, where 0 <= j < nx/2 and 0 <= k < ny,
+   except for f[k][0] =  mode nx/2,k-1, where ny/2+1 <= k < ny, and
+   imag(f[0][0]) = real part of mode nx/2,0 and
+   imag(f[ny/2][0]) = real part of mode nx/2,ny/2
+local data                                                            */
+   int nxh, nxhh, nxhp, nyt, j, k, joff;
+   float ani;
+   float complex t1, t2, t3;
+   if (isign==0)
+      return;
+   nxh = nx/2;
+   nxhh = nxh/2;
+   nxhp = (nxh + 1)/2;
+   nyt = nyi + nyp - 1;
+   if (isign > 0)
+      goto L100;
+/* inverse fourier transform */
+/* transform in x */
+   cfftmr1(&f[nxhd*(nyi-1)],isign,mixup,sct,nxh,2,1,nyp,nxhd);
+/* unscramble coefficients and normalize */
+   ani = 1.0/(float) (2*nx*ny);
+   for (j = 1; j < nxhp; j++) {
+      t3 = cimagf(sct[j]) - crealf(sct[j])*_Complex_I;
+      for (k = nyi-1; k < nyt; k++) {
+         joff = nxhd*k;
+         t2 = conjf(f[nxh-j+joff]);
+         t1 = f[j+joff] + t2;
+         t2 = (f[j+joff] - t2)*t3;
+         f[j+joff] = ani*(t1 + t2);
+         f[nxh-j+joff] = ani*conjf(t1 - t2);
+      }
+   }
+   ani = 2.0*ani;
+   for (k = nyi-1; k < nyt; k++) {
+      joff = nxhd*k;
+      if (nxhp==nxhh)
+         f[nxhh+joff] = ani*conjf(f[nxhh+joff]);
+      f[joff] = ani*((crealf(f[joff]) + cimagf(f[joff]))
+                + (crealf(f[joff]) - cimagf(f[joff]))*_Complex_I);
+   }
+   return;
+/* forward fourier transform */
+/* scramble coefficients */
+L100: for (j = 1; j < nxhp; j++) {
+      t3 = cimagf(sct[j]) + crealf(sct[j])*_Complex_I;
+      for (k = nyi-1; k < nyt; k++) {
+         joff = nxhd*k;
+         t2 = conjf(f[nxh-j+joff]);
+         t1 = f[j+joff] + t2;
+         t2 = (f[j+joff] - t2)*t3;
+         f[j+joff] = t1 + t2;
+         f[nxh-j+joff] = conjf(t1 - t2);
+      }
+   }
+   for (k = nyi-1; k < nyt; k++) {
+      joff = nxhd*k;
+      if (nxhp==nxhh)
+         f[nxhh+joff] = 2.0*conjf(f[nxhh+joff]);
+      f[joff] = (crealf(f[joff]) + cimagf(f[joff]))
+                + (crealf(f[joff]) - cimagf(f[joff]))*_Complex_I;
+   }
+/* then transform in x */
+   cfftmr1(&f[nxhd*(nyi-1)],isign,mixup,sct,nxh,2,1,nyp,nxhd);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cfft2rmxy(float complex f[], int isign, int mixup[],
+               float complex sct[], int nx, int ny, int nxi, int nxp,
+               int nxhd, int nyd, int nxhyd, int nxyd) {
+/* this subroutine performs the y part of a two dimensional mixed radix
+   real to complex fast fourier transform and its inverse, for a subset
+   of x, using complex arithmetic
+   for isign = (-1,1), input: all, output: f
+   nx/ny = system length in x/y direction, must be even and contain
+   only factors 2, 3, 5 and 7
+   if isign = -1, an inverse fourier transform is performed
+   f[m][n] = (1/nx*ny)*sum(f[k][j]*
+         exp(-sqrt(-1)*2pi*n*j/nx)*exp(-sqrt(-1)*2pi*m*k/ny))
+   if isign = 1, a forward fourier transform is performed
+   f[k][j] = sum(f[m][n]*exp(sqrt(-1)*2pi*n*j/nx)*exp(sqrt(-1)*2pi*m*k/ny))
+   mixup = array of digit reversed addresses, from cwfft2rminit
+   sct = sine/cosine table, from cwfft2rminit
+   nxi = initial x index used
+   nxp = number of x indices used
+   nxhd = first dimension of f >= nx/2
+   nyd = second dimension of f >= ny
+   nxhyd = dimension of mixup >= nx/2 + ny
+   nxyd = dimension of sct >= nx + ny
+   fourier coefficients are stored as follows:
+   f[k][j] = mode j,k, where 0 <= j < nx/2 and 0 <= k < ny,
+   except for f[k][0] =  mode nx/2,k-1, where ny/2+1 <= k < ny, and
+   imag(f[0][0]) = real part of mode nx/2,0 and
+   imag(f[ny/2][0]) = real part of mode nx/2,ny/2
+local data                                                            */
+   int nxh, nyh, k, k1, joff;
+   float complex t1;
+   if (isign==0)
+      return;
+   nxh = nx/2;
+   nyh = ny/2;
+   if (isign > 0)
+      goto L80;
+/* inverse fourier transform */
+/* transform in y */
+   cfftmr1(&f[nxi-1],isign,&mixup[nxh],&sct[nx],ny,1,nxhd,nxp,1);
+/* unscramble modes kx = 0, nx/2 */
+   for (k = 1; k < nyh; k++) {
+      if (nxi==1) {
+         joff = nxhd*k;
+         k1 = nxhd*ny - joff;
+         t1 = f[k1];
+         f[k1] = 0.5*(cimagf(f[joff] + t1)
+                  + crealf(f[joff] - t1)*_Complex_I);
+         f[joff] = 0.5*(crealf(f[joff] + t1)
+                    + cimagf(f[joff] - t1)*_Complex_I);
+      }
+   }
+   return;
+/* forward fourier transform */
+/* scramble modes kx = 0, nx/2 */
+L80: for (k = 1; k < nyh; k++) {
+      if (nxi==1) {
+         joff = nxhd*k;
+         k1 = nxhd*ny - joff;
+         t1 = cimagf(f[k1]) + crealf(f[k1])*_Complex_I;
+         f[k1] = conjf(f[joff] - t1);
+         f[joff] += t1;
+      }
+   }
+/* then transform in y */
+   cfftmr1(&f[nxi-1],isign,&mixup[nxh],&sct[nx],ny,1,nxhd,nxp,1);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cfft2rm2x(float complex f[], int isign, int mixup[],
+               float complex sct[], int nx, int ny, int nyi, int nyp,
+               int nxhd, int nyd, int nxhyd, int nxyd) {
+/* this subroutine performs the x part of 2 two dimensional mixed radix
+   real to complex fast fourier transforms, and their inverses, for a
+   subset of y, using complex arithmetic
+   for isign = (-1,1), input: all, output: f
+   nx/ny = system length in x/y direction, must be even and contain
+   only factors 2, 3, 5 and 7
+   if isign = -1, two inverse fourier transforms are performed
+   f[m][n][0:1] = (1/nx*ny)*sum(f[k][j][0:1]*
+         exp(-sqrt(-1)*2pi*n*j/nx)*exp(-sqrt(-1)*2pi*m*k/ny))
+   if isign = 1, two forward fourier transforms are performed
+   f[k][j][0:1] = sum(f[m][n][0:1]*exp(sqrt(-1)*2pi*n*j/nx)*
+         exp(sqrt(-1)*2pi*m*k/ny))
+   mixup = array of digit reversed addresses, from cwfft2rminit
+   sct = sine/cosine table, from cwfft2rminit
+   nyi = initial y index used
+   nyp = number of y indices used
+   nxhd = second dimension of f
+   nyd = third dimension of f
+   nxhyd = dimension of mixup >= nx/2 + ny
+   nxyd = dimension of sct >= nx + ny
+   fourier coefficients are stored as follows:
+   f[k][j][0:1] = mode j,k, where 0 <= j < nx/2 and 0 <= k < ny,
+   except for f[k][0][0:1] =  mode nx/2,k-1, where ny/2+1 <= k < ny, and
+   imag(f[0][0][0:1]) = real part of mode nx/2,0 and
+   imag(f[ny/2][0][0:1]) = real part of mode nx/2,ny/2
+local data                                                            */
+   int nxh, nxhh, nxhp, nyt, j, k, jj, joff;
+   float at1, ani;
+   float complex t1, t2, t3;
+   if (isign==0)
+      return;
+   nxh = nx/2;
+   nxhh = nxh/2;
+   nxhp = (nxh + 1)/2;
+   nyt = nyi + nyp - 1;
+   if (isign > 0)
+      goto L140;
+/* inverse fourier transform */
+/* swap complex components */
+   for (k = nyi-1; k < nyt; k++) {
+      joff = 2*nxhd*k;
+      for (j = 0; j < nxh; j++) {
+         at1 = cimagf(f[2*j+joff]);
+         f[2*j+joff] = crealf(f[2*j+joff])
+                       + crealf(f[1+2*j+joff])*_Complex_I;
+         f[1+2*j+joff] = at1 + cimagf(f[1+2*j+joff])*_Complex_I;
+       }
+   }
+/* transform in x */
+   for (jj = 0; jj < 2; jj++) {
+      cfftmr1(&f[jj+2*nxhd*(nyi-1)],isign,mixup,sct,nxh,2,2,nyp,
+              2*nxhd);
+   }
+/* unscramble coefficients and normalize */
+   ani = 1.0/(float) (2*nx*ny);
+   for (j = 1; j < nxhp; j++) {
+      t3 = cimagf(sct[j]) - crealf(sct[j])*_Complex_I;
+      for (k = nyi-1; k < nyt; k++) {
+         joff = 2*nxhd*k;
+         for (jj = 0; jj < 2; jj++) {
+            t2 = conjf(f[jj+2*(nxh-j)+joff]);
+            t1 = f[jj+2*j+joff] + t2;
+            t2 = (f[jj+2*j+joff] - t2)*t3;
+            f[jj+2*j+joff] = ani*(t1 + t2);
+            f[jj+2*(nxh-j)+joff] = ani*conjf(t1 - t2);
+         }
+      }
+   }
+   ani = 2.0*ani;
+   for (k = nyi-1; k < nyt; k++) {
+      joff = 2*nxhd*k;
+      for (jj = 0; jj < 2; jj++) {
+         if (nxhp==nxhh)
+            f[jj+2*nxhh+joff] = ani*conjf(f[jj+2*nxhh+joff]);
+         f[jj+joff] = ani*((crealf(f[jj+joff]) + cimagf(f[jj+joff]))
+                      + (crealf(f[jj+joff]) - cimagf(f[jj+joff]))*_Complex_I);
+      }
+   }
+   return;
+/* forward fourier transform */
+/* scramble coefficients */
+L140: for (j = 1; j < nxhp; j++) {
+      t3 = cimagf(sct[j]) + crealf(sct[j])*_Complex_I;
+      for (k = nyi-1; k < nyt; k++) {
+         joff = 2*nxhd*k;
+         for (jj = 0; jj < 2; jj++) {
+            t2 = conjf(f[jj+2*(nxh-j)+joff]);
+            t1 = f[jj+2*j+joff] + t2;
+            t2 = (f[jj+2*j+joff] - t2)*t3;
+            f[jj+2*j+joff] = t1 + t2;
+            f[jj+2*(nxh-j)+joff] = conjf(t1 - t2);
+         }
+      }
+   }
+   for (k = nyi-1; k < nyt; k++) {
+      joff = 2*nxhd*k;
+      for (jj = 0; jj < 2; jj++) {
+         if (nxhp==nxhh)
+            f[jj+2*nxhh+joff] = 2.0*conjf(f[jj+2*nxhh+joff]);
+         f[jj+joff] = (crealf(f[jj+joff]) + cimagf(f[jj+joff]))
+                      + (crealf(f[jj+joff]) - cimagf(f[jj+joff]))*_Complex_I;
+      }
+   }
+/* then transform in x */
+   for (jj = 0; jj < 2; jj++) {
+      cfftmr1(&f[jj+2*nxhd*(nyi-1)],isign,mixup,sct,nxh,2,2,nyp,
+              2*nxhd);
+   }
+/* swap complex components */
+   for (k = nyi-1; k < nyt; k++) {
+      joff = 2*nxhd*k;
+      for (j = 0; j < nxh; j++) {
+         at1 = cimagf(f[2*j+joff]);
+         f[2*j+joff] = crealf(f[2*j+joff])
+                       + crealf(f[1+2*j+joff])*_Complex_I;
+         f[1+2*j+joff] = at1 + cimagf(f[1+2*j+joff])*_Complex_I;
+      }
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cfft2rm2y(float complex f[], int isign, int mixup[],
+               float complex sct[], int nx, int ny, int nxi, int nxp,
+               int nxhd, int nyd, int nxhyd, int nxyd) {
+/* this subroutine performs the y part of 2 two dimensional mixed radix
+   real to complex fast fourier transforms, and their inverses, for a
+   subset of x, using complex arithmetic
+   for isign = (-1,1), input: all, output: f
+   nx/ny = system length in x/y direction, must be even and contain
+   only factors 2, 3, 5 and 7
+   if isign = -1, two inverse fourier transforms are performed
+   f[m][n][0:1] = (1/nx*ny)*sum(f[k][j][0:1] *
+         exp(-sqrt(-1)*2pi*n*j/nx)*exp(-sqrt(-1)*2pi*m*k/ny))
+   if isign = 1, two forward fourier transforms are performed
+   f[k][j][0:1] = sum(f[m][n][0:1]*exp(sqrt(-1)*2pi*n*j/nx)*
+         exp(sqrt(-1)*2pi*m*k/ny))
+   mixup = array of digit reversed addresses, from cwfft2rminit
+   sct = sine/cosine table, from cwfft2rminit
+   nxi = initial x index used
+   nxp = number of x indices used
+   nxhd = second dimension of f
+   nyd = third dimension of f
+   nxhyd = dimension of mixup >= nx/2 + ny
+   nxyd = dimension of sct >= nx + ny
+   fourier coefficients are stored as follows:
+   f[k][j][0:1] = mode j,k, where 0 <= j < nx/2 and 0 <= k < ny,
+   except for f[k][0][0:1] =  mode nx/2,k-1, where ny/2+1 <= k < ny, and
+   imag(f[0][0][0:1]) = real part of mode nx/2,0 and
+   imag(f[ny/2][0][0:1]) = real part of mode nx/2,ny/2
+local data                                                            */
+   int nxh, nyh, k, jj, k1, joff;
+   float complex t1;
+   if (isign==0)
+      return;
+   nxh = nx/2;
+   nyh = ny/2;
+   if (isign > 0)
+      goto L90;
+/* inverse fourier transform */
+/* transform in y */
+   cfftmr1(&f[2*(nxi-1)],isign,&mixup[nxh],&sct[nx],ny,1,2*nxhd,2*nxp,
+           1);
+/* unscramble modes kx = 0, nx/2 */
+   for (k = 1; k < nyh; k++) {
+      if (nxi==1) {
+         joff = 2*nxhd*k;
+         k1 = 2*nxhd*ny - joff;
+         for (jj = 0; jj < 2; jj++) {
+            t1 = f[jj+k1];
+            f[jj+k1] = 0.5*(cimagf(f[jj+joff] + t1)
+                        + crealf(f[jj+joff] - t1)*_Complex_I);
+            f[jj+joff] = 0.5*(crealf(f[jj+joff] + t1)
+                         + cimagf(f[jj+joff] - t1)*_Complex_I);
+         }
+      }
+   }
+   return;
+/* forward fourier transform */
+/* scramble modes kx = 0, nx/2 */
+L90: for (k = 1; k < nyh; k++) {
+      if (nxi==1) {
+         joff = 2*nxhd*k;
+         k1 = 2*nxhd*ny - joff;
+         for (jj = 0; jj < 2; jj++) {
+            t1 = cimagf(f[jj+k1]) + crealf(f[jj+k1])*_Complex_I;
+            f[jj+k1] = conjf(f[jj+joff] - t1);
+            f[jj+joff] += t1;
+         }
+      }
+   }
+/* then transform in y */
+   cfftmr1(&f[2*(nxi-1)],isign,&mixup[nxh],&sct[nx],ny,1,2*nxhd,2*nxp,
+           1);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cwfft2rmx(float complex f[], int isign, int mixup[],
+               float complex sct[], int nx, int ny, int nxhd, int nyd,
+               int nxhyd, int nxyd) {
+/* wrapper function for mixed radix real to complex fft, with packed data */
+/* local data */
+   int nxh;
+   static int nxi = 1, nyi = 1;
+/* calculate range of indices */
+   nxh = nx/2;
+/* inverse fourier transform */
+   if (isign < 0) {
+/* perform x fft */
+      cfft2rmxx(f,isign,mixup,sct,nx,ny,nyi,ny,nxhd,nyd,nxhyd,nxyd);
+/* perform y fft */
+      cfft2rmxy(f,isign,mixup,sct,nx,ny,nxi,nxh,nxhd,nyd,nxhyd,nxyd);
+   }
+/* forward fourier transform */
+   else if (isign > 0) {
+/* perform y fft */
+      cfft2rmxy(f,isign,mixup,sct,nx,ny,nxi,nxh,nxhd,nyd,nxhyd,nxyd);
+/* perform x fft */
+      cfft2rmxx(f,isign,mixup,sct,nx,ny,nyi,ny,nxhd,nyd,nxhyd,nxyd);
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cwfft2rm2(float complex f[], int isign, int mixup[],
+               float complex sct[], int nx, int ny, int nxhd, int nyd,
+               int nxhyd, int nxyd) {
+/* wrapper function for 2 2d mixed radix real to complex ffts */
+/* local data */
+   int nxh;
+   static int nxi = 1, nyi = 1;
+/* calculate range of indices */
+   nxh = nx/2;
+/* inverse fourier transform */
+   if (isign < 0) {
+/* perform x fft */
+      cfft2rm2x(f,isign,mixup,sct,nx,ny,nyi,ny,nxhd,nyd,nxhyd,nxyd);
+/* perform y fft */
+      cfft2rm2y(f,isign,mixup,sct,nx,ny,nxi,nxh,nxhd,nyd,nxhyd,nxyd);
+   }
+/* forward fourier transform */
+   else if (isign > 0) {
+/* perform y fft */
+      cfft2rm2y(f,isign,mixup,sct,nx,ny,nxi,nxh,nxhd,nyd,nxhyd,nxyd);
+/* perform x fft */
+      cfft2rm2x(f,isign,mixup,sct,nx,ny,nyi,ny,nxhd,nyd,nxhyd,nxyd);
+   }
+   return;
+}
+
+/* Interfaces to Fortran */
+
+/*--------------------------------------------------------------------*/
+void cgpushpost2l_(float *part, float *fxy, float *q, float *qbm,
+                   float *qm, float *dt, float *ek, int *idimp,
+                   int *nop, int *nx, int *ny, int *nxv, int *nyv,
+                   int *ipbc) {
+   cgpushpost2l(part,fxy,q,*qbm,*qm,*dt,ek,*idimp,*nop,*nx,*ny,*nxv,
+                *nyv,*ipbc);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cisortp2yl_(float *part, int *npic, int *idimp, int *nop,
+                 int *ny1) {
+   cisortp2yl(part,npic,*idimp,*nop,*ny1);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cisortp2xyl_(float *part, int *npic, int *idimp, int *nop,
+                  int *nx1, int *nxy1) {
+   cisortp2xyl(part,npic,*idimp,*nop,*nx1,*nxy1);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cscurve2_(int *kcell, int *nx, int *ny, int *nblok, int *kcurve) {
+   cscurve2(kcell,*nx,*ny,*nblok,*kcurve);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cssortp2l_(float *parta, float *partb, int *npic, int *kcell,
+                int *idimp, int *nop, int *nx1, int *nxy1) {
+   cssortp2l(parta,partb,npic,kcell,*idimp,*nop,*nx1,*nxy1);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cgpush2lt_(float *part, float *fxy, float *qbm, float *dt,
+                float *ek, int *idimp, int *nop, int *npe, int *nx,
+                int *ny, int *nxv, int *nyv, int *ipbc) {
+   cgpush2lt(part,fxy,*qbm,*dt,ek,*idimp,*nop,*npe,*nx,*ny,*nxv,*nyv,
+             *ipbc);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cgpost2lt_(float *part, float *q, float *qm, int *nop, int *npe,
+                int *idimp, int *nxv, int *nyv) {
+   cgpost2lt(part,q,*qm,*nop,*npe,*idimp,*nxv,*nyv);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cdsortp2ylt_(float *parta, float *partb, int *npic, int *idimp,
+                  int *nop, int *npe, int *ny1) {
+   cdsortp2ylt(parta,partb,npic,*idimp,*nop,*npe,*ny1);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cpart2t_(float *part, float *partt, int *idimp, int *nop,
+              int *npe) {
+   cpart2t(part,partt,*idimp,*nop,*npe);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cpartt2_(float *partt, float *part, int *idimp, int *nop,
+              int *npe) {
+   cpartt2(partt,part,*idimp,*nop,*npe);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cpart2c_(float *part, unsigned int *cpart, int *idimp, int *ncomp,
+              int *nop, int *nx, int *ny) {
+   cpart2c(part,cpart,*idimp,*ncomp,*nop,*nx,*ny);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void ccpart2_(unsigned int *cpart, float *part, int *idimp, int *ncomp,
+              int *nop) {
+   ccpart2(cpart,part,*idimp,*ncomp,*nop);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cgpush2c_(unsigned int *cpart, float *fxy, float *qbm, float *dt,
+               float *ek, int *ncomp, int *nop, int *nx, int *ny,
+               int *nxv, int *nyv, int *ipbc) {
+   cgpush2c(cpart,fxy,*qbm,*dt,ek,*ncomp,*nop,*nx,*ny,*nxv,*nyv,*ipbc);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cgpost2c_(unsigned int *cpart, float *q, float *qm, int *ncomp,
+               int *nop, int *nxv, int *nyv) {
+   cgpost2c(cpart,q,*qm,*ncomp,*nop,*nxv,*nyv);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cdsortp2yc_(unsigned int *cparta, unsigned int *cpartb, int *npic,
+                 int *ncomp, int *nop, int *ny1) {
+   cdsortp2yc(cparta,cpartb,npic,*ncomp,*nop,*ny1);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cgpush2s_(float *part, float *fxy, float *qbm, float *dt, float *ek,
+               int *idimp, int *nop, int *nx, int *ny, int *nxv,
+               int *nyv, int *ipbc, int *norder) {
+   cgpush2s(part,fxy,*qbm,*dt,ek,*idimp,*nop,*nx,*ny,*nxv,*nyv,*ipbc,
+            *norder);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cgpost2s_(float *part, float *q, float *qm, int *nop, int *idimp,
+               int *nxv, int *nyv, int *norder) {
+   cgpost2s(part,q,*qm,*nop,*idimp,*nxv,*nyv,*norder);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void ccguard2s_(float *fxy, float *fxys, int *nx, int *ny, int *nxe,
+                int *nye, int *nxv, int *nyv) {
+   ccguard2s(fxy,fxys,*nx,*ny,*nxe,*nye,*nxv,*nyv);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void caguard2s_(float *qs, float *q, int *nx, int *ny, int *nxe,
+                int *nye, int *nxv, int *nyv) {
+   caguard2s(qs,q,*nx,*ny,*nxe,*nye,*nxv,*nyv);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+int cwfft2rminit_(int *mixup, float complex *sct, int *nx, int *ny,
+                  int *nxhyd, int *nxyd) {
+   return cwfft2rminit(mixup,sct,*nx,*ny,*nxhyd,*nxyd);
+}
+
+/*--------------------------------------------------------------------*/
+void cwfft2rmx_(float complex *f, int *isign, int *mixup,
+                float complex *sct, int *nx, int *ny, int *nxhd, int *nyd,
+                int *nxhyd, int *nxyd) {
+   cwfft2rmx(f,*isign,mixup,sct,*nx,*ny,*nxhd,*nyd,*nxhyd,*nxyd);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cwfft2rm2_(float complex *f, int *isign, int *mixup,
+                float complex *sct, int *nx, int *ny, int *nxhd, int *nyd,
+                int *nxhyd, int *nxyd) {
+   cwfft2rm2(f,*isign,mixup,sct,*nx,*ny,*nxhd,*nyd,*nxhyd,*nxyd);
+   return;
+}
@@ -0,0 +1,106 @@
+/* header file for push2x.c */
+
+void cgpushpost2l(float part[], float fxy[], float q[], float qbm,
+                  float qm, float dt, float *ek, int idimp, int nop,
+                  int nx, int ny, int nxv, int nyv, int ipbc);
+
+void cisortp2yl(float part[], int npic[], int idimp, int nop,
+                int ny1);
+
+void cisortp2xyl(float part[], int npic[], int idimp, int nop, int nx1,
+                 int nxy1);
+
+void cscurve(int ix[], int ih, int nbit, int ndim, int kcurve);
+
+void cscurve2(int kcell[], int nx, int ny, int nblok, int kcurve);
+
+void cssortp2l(float parta[], float partb[], int npic[], int kcell[],
+               int idimp, int nop, int nx1, int nxy1);
+
+void cgpush2lt(float part[], float fxy[], float qbm, float dt,
+               float *ek, int idimp, int nop, int npe, int nx, int ny,
+               int nxv, int nyv, int ipbc);
+
+void cgpost2lt(float part[], float q[], float qm, int nop, int npe,
+               int idimp, int nxv, int nyv);
+
+void cdsortp2ylt(float parta[], float partb[], int npic[], int idimp,
+                 int nop, int npe, int ny1);
+
+void cpart2t(float part[], float partt[], int idimp, int nop, int npe);
+
+void cpartt2(float partt[], float part[], int idimp, int nop, int npe);
+
+void cpart2c(float part[], unsigned int cpart[], int idimp, int ncomp,
+             int nop, int nx, int ny);
+
+void ccpart2(unsigned int cpart[], float part[], int idimp, int ncomp,
+             int nop);
+
+void cgpush2c(unsigned int cpart[], float fxy[], float qbm, float dt,
+              float *ek, int ncomp, int nop, int nx, int ny, int nxv,
+              int nyv, int ipbc);
+
+void cgpost2c(unsigned int cpart[], float q[], float qm, int ncomp,
+              int nop, int nxv, int nyv);
+
+void cdsortp2yc(unsigned int cparta[], unsigned int cpartb[], int npic[],
+                int ncomp, int nop, int ny1);
+
+int cspline1(float x, float w[], int norder);
+
+void cgpush2sn(float part[], float fxy[], float qbm, float dt,
+               float *ek, int idimp, int nop, int nx, int ny, int nxv,
+               int nyv, int ipbc, int norder);
+
+void cgpost2sn(float part[], float q[], float qm, int nop, int idimp,
+               int nxv, int nyv, int norder);
+
+void cgpush2s(float part[], float fxy[], float qbm, float dt, float *ek,
+              int idimp, int nop, int nx, int ny, int nxv, int nyv,
+              int ipbc, int norder);
+
+void cgpost2s(float part[], float q[], float qm, int nop, int idimp,
+              int nxv, int nyv, int norder);
+
+void ccguard2s(float fxy[], float fxys[], int nx, int ny, int nxe,
+               int nye, int nxv, int nyv);
+
+void caguard2s(float qs[], float q[], int nx, int ny, int nxe, int nye,
+               int nxv, int nyv);
+
+int cfftmrfac(int factor[], int n, int nfd);
+
+void cfftmrinit(int mixup[], int n);
+
+void cfftmr1(float complex f[], int isign, int mixup[],
+             float complex sct[], int n, int nrs, int is, int nvp,
+             int ivs);
+
+int cwfft2rminit(int mixup[], float complex sct[], int nx, int ny,
+                 int nxhyd, int nxyd);
+
+void cfft2rmxx(float complex f[], int isign, int mixup[],
+               float complex sct[], int nx, int ny, int nyi, int nyp,
+               int nxhd, int nyd, int nxhyd, int nxyd);
+
+void cfft2rmxy(float complex f[], int isign, int mixup[],
+               float complex sct[], int nx, int ny, int nxi, int nxp,
+               int nxhd, int nyd, int nxhyd, int nxyd);
+
+void cfft2rm2x(float complex f[], int isign, int mixup[],
+               float complex sct[], int nx, int ny, int nyi, int nyp,
+               int nxhd, int nyd, int nxhyd, int nxyd);
+
+void cfft2rm2y(float complex f[], int isign, int mixup[],
+               float complex sct[], int nx, int ny, int nxi, int nxp,
+               int nxhd, int nyd, int nxhyd, int nxyd);
+
+void cwfft2rmx(float complex f[], int isign, int mixup[],
+               float complex sct[], int nx, int ny, int nxhd, int nyd,
+               int nxhyd, int nxyd);
+
+void cwfft2rm2(float complex f[], int isign, int mixup[],
+               float complex sct[], int nx, int ny, int nxhd, int nyd,
+               int nxhyd, int nxyd);
+
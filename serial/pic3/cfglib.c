@@ -0,0 +1,256 @@
+/* run time configuration library */
+/* written for the skeleton PIC codes */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include "cfglib.h"
+
+/* MAXCFG = maximum number of parameters */
+/* MAXNAME/MAXVAL = maximum length of parameter name/value */
+/* MAXDECK = maximum size of input deck, in bytes */
+#define MAXCFG                64
+#define MAXNAME               16
+#define MAXVAL                32
+#define MAXDECK               16384
+
+/* parameter table */
+/* cname/cval = parameter name/value strings */
+/* kuse = (0,1,-1) = parameter (not yet used,used,has a bad value) */
+static char cname[MAXCFG][MAXNAME];
+static char cval[MAXCFG][MAXVAL];
+static int kuse[MAXCFG];
+static int ncfg = 0;
+/* kprt = (0,1) = (no,yes) print parameters and errors */
+static int kprt = 1;
+
+/*--------------------------------------------------------------------*/
+static int ccfgadd(const char *name, int lname, const char *val,
+                   int lval) {
+/* add or replace parameter name with value val, later definitions
+   replace earlier ones.  lname/lval = length of name/val
+   returns 1 if name or val is too long or the table is full
+local data                                                            */
+   int i;
+   if ((lname >= MAXNAME) || (lval >= MAXVAL) || (lval < 1))
+      return 1;
+   for (i = 0; i < ncfg; i++) {
+      if ((strncmp(cname[i],name,lname)==0) && (cname[i][lname]==0))
+         break;
+   }
+   if (i==ncfg) {
+      if (ncfg==MAXCFG)
+         return 1;
+      ncfg += 1;
+      memcpy(cname[i],name,lname);
+      cname[i][lname] = 0;
+   }
+   memcpy(cval[i],val,lval);
+   cval[i][lval] = 0;
+   kuse[i] = 0;
+   return 0;
+}
+
+/*--------------------------------------------------------------------*/
+static int ccfgparse(char *text, const char *src) {
+/* parse parameter definitions of the form name = value from text.
+   definitions are separated by blanks, commas or new lines, and
+   comments start with # or ! and extend to the end of the line
+   src = source of text, for error messages
+   returns number of errors found
+local data                                                            */
+   int nerr, lname, lval;
+   char *s, *name, *val;
+   nerr = 0;
+/* remove comments */
+   for (s = text; *s; s++) {
+      if ((*s=='#') || (*s=='!')) {
+         while (*s && (*s != '\n'))
+            *s++ = ' ';
+         if (*s==0)
+            break;
+      }
+   }
+   s = text;
+   while (1) {
+      while (isspace((unsigned char) *s) || (*s==','))
+         s++;
+      if (*s==0)
+         break;
+/* read name */
+      name = s;
+      while (isalnum((unsigned char) *s) || (*s=='_'))
+         s++;
+      lname = s - name;
+      while ((*s==' ') || (*s=='\t'))
+         s++;
+      if ((lname==0) || (*s != '=')) {
+         if (kprt)
+            printf("cfglib: %s: expected name = value at: %.16s\n",
+                   src,name);
+         nerr += 1;
+/* skip to next separator */
+         while (*s && !isspace((unsigned char) *s) && (*s != ','))
+            s++;
+         continue;
+      }
+      s++;
+/* read value */
+      while ((*s==' ') || (*s=='\t'))
+         s++;
+      val = s;
+      while (*s && !isspace((unsigned char) *s) && (*s != ','))
+         s++;
+      lval = s - val;
+      if (ccfgadd(name,lname,val,lval)) {
+         if (kprt)
+            printf("cfglib: %s: cannot store parameter %.*s\n",src,
+                   lname,name);
+         nerr += 1;
+      }
+   }
+   return nerr;
+}
+
+/*--------------------------------------------------------------------*/
+int ccfgread(int argc, char *argv[], int kprint) {
+/* read run time parameters from command line arguments.  an argument
+   of the form name=value defines a parameter, any other argument is
+   the name of an input deck file containing definitions of the same
+   form.  arguments are processed in order, so a definition on the
+   command line following an input deck overrides the deck
+   argc/argv = command line arguments, argv[0] is skipped
+   kprint = (0,1) = (no,yes) print parameters and errors, so that only
+   one MPI node reports
+   returns number of errors found
+local data                                                            */
+   int i, n, nerr;
+   char *text;
+   FILE *unit;
+   nerr = 0;
+   ncfg = 0;
+   kprt = kprint;
+   for (i = 1; i < argc; i++) {
+      if (strchr(argv[i],'=')) {
+         n = strlen(argv[i]);
+         text = (char *) malloc(n+1);
+         if (text==NULL)
+            return nerr + 1;
+         memcpy(text,argv[i],n+1);
+         nerr += ccfgparse(text,"command line");
+         free(text);
+         continue;
+      }
+/* read input deck */
+      unit = fopen(argv[i],"r");
+      if (unit==NULL) {
+         if (kprt)
+            printf("cfglib: cannot open input deck %s\n",argv[i]);
+         nerr += 1;
+         continue;
+      }
+      text = (char *) malloc(MAXDECK);
+      if (text==NULL) {
+         fclose(unit);
+         return nerr + 1;
+      }
+      n = fread(text,1,MAXDECK-1,unit);
+      if (!feof(unit)) {
+         if (kprt)
+            printf("cfglib: input deck %s too large\n",argv[i]);
+         nerr += 1;
+      }
+      fclose(unit);
+      text[n] = 0;
+      nerr += ccfgparse(text,argv[i]);
+      free(text);
+   }
+   return nerr;
+}
+
+/*--------------------------------------------------------------------*/
+static int ccfgfind(const char *name) {
+/* return location of parameter name in table, -1 if not found
+local data                                                            */
+   int i;
+   for (i = 0; i < ncfg; i++) {
+      if (strcmp(cname[i],name)==0)
+         return i;
+   }
+   return -1;
+}
+
+/*--------------------------------------------------------------------*/
+int ccfgint(const char *name, int *ival) {
+/* replace integer parameter ival with value given for name, if any
+   returns 1 if ival was replaced, 0 if name was not given, and -1 if
+   the value given is not an integer, in which case ival is unchanged
+local data                                                            */
+   int i;
+   long it;
+   char *end;
+   i = ccfgfind(name);
+   if (i < 0)
+      return 0;
+   it = strtol(cval[i],&end,10);
+   if ((*end != 0) || (it != (int) it)) {
+      kuse[i] = -1;
+      return -1;
+   }
+   *ival = it;
+   kuse[i] = 1;
+   return 1;
+}
+
+/*--------------------------------------------------------------------*/
+int ccfgflt(const char *name, float *fval) {
+/* replace real parameter fval with value given for name, if any
+   returns 1 if fval was replaced, 0 if name was not given, and -1 if
+   the value given is not a number, in which case fval is unchanged
+local data                                                            */
+   int i;
+   float at;
+   char *end;
+   i = ccfgfind(name);
+   if (i < 0)
+      return 0;
+   at = strtof(cval[i],&end);
+   if (*end != 0) {
+      kuse[i] = -1;
+      return -1;
+   }
+   *fval = at;
+   kuse[i] = 1;
+   return 1;
+}
+
+/*--------------------------------------------------------------------*/
+int ccfgend() {
+/* check that every parameter given was used with a valid value, so
+   that misspelled names are not silently ignored, and print the
+   parameters given if all are valid
+   returns number of parameters which were not used or had bad values
+local data                                                            */
+   int i, nerr;
+   nerr = 0;
+   for (i = 0; i < ncfg; i++) {
+      if (kuse[i]==1)
+         continue;
+      nerr += 1;
+      if (!kprt)
+         continue;
+      if (kuse[i] < 0)
+         printf("cfglib: bad value for %s = %s\n",cname[i],cval[i]);
+      else
+         printf("cfglib: unknown parameter %s = %s\n",cname[i],cval[i]);
+   }
+   if (kprt && (nerr==0) && (ncfg > 0)) {
+      printf("run time parameters:");
+      for (i = 0; i < ncfg; i++) {
+         printf(" %s=%s",cname[i],cval[i]);
+      }
+      printf("\n");
+   }
+   return nerr;
+}
@@ -4,8 +4,11 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <complex.h>
+#include <math.h>
 #include <sys/time.h>
 #include "push3.h"
+#include "push3x.h"
+#include "cfglib.h"
 
 void dtimer(double *time, struct timeval *itime, int icntrl);
 
@@ -33,10 +36,16 @@ int main(int argc, char *argv[]) {
    int idimp = 6, ipbc = 1, sortime = 20;
 /* wke/we/wt = particle kinetic/electric field/total energy */
    float wke = 0.0, we = 0.0, wt = 0.0;
+/* norder = interpolation order = (1,2,3) = (linear,quadratic,cubic) */
+   int norder = 1;
+/* kcurve = (0,1,2) = order cells for sorting along (row,Morton,Hilbert) */
+/* curve, nblok = curve granularity, in cells                            */
+   int kcurve = 0, nblok = 1;
 /* declare scalars for standard code */
-   int j;
+   int j, irc;
    int np, nx, ny, nz, nxh, nyh, nzh, nxe, nye, nze, nxeh;
-   int nxyzh, nxhyz, ny1, nyz1, ntime, nloop, isign;
+   int nxv, nyv, nzv;
+   int nxyzh, nxhyz, ny1, nyz1, nxy1, nxyz1, ntime, nloop, isign;
    float qbme, affp;
 
 /* declare arrays for standard code: */
@@ -46,12 +55,17 @@ int main(int argc, char *argv[]) {
    float *qe = NULL;
 /* fxyze = smoothed electric field with guard cells */
    float *fxyze = NULL;
+/* qs/fxyzs = charge density/smoothed electric field with guard cells */
+/* on both sides, for norder > 1                                      */
+   float *qs = NULL, *fxyzs = NULL;
 /* ffc = form factor array for poisson solver */
    float complex *ffc = NULL;
 /* mixup = bit reverse table for FFT */
    int *mixup = NULL;
 /* sct = sine/cosine table for FFT */
    float complex *sct = NULL;
+/* kcell = position of each cell along space filling curve */
+   int *kcell = NULL;
 /* npic = scratch array for reordering particles */
    int *npic = NULL;
   
@@ -61,6 +75,24 @@ int main(int argc, char *argv[]) {
    float tdpost = 0.0, tguard = 0.0, tfft = 0.0, tfield = 0.0;
    float tpush = 0.0, tsort = 0.0;
    double dtime;
+/* wsum/wsum2 = sum of field energy and its square, for noise estimate */
+   double wsum = 0.0, wsum2 = 0.0;
+
+/* replace parameters with values from input decks or command line, */
+/* for example: cpic3 indx=6 npx=192 npy=192 npz=192                */
+   irc = ccfgread(argc,argv,1);
+   ccfgint("indx",&indx); ccfgint("indy",&indy); ccfgint("indz",&indz);
+   ccfgint("npx",&npx); ccfgint("npy",&npy); ccfgint("npz",&npz);
+   ccfgflt("tend",&tend); ccfgflt("dt",&dt); ccfgflt("vtx",&vtx);
+   ccfgflt("vty",&vty); ccfgflt("vtz",&vtz); ccfgflt("vx0",&vx0);
+   ccfgflt("vy0",&vy0); ccfgflt("vz0",&vz0);
+   ccfgint("sortime",&sortime); ccfgint("norder",&norder);
+   ccfgint("kcurve",&kcurve); ccfgint("nblok",&nblok);
+   irc += ccfgend();
+   if (irc != 0) {
+      printf("invalid run time parameters\n");
+      exit(1);
+   }
 
 /* initialize scalars for standard code */
 /* np = total number of particles in simulation */
@@ -71,6 +103,9 @@ int main(int argc, char *argv[]) {
    nxyzh = (nx > ny ? nx : ny); nxyzh = (nxyzh > nz ? nxyzh : nz)/2;
    nxhyz = nxh > ny ? nxh : ny; nxhyz = nxhyz > nz ? nxhyz : nz;
    ny1 = ny + 1; nyz1 = ny1*(nz + 1);
+   nxy1 = (nx + 1)*ny1; nxyz1 = nxy1*(nz + 1);
+/* nxv/nyv/nzv = dimensions of extended arrays for spline interpolation */
+   nxv = nx + 3; nyv = ny + 3; nzv = nz + 3;
 /* nloop = number of time steps in simulation */
 /* ntime = current time step */
    nloop = tend/dt + .0001; ntime = 0;
@@ -86,7 +121,25 @@ int main(int argc, char *argv[]) {
    ffc = (float complex *) malloc(nxh*nyh*nzh*sizeof(float complex));
    mixup = (int *) malloc(nxhyz*sizeof(int));
    sct = (float complex *) malloc(nxyzh*sizeof(float complex));
-   npic = (int *) malloc(nyz1*sizeof(int));
+   if (kcurve > 0) {
+      if ((kcurve > 2) || (nblok < 1)) {
+         printf("invalid kcurve, nblok = %d,%d\n",kcurve,nblok);
+         exit(1);
+      }
+      kcell = (int *) malloc(nxyz1*sizeof(int));
+      cscurve3(kcell,nx,ny,nz,nblok,kcurve);
+      npic = (int *) malloc(nxyz1*sizeof(int));
+   }
+   else
+      npic = (int *) malloc(nyz1*sizeof(int));
+   if (norder > 1) {
+      if (norder > 3) {
+         printf("invalid norder = %d\n",norder);
+         exit(1);
+      }
+      qs = (float *) malloc(nxv*nyv*nzv*sizeof(float));
+      fxyzs = (float *) malloc(ndim*nxv*nyv*nzv*sizeof(float));
+   }
 
 /* prepare fft tables */
    cwfft3rinit(mixup,sct,indx,indy,indz,nxhyz,nxyzh);
@@ -106,17 +159,28 @@ L500: if (nloop <= ntime)
  
 /* deposit charge with standard procedure: updates qe */
       dtimer(&dtime,&itime,-1);
-      for (j = 0; j < nxe*nye; j++) {
-         qe[j] = 0.0;
+      if (norder > 1) {
+         for (j = 0; j < nxv*nyv*nzv; j++) {
+            qs[j] = 0.0;
+         }
+         cgpost3s(part,qs,qme,np,idimp,nxv,nyv,nzv,norder);
+      }
+      else {
+         for (j = 0; j < nxe*nye; j++) {
+            qe[j] = 0.0;
+         }
+         cgpost3l(part,qe,qme,np,idimp,nxe,nye,nze);
       }
-      cgpost3l(part,qe,qme,np,idimp,nxe,nye,nze);
       dtimer(&dtime,&itime,1);
       time = (float) dtime;
       tdpost += time;
 
 /* add guard cells with standard procedure: updates qe */
       dtimer(&dtime,&itime,-1);
-      caguard3l(qe,nx,ny,nz,nxe,nye,nze);
+      if (norder > 1)
+         caguard3s(qs,qe,nx,ny,nz,nxe,nye,nze,nxv,nyv,nzv);
+      else
+         caguard3l(qe,nx,ny,nz,nxe,nye,nze);
       dtimer(&dtime,&itime,1);
       time = (float) dtime;
       tguard += time;
@@ -136,6 +200,8 @@ L500: if (nloop <= ntime)
       isign = -1;
       cpois33((float complex *)qe,(float complex *)fxyze,isign,ffc,ax,ay,
               az,affp,&we,nx,ny,nz,nxeh,nye,nze,nxh,nyh,nzh);
+      wsum += we;
+      wsum2 += we*we;
       dtimer(&dtime,&itime,1);
       time = (float) dtime;
       tfield += time;
@@ -151,7 +217,10 @@ L500: if (nloop <= ntime)
 
 /* copy guard cells with standard procedure: updates fxyze */
       dtimer(&dtime,&itime,-1);
-      ccguard3l(fxyze,nx,ny,nz,nxe,nye,nze);
+      if (norder > 1)
+         ccguard3s(fxyze,fxyzs,nx,ny,nz,nxe,nye,nze,nxv,nyv,nzv);
+      else
+         ccguard3l(fxyze,nx,ny,nz,nxe,nye,nze);
       dtimer(&dtime,&itime,1);
       time = (float) dtime;
       tguard += time;
@@ -159,8 +228,12 @@ L500: if (nloop <= ntime)
 /* push particles with standard procedure: updates part, wke */
       wke = 0.0;
       dtimer(&dtime,&itime,-1);
-      cgpush3l(part,fxyze,qbme,dt,&wke,idimp,np,nx,ny,nz,nxe,nye,nze,
-               ipbc);
+      if (norder > 1)
+         cgpush3s(part,fxyzs,qbme,dt,&wke,idimp,np,nx,ny,nz,nxv,nyv,nzv,
+                  ipbc,norder);
+      else
+         cgpush3l(part,fxyze,qbme,dt,&wke,idimp,np,nx,ny,nz,nxe,nye,nze,
+                  ipbc);
       dtimer(&dtime,&itime,1);
       time = (float) dtime;
       tpush += time;
@@ -169,7 +242,10 @@ L500: if (nloop <= ntime)
       if (sortime > 0) {
          if (ntime%sortime==0) {
             dtimer(&dtime,&itime,-1);
-            cdsortp3yzl(part,part2,npic,idimp,np,ny1,nyz1);
+            if (kcurve > 0)
+               cssortp3l(part,part2,npic,kcell,idimp,np,nx+1,nxy1,nxyz1);
+            else
+               cdsortp3yzl(part,part2,npic,idimp,np,ny1,nyz1);
 /* exchange pointers */
             tpart = part;
             part = part2;
@@ -193,6 +269,13 @@ L2000:
    printf("ntime = %i\n",ntime);
    printf("Final Field, Kinetic and Total Energies:\n");
    printf("%e %e %e\n",we,wke,wke+we);
+/* field energy fluctuation measures particle noise */
+   wsum = wsum/(double) ntime;
+   wsum2 = wsum2/(double) ntime - wsum*wsum;
+   wsum2 = wsum2 > 0.0 ? sqrt(wsum2) : 0.0;
+   printf("Average and RMS Fluctuation of Field Energy, norder = %d:\n",
+          norder);
+   printf("%e %e\n",wsum,wsum2);
 
    printf("\n");
    printf("deposit time = %f\n",tdpost);
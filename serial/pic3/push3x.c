@@ -0,0 +1,638 @@
+/* C Library for Skeleton 3D Electrostatic PIC Code */
+/* procedures with no Fortran77 equivalent in push3.f, linked with */
+/* both push3.c and push3_f.c */
+/* written for the skeleton PIC codes */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <complex.h>
+#include <math.h>
+#include "push3.h"
+#include "push3x.h"
+
+/*--------------------------------------------------------------------*/
+int cspline1(float x, float w[], int norder) {
+/* this function calculates the interpolation weights of a particle at
+   position x for a spline shape function of order norder
+   input: x, norder, output: w
+   for norder = 1, linear: n = x, dx = x - n
+   w[0] = 1 - dx, w[1] = dx
+   for norder = 2, quadratic: n = x + 0.5, dx = x - n
+   w[0] = .5*(.5 - dx)**2, w[1] = .75 - dx**2, w[2] = .5*(.5 + dx)**2
+   for norder = 3, cubic: n = x, dx = x - n
+   w[0] = (1 - dx)**3/6, w[1] = (4 - 6*dx**2 + 3*dx**3)/6,
+   w[2] = (1 + 3*dx + 3*dx**2 - 3*dx**3)/6, w[3] = dx**3/6
+   x = position of particle, must be >= 0
+   w = interpolation weights for norder+1 grid points
+   returns leftmost grid point used, n for linear, n-1 otherwise
+local data                                                            */
+   int nn;
+   float dx, dx2, dx3, amx;
+   if (norder==2) {
+      nn = x + 0.5f;
+      dx = x - (float) nn;
+      amx = 0.5f - dx;
+      w[0] = 0.5f*amx*amx;
+      w[1] = 0.75f - dx*dx;
+      amx = 0.5f + dx;
+      w[2] = 0.5f*amx*amx;
+      return nn - 1;
+   }
+   nn = x;
+   dx = x - (float) nn;
+   amx = 1.0f - dx;
+   if (norder==3) {
+      dx2 = dx*dx;
+      dx3 = dx*dx2;
+      w[0] = amx*amx*amx/6.0f;
+      w[1] = (4.0f - 6.0f*dx2 + 3.0f*dx3)/6.0f;
+      w[2] = (1.0f + 3.0f*(dx + dx2 - dx3))/6.0f;
+      w[3] = dx3/6.0f;
+      return nn - 1;
+   }
+   w[0] = amx;
+   w[1] = dx;
+   return nn;
+}
+
+/*--------------------------------------------------------------------*/
+void cgpush3sn(float part[], float fxyz[], float qbm, float dt,
+               float *ek, int idimp, int nop, int nx, int ny, int nz,
+               int nxv, int nyv, int nzv, int ipbc, int norder) {
+/* for 3d code, this subroutine updates particle co-ordinates and
+   velocities using leap-frog scheme in time and linear, quadratic or
+   cubic spline interpolation in space
+   scalar version using guard cells on both sides
+   input: all, output: part, ek
+   equations used are:
+   vx(t+dt/2) = vx(t-dt/2) + (q/m)*fx(x(t),y(t),z(t))*dt,
+   vy(t+dt/2) = vy(t-dt/2) + (q/m)*fy(x(t),y(t),z(t))*dt,
+   vz(t+dt/2) = vz(t-dt/2) + (q/m)*fz(x(t),y(t),z(t))*dt,
+   where q/m is charge/mass, and
+   x(t+dt) = x(t) + vx(t+dt/2)*dt, y(t+dt) = y(t) + vy(t+dt/2)*dt,
+   z(t+dt) = z(t) + vz(t+dt/2)*dt
+   fx(x(t),y(t),z(t)), fy(x(t),y(t),z(t)), and fz(x(t),y(t),z(t))
+   are approximated by interpolation from the nearest norder+1 grid
+   points in each direction:
+   fx(x,y,z) = sum(wz[l]*wy[m]*wx[n]*fx(n,m,l)), and similarly for fy, fz
+   where wx, wy, wz are the spline weights calculated by cspline1
+   part[n][0] = position x of particle n
+   part[n][1] = position y of particle n
+   part[n][2] = position z of particle n
+   part[n][3] = velocity vx of particle n
+   part[n][4] = velocity vy of particle n
+   part[n][5] = velocity vz of particle n
+   fxyz[l+1][k+1][j+1][0] = x component of force/charge at grid (j,k,l)
+   fxyz[l+1][k+1][j+1][1] = y component of force/charge at grid (j,k,l)
+   fxyz[l+1][k+1][j+1][2] = z component of force/charge at grid (j,k,l)
+   that is, convolution of electric field over particle shape,
+   with one guard cell on the left and two on the right
+   qbm = particle charge/mass ratio
+   dt = time interval between successive calculations
+   kinetic energy/mass at time t is also calculated, using
+   ek = .125*sum((vx(t+dt/2)+vx(t-dt/2))**2+(vy(t+dt/2)+vy(t-dt/2))**2+
+   (vz(t+dt/2)+vz(t-dt/2))**2)
+   idimp = size of phase space = 6
+   nop = number of particles
+   nx/ny/nz = system length in x/y/z direction
+   nxv = second dimension of field array, must be >= nx+3
+   nyv = third dimension of field array, must be >= ny+3
+   nzv = fourth dimension of field array, must be >= nz+3
+   ipbc = particle boundary condition = (0,1,2,3) =
+   (none,3d periodic,3d reflecting,mixed 2d reflecting/1d periodic)
+   norder = interpolation order = (1,2,3) = (linear,quadratic,cubic)
+local data                                                            */
+   int j, i, k, l, nn, mm, ll, np, mp, lp, nxv3, nxyv3, no1;
+   float qtm, edgelx, edgely, edgelz, edgerx, edgery, edgerz;
+   float at1, dx, dy, dz, vx, vy, vz, ux, uy, uz;
+   float wx[4], wy[4], wz[4];
+   double sum1;
+   nxv3 = 3*nxv;
+   nxyv3 = nxv3*nyv;
+   no1 = norder + 1;
+   qtm = qbm*dt;
+   sum1 = 0.0;
+/* set boundary values */
+   edgelx = 0.0;
+   edgely = 0.0;
+   edgelz = 0.0;
+   edgerx = (float) nx;
+   edgery = (float) ny;
+   edgerz = (float) nz;
+   if (ipbc==2) {
+      edgelx = 1.0;
+      edgely = 1.0;
+      edgelz = 1.0;
+      edgerx = (float) (nx-1);
+      edgery = (float) (ny-1);
+      edgerz = (float) (nz-1);
+   }
+   else if (ipbc==3) {
+      edgelx = 1.0;
+      edgely = 1.0;
+      edgerx = (float) (nx-1);
+      edgery = (float) (ny-1);
+   }
+   for (j = 0; j < nop; j++) {
+/* find interpolation weights */
+      nn = cspline1(part[idimp*j],wx,norder);
+      mm = cspline1(part[1+idimp*j],wy,norder);
+      ll = cspline1(part[2+idimp*j],wz,norder);
+      nn = 3*(nn + 1);
+      mm = nxv3*(mm + 1);
+      ll = nxyv3*(ll + 1);
+/* find acceleration */
+      dx = 0.0;
+      dy = 0.0;
+      dz = 0.0;
+      for (l = 0; l < no1; l++) {
+         lp = nn + ll + nxyv3*l;
+         ux = 0.0;
+         uy = 0.0;
+         uz = 0.0;
+         for (k = 0; k < no1; k++) {
+            mp = lp + mm + nxv3*k;
+            vx = 0.0;
+            vy = 0.0;
+            vz = 0.0;
+            for (i = 0; i < no1; i++) {
+               np = mp + 3*i;
+               vx += wx[i]*fxyz[np];
+               vy += wx[i]*fxyz[np+1];
+               vz += wx[i]*fxyz[np+2];
+            }
+            ux += wy[k]*vx;
+            uy += wy[k]*vy;
+            uz += wy[k]*vz;
+         }
+         at1 = wz[l];
+         dx += at1*ux;
+         dy += at1*uy;
+         dz += at1*uz;
+      }
+/* new velocity */
+      vx = part[3+idimp*j];
+      vy = part[4+idimp*j];
+      vz = part[5+idimp*j];
+      dx = vx + qtm*dx;
+      dy = vy + qtm*dy;
+      dz = vz + qtm*dz;
+/* average kinetic energy */
+      vx += dx;
+      vy += dy;
+      vz += dz;
+      sum1 += vx*vx + vy*vy + vz*vz;
+      part[3+idimp*j] = dx;
+      part[4+idimp*j] = dy;
+      part[5+idimp*j] = dz;
+/* new position */
+      dx = part[idimp*j] + dx*dt;
+      dy = part[1+idimp*j] + dy*dt;
+      dz = part[2+idimp*j] + dz*dt;
+/* periodic boundary conditions */
+      if (ipbc==1) {
+         if (dx < edgelx) dx += edgerx;
+         if (dx >= edgerx) dx -= edgerx;
+         if (dy < edgely) dy += edgery;
+         if (dy >= edgery) dy -= edgery;
+         if (dz < edgelz) dz += edgerz;
+         if (dz >= edgerz) dz -= edgerz;
+      }
+/* reflecting boundary conditions */
+      else if (ipbc==2) {
+         if ((dx < edgelx) || (dx >= edgerx)) {
+            dx = part[idimp*j];
+            part[3+idimp*j] = -part[3+idimp*j];
+         }
+         if ((dy < edgely) || (dy >= edgery)) {
+            dy = part[1+idimp*j];
+            part[4+idimp*j] = -part[4+idimp*j];
+         }
+         if ((dz < edgelz) || (dz >= edgerz)) {
+            dz = part[2+idimp*j];
+            part[5+idimp*j] = -part[5+idimp*j];
+         }
+      }
+/* mixed reflecting/periodic boundary conditions */
+      else if (ipbc==3) {
+         if ((dx < edgelx) || (dx >= edgerx)) {
+            dx = part[idimp*j];
+            part[3+idimp*j] = -part[3+idimp*j];
+         }
+         if ((dy < edgely) || (dy >= edgery)) {
+            dy = part[1+idimp*j];
+            part[4+idimp*j] = -part[4+idimp*j];
+         }
+         if (dz < edgelz) dz += edgerz;
+         if (dz >= edgerz) dz -= edgerz;
+      }
+/* set new position */
+      part[idimp*j] = dx;
+      part[1+idimp*j] = dy;
+      part[2+idimp*j] = dz;
+   }
+/* normalize kinetic energy */
+   *ek += 0.125*sum1;
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cgpost3sn(float part[], float q[], float qm, int nop, int idimp,
+               int nxv, int nyv, int nzv, int norder) {
+/* for 3d code, this subroutine calculates particle charge density
+   using linear, quadratic or cubic spline interpolation
+   scalar version using guard cells on both sides
+   input: all, output: q
+   charge density is approximated by values at the nearest norder+1
+   grid points in each direction
+   q(n,m,l)=qm*wx[n]*wy[m]*wz[l]
+   where wx, wy, wz are the spline weights calculated by cspline1
+   part[n][0] = position x of particle n
+   part[n][1] = position y of particle n
+   part[n][2] = position z of particle n
+   q[l+1][k+1][j+1] = charge density at grid point j,k,l,
+   with one guard cell on the left and two on the right
+   qm = charge on particle, in units of e
+   nop = number of particles
+   idimp = size of phase space = 6
+   nxv = first dimension of charge array, must be >= nx+3
+   nyv = second dimension of charge array, must be >= ny+3
+   nzv = third dimension of charge array, must be >= nz+3
+   norder = interpolation order = (1,2,3) = (linear,quadratic,cubic)
+local data                                                            */
+   int j, i, k, l, nn, mm, ll, mp, lp, nxyv, no1;
+   float at1, at2;
+   float wx[4], wy[4], wz[4];
+   nxyv = nxv*nyv;
+   no1 = norder + 1;
+   for (j = 0; j < nop; j++) {
+/* find interpolation weights */
+      nn = cspline1(part[idimp*j],wx,norder);
+      mm = cspline1(part[1+idimp*j],wy,norder);
+      ll = cspline1(part[2+idimp*j],wz,norder);
+      nn = nn + 1;
+      mm = nxv*(mm + 1);
+      ll = nxyv*(ll + 1);
+/* deposit charge */
+      for (l = 0; l < no1; l++) {
+         lp = nn + mm + ll + nxyv*l;
+         at1 = qm*wz[l];
+         for (k = 0; k < no1; k++) {
+            mp = lp + nxv*k;
+            at2 = at1*wy[k];
+            for (i = 0; i < no1; i++) {
+               q[i+mp] += at2*wx[i];
+            }
+         }
+      }
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cgpush3s(float part[], float fxyz[], float qbm, float dt,
+              float *ek, int idimp, int nop, int nx, int ny, int nz,
+              int nxv, int nyv, int nzv, int ipbc, int norder) {
+/* for 3d code, this subroutine updates particle co-ordinates and
+   velocities using spline interpolation of order norder, by calling
+   cgpush3sn with a constant order, so that a specialized kernel with
+   fixed length interpolation loops is generated for each order
+   norder = interpolation order = (1,2,3) = (linear,quadratic,cubic)
+   other arguments are described in cgpush3sn                        */
+   switch (norder) {
+   case 2:
+      cgpush3sn(part,fxyz,qbm,dt,ek,idimp,nop,nx,ny,nz,nxv,nyv,nzv,
+                ipbc,2);
+      break;
+   case 3:
+      cgpush3sn(part,fxyz,qbm,dt,ek,idimp,nop,nx,ny,nz,nxv,nyv,nzv,
+                ipbc,3);
+      break;
+   default:
+      cgpush3sn(part,fxyz,qbm,dt,ek,idimp,nop,nx,ny,nz,nxv,nyv,nzv,
+                ipbc,1);
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cgpost3s(float part[], float q[], float qm, int nop, int idimp,
+              int nxv, int nyv, int nzv, int norder) {
+/* for 3d code, this subroutine calculates particle charge density
+   using spline interpolation of order norder, by calling cgpost3sn with
+   a constant order, so that a specialized kernel with fixed length
+   interpolation loops is generated for each order
+   norder = interpolation order = (1,2,3) = (linear,quadratic,cubic)
+   other arguments are described in cgpost3sn                        */
+   switch (norder) {
+   case 2:
+      cgpost3sn(part,q,qm,nop,idimp,nxv,nyv,nzv,2);
+      break;
+   case 3:
+      cgpost3sn(part,q,qm,nop,idimp,nxv,nyv,nzv,3);
+      break;
+   default:
+      cgpost3sn(part,q,qm,nop,idimp,nxv,nyv,nzv,1);
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cscurve(int ix[], int ih, int nbit, int ndim, int kcurve) {
+/* this subroutine finds the coordinates of point ih along a Morton or
+   Hilbert space filling curve, using the transposed representation of
+   J. Skilling, AIP Conf. Proc. 707, 381 (2004)
+   ix = output coordinates of point ih, each in the range 0:2**nbit-1
+   ih = index of point along curve, 0 <= ih < 2**(nbit*ndim)
+   nbit = number of bits per coordinate
+   ndim = number of dimensions
+   kcurve = (1,2) = (Morton,Hilbert) curve
+local data                                                            */
+   int i, j, k, it, ip, iq, nn;
+/* distribute the bits of ih over the coordinates, most significant */
+/* bit first, which is the Morton order                             */
+   for (i = 0; i < ndim; i++) {
+      ix[i] = 0;
+   }
+   k = nbit*ndim;
+   for (j = 0; j < nbit; j++) {
+      for (i = 0; i < ndim; i++) {
+         k -= 1;
+         ix[i] = (ix[i] << 1) | ((ih >> k) & 1);
+      }
+   }
+   if ((kcurve != 2) || (nbit < 1))
+      return;
+/* gray decode */
+   it = ix[ndim-1] >> 1;
+   for (i = ndim-1; i > 0; i--) {
+      ix[i] ^= ix[i-1];
+   }
+   ix[0] ^= it;
+/* undo excess work */
+   nn = 2 << (nbit - 1);
+   for (iq = 2; iq != nn; iq <<= 1) {
+      ip = iq - 1;
+      for (i = ndim-1; i >= 0; i--) {
+/* invert */
+         if (ix[i] & iq) {
+            ix[0] ^= ip;
+         }
+/* exchange */
+         else {
+            it = (ix[0] ^ ix[i]) & ip;
+            ix[0] ^= it;
+            ix[i] ^= it;
+         }
+      }
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cscurve3(int kcell[], int nx, int ny, int nz, int nblok,
+              int kcurve) {
+/* this subroutine numbers the cells of a 3d grid along a space filling
+   curve.  the grid is divided into blocks of nblok x nblok x nblok
+   cells which are visited in Morton or Hilbert order, and the cells
+   within a block are visited in row order.  guard cells are numbered
+   last
+   kcell[l][m][n] = position of cell (n,m,l) along curve
+   nx/ny/nz = system length in x/y/z direction
+   nblok = curve granularity, in cells
+   kcurve = (0,1,2) = (row,Morton,Hilbert) order
+local data                                                            */
+   int i, j, k, n, m, l, nx1, ny1, nz1, nxy1, nbx, nby, nbz, nbit;
+   int ih, nh, isum;
+   int ix[3];
+   nx1 = nx + 1; ny1 = ny + 1; nz1 = nz + 1; nxy1 = nx1*ny1;
+   nbx = (nx - 1)/nblok + 1; nby = (ny - 1)/nblok + 1;
+   nbz = (nz - 1)/nblok + 1;
+   if (kcurve==0) {
+      nbx = 1; nby = 1; nbz = 1;
+      nblok = nx > ny ? nx : ny;
+      nblok = nblok > nz ? nblok : nz;
+   }
+/* find number of bits needed for largest block coordinate */
+   nbit = 0;
+   k = nbx > nby ? nbx : nby;
+   k = k > nbz ? k : nbz;
+   while ((1 << nbit) < k) {
+      nbit += 1;
+   }
+   nh = 1 << (3*nbit);
+/* mark all cells as guard cells */
+   for (k = 0; k < nxy1*nz1; k++) {
+      kcell[k] = -1;
+   }
+/* visit blocks along curve, skipping those outside the grid */
+   isum = 0;
+   for (ih = 0; ih < nh; ih++) {
+      cscurve(ix,ih,nbit,3,kcurve);
+      if ((ix[0] >= nbx) || (ix[1] >= nby) || (ix[2] >= nbz))
+         continue;
+      for (k = 0; k < nblok; k++) {
+         l = k + nblok*ix[2];
+         if (l >= nz)
+            break;
+         for (j = 0; j < nblok; j++) {
+            m = j + nblok*ix[1];
+            if (m >= ny)
+               break;
+            for (i = 0; i < nblok; i++) {
+               n = i + nblok*ix[0];
+               if (n >= nx)
+                  break;
+               kcell[n+nx1*m+nxy1*l] = isum;
+               isum += 1;
+            }
+         }
+      }
+   }
+/* number guard cells */
+   for (k = 0; k < nxy1*nz1; k++) {
+      if (kcell[k] < 0) {
+         kcell[k] = isum;
+         isum += 1;
+      }
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cssortp3l(float parta[], float partb[], int npic[], int kcell[],
+               int idimp, int nop, int nx1, int nxy1, int nxyz1) {
+/* this subroutine sorts particles by cell, with the cells ordered
+   along a space filling curve
+   linear interpolation
+   parta/partb = input/output particle arrays
+   parta[n][0] = position x of particle n
+   parta[n][1] = position y of particle n
+   parta[n][2] = position z of particle n
+   npic = address offset for reordering particles
+   kcell = position of each cell along curve, from cscurve3
+   idimp = size of phase space = 6
+   nop = number of particles
+   nx1 = system length in x direction + 1
+   nxy1 = nx1*ny1, where ny1 = system length in y direction + 1
+   nxyz1 = nxy1*nz1, where nz1 = system length in z direction + 1
+local data                                                            */
+   int i, j, k, n, m, l, isum, ist, ip;
+/* clear counter array */
+   for (k = 0; k < nxyz1; k++) {
+      npic[k] = 0;
+   }
+/* find how many particles in each cell */
+   for (j = 0; j < nop; j++) {
+      n = parta[idimp*j];
+      m = parta[1+idimp*j];
+      l = parta[2+idimp*j];
+      l = kcell[n+nx1*m+nxy1*l];
+      npic[l] += 1;
+   }
+/* find address offset */
+   isum = 0;
+   for (k = 0; k < nxyz1; k++) {
+      ist = npic[k];
+      npic[k] = isum;
+      isum += ist;
+   }
+/* find addresses of particles at each cell and reorder particles */
+   for (j = 0; j < nop; j++) {
+      n = parta[idimp*j];
+      m = parta[1+idimp*j];
+      l = parta[2+idimp*j];
+      l = kcell[n+nx1*m+nxy1*l];
+      ip = npic[l];
+      for (i = 0; i < idimp; i++) {
+         partb[i+idimp*ip] = parta[i+idimp*j];
+      }
+      npic[l] = ip + 1;
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void ccguard3s(float fxyz[], float fxyzs[], int nx, int ny, int nz,
+               int nxe, int nye, int nze, int nxv, int nyv, int nzv) {
+/* copy periodic vector field fxyz into extended field fxyzs with one
+   guard cell on the left and two on the right, for spline interpolation
+   of order up to 3
+   fxyz[l][k][j][0:2] = field at grid (j,k,l), without guard cells
+   fxyzs[l+1][k+1][j+1][0:2] = field at grid (j,k,l), with guard cells
+   nx/ny/nz = system length in x/y/z direction
+   nxe/nye/nze = dimensions of field array fxyz, must be >= nx/ny/nz
+   nxv/nyv/nzv = dimensions of field array fxyzs, must be >= nx+3/ny+3/nz+3
+local data                                                 */
+   int j, k, l, jj, kk, ll, nn, mm;
+   for (l = 0; l < nz+3; l++) {
+      ll = l - 1;
+      ll = ll < 0 ? ll + nz : (ll >= nz ? ll - nz : ll);
+      for (k = 0; k < ny+3; k++) {
+         kk = k - 1;
+         kk = kk < 0 ? kk + ny : (kk >= ny ? kk - ny : kk);
+         mm = 3*nxv*(k + nyv*l);
+         nn = 3*nxe*(kk + nye*ll);
+         for (j = 0; j < nx+3; j++) {
+            jj = j - 1;
+            jj = jj < 0 ? jj + nx : (jj >= nx ? jj - nx : jj);
+            fxyzs[3*j+mm] = fxyz[3*jj+nn];
+            fxyzs[1+3*j+mm] = fxyz[1+3*jj+nn];
+            fxyzs[2+3*j+mm] = fxyz[2+3*jj+nn];
+         }
+      }
+   }
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void caguard3s(float qs[], float q[], int nx, int ny, int nz, int nxe,
+               int nye, int nze, int nxv, int nyv, int nzv) {
+/* accumulate extended periodic scalar field qs with one guard cell on
+   the left and two on the right into field q without guard cells, for
+   spline interpolation of order up to 3
+   qs[l+1][k+1][j+1] = charge density at grid (j,k,l), with guard cells
+   q[l][k][j] = charge density at grid (j,k,l), without guard cells
+   nx/ny/nz = system length in x/y/z direction
+   nxe/nye/nze = dimensions of field array q, must be >= nx/ny/nz
+   nxv/nyv/nzv = dimensions of field array qs, must be >= nx+3/ny+3/nz+3
+local data                                                 */
+   int j, k, l, kk, ll, nn, mm;
+/* clear field */
+   for (l = 0; l < nz; l++) {
+      for (k = 0; k < ny; k++) {
+         nn = nxe*(k + nye*l);
+         for (j = 0; j < nx; j++) {
+            q[j+nn] = 0.0;
+         }
+      }
+   }
+/* accumulate interior and guard cells */
+   for (l = 0; l < nz+3; l++) {
+      ll = l - 1;
+      ll = ll < 0 ? ll + nz : (ll >= nz ? ll - nz : ll);
+      for (k = 0; k < ny+3; k++) {
+         kk = k - 1;
+         kk = kk < 0 ? kk + ny : (kk >= ny ? kk - ny : kk);
+         mm = nxv*(k + nyv*l);
+         nn = nxe*(kk + nye*ll);
+         q[nx-1+nn] += qs[mm];
+         for (j = 1; j < nx+1; j++) {
+            q[j-1+nn] += qs[j+mm];
+         }
+         q[nn] += qs[nx+1+mm];
+         q[1+nn] += qs[nx+2+mm];
+      }
+   }
+   return;
+}
+
+/* Interfaces to Fortran */
+
+/*--------------------------------------------------------------------*/
+void cscurve3_(int *kcell, int *nx, int *ny, int *nz, int *nblok,
+               int *kcurve) {
+   cscurve3(kcell,*nx,*ny,*nz,*nblok,*kcurve);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cssortp3l_(float *parta, float *partb, int *npic, int *kcell,
+                int *idimp, int *nop, int *nx1, int *nxy1, int *nxyz1) {
+   cssortp3l(parta,partb,npic,kcell,*idimp,*nop,*nx1,*nxy1,*nxyz1);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cgpush3s_(float *part, float *fxyz, float *qbm, float *dt,
+               float *ek, int *idimp, int *nop, int *nx, int *ny,
+               int *nz, int *nxv, int *nyv, int *nzv, int *ipbc,
+               int *norder) {
+   cgpush3s(part,fxyz,*qbm,*dt,ek,*idimp,*nop,*nx,*ny,*nz,*nxv,*nyv,
+            *nzv,*ipbc,*norder);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void cgpost3s_(float *part, float *q, float *qm, int *nop, int *idimp,
+               int *nxv, int *nyv, int *nzv, int *norder) {
+   cgpost3s(part,q,*qm,*nop,*idimp,*nxv,*nyv,*nzv,*norder);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void ccguard3s_(float *fxyz, float *fxyzs, int *nx, int *ny, int *nz,
+                int *nxe, int *nye, int *nze, int *nxv, int *nyv,
+                int *nzv) {
+   ccguard3s(fxyz,fxyzs,*nx,*ny,*nz,*nxe,*nye,*nze,*nxv,*nyv,*nzv);
+   return;
+}
+
+/*--------------------------------------------------------------------*/
+void caguard3s_(float *qs, float *q, int *nx, int *ny, int *nz,
+                int *nxe, int *nye, int *nze, int *nxv, int *nyv,
+                int *nzv) {
+   caguard3s(qs,q,*nx,*ny,*nz,*nxe,*nye,*nze,*nxv,*nyv,*nzv);
+   return;
+}
+
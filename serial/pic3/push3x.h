@@ -0,0 +1,31 @@
+/* header file for push3x.c */
+
+int cspline1(float x, float w[], int norder);
+
+void cgpush3sn(float part[], float fxyz[], float qbm, float dt,
+               float *ek, int idimp, int nop, int nx, int ny, int nz,
+               int nxv, int nyv, int nzv, int ipbc, int norder);
+
+void cgpost3sn(float part[], float q[], float qm, int nop, int idimp,
+               int nxv, int nyv, int nzv, int norder);
+
+void cgpush3s(float part[], float fxyz[], float qbm, float dt,
+              float *ek, int idimp, int nop, int nx, int ny, int nz,
+              int nxv, int nyv, int nzv, int ipbc, int norder);
+
+void cgpost3s(float part[], float q[], float qm, int nop, int idimp,
+              int nxv, int nyv, int nzv, int norder);
+
+void cscurve(int ix[], int ih, int nbit, int ndim, int kcurve);
+
+void cscurve3(int kcell[], int nx, int ny, int nz, int nblok,
+              int kcurve);
+
+void cssortp3l(float parta[], float partb[], int npic[], int kcell[],
+               int idimp, int nop, int nx1, int nxy1, int nxyz1);
+
+void ccguard3s(float fxyz[], float fxyzs[], int nx, int ny, int nz,
+               int nxe, int nye, int nze, int nxv, int nyv, int nzv);
+
+void caguard3s(float qs[], float q[], int nx, int ny, int nz, int nxe,
+               int nye, int nze, int nxv, int nyv, int nzv);
@@ -8,6 +8,7 @@
 #include "vpush2.h"
 #include "sselib2.h"
 #include "ssepush2.h"
+#include "cfglib.h"
 
 void dtimer(double *time, struct timeval *itime, int icntrl);
 
@@ -67,6 +68,20 @@ int main(int argc, char *argv[]) {
    float tpush = 0.0, tsort = 0.0;
    double dtime;
 
+/* replace parameters with values from input decks or command line, */
+/* for example: cvpic2 indx=10 npx=1024 npy=1024                    */
+   irc = ccfgread(argc,argv,1);
+   ccfgint("indx",&indx); ccfgint("indy",&indy); ccfgint("npx",&npx);
+   ccfgint("npy",&npy); ccfgflt("tend",&tend); ccfgflt("dt",&dt);
+   ccfgflt("vtx",&vtx); ccfgflt("vty",&vty); ccfgflt("vx0",&vx0);
+   ccfgflt("vy0",&vy0); ccfgint("sortime",&sortime);
+   ccfgint("kvec",&kvec);
+   irc += ccfgend();
+   if (irc != 0) {
+      printf("invalid run time parameters\n");
+      exit(1);
+   }
+
 /* initialize scalars for standard code */
 /* np = total number of particles in simulation */
 /* nx/ny = number of grid points in x/y direction */